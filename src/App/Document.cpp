@@ -87,9 +87,28 @@ recompute path. Also, it enables more complicated dependencies beyond trees.
 #include <unordered_set>
 #include <unordered_map>
 #include <random>
+#include <atomic>
+#include <chrono>
+
+#if defined(FC_OS_WIN32)
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+#if defined(__GLIBC__)
+# include <malloc.h>
+#elif defined(FC_OS_MACOSX)
+# include <malloc/malloc.h>
+#endif
 
 #include <QCoreApplication>
 #include <QCryptographicHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 #include "AutoTransaction.h"
 #include "Document.h"
@@ -160,8 +179,169 @@ typedef std::vector <size_t> Path;
 
 namespace App {
 
+/** Measures the costs of a single object recompute for the recompute profile
+ *
+ * The allocation delta is taken from the process wide heap statistics, so it
+ * includes allocations of concurrently running threads.
+ */
+struct RecomputeProbe
+{
+    std::chrono::steady_clock::time_point wallStart;
+    double wallTime = 0.0;
+    double cpuStart = 0.0;
+    double cpuTime = 0.0;
+    long long memoryStart = 0;
+    long long memoryDelta = 0;
+    int thread = 0;
+    bool started = false;
+
+    void start() {
+        started = true;
+        thread = threadIndex();
+        memoryStart = allocatedMemory();
+        cpuStart = threadCpuTime();
+        wallStart = std::chrono::steady_clock::now();
+    }
+
+    void stop() {
+        wallTime = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - wallStart).count();
+        cpuTime = threadCpuTime() - cpuStart;
+        memoryDelta = allocatedMemory() - memoryStart;
+    }
+
+    /// Adds the costs of another phase of the same recompute, e.g. the
+    /// expression evaluation in the main thread around a concurrent recompute
+    void add(const RecomputeProbe &other) {
+        if (!other.started)
+            return;
+        if (!started) {
+            *this = other;
+            return;
+        }
+        if (other.wallStart < wallStart)
+            wallStart = other.wallStart;
+        wallTime += other.wallTime;
+        cpuTime += other.cpuTime;
+        memoryDelta += other.memoryDelta;
+    }
+
+    static double threadCpuTime() {
+#if defined(FC_OS_WIN32)
+        FILETIME creation, exit, kernel, user;
+        if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+            return 0.0;
+        ULARGE_INTEGER k, u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        // FILETIME is in units of 100ns
+        return (k.QuadPart + u.QuadPart) * 1e-7;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+        struct timespec ts;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+            return 0.0;
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+        return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+    }
+
+    static long long allocatedMemory() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+        struct mallinfo2 info = mallinfo2();
+        return static_cast<long long>(info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+        struct mallinfo info = mallinfo();
+        return static_cast<long long>(static_cast<unsigned int>(info.uordblks))
+            + static_cast<unsigned int>(info.hblkhd);
+#elif defined(FC_OS_MACOSX)
+        return static_cast<long long>(mstats().bytes_used);
+#else
+        return 0;
+#endif
+    }
+
+    static int threadIndex() {
+        static std::atomic<int> _ThreadCount(0);
+        static thread_local int _ThreadIndex = _ThreadCount++;
+        return _ThreadIndex;
+    }
+};
+
 static bool _IsRestoring;
 static bool _IsRelabeling;
+static std::atomic<unsigned long> _DependencyListRevision(1);
+
+// Objects of a document bucketed by their exact type, or by the exact types
+// of their extensions. Each entry carries the sequence number under which
+// the object was indexed, so that a query spanning several buckets returns
+// the objects in the order of Document::getObjects().
+class ObjectTypeIndex
+{
+public:
+    void add(Base::Type type, std::size_t sequence, DocumentObject *obj) {
+        buckets[type.getKey()].emplace_back(sequence, obj);
+    }
+
+    void remove(Base::Type type, DocumentObject *obj) {
+        auto it = buckets.find(type.getKey());
+        if(it == buckets.end())
+            return;
+        auto &bucket = it->second;
+        for(auto iter = bucket.begin(); iter != bucket.end(); ++iter) {
+            if(iter->second == obj) {
+                bucket.erase(iter);
+                break;
+            }
+        }
+        if(bucket.empty())
+            buckets.erase(it);
+    }
+
+    void clear() {
+        buckets.clear();
+    }
+
+    /// returns the objects of the given type or, if derived is true, of a type derived from it
+    std::vector<DocumentObject*> find(Base::Type type, bool derived) const {
+        std::vector<const Bucket*> matches;
+        std::size_t count = 0;
+        for(auto &v : buckets) {
+            if(v.first == type.getKey()
+                    || (derived && Base::Type::fromKey(v.first).isDerivedFrom(type)))
+            {
+                matches.push_back(&v.second);
+                count += v.second.size();
+            }
+        }
+
+        std::vector<DocumentObject*> res;
+        res.reserve(count);
+        if(matches.size() == 1) {
+            for(auto &entry : *matches.front())
+                res.push_back(entry.second);
+            return res;
+        }
+
+        // An object may be listed in several buckets of the extension index
+        Bucket merged;
+        merged.reserve(count);
+        for(auto bucket : matches)
+            merged.insert(merged.end(), bucket->begin(), bucket->end());
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        for(auto &entry : merged)
+            res.push_back(entry.second);
+        return res;
+    }
+
+private:
+    typedef std::vector<std::pair<std::size_t, DocumentObject*> > Bucket;
+    std::unordered_map<unsigned int, Bucket> buckets;
+};
+
 // Pimpl class
 struct DocumentP
 {
@@ -189,6 +369,41 @@ struct DocumentP
 #endif //USE_OLD_DAG
     std::multimap<const App::DocumentObject*, 
         std::unique_ptr<App::DocumentObjectExecReturn> > _RecomputeLog;
+    // synchronizes the recompute workers with the main thread
+    QMutex recomputeMutex;
+    QWaitCondition recomputeCondition;
+    // number of running recompute workers
+    int recomputeTasks;
+    // property changes of recompute workers waiting for the main thread
+    struct BeforeChange {
+        DocumentObject *obj;
+        const Property *prop;
+        bool done;
+    };
+    std::deque<BeforeChange*> beforeChanges;
+    // sorted dependency lists of the whole document, keyed by the options
+    // passed to recompute(), valid as long as depListRevision is current
+    std::map<int, std::vector<App::DocumentObject*> > depListCache;
+    unsigned long depListRevision;
+    Document::RecomputeStatistics recomputeStats;
+    // recompute profile, see Document::setRecomputeProfiling()
+    bool profiling;
+    std::vector<Document::RecomputeProfileEntry> recomputeProfile;
+    std::chrono::steady_clock::time_point profileStart;
+    // the first recomputed dependency that enforced the recompute of an
+    // object, both by name as objects may be deleted in between
+    std::unordered_map<std::string, std::string> recomputeTriggers;
+    // project file of a lazy restore, see Base::XMLReader::setLazyRestore()
+    std::shared_ptr<Base::LazyDocFile::Archive> lazyArchive;
+    // objects by type and by extension type, see Document::getObjectsOfType()
+    // and Document::getObjectsWithExtension()
+    ObjectTypeIndex typeIndex;
+    ObjectTypeIndex extensionIndex;
+    // the extension index is built on demand, possibly by a recompute worker
+    bool extensionIndexValid;
+    QMutex extensionIndexMutex;
+    std::unordered_map<const App::DocumentObject*, std::size_t> objectSequence;
+    std::size_t nextObjectSequence;
 
     DocumentP() {
         static std::random_device _RD;
@@ -210,6 +425,75 @@ struct DocumentP
         iUndoMode = 0;
         UndoMemSize = 0;
         UndoMaxStackSize = 20;
+        depListRevision = 0;
+        recomputeTasks = 0;
+        profiling = false;
+        extensionIndexValid = false;
+        nextObjectSequence = 0;
+    }
+
+    void indexExtensions(App::DocumentObject *obj, std::size_t sequence) {
+        for(auto it = obj->extensionBegin(); it != obj->extensionEnd(); ++it)
+            extensionIndex.add(it->first, sequence, obj);
+    }
+
+    void indexObject(App::DocumentObject *obj) {
+        std::size_t sequence = nextObjectSequence++;
+        objectSequence[obj] = sequence;
+        typeIndex.add(obj->getTypeId(), sequence, obj);
+        QMutexLocker lock(&extensionIndexMutex);
+        if(extensionIndexValid)
+            indexExtensions(obj, sequence);
+    }
+
+    void unindexObject(App::DocumentObject *obj) {
+        auto it = objectSequence.find(obj);
+        if(it == objectSequence.end())
+            return;
+        objectSequence.erase(it);
+        typeIndex.remove(obj->getTypeId(), obj);
+        QMutexLocker lock(&extensionIndexMutex);
+        if(extensionIndexValid) {
+            for(auto ext = obj->extensionBegin(); ext != obj->extensionEnd(); ++ext)
+                extensionIndex.remove(ext->first, obj);
+        }
+    }
+
+    void clearIndex() {
+        typeIndex.clear();
+        objectSequence.clear();
+        nextObjectSequence = 0;
+        QMutexLocker lock(&extensionIndexMutex);
+        extensionIndex.clear();
+        extensionIndexValid = false;
+    }
+
+    void addProfileEntry(const App::DocumentObject *obj, const RecomputeProbe &probe, bool error) {
+        Document::RecomputeProfileEntry entry;
+        entry.name = obj->getNameInDocument()?obj->getNameInDocument():"";
+        entry.label = obj->Label.getStrValue();
+        auto it = recomputeTriggers.find(obj->getFullName());
+        if(it!=recomputeTriggers.end())
+            entry.trigger = it->second;
+        entry.startTime = std::chrono::duration<double>(probe.wallStart - profileStart).count();
+        entry.wallTime = probe.wallTime;
+        entry.cpuTime = probe.cpuTime;
+        entry.memoryDelta = probe.memoryDelta;
+        entry.thread = probe.thread;
+        entry.error = error;
+        recomputeProfile.push_back(entry);
+    }
+
+    void enforceRecomputeInList(App::DocumentObject *obj) {
+        // set all dependent object touched to force recompute
+        for (auto inObjIt : obj->getInList()) {
+            inObjIt->enforceRecompute();
+            if(profiling) {
+                recomputeTriggers.emplace(inObjIt->getFullName(),
+                        inObjIt->getDocument()==obj->getDocument()
+                            ? std::string(obj->getNameInDocument()) : obj->getFullName());
+            }
+        }
     }
 
     void addRecomputeLog(const char *why, App::DocumentObject *obj) {
@@ -252,6 +536,74 @@ struct DocumentP
     static partialTopologicalSort(const std::vector<App::DocumentObject*>& objects);
 };
 
+/** Recompute of a single object in a worker thread
+ *
+ * Only DocumentObject::recompute() is run in the worker. Exceptions and
+ * object signals are captured and handed over to the main thread, which
+ * reports them in topological order so that the signal sequence and the
+ * recompute log do not depend on thread scheduling.
+ *
+ * Before a property is changed the worker waits for the main thread to
+ * handle the change, see Document::_beforeChangeFromWorker().
+ */
+class RecomputeTask : public QRunnable
+{
+public:
+    struct ObjectSignal {
+        DocumentObject *obj;
+        const Property *prop;
+        int type;
+    };
+
+    RecomputeTask(DocumentP *d, DocumentObject *obj, bool profiling)
+        : d(d), obj(obj), returnCode(DocumentObject::StdReturn), result(0), profiling(profiling)
+    {
+        setAutoDelete(false);
+    }
+
+    virtual ~RecomputeTask()
+    {
+        delete returnCode;
+    }
+
+    virtual void run() override;
+
+    DocumentP *d;
+    DocumentObject *obj;
+    DocumentObjectExecReturn *returnCode;
+    std::exception_ptr exception;
+    std::vector<ObjectSignal> pendingSignals;
+    std::vector<std::string> pendingWarnings;
+    int result;
+    bool profiling;
+    // the recompute in the worker thread
+    RecomputeProbe probe;
+    // the expression evaluation in the main thread before the recompute
+    RecomputeProbe expressionProbe;
+};
+
+static thread_local RecomputeTask *_CurrentRecomputeTask;
+
+void RecomputeTask::run()
+{
+    _CurrentRecomputeTask = this;
+    if (profiling)
+        probe.start();
+    try {
+        returnCode = obj->recompute();
+    }
+    catch (...) {
+        exception = std::current_exception();
+    }
+    if (profiling)
+        probe.stop();
+    _CurrentRecomputeTask = 0;
+
+    QMutexLocker locker(&d->recomputeMutex);
+    --d->recomputeTasks;
+    d->recomputeCondition.wakeAll();
+}
+
 } // namespace App
 
 PROPERTY_SOURCE(App::Document, App::PropertyContainer)
@@ -1284,6 +1636,7 @@ void Document::clearDocument()
     if(this->d->objectArray.size()) {
         GetApplication().signalDeleteDocument(*this);
         this->d->objectArray.clear();
+        this->d->clearIndex();
         for(auto &v : this->d->objectMap) {
             v.second->setStatus(ObjectStatus::Destroy, true);
             delete(v.second);
@@ -1299,6 +1652,8 @@ void Document::clearDocument()
 
     this->d->clearRecomputeLog();
     this->d->objectArray.clear();
+    this->d->clearIndex();
+    _invalidateDependencyList();
     this->d->objectMap.clear();
     this->d->objectIdMap.clear();
     this->d->lastObjectId = 0;
@@ -1418,6 +1773,7 @@ void Document::onChanged(const Property* prop)
 
     // the Name property is a label for display purposes
     if (prop == &Label) {
+        Expression::invalidateBindings();
         Base::FlagToggler<> flag(_IsRelabeling);
         App::GetApplication().signalRelabelDocument(*this);
     } else if(prop == &ShowHidden) {
@@ -1472,6 +1828,77 @@ void Document::onChangedProperty(const DocumentObject *Who, const Property *What
     signalChangedObject(*Who, *What);
 }
 
+bool Document::_isRecomputeWorker()
+{
+    return _CurrentRecomputeTask != 0;
+}
+
+void Document::_queueObjectSignal(DocumentObject *obj, const Property *prop, int type)
+{
+    _CurrentRecomputeTask->pendingSignals.push_back({obj,prop,type});
+}
+
+void Document::_beforeChangeFromWorker(DocumentObject *obj, const Property *prop)
+{
+    // The before change signal must see the old value and the undo
+    // transaction must copy it, so wait until the main thread has done both
+    DocumentP::BeforeChange request = {obj, prop, false};
+    QMutexLocker locker(&d->recomputeMutex);
+    d->beforeChanges.push_back(&request);
+    d->recomputeCondition.wakeAll();
+    while (!request.done)
+        d->recomputeCondition.wait(&d->recomputeMutex);
+}
+
+void Document::_waitForRecomputeWorkers()
+{
+    QMutexLocker locker(&d->recomputeMutex);
+    while (d->recomputeTasks > 0 || !d->beforeChanges.empty()) {
+        if (d->beforeChanges.empty()) {
+            d->recomputeCondition.wait(&d->recomputeMutex);
+            continue;
+        }
+        auto request = d->beforeChanges.front();
+        d->beforeChanges.pop_front();
+        locker.unlock();
+        try {
+            onBeforeChangeProperty(request->obj, request->prop);
+            request->obj->signalBeforeChange(*request->obj, *request->prop);
+        }
+        catch (const Base::Exception &e) {
+            e.ReportException();
+        }
+        catch (...) {
+            FC_ERR("Unknown exception on changing " << request->prop->getFullName());
+        }
+        locker.relock();
+        request->done = true;
+        d->recomputeCondition.wakeAll();
+    }
+}
+
+void Document::_queueRecomputeWarning(DocumentObject *obj, const char *msg)
+{
+    std::ostringstream str;
+    str << obj->getTypeId().getName() << " / " << obj->getNameInDocument() << ": " << msg;
+    _CurrentRecomputeTask->pendingWarnings.push_back(str.str());
+}
+
+void Document::_emitObjectSignal(DocumentObject *obj, const Property *prop, int type)
+{
+    switch (type) {
+    case 1: // changed
+        if (prop == &obj->Label && obj->oldLabel != obj->Label.getStrValue())
+            signalRelabelObject(*obj);
+        onChangedProperty(obj, prop);
+        obj->signalChanged(*obj, *prop);
+        break;
+    default: // touched
+        signalTouchedObject(*obj);
+        break;
+    }
+}
+
 void Document::setTransactionMode(int iMode)
 {
     d->iTransactionMode = iMode;
@@ -1601,6 +2028,8 @@ Document::~Document()
 #endif
 
     d->objectArray.clear();
+    d->clearIndex();
+    _invalidateDependencyList();
     for (auto it = d->objectMap.begin(); it != d->objectMap.end(); ++it) {
         it->second->setStatus(ObjectStatus::Destroy, true);
         delete(it->second);
@@ -2559,6 +2988,11 @@ bool Document::saveToFile(const char* filename) const
     }
     Base::FileInfo tmp(fn);
 
+    // the data not read yet from the project file must be loaded before
+    // the file may get overwritten
+    Base::LazyDocFile::loadAll(d->lazyArchive);
+    d->lazyArchive.reset();
+
     // open extra scope to close ZipWriter properly
     {
         Base::ofstream file(tmp, std::ios::out | std::ios::binary);
@@ -2569,6 +3003,9 @@ bool Document::saveToFile(const char* filename) const
 
         writer.setComment("FreeCAD Document");
         writer.setLevel(compression);
+        if (hGrp->GetBool("ParallelCompression", false))
+            writer.setThreadCount(QThread::idealThreadCount());
+        writer.setPerFileCompression(hGrp->GetBool("PerFileCompression", false));
         writer.putNextEntry("Document.xml");
 
         if (hGrp->GetBool("SaveBinaryBrep", false))
@@ -2642,6 +3079,7 @@ void Document::restore (const char *filename,
         signal = true;
         GetApplication().signalDeleteDocument(*this);
         d->objectArray.clear();
+        d->clearIndex();
         for(auto &v : d->objectMap) {
             v.second->setStatus(ObjectStatus::Destroy, true);
             delete(v.second);
@@ -2656,6 +3094,8 @@ void Document::restore (const char *filename,
 
     d->clearRecomputeLog();
     d->objectArray.clear();
+    d->clearIndex();
+    _invalidateDependencyList();
     d->objectMap.clear();
     d->objectIdMap.clear();
     d->lastObjectId = 0;
@@ -2682,6 +3122,14 @@ void Document::restore (const char *filename,
     if (!reader.isValid())
         throw Base::FileException("Error reading compression file",filename);
 
+    // defer reading heavy data like shapes or meshes until it is needed
+    d->lazyArchive.reset();
+    if (App::GetApplication().GetParameterGroupByPath
+            ("User parameter:BaseApp/Preferences/Document")->GetBool("LazyRestore",false)) {
+        reader.setLazyRestore(true);
+        d->lazyArchive = reader.getLazyArchive();
+    }
+
     GetApplication().signalStartRestoreDocument(*this);
     setStatus(Document::Restoring, true);
 
@@ -3172,6 +3620,20 @@ std::vector<App::Document*> Document::getDependentDocuments(
     return ret;
 }
 
+void Document::_invalidateDependencyList()
+{
+    ++_DependencyListRevision;
+    // Object and link changes may also change what an expression refers to
+    Expression::invalidateBindings();
+}
+
+void Document::_invalidateExtensionIndex()
+{
+    QMutexLocker lock(&d->extensionIndexMutex);
+    d->extensionIndex.clear();
+    d->extensionIndexValid = false;
+}
+
 void Document::_rebuildDependencyList(const std::vector<App::DocumentObject*> &objs)
 {
 #ifdef USE_OLD_DAG
@@ -3368,8 +3830,12 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
 
     // delete recompute log
     d->clearRecomputeLog();
+    d->recomputeTriggers.clear();
+    if (d->profiling)
+        clearRecomputeProfile();
 
     FC_TIME_INIT(t);
+    auto recomputeStart = std::chrono::steady_clock::now();
 
     Base::ObjectStatusLocker<Document::Status, Document> exe(Document::Recomputing, this);
     signalBeforeRecompute(*this);
@@ -3393,7 +3859,33 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     }
     std::reverse(topoSortedObjects.begin(),topoSortedObjects.end());
 #else
-    auto topoSortedObjects = getDependencyList(objs.empty()?d->objectArray:objs,DepSort|options);
+    std::vector<App::DocumentObject*> topoSortedObjects;
+    auto depListStart = std::chrono::steady_clock::now();
+    if (objs.size()) {
+        topoSortedObjects = getDependencyList(objs,DepSort|options);
+        ++d->recomputeStats.depListMisses;
+    }
+    else {
+        // Reuse the sorted list of the whole document as long as no link
+        // has changed and no object was added or removed
+        unsigned long revision = _DependencyListRevision;
+        if (d->depListRevision != revision) {
+            d->depListCache.clear();
+            d->depListRevision = revision;
+        }
+        auto it = d->depListCache.find(options);
+        if (it != d->depListCache.end()) {
+            topoSortedObjects = it->second;
+            ++d->recomputeStats.depListHits;
+        }
+        else {
+            topoSortedObjects = getDependencyList(d->objectArray,DepSort|options);
+            d->depListCache[options] = topoSortedObjects;
+            ++d->recomputeStats.depListMisses;
+        }
+    }
+    d->recomputeStats.depListTime += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - depListStart).count();
 #endif
     for(auto obj : topoSortedObjects)
         obj->setStatus(ObjectStatus::PendingRecompute,true);
@@ -3401,6 +3893,12 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     ParameterGrp::handle hGrp = GetApplication().GetParameterGroupByPath(
             "User parameter:BaseApp/Preferences/Document");
     bool canAbort = hGrp->GetBool("CanAbortRecompute",true);
+    int threads = 0;
+    if (hGrp->GetBool("ParallelRecompute",false)) {
+        threads = hGrp->GetInt("RecomputeThreads",0);
+        if (threads <= 0)
+            threads = QThread::idealThreadCount();
+    }
 
     std::set<App::DocumentObject *> filter;
     size_t idx = 0;
@@ -3414,6 +3912,12 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
             if(canAbort)
                 seq.reset(new Base::SequencerLauncher("Recompute...", topoSortedObjects.size()));
             FC_LOG("Recompute pass " << passes);
+            if (passes == 0 && threads > 1) {
+                // the second pass is left to the serial loop below
+                if (_recomputeConcurrently(topoSortedObjects,filter,threads,seq.get(),objectCount,hasError) < 0)
+                    passes = 2;
+                idx = topoSortedObjects.size();
+            }
             for (;idx<topoSortedObjects.size();(seq?seq->next(true):true),++idx) {
                 auto obj = topoSortedObjects[idx];
                 if(!obj->getNameInDocument() || filter.find(obj)!=filter.end())
@@ -3441,9 +3945,7 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
                 if(obj->isTouched() || doRecompute) {
                     signalRecomputedObject(*obj);
                     obj->purgeTouched();
-                    // set all dependent object touched to force recompute
-                    for (auto inObjIt : obj->getInList())
-                        inObjIt->enforceRecompute();
+                    d->enforceRecomputeInList(obj);
                 }
             }
             // check if all objects are recomputed but still thouched 
@@ -3482,6 +3984,9 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     signalRecomputed(*this,topoSortedObjects);
 
     FC_TIME_LOG(t,"Recompute total");
+    ++d->recomputeStats.recomputeCount;
+    d->recomputeStats.recomputeTime += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - recomputeStart).count();
 
     if(d->_RecomputeLog.size())
         Base::Console().Error("Recompute failed! Please check report view.\n");
@@ -3663,19 +4168,126 @@ const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
     return d->findRecomputeLog(Obj);
 }
 
+const Document::RecomputeStatistics &Document::getRecomputeStatistics() const
+{
+    return d->recomputeStats;
+}
+
+void Document::resetRecomputeStatistics()
+{
+    d->recomputeStats = RecomputeStatistics();
+}
+
+void Document::setRecomputeProfiling(bool enable)
+{
+    if (enable && !d->profiling)
+        clearRecomputeProfile();
+    d->profiling = enable;
+}
+
+bool Document::isRecomputeProfiling() const
+{
+    return d->profiling;
+}
+
+const std::vector<Document::RecomputeProfileEntry> &Document::getRecomputeProfile() const
+{
+    return d->recomputeProfile;
+}
+
+void Document::clearRecomputeProfile()
+{
+    d->recomputeProfile.clear();
+    d->profileStart = std::chrono::steady_clock::now();
+}
+
+static void _writeJsonString(std::ostream &out, const std::string &str)
+{
+    out << '"';
+    for (unsigned char c : str) {
+        switch (c) {
+        case '"':  out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\r': out << "\\r"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (c < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out << buf;
+            }
+            else
+                out << c;
+        }
+    }
+    out << '"';
+}
+
+void Document::exportRecomputeProfile(std::ostream &out) const
+{
+    // Chrome trace event format, can be viewed with chrome://tracing
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (auto &entry : d->recomputeProfile) {
+        if (!first)
+            out << ',';
+        first = false;
+        out << "\n{\"name\":";
+        _writeJsonString(out, entry.label);
+        out << ",\"cat\":\"recompute\",\"ph\":\"X\",\"pid\":1"
+            << ",\"tid\":" << entry.thread
+            << ",\"ts\":" << static_cast<long long>(entry.startTime * 1e6)
+            << ",\"dur\":" << static_cast<long long>(entry.wallTime * 1e6)
+            << ",\"args\":{\"object\":";
+        _writeJsonString(out, entry.name);
+        out << ",\"trigger\":";
+        _writeJsonString(out, entry.trigger);
+        out << ",\"cpu\":" << entry.cpuTime
+            << ",\"memory\":" << entry.memoryDelta
+            << ",\"error\":" << (entry.error ? "true" : "false")
+            << "}}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"document\":";
+    _writeJsonString(out, getName());
+    out << "}}" << std::endl;
+}
+
 // call the recompute of the Feature and handle the exceptions and errors.
 int Document::_recomputeFeature(DocumentObject* Feat)
 {
     FC_LOG("Recomputing " << Feat->getFullName());
 
-    DocumentObjectExecReturn  *returnCode = 0;
-    try {
-        returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
+    RecomputeProbe probe;
+    if(d->profiling)
+        probe.start();
+
+    int res = _recomputeFeatureStep(Feat, [Feat]() {
+        DocumentObjectExecReturn *returnCode = 
+            Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
         if (returnCode == DocumentObject::StdReturn) {
             returnCode = Feat->recompute();
             if(returnCode == DocumentObject::StdReturn)
                 returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
         }
+        return returnCode;
+    });
+    if(!res)
+        Feat->resetError();
+
+    if(d->profiling) {
+        probe.stop();
+        d->addProfileEntry(Feat, probe, res!=0);
+    }
+    return res;
+}
+
+int Document::_recomputeFeatureStep(DocumentObject* Feat,
+        const std::function<DocumentObjectExecReturn*()> &step)
+{
+    DocumentObjectExecReturn  *returnCode = 0;
+    try {
+        returnCode = step();
     }
     catch(Base::AbortException &e){
         e.ReportException();
@@ -3707,9 +4319,7 @@ int Document::_recomputeFeature(DocumentObject* Feat)
     }
 #endif
 
-    if(returnCode == DocumentObject::StdReturn) {
-        Feat->resetError();
-    }else{
+    if(returnCode != DocumentObject::StdReturn) {
         returnCode->Which = Feat;
         d->addRecomputeLog(returnCode);
         FC_ERR("Failed to recompute " << Feat->getFullName() << ": " << returnCode->Why);
@@ -3718,6 +4328,133 @@ int Document::_recomputeFeature(DocumentObject* Feat)
     return 0;
 }
 
+int Document::_recomputeConcurrently(const std::vector<App::DocumentObject*> &objs,
+        std::set<App::DocumentObject*> &filter, int threads,
+        Base::SequencerLauncher *seq, int &objectCount, bool *hasError)
+{
+    // Group the objects into levels. An object only depends on objects of
+    // lower levels, so all objects of one level can be recomputed at once.
+    std::unordered_map<App::DocumentObject*, size_t> levelMap;
+    std::vector<std::vector<App::DocumentObject*> > levels;
+    for (auto obj : objs) {
+        size_t level = 0;
+        for (auto dep : obj->getOutList()) {
+            auto it = levelMap.find(dep);
+            if (it != levelMap.end() && it->second >= level)
+                level = it->second + 1;
+        }
+        levelMap[obj] = level;
+        if (levels.size() <= level)
+            levels.resize(level+1);
+        levels[level].push_back(obj);
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    for (auto &level : levels) {
+        std::vector<std::unique_ptr<RecomputeTask> > tasks(level.size());
+        for (size_t i=0; i<level.size(); ++i) {
+            auto obj = level[i];
+            if (!obj->getNameInDocument() || filter.count(obj)
+                    || !obj->canRecomputeConcurrently() || !obj->mustRecompute())
+                continue;
+
+            FC_LOG("Recomputing " << obj->getFullName() << " concurrently");
+            tasks[i].reset(new RecomputeTask(d, obj, d->profiling));
+
+            // Expressions may call into Python, so evaluate them here
+            if (d->profiling)
+                tasks[i]->expressionProbe.start();
+            tasks[i]->result = _recomputeFeatureStep(obj, [obj]() {
+                return obj->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
+            });
+            if (d->profiling)
+                tasks[i]->expressionProbe.stop();
+            if (tasks[i]->result)
+                continue;
+
+            // The out list is cached on demand, build it before the workers
+            // start to access it
+            for (auto dep : obj->getOutList())
+                dep->getOutList();
+            {
+                QMutexLocker locker(&d->recomputeMutex);
+                ++d->recomputeTasks;
+            }
+            pool.start(tasks[i].get());
+        }
+        // Handle the property changes of the workers until they are done
+        _waitForRecomputeWorkers();
+        pool.waitForDone();
+
+        // Finish the recompute in the main thread in topological order
+        for (size_t i=0; i<level.size(); (seq?seq->next(true):true), ++i) {
+            auto obj = level[i];
+            if (!obj->getNameInDocument() || filter.count(obj))
+                continue;
+
+            bool doRecompute = false;
+            int res = 0;
+            auto &task = tasks[i];
+            if (task) {
+                doRecompute = true;
+                ++objectCount;
+                res = task->result;
+                RecomputeProbe outputProbe;
+                if (d->profiling)
+                    outputProbe.start();
+                for (auto &msg : task->pendingWarnings)
+                    Base::Console().Warning("%s\n", msg.c_str());
+                if (!res) {
+                    for (auto &sig : task->pendingSignals)
+                        _emitObjectSignal(sig.obj, sig.prop, sig.type);
+                    res = _recomputeFeatureStep(obj, [&task, obj]() {
+                        if (task->exception)
+                            std::rethrow_exception(task->exception);
+                        DocumentObjectExecReturn *returnCode = task->returnCode;
+                        task->returnCode = DocumentObject::StdReturn;
+                        if (returnCode == DocumentObject::StdReturn)
+                            returnCode = obj->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
+                        return returnCode;
+                    });
+                    if (!res)
+                        obj->resetError();
+                }
+                if (d->profiling) {
+                    outputProbe.stop();
+                    task->probe.add(task->expressionProbe);
+                    task->probe.add(outputProbe);
+                    d->addProfileEntry(obj, task->probe, res!=0);
+                }
+            }
+            else if (obj->mustRecompute()) {
+                doRecompute = true;
+                ++objectCount;
+                res = _recomputeFeature(obj);
+            }
+
+            if (res) {
+                if (hasError)
+                    *hasError = true;
+                if (res < 0)
+                    return -1;
+                // if something happened filter all object in its
+                // inListRecursive from the queue then proceed
+                obj->getInListEx(filter,true);
+                filter.insert(obj);
+                continue;
+            }
+            if (obj->isTouched() || doRecompute) {
+                signalRecomputedObject(*obj);
+                obj->purgeTouched();
+                d->enforceRecomputeInList(obj);
+            }
+        }
+    }
+    return 0;
+}
+
 bool Document::recomputeFeature(DocumentObject* Feat, bool recursive)
 {
     // delete recompute log
@@ -3782,6 +4519,8 @@ DocumentObject * Document::addObject(const char* sType, const char* pObjectName,
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    d->indexObject(pcObject);
+    _invalidateDependencyList();
     // insert in the adjacence list and reference through the ConectionMap
     //_DepConMap[pcObject] = add_vertex(_DepList);
 
@@ -3884,6 +4623,8 @@ std::vector<DocumentObject *> Document::addObjects(const char* sType, const std:
         pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
         // insert in the vector
         d->objectArray.push_back(pcObject);
+        d->indexObject(pcObject);
+        _invalidateDependencyList();
 
         pcObject->Label.setValue(ObjectName);
 
@@ -3948,6 +4689,8 @@ void Document::addObject(DocumentObject* pcObject, const char* pObjectName)
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    d->indexObject(pcObject);
+    _invalidateDependencyList();
 
     pcObject->Label.setValue( ObjectName );
 
@@ -3975,6 +4718,8 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
     if(!pcObject->_Id) pcObject->_Id = ++d->lastObjectId;
     d->objectIdMap[pcObject->_Id] = pcObject;
     d->objectArray.push_back(pcObject);
+    d->indexObject(pcObject);
+    _invalidateDependencyList();
     // cache the pointer to the name string in the Object (for performance of DocumentObject::getNameInDocument())
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
 
@@ -4103,6 +4848,8 @@ void Document::removeObject(const char* sName)
     for (std::vector<DocumentObject*>::iterator obj = d->objectArray.begin(); obj != d->objectArray.end(); ++obj) {
         if (*obj == pos->second) {
             d->objectArray.erase(obj);
+            d->unindexObject(pos->second);
+            _invalidateDependencyList();
             break;
         }
     }
@@ -4178,6 +4925,8 @@ void Document::_removeObject(DocumentObject* pcObject)
     for (std::vector<DocumentObject*>::iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
         if (*it == pcObject) {
             d->objectArray.erase(it);
+            d->unindexObject(pcObject);
+            _invalidateDependencyList();
             break;
         }
     }
@@ -4482,22 +5231,23 @@ const std::vector<DocumentObject*> &Document::getObjects() const
 
 std::vector<DocumentObject*> Document::getObjectsOfType(const Base::Type& typeId) const
 {
-    std::vector<DocumentObject*> Objects;
-    for (std::vector<DocumentObject*>::const_iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
-        if ((*it)->getTypeId().isDerivedFrom(typeId))
-            Objects.push_back(*it);
-    }
-    return Objects;
+    return d->typeIndex.find(typeId, true);
 }
 
 std::vector< DocumentObject* > Document::getObjectsWithExtension(const Base::Type& typeId, bool derived) const {
 
-    std::vector<DocumentObject*> Objects;
-    for (std::vector<DocumentObject*>::const_iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
-        if ((*it)->hasExtension(typeId, derived))
-            Objects.push_back(*it);
+    QMutexLocker lock(&d->extensionIndexMutex);
+    if (!d->extensionIndexValid) {
+        // extensions may be added to an object after it was added to the
+        // document, so the index is rebuilt after any such change
+        for (auto obj : d->objectArray) {
+            auto it = d->objectSequence.find(obj);
+            if (it != d->objectSequence.end())
+                d->indexExtensions(obj, it->second);
+        }
+        d->extensionIndexValid = true;
     }
-    return Objects;
+    return d->extensionIndex.find(typeId, derived);
 }
 
 
@@ -4506,24 +5256,16 @@ std::vector<DocumentObject*> Document::findObjects(const Base::Type& typeId, con
     boost::regex rx(objname);
     boost::cmatch what;
     std::vector<DocumentObject*> Objects;
-    for (std::vector<DocumentObject*>::const_iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
-        if ((*it)->getTypeId().isDerivedFrom(typeId)) {
-            if (boost::regex_match((*it)->getNameInDocument(), what, rx))
-                Objects.push_back(*it);
-        }
+    for (auto obj : getObjectsOfType(typeId)) {
+        if (boost::regex_match(obj->getNameInDocument(), what, rx))
+            Objects.push_back(obj);
     }
     return Objects;
 }
 
 int Document::countObjectsOfType(const Base::Type& typeId) const
 {
-    int ct=0;
-    for (auto it = d->objectMap.begin(); it != d->objectMap.end(); ++it) {
-        if (it->second->getTypeId().isDerivedFrom(typeId))
-            ct++;
-    }
-
-    return ct;
+    return static_cast<int>(getObjectsOfType(typeId).size());
 }
 
 PyObject * Document::getPyObject(void)
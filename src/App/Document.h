@@ -41,6 +41,7 @@
 
 namespace Base {
     class Writer;
+    class SequencerLauncher;
 }
 
 namespace App
@@ -333,6 +334,59 @@ public:
     bool recomputeFeature(DocumentObject* Feat,bool recursive=false);
     /// get the text of the error of a specified object
     const char* getErrorDescription(const App::DocumentObject*) const;
+
+    /// Timing counters of recompute()
+    struct RecomputeStatistics {
+        /// number of recomputes that reused the cached dependency list
+        unsigned long depListHits = 0;
+        /// number of recomputes that had to rebuild the dependency list
+        unsigned long depListMisses = 0;
+        /// accumulated time in seconds spent building and sorting dependency lists
+        double depListTime = 0.0;
+        /// number of calls of recompute()
+        unsigned long recomputeCount = 0;
+        /// accumulated time in seconds spent in recompute()
+        double recomputeTime = 0.0;
+    };
+    /// get the timing counters of recompute()
+    const RecomputeStatistics &getRecomputeStatistics() const;
+    /// reset the timing counters of recompute()
+    void resetRecomputeStatistics();
+
+    /// One object recompute recorded while recompute profiling is enabled
+    struct RecomputeProfileEntry {
+        /// internal name of the recomputed object
+        std::string name;
+        /// label of the recomputed object
+        std::string label;
+        /// name of the dependency whose recompute triggered this one, empty
+        /// if the object itself was touched
+        std::string trigger;
+        /// start time in seconds since the profile was cleared
+        double startTime = 0.0;
+        /// elapsed wall clock time in seconds, including the expression
+        /// evaluation. A concurrent recompute sums the time of its phases in
+        /// the main and in the worker thread.
+        double wallTime = 0.0;
+        /// CPU time in seconds consumed by the recomputing threads
+        double cpuTime = 0.0;
+        /// change of the allocated heap memory in bytes, 0 if unsupported
+        long long memoryDelta = 0;
+        /// index of the thread that ran the recompute
+        int thread = 0;
+        /// true if the recompute failed
+        bool error = false;
+    };
+    /// enable or disable recording each object recompute
+    void setRecomputeProfiling(bool enable);
+    /// check if each object recompute is recorded
+    bool isRecomputeProfiling() const;
+    /// get the object recomputes recorded during the last recompute()
+    const std::vector<RecomputeProfileEntry> &getRecomputeProfile() const;
+    /// clear the recorded object recomputes
+    void clearRecomputeProfile();
+    /// write the recorded object recomputes in the Chrome trace event format
+    void exportRecomputeProfile(std::ostream &out) const;
     /// return the status bits
     bool testStatus(Status pos) const;
     /// set the status bits
@@ -520,11 +574,42 @@ protected:
     /// helper which Recompute only this feature
     /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
     int _recomputeFeature(DocumentObject* Feat);
+    /// helper which runs one step of a feature recompute and reports its errors
+    /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
+    int _recomputeFeatureStep(DocumentObject* Feat,
+            const std::function<DocumentObjectExecReturn*()> &step);
+    /** helper which recomputes the given topological sorted objects level by
+     * level, running the objects that allow it in a pool of worker threads
+     * @return 0 if succeeded, -1 if aborted by user.
+     */
+    int _recomputeConcurrently(const std::vector<App::DocumentObject*> &objs,
+            std::set<App::DocumentObject*> &filter, int threads,
+            Base::SequencerLauncher *seq, int &objectCount, bool *hasError);
+    /// \internal check if the calling thread is a recompute worker thread
+    static bool _isRecomputeWorker();
+    /// \internal queue an object signal emitted by a recompute worker thread
+    void _queueObjectSignal(DocumentObject *obj, const Property *prop, int type);
+    /// \internal let the main thread handle a property change of a recompute worker thread
+    void _beforeChangeFromWorker(DocumentObject *obj, const Property *prop);
+    /// \internal handle the property changes of the recompute workers until they are done
+    void _waitForRecomputeWorkers();
+    /// \internal emit an object signal queued by a recompute worker thread
+    void _emitObjectSignal(DocumentObject *obj, const Property *prop, int type);
+    /// \internal queue a warning of a recompute worker thread for the main thread
+    void _queueRecomputeWarning(DocumentObject *obj, const char *msg);
     void _clearRedos();
 
     /// refresh the internal dependency graph
     void _rebuildDependencyList(
         const std::vector<App::DocumentObject*> &objs = std::vector<App::DocumentObject*>());
+    /** \internal invalidate the cached dependency lists
+     *
+     * Called whenever an object is added or removed or any link changes. As
+     * dependencies may cross document boundaries this affects all documents.
+     */
+    static void _invalidateDependencyList();
+    /// \internal invalidate the index of getObjectsWithExtension()
+    void _invalidateExtensionIndex();
 
     std::string getTransientDirectoryName(const std::string& uuid, const std::string& filename) const;
 
@@ -100,7 +100,12 @@ App::DocumentObjectExecReturn *DocumentObject::recompute(void)
     //check if the links are valid before making the recompute
     if(!GeoFeatureGroupExtension::areLinksValid(this)) {
 #if 1
-        Base::Console().Warning("%s / %s: Links go out of the allowed scope\n", getTypeId().getName(), getNameInDocument());
+        // Base::Console is not thread safe, a recompute worker thread
+        // leaves the warning to the main thread
+        if (_pDoc && Document::_isRecomputeWorker())
+            _pDoc->_queueRecomputeWarning(this, "Links go out of the allowed scope");
+        else
+            Base::Console().Warning("%s / %s: Links go out of the allowed scope\n", getTypeId().getName(), getNameInDocument());
 #else
         return new App::DocumentObjectExecReturn("Links go out of the allowed scope", this);
 #endif
@@ -144,8 +149,12 @@ void DocumentObject::touch(bool noRecompute)
     if(!noRecompute)
         StatusBits.set(ObjectStatus::Enforce);
     StatusBits.set(ObjectStatus::Touch);
-    if (_pDoc)
-        _pDoc->signalTouchedObject(*this);
+    if (_pDoc) {
+        if (Document::_isRecomputeWorker())
+            _pDoc->_queueObjectSignal(this,0,2);
+        else
+            _pDoc->signalTouchedObject(*this);
+    }
 }
 
 /**
@@ -686,6 +695,13 @@ void DocumentObject::onBeforeChange(const Property* prop)
     if (prop == &Label)
         oldLabel = Label.getStrValue();
 
+    // Signals must not be emitted from a recompute worker thread, let the
+    // document emit them in the main thread
+    if (_pDoc && Document::_isRecomputeWorker()) {
+        _pDoc->_beforeChangeFromWorker(this,prop);
+        return;
+    }
+
     if (_pDoc)
         onBeforeChangeProperty(_pDoc, prop);
 
@@ -716,8 +732,12 @@ void DocumentObject::onChanged(const Property* prop)
     // if (_pDoc)
     //     _pDoc->onChangedProperty(this,prop);
 
-    if (prop == &Label && _pDoc && oldLabel != Label.getStrValue())
-        _pDoc->signalRelabelObject(*this);
+    if (prop == &Label && _pDoc && oldLabel != Label.getStrValue()) {
+        // Expressions may refer to the object by its label
+        Expression::invalidateBindings();
+        if (!Document::_isRecomputeWorker())
+            _pDoc->signalRelabelObject(*this);
+    }
 
     // set object touched if it is an input property
     if (!testStatus(ObjectStatus::NoTouch) 
@@ -736,6 +756,11 @@ void DocumentObject::onChanged(const Property* prop)
     //call the parent for appropriate handling
     TransactionalObject::onChanged(prop);
 
+    if (_pDoc && Document::_isRecomputeWorker()) {
+        _pDoc->_queueObjectSignal(this,prop,1);
+        return;
+    }
+
     // Now signal the view provider
     if (_pDoc)
         _pDoc->onChangedProperty(this,prop);
@@ -744,6 +769,7 @@ void DocumentObject::onChanged(const Property* prop)
 }
 
 void DocumentObject::clearOutListCache() const {
+    Document::_invalidateDependencyList();
     _outList.clear();
     _outListMap.clear();
     _outListCached = false;
@@ -968,6 +994,7 @@ void App::DocumentObject::_removeBackLink(DocumentObject* rmvObj)
     auto it = std::find(_inList.begin(), _inList.end(), rmvObj);
     if(it != _inList.end())
         _inList.erase(it);
+    Document::_invalidateDependencyList();
 #else
     (void)rmvObj;
 #endif
@@ -981,6 +1008,7 @@ void App::DocumentObject::_addBackLink(DocumentObject* newObj)
     //this removal would clear the object from the inlist, even though there may be other link properties 
     //from this object that link to us.
     _inList.push_back(newObj);
+    Document::_invalidateDependencyList();
 #else
     (void)newObj;
 #endif //USE_OLD_DAG    
@@ -1208,3 +1236,11 @@ void DocumentObject::onPropertyStatusChanged(const Property &prop, unsigned long
     if(!Document::isAnyRestoring() && getNameInDocument() && getDocument())
         getDocument()->signalChangePropertyEditor(*getDocument(),prop);
 }
+
+void DocumentObject::onExtensionRegistered(Base::Type extension) {
+    (void)extension;
+    // extensions added in the constructor are indexed when the object is
+    // added to the document
+    if(getNameInDocument() && getDocument())
+        getDocument()->_invalidateExtensionIndex();
+}
@@ -153,6 +153,17 @@ public:
     void enforceRecompute();
     /// Test if this document object must be recomputed
     bool mustRecompute(void) const;
+    /** Check whether execute() can run in a worker thread
+     *
+     * Document::recompute() may recompute objects returning true here
+     * concurrently if parallel recompute is enabled in the preferences.
+     * Reimplement it only if execute() just reads the object's own properties
+     * and those of the objects it depends on, only changes its own
+     * properties and neither calls into Python nor modifies any link.
+     * Base::Console is not thread safe, so execute() must not write to it
+     * either but report problems by its return value or by an exception.
+     */
+    virtual bool canRecomputeConcurrently() const {return false;}
     /// reset this document object touched
     void purgeTouched(void) {
         StatusBits.reset(ObjectStatus::Touch);
@@ -413,6 +424,7 @@ public:
     friend class Document;
     friend class Transaction;
     friend class ObjectExecution;
+    friend class RecomputeTask;
 
     static DocumentObjectExecReturn *StdReturn;
 
@@ -601,6 +613,8 @@ protected:
 
     /// get called when a property status has changed
     virtual void onPropertyStatusChanged(const Property &prop, unsigned long oldStatus) override;
+    /// get called after an extension was added to the object
+    virtual void onExtensionRegistered(Base::Type extension) override;
 
      /// python object of this class and all descendent
 protected: // attributes
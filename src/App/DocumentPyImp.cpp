@@ -459,6 +459,37 @@ PyObject*  DocumentPy::clearUndos(PyObject * args)
     Py_Return;
 }
 
+PyObject*  DocumentPy::resetRecomputeStatistics(PyObject * args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return NULL;
+    getDocumentPtr()->resetRecomputeStatistics();
+    Py_Return;
+}
+
+PyObject*  DocumentPy::exportRecomputeProfile(PyObject * args)
+{
+    char* fn=0;
+    if (!PyArg_ParseTuple(args, "|s",&fn))
+        return NULL;
+    if (fn) {
+        Base::FileInfo fi(fn);
+        Base::ofstream str(fi);
+        getDocumentPtr()->exportRecomputeProfile(str);
+        str.close();
+        Py_Return;
+    }
+    else {
+        std::stringstream str;
+        getDocumentPtr()->exportRecomputeProfile(str);
+#if PY_MAJOR_VERSION >= 3
+        return PyUnicode_FromString(str.str().c_str());
+#else
+        return PyString_FromString(str.str().c_str());
+#endif
+    }
+}
+
 PyObject*  DocumentPy::recompute(PyObject * args)
 {
     PyObject *pyobjs = Py_None;
@@ -873,6 +904,43 @@ Py::Boolean DocumentPy::getTransacting() const {
     return Py::Boolean(getDocumentPtr()->isPerformingTransaction());
 }
 
+Py::Dict DocumentPy::getRecomputeStatistics() const {
+    const auto &stats = getDocumentPtr()->getRecomputeStatistics();
+    Py::Dict dict;
+    dict.setItem("DependencyListHits", Py::Long(stats.depListHits));
+    dict.setItem("DependencyListMisses", Py::Long(stats.depListMisses));
+    dict.setItem("DependencyListTime", Py::Float(stats.depListTime));
+    dict.setItem("RecomputeCount", Py::Long(stats.recomputeCount));
+    dict.setItem("RecomputeTime", Py::Float(stats.recomputeTime));
+    return dict;
+}
+
+Py::Boolean DocumentPy::getRecomputeProfiling() const {
+    return Py::Boolean(getDocumentPtr()->isRecomputeProfiling());
+}
+
+void DocumentPy::setRecomputeProfiling(Py::Boolean arg) {
+    getDocumentPtr()->setRecomputeProfiling(arg.isTrue());
+}
+
+Py::List DocumentPy::getRecomputeProfile() const {
+    Py::List list;
+    for (auto &entry : getDocumentPtr()->getRecomputeProfile()) {
+        Py::Dict dict;
+        dict.setItem("Name", Py::String(entry.name));
+        dict.setItem("Label", Py::String(entry.label));
+        dict.setItem("Trigger", Py::String(entry.trigger));
+        dict.setItem("StartTime", Py::Float(entry.startTime));
+        dict.setItem("WallTime", Py::Float(entry.wallTime));
+        dict.setItem("CPUTime", Py::Float(entry.cpuTime));
+        dict.setItem("MemoryDelta", Py::Long(static_cast<PY_LONG_LONG>(entry.memoryDelta)));
+        dict.setItem("Thread", Py::Long(entry.thread));
+        dict.setItem("Error", Py::Boolean(entry.error));
+        list.append(dict);
+    }
+    return list;
+}
+
 Py::String DocumentPy::getOldLabel() const {
     return Py::String(getDocumentPtr()->getOldLabel());
 }
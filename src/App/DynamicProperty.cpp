@@ -31,6 +31,7 @@
 #include "PropertyContainer.h"
 #include "Application.h"
 #include "ExtensionContainer.h"
+#include "Expression.h"
 #include <Base/Reader.h>
 #include <Base/Writer.h>
 #include <Base/Console.h>
@@ -57,6 +58,8 @@ void DynamicProperty::clear() {
     for(auto &v : index)
         delete v.property;
     index.clear();
+    // Expressions may have resolved to the removed properties
+    Expression::invalidateBindings();
 }
 
 void DynamicProperty::getPropertyList(std::vector<Property*> &List) const
@@ -176,6 +179,8 @@ Property* DynamicProperty::addDynamicProperty(PropertyContainer &pc, const char*
     pcProperty->syncType(attr);
     pcProperty->StatusBits.set((size_t)Property::PropDynamic);
 
+    Expression::invalidateBindings();
+
     GetApplication().signalAppendDynamicProperty(*pcProperty);
 
     return pcProperty;
@@ -190,6 +195,7 @@ bool DynamicProperty::addProperty(Property *prop)
         return false;
     index.emplace(prop,std::string(),prop->getName(),
             prop->getGroup(),prop->getDocumentation(),prop->getType(),false,false);
+    Expression::invalidateBindings();
     return true;
 }
 
@@ -199,6 +205,7 @@ bool DynamicProperty::removeProperty(const Property *prop)
     auto it = index.find(const_cast<Property*>(prop));
     if (it != index.end()) {
         index.erase(it);
+        Expression::invalidateBindings();
         return true;
     }
     return false;
@@ -217,6 +224,7 @@ bool DynamicProperty::removeDynamicProperty(const char* name)
         GetApplication().signalRemoveDynamicProperty(*prop);
         Property::destroy(prop);
         index.erase(it);
+        Expression::invalidateBindings();
         return true;
     }
 
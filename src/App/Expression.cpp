@@ -54,6 +54,7 @@
 #include <deque>
 #include <algorithm>
 #include "ExpressionParser.h"
+#include "ExpressionProgram.h"
 #include <Base/Unit.h>
 #include <App/PropertyUnits.h>
 #include <App/ObjectIdentifier.h>
@@ -1147,6 +1148,10 @@ ExpressionPtr Expression::replaceObject(const DocumentObject *parent,
 }
 
 App::any Expression::getValueAsAny() const {
+    ExpressionProgram::Value value;
+    if(ExpressionProgram::eval(this,value))
+        return ExpressionProgram::toAny(value);
+
     Base::PyGILStateLocker lock;
     return pyObjectToAny(getPyValue());
 }
@@ -1168,6 +1173,7 @@ Py::Object Expression::getPyValue() const {
 void Expression::addComponent(Component *component) {
     assert(component);
     components.push_back(component);
+    std::atomic_store(&program, std::shared_ptr<ExpressionProgram>());
 }
 
 void Expression::visit(ExpressionVisitor &v) {
@@ -1178,6 +1184,10 @@ void Expression::visit(ExpressionVisitor &v) {
 }
 
 Expression* Expression::eval() const {
+    ExpressionProgram::Value value;
+    if(ExpressionProgram::eval(this,value))
+        return ExpressionProgram::toExpression(owner,value);
+
     Base::PyGILStateLocker lock;
     return expressionFromPy(owner,getPyValue());
 }
@@ -1310,6 +1320,31 @@ Py::Object UnitExpression::_getPyValue() const {
     return Py::Object(cache);
 }
 
+bool UnitExpression::_compile(ExpressionProgram &program) const {
+    // Same value as pyFromQuantity()
+    ExpressionProgram::Value value;
+    if(!quantity.getUnit().isEmpty()) {
+        value.kind = ExpressionProgram::Value::Quantity;
+        value.quantity = quantity;
+    } else {
+        long l;
+        int i;
+        switch(essentiallyInteger(quantity.getValue(),l,i)) {
+        case 0:
+            value.kind = ExpressionProgram::Value::Float;
+            value.number = quantity.getValue();
+            break;
+        case 1:
+            value.kind = ExpressionProgram::Value::Integer;
+            value.integer = l;
+            break;
+        default:
+            return false;
+        }
+    }
+    return program.addConstant(value);
+}
+
 //
 // NumberExpression class
 //
@@ -1731,6 +1766,15 @@ void OperatorExpression::_visit(ExpressionVisitor &v)
         right->visit(v);
 }
 
+bool OperatorExpression::_compile(ExpressionProgram &program) const
+{
+    if (!program.add(left))
+        return false;
+    if (op != NEG && op != POS && !program.add(right))
+        return false;
+    return program.addOperator(op);
+}
+
 bool OperatorExpression::isCommutative() const
 {
     switch (op) {
@@ -2157,6 +2201,17 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         v3 = pyToQuantity(e3,expr,"Invalid third argument.");
     }
 
+    return Py::asObject(new QuantityPy(new Quantity(evaluate(expr, f, v1, v2, v3, args.size()))));
+}
+
+/**
+  * Evaluate one of the numerical functions. The arguments are already
+  * converted to quantities, \a argCount is the number of given arguments.
+  */
+
+Quantity FunctionExpression::evaluate(const Expression *expr, int f, const Quantity &v1,
+        const Quantity &v2, const Quantity &v3, std::size_t argCount)
+{
     double output;
     Unit unit;
     double scaler = 1;
@@ -2226,7 +2281,7 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         break;
     }
     case ATAN2:
-        if (e2.isNone())
+        if (argCount < 2)
             _EXPR_THROW("Invalid second argument.",expr);
 
         if (v1.getUnit() != v2.getUnit())
@@ -2235,12 +2290,12 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         scaler = 180.0 / M_PI;
         break;
     case MOD:
-        if (e2.isNone())
+        if (argCount < 2)
             _EXPR_THROW("Invalid second argument.",expr);
         unit = v1.getUnit() / v2.getUnit();
         break;
     case POW: {
-        if (e2.isNone())
+        if (argCount < 2)
             _EXPR_THROW("Invalid second argument.",expr);
 
         if (!v2.getUnit().isEmpty())
@@ -2258,17 +2313,13 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
     }
     case HYPOT:
     case CATH:
-        if (e2.isNone())
+        if (argCount < 2)
             _EXPR_THROW("Invalid second argument.",expr);
         if (v1.getUnit() != v2.getUnit())
             _EXPR_THROW("Units must be equal.",expr);
 
-        if (args.size() > 2) {
-            if (e3.isNone())
-                _EXPR_THROW("Invalid second argument.",expr);
-            if (v2.getUnit() != v3.getUnit())
-                _EXPR_THROW("Units must be equal.",expr);
-        }
+        if (argCount > 2 && v2.getUnit() != v3.getUnit())
+            _EXPR_THROW("Units must be equal.",expr);
         unit = v1.getUnit();
         break;
     default:
@@ -2332,11 +2383,11 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         break;
     }
     case HYPOT: {
-        output = sqrt(pow(v1.getValue(), 2) + pow(v2.getValue(), 2) + (!e3.isNone() ? pow(v3.getValue(), 2) : 0));
+        output = sqrt(pow(v1.getValue(), 2) + pow(v2.getValue(), 2) + (argCount > 2 ? pow(v3.getValue(), 2) : 0));
         break;
     }
     case CATH: {
-        output = sqrt(pow(v1.getValue(), 2) - pow(v2.getValue(), 2) - (!e3.isNone() ? pow(v3.getValue(), 2) : 0));
+        output = sqrt(pow(v1.getValue(), 2) - pow(v2.getValue(), 2) - (argCount > 2 ? pow(v3.getValue(), 2) : 0));
         break;
     }
     case ROUND:
@@ -2355,13 +2406,24 @@ Py::Object FunctionExpression::evaluate(const Expression *expr, int f, const std
         _EXPR_THROW("Unknown function: " << f,expr);
     }
 
-    return Py::asObject(new QuantityPy(new Quantity(scaler * output, unit)));
+    return Quantity(scaler * output, unit);
 }
 
 Py::Object FunctionExpression::_getPyValue() const {
     return evaluate(this,f,args);
 }
 
+bool FunctionExpression::_compile(ExpressionProgram &program) const {
+    // Only the numerical functions
+    if (!owner || f <= NONE || f >= LIST || args.empty() || args.size() > 3)
+        return false;
+    for (auto arg : args) {
+        if (!program.add(arg))
+            return false;
+    }
+    return program.addFunction(this, f, static_cast<int>(args.size()));
+}
+
 /**
   * Try to simplify the expression, i.e calculate all constant expressions.
   *
@@ -2615,6 +2677,10 @@ Py::Object VariableExpression::_getPyValue() const {
     return var.getPyValue(true);
 }
 
+bool VariableExpression::_compile(ExpressionProgram &program) const {
+    return program.addProperty(&var);
+}
+
 void VariableExpression::_toString(std::ostream &ss, bool persistent,int) const {
     if(persistent)
         ss << var.toPersistentString();
@@ -2663,33 +2729,47 @@ void VariableExpression::_getIdentifiers(std::set<App::ObjectIdentifier> &deps)
     deps.insert(var);
 }
 
+// The functions below modify var in place, which may invalidate the property
+// resolved by a compiled expression
+
 bool VariableExpression::_relabeledDocument(const std::string &oldName,
         const std::string &newName, ExpressionVisitor &v)
 {
-    return var.relabeledDocument(v, oldName, newName);
+    if(!var.relabeledDocument(v, oldName, newName))
+        return false;
+    invalidateBindings();
+    return true;
 }
 
 bool VariableExpression::_adjustLinks(
         const std::set<App::DocumentObject *> &inList, ExpressionVisitor &v)
 {
-    return var.adjustLinks(v,inList);
+    if(!var.adjustLinks(v,inList))
+        return false;
+    invalidateBindings();
+    return true;
 }
 
 void VariableExpression::_importSubNames(const ObjectIdentifier::SubNameMap &subNameMap)
 {
     var.importSubNames(subNameMap);
+    invalidateBindings();
 }
 
 void VariableExpression::_updateLabelReference(
         App::DocumentObject *obj, const std::string &ref, const char *newLabel)
 {
-    var.updateLabelReference(obj,ref,newLabel);
+    if(var.updateLabelReference(obj,ref,newLabel))
+        invalidateBindings();
 }
 
 bool VariableExpression::_updateElementReference(
         App::DocumentObject *feature, bool reverse, ExpressionVisitor &v)
 {
-    return var.updateElementReference(v,feature,reverse);
+    if(!var.updateElementReference(v,feature,reverse))
+        return false;
+    invalidateBindings();
+    return true;
 }
 
 bool VariableExpression::_renameObjectIdentifier(
@@ -2704,6 +2784,7 @@ bool VariableExpression::_renameObjectIdentifier(
             var = it->second.relativeTo(path);
         else
             var = it->second;
+        invalidateBindings();
         return true;
     }
     return false;
@@ -2739,6 +2820,7 @@ void VariableExpression::_moveCells(const CellAddress &address,
         addr.setRow(thisRow + rowCount);
         addr.setCol(thisCol + colCount);
         var.setComponent(idx,ObjectIdentifier::SimpleComponent(addr.toString()));
+        invalidateBindings();
     }
 }
 
@@ -2758,11 +2840,13 @@ void VariableExpression::_offsetCells(int rowOffset, int colOffset, ExpressionVi
     if(!addr.isAbsoluteRow())
         addr.setRow(addr.row()+rowOffset);
     var.setComponent(idx,ObjectIdentifier::SimpleComponent(addr.toString()));
+    invalidateBindings();
 }
 
 void VariableExpression::setPath(const ObjectIdentifier &path)
 {
      var = path;
+     invalidateBindings();
 }
 
 //
@@ -2942,6 +3026,21 @@ void ConditionalExpression::_visit(ExpressionVisitor &v)
     falseExpr->visit(v);
 }
 
+bool ConditionalExpression::_compile(ExpressionProgram &program) const
+{
+    if (!program.add(condition))
+        return false;
+    std::size_t toFalse = program.addJump(true);
+    if (!program.add(trueExpr))
+        return false;
+    std::size_t toEnd = program.addJump(false);
+    program.setJumpTarget(toFalse);
+    if (!program.add(falseExpr))
+        return false;
+    program.setJumpTarget(toEnd);
+    return true;
+}
+
 TYPESYSTEM_SOURCE(App::ConstantExpression, App::NumberExpression)
 
 ConstantExpression::ConstantExpression(const DocumentObject *_owner,
@@ -2975,6 +3074,18 @@ Py::Object ConstantExpression::_getPyValue() const {
     return Py::Object(cache);
 }
 
+bool ConstantExpression::_compile(ExpressionProgram &program) const {
+    if(strcmp(name,"None")==0)
+        return false;
+    if(strcmp(name,"True")==0 || strcmp(name,"False")==0) {
+        ExpressionProgram::Value value;
+        value.boolean = true;
+        value.integer = strcmp(name,"True")==0 ? 1 : 0;
+        return program.addConstant(value);
+    }
+    return NumberExpression::_compile(program);
+}
+
 bool ConstantExpression::isNumber() const {
     return strcmp(name,"None")
         && strcmp(name,"True")
@@ -32,6 +32,7 @@
 #include <Base/BaseClass.h>
 #include <Base/Quantity.h>
 #include <set>
+#include <memory>
 #include <deque>
 #include <App/Range.h>
 
@@ -44,6 +45,7 @@ namespace App  {
 
 class DocumentObject;
 class Expression;
+class ExpressionProgram;
 class Document;
 
 typedef std::unique_ptr<Expression> ExpressionPtr;
@@ -182,7 +184,11 @@ public:
 
     bool isSame(const Expression &other) const;
 
+    /// Mark the properties resolved by all compiled expressions as outdated
+    static void invalidateBindings();
+
     friend ExpressionVisitor;
+    friend class ExpressionProgram;
 
 protected:
     virtual bool _isIndexable() const {return false;}
@@ -209,12 +215,15 @@ protected:
     virtual void _offsetCells(int, int, ExpressionVisitor &) {}
     virtual Py::Object _getPyValue() const = 0;
     virtual void _visit(ExpressionVisitor &) {}
+    virtual bool _compile(ExpressionProgram &) const {return false;}
 
 protected:
     App::DocumentObject * owner; /**< The document object used to access unqualified variables (i.e local scope) */
 
     ComponentList components;
 
+    mutable std::shared_ptr<ExpressionProgram> program; /**< Compiled form, created on first evaluation */
+
 public:
     std::string comment;
 };
@@ -95,6 +95,7 @@ protected:
     virtual Expression * _copy() const override;
     virtual void _toString(std::ostream &ss, bool persistent, int indent) const override;
     virtual Py::Object _getPyValue() const override;
+    virtual bool _compile(ExpressionProgram &) const override;
 
 protected:
     mutable PyObject *cache = 0;
@@ -139,6 +140,7 @@ protected:
     virtual Py::Object _getPyValue() const override;
     virtual void _toString(std::ostream &ss, bool persistent, int indent) const override;
     virtual Expression* _copy() const override;
+    virtual bool _compile(ExpressionProgram &) const override;
 
 protected:
     const char *name;
@@ -195,6 +197,8 @@ protected:
 
     virtual void _visit(ExpressionVisitor & v) override;
 
+    virtual bool _compile(ExpressionProgram &) const override;
+
     virtual bool isCommutative() const;
 
     virtual bool isLeftAssociative() const;
@@ -224,6 +228,7 @@ protected:
     virtual void _visit(ExpressionVisitor & v) override;
     virtual void _toString(std::ostream &ss, bool persistent, int indent) const override;
     virtual Py::Object _getPyValue() const override;
+    virtual bool _compile(ExpressionProgram &) const override;
 
 protected:
 
@@ -297,12 +302,16 @@ public:
 
     static Py::Object evaluate(const Expression *owner, int type, const std::vector<Expression*> &args);
 
+    static Base::Quantity evaluate(const Expression *owner, int type, const Base::Quantity &v1,
+            const Base::Quantity &v2, const Base::Quantity &v3, std::size_t argCount);
+
 protected:
     static Py::Object evalAggregate(const Expression *owner, int type, const std::vector<Expression*> &args);
     virtual Py::Object _getPyValue() const override;
     virtual Expression * _copy() const override;
     virtual void _visit(ExpressionVisitor & v) override;
     virtual void _toString(std::ostream &ss, bool persistent, int indent) const override;
+    virtual bool _compile(ExpressionProgram &) const override;
 
     Function f;        /**< Function to execute */
     std::vector<Expression *> args; /** Arguments to function*/
@@ -357,6 +366,7 @@ protected:
                     App::DocumentObject *newObj) const override;
     virtual void _moveCells(const CellAddress &, int, int, ExpressionVisitor &) override;
     virtual void _offsetCells(int, int, ExpressionVisitor &) override;
+    virtual bool _compile(ExpressionProgram &) const override;
 
 protected:
 
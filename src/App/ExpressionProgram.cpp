@@ -0,0 +1,625 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD Developers                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#include <atomic>
+#include <cmath>
+#include <climits>
+
+#include <QMutexLocker>
+
+#include <Base/Exception.h>
+#include "ExpressionProgram.h"
+#include "ExpressionParser.h"
+#include "PropertyStandard.h"
+#include "PropertyUnits.h"
+
+using namespace App;
+using namespace Base;
+
+typedef ExpressionProgram::Value Value;
+
+// Incremented whenever a resolved property may have become invalid
+static std::atomic<unsigned long> _BindingRevision(1);
+
+// Integers up to this magnitude convert to double without loss
+static const double _MaxExactInteger = 9007199254740992.0;
+
+void Expression::invalidateBindings()
+{
+    ++_BindingRevision;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// Value helpers, implementing the same semantics as the Python number types
+// and Base::QuantityPy
+
+static inline void setInteger(Value &v, long l, bool boolean=false)
+{
+    v.kind = Value::Integer;
+    v.boolean = boolean;
+    v.integer = l;
+}
+
+static inline void setFloat(Value &v, double d)
+{
+    v.kind = Value::Float;
+    v.boolean = false;
+    v.number = d;
+}
+
+static inline void setQuantity(Value &v, const Quantity &q)
+{
+    v.kind = Value::Quantity;
+    v.boolean = false;
+    v.quantity = q;
+}
+
+// Conversion of an int or float operand for float arithmetic
+static inline bool toDouble(const Value &v, double &d)
+{
+    if(v.kind == Value::Float) {
+        d = v.number;
+        return true;
+    }
+    if(v.kind != Value::Integer)
+        return false;
+    d = static_cast<double>(v.integer);
+    return std::fabs(d) < _MaxExactInteger;
+}
+
+// Conversion of an operand of a QuantityPy operation or function argument
+static inline Quantity toQuantity(const Value &v)
+{
+    switch(v.kind) {
+    case Value::Integer:
+        return Quantity(static_cast<double>(v.integer));
+    case Value::Float:
+        return Quantity(v.number);
+    default:
+        return v.quantity;
+    }
+}
+
+static inline bool isTrue(const Value &v)
+{
+    switch(v.kind) {
+    case Value::Integer:
+        return v.integer != 0;
+    case Value::Float:
+        return v.number != 0.0;
+    default:
+        return v.quantity.getValue() != 0.0;
+    }
+}
+
+static inline bool addInteger(long a, long b, long &res)
+{
+    if((b > 0 && a > LONG_MAX - b) || (b < 0 && a < LONG_MIN - b))
+        return false;
+    res = a + b;
+    return true;
+}
+
+static inline bool subtractInteger(long a, long b, long &res)
+{
+    if((b < 0 && a > LONG_MAX + b) || (b > 0 && a < LONG_MIN + b))
+        return false;
+    res = a - b;
+    return true;
+}
+
+static inline bool multiplyInteger(long a, long b, long &res)
+{
+    if(a > 0) {
+        if(b > 0 ? a > LONG_MAX / b : b < LONG_MIN / a)
+            return false;
+    }
+    else if(a < 0) {
+        if(b > 0 ? a < LONG_MIN / b : b < LONG_MAX / a)
+            return false;
+    }
+    res = a * b;
+    return true;
+}
+
+static inline bool powerInteger(long base, long exp, long &res)
+{
+    long result = 1;
+    while(exp) {
+        if((exp & 1) && !multiplyInteger(result, base, result))
+            return false;
+        exp >>= 1;
+        if(exp && !multiplyInteger(base, base, base))
+            return false;
+    }
+    res = result;
+    return true;
+}
+
+// Python float power, anything raising an exception or returning complex
+// number is left to Python
+static inline bool powerFloat(double base, double exp, double &res)
+{
+    if(!std::isfinite(base) || !std::isfinite(exp))
+        return false;
+    if(exp == 0.0) {
+        res = 1.0;
+        return true;
+    }
+    if(base == 0.0 && exp < 0.0)
+        return false;
+    if(base < 0.0 && exp != std::floor(exp))
+        return false;
+    res = std::pow(base, exp);
+    return std::isfinite(res);
+}
+
+template<class T>
+static inline bool compare(int op, const T &a, const T &b, bool &res)
+{
+    switch(op) {
+    case OperatorExpression::EQ:
+        res = a == b;
+        break;
+    case OperatorExpression::NEQ:
+        res = a != b;
+        break;
+    case OperatorExpression::LT:
+        res = a < b;
+        break;
+    case OperatorExpression::LTE:
+        res = a <= b;
+        break;
+    case OperatorExpression::GT:
+        res = a > b;
+        break;
+    case OperatorExpression::GTE:
+        res = a >= b;
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+static bool compare(int op, const Value &l, const Value &r, bool &res)
+{
+    if(l.kind == Value::Quantity || r.kind == Value::Quantity) {
+        if(l.kind != r.kind)
+            return false;
+        // Same as QuantityPy::richCompare()
+        const Quantity &a = l.quantity;
+        const Quantity &b = r.quantity;
+        switch(op) {
+        case OperatorExpression::EQ:
+            res = a == b;
+            break;
+        case OperatorExpression::NEQ:
+            res = !(a == b);
+            break;
+        case OperatorExpression::LT:
+            res = a < b;
+            break;
+        case OperatorExpression::LTE:
+            res = a < b || a == b;
+            break;
+        case OperatorExpression::GT:
+            res = !(a < b) && !(a == b);
+            break;
+        case OperatorExpression::GTE:
+            res = !(a < b);
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    if(l.kind == Value::Integer && r.kind == Value::Integer)
+        return compare(op, l.integer, r.integer, res);
+
+    double a, b;
+    if(!toDouble(l, a) || !toDouble(r, b))
+        return false;
+    return compare(op, a, b, res);
+}
+
+static bool unaryOperator(int op, Value &v)
+{
+    switch(v.kind) {
+    case Value::Integer:
+        if(op == OperatorExpression::NEG) {
+            if(v.integer == LONG_MIN)
+                return false;
+            setInteger(v, -v.integer);
+        }
+        else
+            setInteger(v, v.integer);
+        return true;
+    case Value::Float:
+        if(op == OperatorExpression::NEG)
+            setFloat(v, -v.number);
+        return true;
+    default:
+        if(op == OperatorExpression::NEG)
+            v.quantity = v.quantity * -1.0;
+        return true;
+    }
+}
+
+// Evaluate a binary operator, the result is stored in l
+static bool binaryOperator(int op, Value &l, const Value &r)
+{
+    switch(op) {
+    case OperatorExpression::EQ:
+    case OperatorExpression::NEQ:
+    case OperatorExpression::LT:
+    case OperatorExpression::LTE:
+    case OperatorExpression::GT:
+    case OperatorExpression::GTE: {
+        bool res;
+        if(!compare(op, l, r, res))
+            return false;
+        setInteger(l, res ? 1 : 0, true);
+        return true;
+    }
+    case OperatorExpression::POW:
+        if(l.kind == Value::Quantity) {
+            if(r.kind == Value::Quantity)
+                l.quantity = l.quantity.pow(r.quantity);
+            else if(r.kind == Value::Float)
+                l.quantity = l.quantity.pow(r.number);
+            else
+                l.quantity = l.quantity.pow(static_cast<double>(r.integer));
+            return true;
+        }
+        if(r.kind == Value::Quantity)
+            return false;
+        if(l.kind == Value::Integer && r.kind == Value::Integer && r.integer >= 0) {
+            long res;
+            if(!powerInteger(l.integer, r.integer, res))
+                return false;
+            setInteger(l, res);
+            return true;
+        }
+        else {
+            double a, b, res;
+            if(!toDouble(l, a) || !toDouble(r, b) || !powerFloat(a, b, res))
+                return false;
+            setFloat(l, res);
+            return true;
+        }
+    default:
+        break;
+    }
+
+    if(l.kind == Value::Quantity || r.kind == Value::Quantity) {
+        Quantity a = toQuantity(l);
+        Quantity b = toQuantity(r);
+        switch(op) {
+        case OperatorExpression::ADD:
+            setQuantity(l, a + b);
+            break;
+        case OperatorExpression::SUB:
+            setQuantity(l, a - b);
+            break;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            setQuantity(l, a * b);
+            break;
+        case OperatorExpression::DIV:
+            setQuantity(l, a / b);
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    // Python int true division results in float
+    if(l.kind == Value::Integer && r.kind == Value::Integer && op != OperatorExpression::DIV) {
+        long res;
+        switch(op) {
+        case OperatorExpression::ADD:
+            if(!addInteger(l.integer, r.integer, res))
+                return false;
+            break;
+        case OperatorExpression::SUB:
+            if(!subtractInteger(l.integer, r.integer, res))
+                return false;
+            break;
+        case OperatorExpression::MUL:
+        case OperatorExpression::UNIT:
+            if(!multiplyInteger(l.integer, r.integer, res))
+                return false;
+            break;
+        default:
+            return false;
+        }
+        setInteger(l, res);
+        return true;
+    }
+
+    double a, b;
+    if(!toDouble(l, a) || !toDouble(r, b))
+        return false;
+    switch(op) {
+    case OperatorExpression::ADD:
+        setFloat(l, a + b);
+        break;
+    case OperatorExpression::SUB:
+        setFloat(l, a - b);
+        break;
+    case OperatorExpression::MUL:
+    case OperatorExpression::UNIT:
+        setFloat(l, a * b);
+        break;
+    case OperatorExpression::DIV:
+        if(b == 0.0)
+            return false;
+        setFloat(l, a / b);
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// ExpressionProgram
+
+bool ExpressionProgram::eval(const Expression *expr, Value &result)
+{
+    auto program = std::atomic_load(&expr->program);
+    if(!program) {
+        program = std::make_shared<ExpressionProgram>();
+        program->compile(expr);
+        std::atomic_store(&expr->program, program);
+    }
+    if(!program->valid)
+        return false;
+    return program->run(result);
+}
+
+bool ExpressionProgram::compile(const Expression *expr)
+{
+    valid = add(expr) && stackSize == 1;
+    if(!valid) {
+        code.clear();
+        constants.clear();
+        slots.clear();
+    }
+    return valid;
+}
+
+bool ExpressionProgram::push(int count)
+{
+    stackSize += count;
+    return stackSize <= MaxStackSize;
+}
+
+bool ExpressionProgram::add(const Expression *expr)
+{
+    if(!expr || expr->hasComponent())
+        return false;
+    return expr->_compile(*this);
+}
+
+bool ExpressionProgram::addConstant(const Value &value)
+{
+    if(!push(1))
+        return false;
+    code.push_back({PushConstant, 0, static_cast<int>(constants.size()), 0});
+    constants.push_back(value);
+    return true;
+}
+
+bool ExpressionProgram::addProperty(const ObjectIdentifier *path)
+{
+    if(!push(1))
+        return false;
+    code.push_back({PushProperty, 0, static_cast<int>(slots.size()), 0});
+    slots.push_back({path, 0, Value::Integer});
+    return true;
+}
+
+bool ExpressionProgram::addOperator(int op)
+{
+    switch(op) {
+    case OperatorExpression::NEG:
+    case OperatorExpression::POS:
+        if(stackSize < 1)
+            return false;
+        code.push_back({Unary, op, 0, 0});
+        return true;
+    case OperatorExpression::ADD:
+    case OperatorExpression::SUB:
+    case OperatorExpression::MUL:
+    case OperatorExpression::DIV:
+    case OperatorExpression::POW:
+    case OperatorExpression::UNIT:
+    case OperatorExpression::EQ:
+    case OperatorExpression::NEQ:
+    case OperatorExpression::LT:
+    case OperatorExpression::GT:
+    case OperatorExpression::LTE:
+    case OperatorExpression::GTE:
+        if(stackSize < 2)
+            return false;
+        code.push_back({Binary, op, 0, 0});
+        --stackSize;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ExpressionProgram::addFunction(const Expression *expr, int function, int argc)
+{
+    if(argc < 1 || argc > 3 || stackSize < argc)
+        return false;
+    code.push_back({Function, function, argc, expr});
+    stackSize -= argc - 1;
+    return true;
+}
+
+std::size_t ExpressionProgram::addJump(bool ifFalse)
+{
+    // A conditional jump consumes the condition. An unconditional jump skips
+    // the other branch of a conditional, which pushes its own result instead.
+    --stackSize;
+    code.push_back({ifFalse ? JumpIfFalse : Jump, 0, 0, 0});
+    return code.size() - 1;
+}
+
+void ExpressionProgram::setJumpTarget(std::size_t jump)
+{
+    code[jump].arg = static_cast<int>(code.size());
+}
+
+bool ExpressionProgram::bind()
+{
+    revision = _BindingRevision;
+    bound = false;
+    try {
+        for(auto &slot : slots) {
+            const Property *prop = slot.path->getPlainProperty();
+            if(!prop)
+                return false;
+            Base::Type type = prop->getTypeId();
+            if(type.isDerivedFrom(PropertyQuantity::getClassTypeId()))
+                slot.kind = Value::Quantity;
+            else if(type.isDerivedFrom(PropertyFloat::getClassTypeId()))
+                slot.kind = Value::Float;
+            else if(type.isDerivedFrom(PropertyInteger::getClassTypeId()))
+                slot.kind = Value::Integer;
+            else
+                return false;
+            slot.prop = prop;
+        }
+    }
+    catch(Base::Exception &) {
+        return false;
+    }
+    bound = true;
+    return true;
+}
+
+bool ExpressionProgram::run(Value &result)
+{
+    QMutexLocker lock(&mutex);
+
+    if(revision != _BindingRevision) {
+        if(!bind())
+            return false;
+    }
+    else if(!bound)
+        return false;
+
+    Value stack[MaxStackSize];
+    int top = -1;
+    try {
+        for(std::size_t pc=0; pc<code.size(); ++pc) {
+            const Instruction &inst = code[pc];
+            switch(inst.code) {
+            case PushConstant:
+                stack[++top] = constants[inst.arg];
+                break;
+            case PushProperty: {
+                const Slot &slot = slots[inst.arg];
+                Value &v = stack[++top];
+                if(slot.kind == Value::Quantity)
+                    setQuantity(v, static_cast<const PropertyQuantity*>(slot.prop)->getQuantityValue());
+                else if(slot.kind == Value::Float)
+                    setFloat(v, static_cast<const PropertyFloat*>(slot.prop)->getValue());
+                else
+                    setInteger(v, static_cast<const PropertyInteger*>(slot.prop)->getValue());
+                break;
+            }
+            case Unary:
+                if(!unaryOperator(inst.op, stack[top]))
+                    return false;
+                break;
+            case Binary:
+                --top;
+                if(!binaryOperator(inst.op, stack[top], stack[top+1]))
+                    return false;
+                break;
+            case Function: {
+                top -= inst.arg - 1;
+                Quantity args[3];
+                for(int i=0; i<inst.arg; ++i)
+                    args[i] = toQuantity(stack[top+i]);
+                setQuantity(stack[top], FunctionExpression::evaluate(
+                            inst.expr, inst.op, args[0], args[1], args[2], inst.arg));
+                break;
+            }
+            case JumpIfFalse:
+                if(isTrue(stack[top--]))
+                    break;
+                // fall through
+            case Jump:
+                pc = inst.arg - 1;
+                break;
+            }
+        }
+    }
+    catch(Base::Exception &) {
+        // Let Python evaluation report the error
+        return false;
+    }
+
+    result = stack[0];
+    return true;
+}
+
+App::any ExpressionProgram::toAny(const Value &value)
+{
+    switch(value.kind) {
+    case Value::Integer:
+        return App::any(value.integer);
+    case Value::Float:
+        return App::any(value.number);
+    default:
+        return App::any(value.quantity);
+    }
+}
+
+Expression *ExpressionProgram::toExpression(const DocumentObject *owner, const Value &value)
+{
+    switch(value.kind) {
+    case Value::Integer:
+        if(value.boolean) {
+            if(value.integer)
+                return new ConstantExpression(owner,"True",Quantity(1.0));
+            else
+                return new ConstantExpression(owner,"False",Quantity(0.0));
+        }
+        return new NumberExpression(owner,Quantity(static_cast<double>(value.integer)));
+    case Value::Float:
+        return new NumberExpression(owner,Quantity(value.number));
+    default:
+        return new NumberExpression(owner,value.quantity);
+    }
+}
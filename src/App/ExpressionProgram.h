@@ -0,0 +1,152 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD Developers                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef APP_EXPRESSIONPROGRAM_H
+#define APP_EXPRESSIONPROGRAM_H
+
+#include <vector>
+#include <QMutex>
+#include <Base/Quantity.h>
+#include <App/Expression.h>
+
+namespace App {
+
+class Property;
+
+/**
+ * @brief Compiled form of a numerical expression.
+ *
+ * The expression tree is lowered into a flat list of instructions working
+ * on a value stack, with the referenced properties resolved in advance.
+ * Evaluating the program needs neither Python nor any heap allocation.
+ *
+ * Only numbers, constants, property references, the arithmetic and
+ * comparison operators, conditionals and the numerical functions are
+ * compiled; Expression::eval() falls back to the Python based evaluation
+ * for anything else. The result is the same as the one of the Python
+ * evaluation, including the distinction between Python int, float and
+ * Quantity. Operations that would raise a Python exception (e.g. division
+ * by zero, unit mismatch, integer overflow) stop the compiled evaluation,
+ * so that the error is reported by the Python evaluation.
+ *
+ * The resolved properties are invalidated by Expression::invalidateBindings(),
+ * which is called whenever objects, labels, links or dynamic properties
+ * change, and resolved again on the next evaluation.
+ *
+ * The program of an expression is created by its first evaluation and kept
+ * in Expression::program.
+ */
+class AppExport ExpressionProgram
+{
+public:
+    struct Value {
+        enum Kind {
+            Integer,    ///< Python int, or bool (PyBool is a PyLong)
+            Float,      ///< Python float
+            Quantity,   ///< Base.Quantity
+        };
+        Kind kind;
+        bool boolean;   ///< Integer is a Python bool
+        long integer;
+        double number;
+        Base::Quantity quantity;
+
+        Value() : kind(Integer), boolean(false), integer(0), number(0.0) {}
+    };
+
+    /** Evaluate an expression using its compiled program
+     *
+     * @param expr: the expression, compiled on first call
+     * @param result: the value of the expression
+     *
+     * @return false if the expression is not compiled or cannot be
+     * evaluated without Python, in which case the caller shall fall back to
+     * Expression::getPyValue().
+     */
+    static bool eval(const Expression *expr, Value &result);
+
+    /// Convert the result to the same value as pyObjectToAny() would do
+    static App::any toAny(const Value &value);
+    /// Convert the result to the same expression as expressionFromPy() would do
+    static Expression *toExpression(const App::DocumentObject *owner, const Value &value);
+
+    /** @name Functions used by Expression::_compile()
+     * The functions append the instructions of (part of) an expression and
+     * return false if the expression cannot be compiled.
+     */
+    //@{
+    bool add(const Expression *expr);
+    bool addConstant(const Value &value);
+    bool addProperty(const ObjectIdentifier *path);
+    bool addOperator(int op);
+    bool addFunction(const Expression *expr, int function, int argc);
+    /// Append a jump to a yet unknown target, conditional jumps pop the condition
+    std::size_t addJump(bool ifFalse);
+    /// Let the given jump continue at the next added instruction
+    void setJumpTarget(std::size_t jump);
+    //@}
+
+private:
+    enum OpCode {
+        PushConstant,
+        PushProperty,
+        Unary,
+        Binary,
+        Function,
+        Jump,
+        JumpIfFalse,
+    };
+
+    struct Instruction {
+        OpCode code;
+        int op;         ///< operator or function
+        int arg;        ///< constant/slot index, argument count or jump target
+        const Expression *expr;
+    };
+
+    struct Slot {
+        const ObjectIdentifier *path;
+        const Property *prop;
+        Value::Kind kind;
+    };
+
+    bool compile(const Expression *expr);
+    bool run(Value &result);
+    bool bind();
+    bool push(int count);
+
+    // Maximum stack depth of a compiled expression
+    enum { MaxStackSize = 32 };
+
+    std::vector<Instruction> code;
+    std::vector<Value> constants;
+    std::vector<Slot> slots;
+    int stackSize = 0;
+    bool valid = false;
+    bool bound = false;
+    unsigned long revision = 0;
+    QMutex mutex;
+};
+
+}
+
+#endif // APP_EXPRESSIONPROGRAM_H
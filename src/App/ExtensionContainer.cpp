@@ -66,6 +66,7 @@ void ExtensionContainer::registerExtension(Base::Type extension, Extension* ext)
     }
         
     _extensions[extension] = ext;
+    onExtensionRegistered(extension);
 }
 
 bool ExtensionContainer::hasExtension(Base::Type t, bool derived) const {
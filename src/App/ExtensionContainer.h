@@ -186,7 +186,11 @@ public:
     //done by the default Save/Restore methods.
     void saveExtensions(Base::Writer& writer) const;
     void restoreExtensions(Base::XMLReader& reader);
-    
+
+protected:
+    /// get called after an extension was added to the container
+    virtual void onExtensionRegistered(Base::Type extension) {(void)extension;}
+
 private:
     //stored extensions
     std::map<Base::Type, App::Extension*> _extensions;
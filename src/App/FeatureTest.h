@@ -108,6 +108,10 @@ public:
   virtual short mustExecute(void) const;
   /// recalculate the Feature
   virtual DocumentObjectExecReturn *execute(void);
+  /// execute() only touches its own properties
+  virtual bool canRecomputeConcurrently() const {
+    return true;
+  }
   /// returns the type name of the ViewProvider
   //FIXME: Probably it makes sense to have a view provider for unittests (e.g. Gui::ViewProviderTest)
   virtual const char* getViewProviderName(void) const {
@@ -1225,6 +1225,30 @@ Property *ObjectIdentifier::getProperty(int *ptype) const
     return result.resolvedProperty;
 }
 
+/**
+ * @brief Get the property whose Python value is the value of this object identifier.
+ *
+ * @return The property if this identifier refers to a whole property of a
+ * document object in the owner document, without pseudo property, sub-object
+ * or further path components, or 0 otherwise.
+ */
+
+Property *ObjectIdentifier::getPlainProperty() const
+{
+    if(!owner || subObjectName.getString().size())
+        return 0;
+    ResolveResults result(*this);
+    if(!result.resolvedProperty
+            || result.propertyType != PseudoNone
+            || result.resolvedSubObject
+            || result.propertyIndex+1 != (int)components.size()
+            || result.resolvedDocument != owner->getDocument()
+            || !result.resolvedDocumentObject
+            || result.resolvedProperty->getContainer() != result.resolvedDocumentObject)
+        return 0;
+    return result.resolvedProperty;
+}
+
 Property *ObjectIdentifier::resolveProperty(const App::DocumentObject *obj, 
         const char *propertyName, App::DocumentObject *&sobj, int &ptype) const 
 {
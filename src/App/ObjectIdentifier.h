@@ -316,6 +316,8 @@ public:
 
     App::Property *getProperty(int *ptype=0) const;
 
+    App::Property *getPlainProperty() const;
+
     App::ObjectIdentifier canonicalPath() const;
 
     // Document-centric functions
@@ -28,11 +28,13 @@
 
 
 #include <assert.h>
+#include <memory>
 
 #include "BaseClass.h"
 
 namespace Base
 {
+class LazyDocFile;
 class Reader;
 class Writer;
 class XMLReader;
@@ -146,6 +148,33 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader &/*reader*/);
+    /** This method is used to defer restoring a file until its data is needed.
+     * If the document is restored in lazy mode it is called instead of RestoreDocFile().
+     * An object that supports this sets the restore function of the passed file,
+     * keeps it and calls LazyDocFile::load() before its data is accessed, then it
+     * returns true. The default implementation returns false, so that
+     * RestoreDocFile() is called right away.
+     */
+    virtual bool RestoreDocFileLazily(const std::shared_ptr<LazyDocFile>&) {
+        return false;
+    }
+    /// Compression of the files written in SaveDocFile()
+    enum DocFileCompression {
+        /// Use the compression level of the document
+        DefaultCompression,
+        /// Use the fastest compression level, for data that compresses poorly
+        FastCompression,
+        /// Store the data uncompressed, e.g. for already compressed data
+        NoCompression
+    };
+    /** Returns how the files written in SaveDocFile() should be compressed.
+     * It is only applied if enabled with ZipWriter::setPerFileCompression().
+     * Files that are stored uncompressed are memory mapped on restore
+     * instead of being read through the inflating zip stream.
+     */
+    virtual DocFileCompression getDocFileCompression() const {
+        return DefaultCompression;
+    }
     /// Encodes an attribute upon saving.
     static std::string encodeAttribute(const std::string&);
 
@@ -30,7 +30,11 @@
 # include <xercesc/sax2/SAX2XMLReader.hpp>
 #endif
 
+#include <exception>
 #include <locale>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
 #include "Reader.h"
@@ -302,7 +306,98 @@ void Base::XMLReader::readBinFile(const char* filename)
     to.close();
 }
 
+namespace Base {
+
+/** Lazily memory mapped project archive.
+ * Files that are stored uncompressed in the archive are read directly from
+ * the mapping instead of being copied through the zip stream.
+ */
+class XMLReader::MappedArchive
+{
+public:
+    MappedArchive(const std::string& fileName)
+        : file(QString::fromUtf8(fileName.c_str())), data(0), size(0), tried(false)
+    {
+    }
+    /// Returns the data of the current entry of the zip stream if it can be mapped
+    const char* entryData(zipios::ZipInputStream &zipstream,
+                          const zipios::ConstEntryPointer &entry)
+    {
+        const zipios::ZipLocalEntry* local = dynamic_cast<const zipios::ZipLocalEntry*>(entry.get());
+        if (!local || local->getMethod() != zipios::STORED)
+            return 0;
+        if (!tried) {
+            tried = true;
+            if (file.open(QIODevice::ReadOnly)) {
+                size = file.size();
+                data = reinterpret_cast<const char*>(file.map(0, size));
+            }
+        }
+        if (!data)
+            return 0;
+
+        // make sure the mapped file really is the archive the stream reads from
+        qint64 offset = zipstream.getEntryDataOffset();
+        qint64 header = offset - local->getLocalHeaderSize();
+        std::string name = local->getName();
+        if (header < 0 || offset + local->getCompressedSize() > size)
+            return 0;
+        if (data[header] != 'P' || data[header+1] != 'K' || data[header+2] != 3 || data[header+3] != 4)
+            return 0;
+        if (name.compare(0, std::string::npos, data + header + 30, name.size()) != 0)
+            return 0;
+        return data + offset;
+    }
+
+private:
+    QFile file;
+    const char* data;
+    qint64 size;
+    bool tried;
+};
+
+}
+
+namespace {
+
+// Read-only stream buffer on a memory block
+class MemoryStreambuf : public std::streambuf
+{
+public:
+    MemoryStreambuf(const char* data, std::size_t size)
+    {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+
+protected:
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode)
+    {
+        off_type pos = off;
+        if (dir == std::ios_base::cur)
+            pos += gptr() - eback();
+        else if (dir == std::ios_base::end)
+            pos += egptr() - eback();
+        if (pos < 0 || pos > egptr() - eback())
+            return pos_type(off_type(-1));
+        setg(eback(), eback() + pos, egptr());
+        return pos_type(pos);
+    }
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode mode)
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, mode);
+    }
+};
+
+}
+
 void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
+{
+    MappedArchive archive(_File.filePath());
+    readFiles(zipstream, archive);
+}
+
+void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream, MappedArchive &archive) const
 {
     // It's possible that not all objects inside the document could be created, e.g. if a module
     // is missing that would know these object types. So, there may be data files inside the zip
@@ -333,10 +428,27 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
         // no file name for the current entry in the zip was registered.
         if (jt != FileList.end()) {
             try {
-                Base::Reader reader(zipstream, jt->FileName, FileVersion);
-                jt->Object->RestoreDocFile(reader);
-                if (reader.getLocalReader())
-                    reader.getLocalReader()->readFiles(zipstream);
+                std::shared_ptr<LazyDocFile> lazyFile;
+                if (_lazyArchive)
+                    lazyFile = LazyDocFile::create(_lazyArchive, jt->FileName, FileVersion);
+                if (lazyFile && jt->Object->RestoreDocFileLazily(lazyFile)) {
+                    // the object reads the file on first access of its data
+                }
+                else if (const char* data = archive.entryData(zipstream, entry)) {
+                    std::size_t size = entry->getSize();
+                    MemoryStreambuf buf(data, size);
+                    std::istream str(&buf);
+                    Base::Reader reader(str, jt->FileName, FileVersion, data, size);
+                    jt->Object->RestoreDocFile(reader);
+                    if (reader.getLocalReader())
+                        reader.getLocalReader()->readFiles(zipstream, archive);
+                }
+                else {
+                    Base::Reader reader(zipstream, jt->FileName, FileVersion);
+                    jt->Object->RestoreDocFile(reader);
+                    if (reader.getLocalReader())
+                        reader.getLocalReader()->readFiles(zipstream, archive);
+                }
             }
             catch(...) {
                 // For any exception we just continue with the next file.
@@ -363,6 +475,19 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
     }
 }
 
+void Base::XMLReader::setLazyRestore(bool on)
+{
+    if (on && !_lazyArchive)
+        _lazyArchive = LazyDocFile::openArchive(_File.filePath());
+    else if (!on)
+        _lazyArchive.reset();
+}
+
+std::shared_ptr<Base::LazyDocFile::Archive> Base::XMLReader::getLazyArchive() const
+{
+    return _lazyArchive;
+}
+
 const char *Base::XMLReader::addFile(const char* Name, Base::Persistence *Object)
 {
     FileEntry temp;
@@ -558,8 +683,10 @@ void Base::XMLReader::clearPartialRestoreObject(void)
 
 // ----------------------------------------------------------
 
-Base::Reader::Reader(std::istream& str, const std::string& name, int version)
+Base::Reader::Reader(std::istream& str, const std::string& name, int version,
+                     const char* data, std::size_t size)
   : std::istream(str.rdbuf()), _str(str), _name(name), fileVersion(version)
+  , _data(data), _size(size)
 {
 }
 
@@ -577,6 +704,16 @@ int Base::Reader::getFileVersion() const
     return fileVersion;
 }
 
+const char* Base::Reader::getData() const
+{
+    return _data;
+}
+
+std::size_t Base::Reader::getDataSize() const
+{
+    return _size;
+}
+
 std::istream& Base::Reader::getStream()
 {
     return this->_str;
@@ -591,3 +728,145 @@ std::shared_ptr<Base::XMLReader> Base::Reader::getLocalReader() const
 {
     return(this->localreader);
 }
+
+// ----------------------------------------------------------------------------
+
+namespace Base {
+
+class LazyDocFile::Archive
+{
+public:
+    Archive(const std::string& fileName)
+        : fileName(fileName)
+    {
+        QFileInfo fi(QString::fromUtf8(fileName.c_str()));
+        size = fi.size();
+        modified = fi.lastModified();
+    }
+
+    std::istream* getInputStream(const std::string& entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        QFileInfo fi(QString::fromUtf8(fileName.c_str()));
+        if (!fi.exists() || fi.size() != size || fi.lastModified() != modified)
+            throw Base::FileException("Project file has changed since it was opened", fileName.c_str());
+        if (!zip)
+            zip.reset(new zipios::ZipFile(fileName));
+        std::istream* str = zip->getInputStream(entry);
+        if (!str)
+            throw Base::FileException("No such file in project file", fileName.c_str());
+        return str;
+    }
+
+    std::string fileName;
+    qint64 size;
+    QDateTime modified;
+    std::unique_ptr<zipios::ZipFile> zip;
+    std::vector<std::weak_ptr<LazyDocFile> > files;
+    std::mutex mutex;
+};
+
+}
+
+Base::LazyDocFile::LazyDocFile(const std::shared_ptr<Archive>& archive, const std::string& fileName, int version)
+  : _archive(archive), _fileName(fileName), _version(version), _loaded(false)
+{
+}
+
+Base::LazyDocFile::~LazyDocFile()
+{
+}
+
+std::string Base::LazyDocFile::getFileName() const
+{
+    return _fileName;
+}
+
+void Base::LazyDocFile::setRestoreFunction(const RestoreFunction& func)
+{
+    _restore = func;
+}
+
+bool Base::LazyDocFile::isLoaded() const
+{
+    return _loaded;
+}
+
+void Base::LazyDocFile::load()
+{
+    if (!_loaded) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_loaded) {
+            try {
+                std::unique_ptr<std::istream> str(_archive->getInputStream(_fileName));
+                Base::Reader reader(*str, _fileName, _version);
+                if (_restore)
+                    _restore(reader);
+            }
+            catch (const Base::Exception& e) {
+                _error = e.what();
+            }
+            catch (const std::exception& e) {
+                _error = e.what();
+            }
+            catch (...) {
+                _error = "Unknown error";
+            }
+
+            if (!_error.empty())
+                Base::Console().Error("Reading failed from embedded file %s: %s\n", _fileName.c_str(), _error.c_str());
+            _loaded = true;
+        }
+    }
+
+    if (!_error.empty()) {
+        std::string msg = "Reading failed from embedded file " + _fileName + ": " + _error;
+        throw Base::FileException(msg.c_str(), _archive->fileName.c_str());
+    }
+}
+
+std::shared_ptr<Base::LazyDocFile::Archive> Base::LazyDocFile::openArchive(const std::string& fileName)
+{
+    return std::make_shared<Archive>(fileName);
+}
+
+std::shared_ptr<Base::LazyDocFile> Base::LazyDocFile::create(const std::shared_ptr<Archive>& archive,
+                                                             const std::string& fileName, int version)
+{
+    std::shared_ptr<LazyDocFile> file(new LazyDocFile(archive, fileName, version));
+    std::lock_guard<std::mutex> lock(archive->mutex);
+    archive->files.push_back(file);
+    return file;
+}
+
+void Base::LazyDocFile::loadAll(const std::shared_ptr<Archive>& archive)
+{
+    if (!archive)
+        return;
+
+    std::vector<std::weak_ptr<LazyDocFile> > files;
+    {
+        std::lock_guard<std::mutex> lock(archive->mutex);
+        files = archive->files;
+    }
+
+    std::exception_ptr error;
+    for (std::vector<std::weak_ptr<LazyDocFile> >::iterator it = files.begin(); it != files.end(); ++it) {
+        std::shared_ptr<LazyDocFile> file = it->lock();
+        if (!file)
+            continue;
+        try {
+            file->load();
+        }
+        catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    std::lock_guard<std::mutex> lock(archive->mutex);
+    archive->files.clear();
+}
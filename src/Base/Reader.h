@@ -28,6 +28,10 @@
 #include <map>
 #include <bitset>
 #include <memory>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
 
 #include <xercesc/framework/XMLPScanToken.hpp>
 #include <xercesc/sax2/Attributes.hpp>
@@ -48,6 +52,59 @@ XERCES_CPP_NAMESPACE_END
 namespace Base
 {
 
+class Reader;
+class XMLReader;
+
+/** The LazyDocFile class
+ * Deferred access to a file inside a project archive. If lazy restore is enabled
+ * the XMLReader passes it to Persistence::RestoreDocFileLazily() instead of calling
+ * RestoreDocFile(). The object then reads the file on first access of its data.
+ */
+class BaseExport LazyDocFile
+{
+public:
+    class Archive;
+    typedef std::function<void(Reader&)> RestoreFunction;
+
+    ~LazyDocFile();
+
+    /// Returns the name of the file in the archive
+    std::string getFileName() const;
+    /// Sets the function that reads the file, it must not change the document
+    void setRestoreFunction(const RestoreFunction&);
+    /// Returns true if reading the file has been tried
+    bool isLoaded() const;
+    /** Reads the file if this hasn't been done yet. If reading fails the error
+     * is reported once and a Base::FileException is thrown by this and every
+     * later call, so that the missing data is never taken for the content of
+     * the file.
+     */
+    void load();
+
+    /// Opens the archive for deferred reading of its files
+    static std::shared_ptr<Archive> openArchive(const std::string& fileName);
+    /// Creates the handle of a file of the archive
+    static std::shared_ptr<LazyDocFile> create(const std::shared_ptr<Archive>&,
+                                               const std::string& fileName, int version);
+    /** Reads all files of the archive that haven't been read yet. This must
+     * be done before the archive is overwritten. If any file cannot be read
+     * the first error is thrown after trying all files, and the files are
+     * kept so that the next call throws again.
+     */
+    static void loadAll(const std::shared_ptr<Archive>&);
+
+private:
+    LazyDocFile(const std::shared_ptr<Archive>&, const std::string& fileName, int version);
+
+    std::shared_ptr<Archive> _archive;
+    std::string _fileName;
+    int _version;
+    RestoreFunction _restore;
+    std::string _error;
+    std::atomic<bool> _loaded;
+    std::mutex _mutex;
+};
+
 
 /** The XML reader class
  * This is an important helper class for the store and retrieval system
@@ -182,6 +239,12 @@ public:
     const char *addFile(const char* Name, Base::Persistence *Object);
     /// process the requested file writes
     void readFiles(zipios::ZipInputStream &zipstream) const;
+    /** Defers reading the files of objects that support it until their data
+     * is needed, see Persistence::RestoreDocFileLazily().
+     */
+    void setLazyRestore(bool on);
+    /// Returns the archive the deferred files are read from or null
+    std::shared_ptr<LazyDocFile::Archive> getLazyArchive() const;
     /// get all registered file names
     const std::vector<std::string>& getFilenames() const;
     bool isRegistered(Base::Persistence *Object) const;
@@ -290,16 +353,28 @@ protected:
     std::vector<std::string> FileNames;
 
     std::bitset<32> StatusBits;
+    std::shared_ptr<LazyDocFile::Archive> _lazyArchive;
+
+private:
+    class MappedArchive;
+    void readFiles(zipios::ZipInputStream &zipstream, MappedArchive &archive) const;
 };
 
 class BaseExport Reader : public std::istream
 {
 public:
-    Reader(std::istream&, const std::string&, int version);
+    Reader(std::istream&, const std::string&, int version,
+           const char* data=0, std::size_t size=0);
     ~Reader();
     std::istream& getStream();
     std::string getFileName() const;
     int getFileVersion() const;
+    /** Returns the content of the file if it is directly accessible in
+     * memory, i.e. if it was stored uncompressed in the archive which
+     * then gets memory mapped, otherwise a null pointer.
+     */
+    const char* getData() const;
+    std::size_t getDataSize() const;
     void initLocalReader(std::shared_ptr<Base::XMLReader>);
     std::shared_ptr<Base::XMLReader> getLocalReader() const;
 
@@ -307,6 +382,8 @@ private:
     std::istream& _str;
     std::string _name;
     int fileVersion;
+    const char* _data;
+    std::size_t _size;
     std::shared_ptr<Base::XMLReader> localreader;
 };
 
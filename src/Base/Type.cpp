@@ -43,15 +43,19 @@ struct Base::TypeData
            const Type type = Type::badType(),
            const Type theParent = Type::badType(),
            Type::instantiationMethod method = 0
-          ):name(theName),parent(theParent),type(type),instMethod(method) { }
+          ):name(theName),parent(theParent),type(type),instMethod(method)
+           ,first(0),last(0) { }
 
   std::string name;
   Type parent;
   Type type;
   Type::instantiationMethod instMethod;
+  /// pre-order number of the type and of its last derived type
+  unsigned int first;
+  unsigned int last;
 };
 
-map<string,unsigned int> Type::typemap;
+unordered_map<string,unsigned int> Type::typemap;
 vector<TypeData*>        Type::typedata;
 set<string>              Type::loadModuleSet;
 
@@ -144,6 +148,28 @@ const Type Type::createType(const Type parent, const char *name, instantiationMe
   Type newType;
   newType.index = Type::typedata.size();
   TypeData * typeData = new TypeData(name, newType, parent,method);
+
+  // Insert the new type as the last derived type of its parent and shift
+  // the numbers behind it. Types without parent are appended as new roots.
+  if (parent.isBad()) {
+    typeData->first = typeData->last = newType.index;
+  }
+  else {
+    const unsigned int parentFirst = typedata[parent.index]->first;
+    const unsigned int parentLast = typedata[parent.index]->last;
+    for (std::vector<TypeData*>::iterator it = typedata.begin(); it != typedata.end(); ++it) {
+      TypeData *data = *it;
+      if (data->first > parentLast) {
+        ++data->first;
+        ++data->last;
+      }
+      else if (data->first <= parentFirst && data->last >= parentLast) {
+        // the parent itself and its base types
+        ++data->last;
+      }
+    }
+    typeData->first = typeData->last = parentLast + 1;
+  }
   Type::typedata.push_back(typeData);
 
   // add to dictionary for fast lookup
@@ -175,8 +201,8 @@ void Type::destruct(void)
 
 Type Type::fromName(const char *name)
 {
-  std::map<std::string,unsigned int>::const_iterator pos;
-  
+  std::unordered_map<std::string,unsigned int>::const_iterator pos;
+
   pos = typemap.find(name);
   if (pos != typemap.end())
     return typedata[pos->second]->type;
@@ -204,15 +230,9 @@ const Type Type::getParent(void) const
 
 bool Type::isDerivedFrom(const Type type) const
 {
-  
-  Type temp(*this);
-  do {
-    if (temp == type)
-      return true;
-    temp = temp.getParent();
-  } while (temp != badType());
-
-  return false;
+  const TypeData *self = typedata[index];
+  const TypeData *base = typedata[type.index];
+  return self->first >= base->first && self->first <= base->last;
 }
 
 int Type::getAllDerivedFrom(const Type type, std::vector<Type> & List)
@@ -29,6 +29,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace Base
@@ -73,6 +74,11 @@ struct TypeData;
   One important note about the use of Type to register class
   information: super classes must be registered before any of their
   derived classes are.
+
+  Every type owns an interval of the pre-order numbering of the type
+  hierarchy that encloses the intervals of all its derived types, so
+  isDerivedFrom() is a constant time check. The numbering is updated
+  by createType().
 */
 class BaseExport Type
 {
@@ -129,7 +135,7 @@ private:
   unsigned int index;
 
 
-  static std::map<std::string,unsigned int> typemap;
+  static std::unordered_map<std::string,unsigned int> typemap;
   static std::vector<TypeData*>     typedata;
 
   static std::set<std::string>  loadModuleSet;
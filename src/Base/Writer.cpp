@@ -36,8 +36,12 @@
 #include "Tools.h"
 
 #include <algorithm>
+#include <climits>
 #include <locale>
 #include <limits>
+#include <zlib.h>
+#include <QRunnable>
+#include <QThreadPool>
 
 using namespace Base;
 using namespace std;
@@ -240,8 +244,144 @@ void Writer::decInd(void)
 
 // ----------------------------------------------------------------------------
 
+namespace {
+
+// Output buffer an entry is serialized into before it gets compressed.
+// Unlike std::ostringstream the data can be taken over without a copy.
+class EntryStreambuf : public std::streambuf
+{
+public:
+    EntryStreambuf()
+    {
+        data.resize(1 << 16);
+        setp(&data[0], &data[0] + data.size());
+    }
+    void take(std::string& str)
+    {
+        data.resize(pptr() - pbase());
+        str.swap(data);
+        data.clear();
+        setp(0, 0);
+    }
+
+protected:
+    virtual int_type overflow(int_type c)
+    {
+        std::size_t used = pptr() - pbase();
+        data.resize(data.size() * 2);
+        setp(&data[0], &data[0] + data.size());
+        // pbump() only takes an int
+        while (used > 0) {
+            int step = static_cast<int>(std::min<std::size_t>(used, INT_MAX));
+            pbump(step);
+            used -= step;
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            return sputc(traits_type::to_char_type(c));
+        return traits_type::not_eof(c);
+    }
+
+private:
+    std::string data;
+};
+
+}
+
+struct ZipWriter::BufferedFile
+{
+    BufferedFile(const std::string& name, int level)
+        : name(name), level(level), method(zipios::DEFLATED), size(0), crc(0)
+    {
+    }
+
+    std::string name;
+    std::string data;
+    int level;
+    zipios::StorageMethod method;
+    uint32 size;
+    uint32 crc;
+    std::string error;
+};
+
+namespace {
+
+// Replaces the serialized data of a file with its compressed version
+void compressFile(std::string& data, int level, zipios::StorageMethod& method,
+                  uint32& size, uint32& crc, std::string& error)
+{
+    if (data.size() >= std::numeric_limits<uint32>::max()) {
+        error = "file exceeds the 4 GB limit of the zip format";
+        return;
+    }
+
+    size = static_cast<uint32>(data.size());
+    crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<const Bytef*>(data.data()), size);
+    method = zipios::STORED;
+    if (level == Z_NO_COMPRESSION || size == 0)
+        return;
+
+    z_stream zs;
+    zs.zalloc = Z_NULL;
+    zs.zfree = Z_NULL;
+    zs.opaque = Z_NULL;
+    // negative window bits to write a raw deflate stream as used by zip
+    if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        error = "failed to initialize compression";
+        return;
+    }
+
+    // keep the data stored if compressing doesn't make it smaller
+    std::string out;
+    out.resize(size);
+    zs.next_in = reinterpret_cast<Bytef*>(&data[0]);
+    zs.avail_in = size;
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = size;
+    int ret = deflate(&zs, Z_FINISH);
+    uLong compressedSize = zs.total_out;
+    deflateEnd(&zs);
+    if (ret == Z_STREAM_END) {
+        out.resize(compressedSize);
+        data.swap(out);
+        method = zipios::DEFLATED;
+    }
+}
+
+class CompressFileTask : public QRunnable
+{
+public:
+    CompressFileTask(std::string& data, int level, zipios::StorageMethod& method,
+                     uint32& size, uint32& crc, std::string& error)
+        : data(data), level(level), method(method), size(size), crc(crc), error(error)
+    {
+    }
+    virtual void run()
+    {
+        try {
+            compressFile(data, level, method, size, crc, error);
+        }
+        catch (const std::bad_alloc&) {
+            error = "out of memory";
+        }
+    }
+
+private:
+    std::string& data;
+    int level;
+    zipios::StorageMethod& method;
+    uint32& size;
+    uint32& crc;
+    std::string& error;
+};
+
+// Upper limit of serialized data kept in memory before the files are written
+const std::size_t MaxBufferedSize = std::size_t(256) << 20;
+
+}
+
 ZipWriter::ZipWriter(const char* FileName) 
-  : ZipStream(FileName)
+  : ZipStream(FileName), EntryStream(0), Level(6), ThreadCount(1), PerFileCompression(false)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -254,7 +394,7 @@ ZipWriter::ZipWriter(const char* FileName)
 }
 
 ZipWriter::ZipWriter(std::ostream& os) 
-  : ZipStream(os)
+  : ZipStream(os), EntryStream(0), Level(6), ThreadCount(1), PerFileCompression(false)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -271,12 +411,86 @@ void ZipWriter::writeFiles(void)
     // use a while loop because it is possible that while
     // processing the files new ones can be added
     size_t index = 0;
+    std::vector<BufferedFile> files;
+    std::size_t bufferedSize = 0;
     while (index < FileList.size()) {
         FileEntry entry = FileList.begin()[index];
-        ZipStream.putNextEntry(entry.FileName);
-        entry.Object->SaveDocFile(*this);
         index++;
+
+        int level = Level;
+        if (PerFileCompression) {
+            Persistence::DocFileCompression compression = entry.Object->getDocFileCompression();
+            if (compression == Persistence::NoCompression)
+                level = Z_NO_COMPRESSION;
+            else if (compression == Persistence::FastCompression && Level != Z_NO_COMPRESSION)
+                level = Z_BEST_SPEED;
+        }
+
+        if (ThreadCount <= 1) {
+            // nothing to gain from buffering, stream the file directly. The
+            // level is taken when the entry is opened. The entry is always
+            // deflated, so uncompressed files are not memory mapped on restore.
+            ZipStream.setLevel(level);
+            ZipStream.putNextEntry(entry.FileName);
+            ZipStream.setLevel(Level);
+            entry.Object->SaveDocFile(*this);
+            continue;
+        }
+
+        files.push_back(BufferedFile(entry.FileName, level));
+
+        EntryStreambuf buf;
+        std::ostream str(&buf);
+        str.copyfmt(ZipStream);
+        EntryStream = &str;
+        try {
+            entry.Object->SaveDocFile(*this);
+        }
+        catch (...) {
+            EntryStream = 0;
+            throw;
+        }
+        EntryStream = 0;
+        buf.take(files.back().data);
+
+        bufferedSize += files.back().data.size();
+        if (bufferedSize >= MaxBufferedSize) {
+            writeBufferedFiles(files);
+            bufferedSize = 0;
+        }
+    }
+
+    writeBufferedFiles(files);
+}
+
+void ZipWriter::writeBufferedFiles(std::vector<BufferedFile>& files)
+{
+    if (files.empty())
+        return;
+
+    if (ThreadCount > 1 && files.size() > 1) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(ThreadCount);
+        for (std::vector<BufferedFile>::iterator it = files.begin(); it != files.end(); ++it)
+            pool.start(new CompressFileTask(it->data, it->level, it->method, it->size, it->crc, it->error));
+        pool.waitForDone();
+    }
+    else {
+        for (std::vector<BufferedFile>::iterator it = files.begin(); it != files.end(); ++it)
+            compressFile(it->data, it->level, it->method, it->size, it->crc, it->error);
     }
+
+    // write the files in their original order
+    for (std::vector<BufferedFile>::iterator it = files.begin(); it != files.end(); ++it) {
+        if (!it->error.empty()) {
+            addError(it->name + ": " + it->error);
+            continue;
+        }
+        ZipStream.putRawEntry(it->name, it->method, it->data.data(),
+                              static_cast<uint32>(it->data.size()), it->size, it->crc);
+    }
+
+    files.clear();
 }
 
 ZipWriter::~ZipWriter()
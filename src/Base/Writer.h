@@ -152,14 +152,35 @@ public:
 
     virtual void writeFiles(void);
 
-    virtual std::ostream &Stream(void){return ZipStream;}
+    virtual std::ostream &Stream(void){return EntryStream ? *EntryStream : ZipStream;}
 
     void setComment(const char* str){ZipStream.setComment(str);}
-    void setLevel(int level){ZipStream.setLevel( level );}
+    void setLevel(int level){ZipStream.setLevel( level ); Level = level;}
     void putNextEntry(const char* str){ZipStream.putNextEntry(str);}
 
+    /** Sets the number of threads used to compress the files in writeFiles().
+     * With more than one thread the files are serialized into memory in batches
+     * and compressed in parallel before they are written in their original order.
+     */
+    void setThreadCount(int count){ThreadCount = count;}
+    int getThreadCount() const {return ThreadCount;}
+    /** Sets whether the compression returned by Persistence::getDocFileCompression()
+     * is applied in writeFiles(). If not, all files are compressed with the level
+     * set by setLevel().
+     */
+    void setPerFileCompression(bool on){PerFileCompression = on;}
+    bool getPerFileCompression() const {return PerFileCompression;}
+
+private:
+    struct BufferedFile;
+    void writeBufferedFiles(std::vector<BufferedFile>&);
+
 private:
     zipios::ZipOutputStream ZipStream;
+    std::ostream *EntryStream;
+    int Level;
+    int ThreadCount;
+    bool PerFileCompression;
 };
 
 /** The StringWriter class 
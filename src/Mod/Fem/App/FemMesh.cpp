@@ -24,7 +24,10 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
 # include <cstdlib>
+# include <cstring>
 # include <memory>
 # include <Bnd_Box.hxx>
 # include <BRep_Tool.hxx>
@@ -38,6 +41,7 @@
 # include <TopoDS_Shape.hxx>
 # include <ShapeAnalysis_ShapeTolerance.hxx>
 
+# include <boost/algorithm/string.hpp>
 # include <boost/assign/list_of.hpp>
 # include <boost/tokenizer.hpp> //to simplify parsing input files we use the boost lib
 
@@ -74,6 +78,9 @@
 #include <Base/Interpreter.h>
 #include <App/Application.h>
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include <Mod/Mesh/App/Core/MeshKernel.h>
 #include <Mod/Mesh/App/Core/Evaluation.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
@@ -92,6 +99,161 @@ using namespace Fem;
 using namespace Base;
 using namespace boost;
 
+namespace Fem {
+
+/*!
+ * A uniform grid over the nodes of a FemMesh in global coordinates. It restricts
+ * the nodes that must be measured against a shape to the ones inside the bounding
+ * box of the shape instead of walking over all nodes of the mesh.
+ */
+class FemNodeIndex
+{
+public:
+    FemNodeIndex(const SMESHDS_Mesh* data, const Base::Matrix4D& mat)
+        : _Mtrx(mat), nx(1), ny(1), nz(1)
+    {
+        std::size_t numNodes = static_cast<std::size_t>(data->NbNodes());
+        ids.reserve(numNodes);
+        nodes.reserve(numNodes);
+
+        SMDS_NodeIteratorPtr aNodeIter = data->nodesIterator();
+        while (aNodeIter->more()) {
+            const SMDS_MeshNode* aNode = aNodeIter->next();
+            Base::Vector3d vec(aNode->X(),aNode->Y(),aNode->Z());
+            // Apply the matrix to hold the nodes in absolute space.
+            vec = mat * vec;
+            ids.push_back(aNode->GetID());
+            nodes.push_back(vec);
+            bbox.Add(vec);
+        }
+
+        build();
+    }
+
+    std::size_t size() const
+    {
+        return ids.size();
+    }
+    const Base::Matrix4D& getTransform() const
+    {
+        return _Mtrx;
+    }
+    int getNodeId(std::size_t index) const
+    {
+        return ids[index];
+    }
+    const Base::Vector3d& getNode(std::size_t index) const
+    {
+        return nodes[index];
+    }
+    /// indices of all nodes inside the box
+    void getNodesInBox(const Bnd_Box& box, std::vector<std::size_t>& indices) const
+    {
+        if (box.IsVoid() || nodes.empty())
+            return;
+
+        Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+        box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+        if (xmax < bbox.MinX || xmin > bbox.MaxX ||
+            ymax < bbox.MinY || ymin > bbox.MaxY ||
+            zmax < bbox.MinZ || zmin > bbox.MaxZ)
+            return;
+
+        int i0 = cellX(xmin), i1 = cellX(xmax);
+        int j0 = cellY(ymin), j1 = cellY(ymax);
+        int k0 = cellZ(zmin), k1 = cellZ(zmax);
+        for (int k = k0; k <= k1; k++) {
+            for (int j = j0; j <= j1; j++) {
+                for (int i = i0; i <= i1; i++) {
+                    std::size_t cell = cellIndex(i, j, k);
+                    for (std::size_t it = offsets[cell]; it < offsets[cell+1]; ++it) {
+                        const Base::Vector3d& vec = nodes[elements[it]];
+                        if (!box.IsOut(gp_Pnt(vec.x,vec.y,vec.z)))
+                            indices.push_back(elements[it]);
+                    }
+                }
+            }
+        }
+
+        // keep the order of the node iterator
+        std::sort(indices.begin(), indices.end());
+    }
+
+private:
+    void build()
+    {
+        std::size_t numNodes = nodes.size();
+        if (numNodes > 0) {
+            // aim at roughly eight nodes per cell
+            double lx = bbox.LengthX(), ly = bbox.LengthY(), lz = bbox.LengthZ();
+            double maxLen = std::max(lx, std::max(ly, lz));
+            if (maxLen > 0.0) {
+                // flat or linear meshes must not give a zero volume
+                double minLen = maxLen * 1.0e-3;
+                lx = std::max(lx, minLen);
+                ly = std::max(ly, minLen);
+                lz = std::max(lz, minLen);
+                double numCells = std::max(1.0, static_cast<double>(numNodes) / 8.0);
+                double edge = std::cbrt(lx * ly * lz / numCells);
+                nx = std::min(1024, static_cast<int>(lx / edge) + 1);
+                ny = std::min(1024, static_cast<int>(ly / edge) + 1);
+                nz = std::min(1024, static_cast<int>(lz / edge) + 1);
+            }
+        }
+
+        // count the nodes per cell, then fill the cells
+        std::vector<std::size_t> cells(numNodes);
+        offsets.assign(static_cast<std::size_t>(nx) * ny * nz + 1, 0);
+        for (std::size_t it = 0; it < numNodes; ++it) {
+            const Base::Vector3d& vec = nodes[it];
+            cells[it] = cellIndex(cellX(vec.x), cellY(vec.y), cellZ(vec.z));
+            offsets[cells[it] + 1]++;
+        }
+        for (std::size_t it = 1; it < offsets.size(); ++it)
+            offsets[it] += offsets[it - 1];
+
+        std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+        elements.resize(numNodes);
+        for (std::size_t it = 0; it < numNodes; ++it)
+            elements[fill[cells[it]]++] = it;
+    }
+    static int cell(double value, double minValue, double length, int count)
+    {
+        if (length <= 0.0)
+            return 0;
+        int index = static_cast<int>((value - minValue) / length * count);
+        return std::max(0, std::min(count - 1, index));
+    }
+    int cellX(double x) const
+    {
+        return cell(x, bbox.MinX, bbox.LengthX(), nx);
+    }
+    int cellY(double y) const
+    {
+        return cell(y, bbox.MinY, bbox.LengthY(), ny);
+    }
+    int cellZ(double z) const
+    {
+        return cell(z, bbox.MinZ, bbox.LengthZ(), nz);
+    }
+    std::size_t cellIndex(int i, int j, int k) const
+    {
+        return (static_cast<std::size_t>(k) * ny + j) * nx + i;
+    }
+
+private:
+    Base::Matrix4D _Mtrx;
+    std::vector<int> ids;
+    std::vector<Base::Vector3d> nodes;
+    Base::BoundBox3d bbox;
+    int nx, ny, nz;
+    /// nodes of cell i are elements[offsets[i]] ... elements[offsets[i+1]-1]
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> elements;
+};
+
+}
+
 static int StatCount = 0;
 
 SMESH_Gen* FemMesh::_mesh_gen = 0;
@@ -138,6 +300,7 @@ FemMesh &FemMesh::operator=(const FemMesh& mesh)
 void FemMesh::copyMeshData(const FemMesh& mesh)
 {
     _Mtrx = mesh._Mtrx;
+    invalidateNodeIndex();
 
     // See file SMESH_I/SMESH_Gen_i.cxx in the git repo of smesh at https://git.salome-platform.org
 #if 1
@@ -490,6 +653,8 @@ const SMESH_Mesh* FemMesh::getSMesh() const
 
 SMESH_Mesh* FemMesh::getSMesh()
 {
+    // the caller may modify the mesh
+    invalidateNodeIndex();
     return myMesh;
 }
 
@@ -553,6 +718,7 @@ void FemMesh::setStandardHypotheses()
 void FemMesh::compute()
 {
     getGenerator()->Compute(*myMesh, myMesh->GetShapeToMesh());
+    invalidateNodeIndex();
 }
 
 std::set<long> FemMesh::getSurfaceNodes(long /*ElemId*/, short /*FaceId*/, float /*Angle*/) const
@@ -749,8 +915,6 @@ std::map<int, int> FemMesh::getccxVolumesByFace(const TopoDS_Face &face) const
 
 std::set<int> FemMesh::getNodesBySolid(const TopoDS_Solid &solid) const
 {
-    std::set<int> result;
-
     Bnd_Box box;
     BRepBndLib::Add(solid, box);
 
@@ -760,131 +924,120 @@ std::set<int> FemMesh::getNodesBySolid(const TopoDS_Solid &solid) const
     double limit = analysis.Tolerance(solid, 1, shapetype);
     Base::Console().Log("The limit if a node is in or out: %.12lf in scientific: %.4e \n", limit, limit);
 
-    // get the current transform of the FemMesh
-    const Base::Matrix4D Mtrx(getTransform());
-
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    while (aNodeIter->more()) {
-        const SMDS_MeshNode* aNode = aNodeIter->next();
-        Base::Vector3d vec(aNode->X(),aNode->Y(),aNode->Z());
-        // Apply the matrix to hold the BoundBox in absolute space.
-        vec = Mtrx * vec;
-
-        if (!box.IsOut(gp_Pnt(vec.x,vec.y,vec.z))) {
-            // create a vertex
-            BRepBuilderAPI_MakeVertex aBuilder(gp_Pnt(vec.x,vec.y,vec.z));
-            TopoDS_Shape s = aBuilder.Vertex();
-            // measure distance
-            BRepExtrema_DistShapeShape measure(solid,s);
-            measure.Perform();
-            if (!measure.IsDone() || measure.NbSolution() < 1)
-                continue;
-
-            if (measure.Value() < limit)
-                result.insert(aNode->GetID());
-        }
-    }
-    return result;
+    return getNodesByShape(solid, box, limit);
 }
 
 std::set<int> FemMesh::getNodesByFace(const TopoDS_Face &face) const
 {
-    std::set<int> result;
-
     Bnd_Box box;
     BRepBndLib::Add(face, box, Standard_False);  // https://forum.freecadweb.org/viewtopic.php?f=18&t=21571&start=70#p221591
     // limit where the mesh node belongs to the face:
     double limit = BRep_Tool::Tolerance(face);
     box.Enlarge(limit);
 
-    // get the current transform of the FemMesh
-    const Base::Matrix4D Mtrx(getTransform());
-
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    while (aNodeIter->more()) {
-        const SMDS_MeshNode* aNode = aNodeIter->next();
-        Base::Vector3d vec(aNode->X(),aNode->Y(),aNode->Z());
-        // Apply the matrix to hold the BoundBox in absolute space.
-        vec = Mtrx * vec;
-
-        if (!box.IsOut(gp_Pnt(vec.x,vec.y,vec.z))) {
-            // create a vertex
-            BRepBuilderAPI_MakeVertex aBuilder(gp_Pnt(vec.x,vec.y,vec.z));
-            TopoDS_Shape s = aBuilder.Vertex();
-            // measure distance
-            BRepExtrema_DistShapeShape measure(face,s);
-            measure.Perform();
-            if (!measure.IsDone() || measure.NbSolution() < 1)
-                continue;
-
-            if (measure.Value() < limit)
-                result.insert(aNode->GetID());
-        }
-    }
-
-    return result;
+    return getNodesByShape(face, box, limit);
 }
 
 std::set<int> FemMesh::getNodesByEdge(const TopoDS_Edge &edge) const
 {
-    std::set<int> result;
-
     Bnd_Box box;
     BRepBndLib::Add(edge, box);
     // limit where the mesh node belongs to the edge:
     double limit = BRep_Tool::Tolerance(edge);
     box.Enlarge(limit);
 
-    // get the current transform of the FemMesh
-    const Base::Matrix4D Mtrx(getTransform());
+    return getNodesByShape(edge, box, limit);
+}
 
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    while (aNodeIter->more()) {
-        const SMDS_MeshNode* aNode = aNodeIter->next();
-        Base::Vector3d vec(aNode->X(),aNode->Y(),aNode->Z());
-        // Apply the matrix to hold the BoundBox in absolute space.
-        vec = Mtrx * vec;
+std::set<int> FemMesh::getNodesByVertex(const TopoDS_Vertex &vertex) const
+{
+    std::set<int> result;
 
-        if (!box.IsOut(gp_Pnt(vec.x,vec.y,vec.z))) {
-            // create a vertex
-            BRepBuilderAPI_MakeVertex aBuilder(gp_Pnt(vec.x,vec.y,vec.z));
-            TopoDS_Shape s = aBuilder.Vertex();
-            // measure distance
-            BRepExtrema_DistShapeShape measure(edge,s);
-            measure.Perform();
-            if (!measure.IsDone() || measure.NbSolution() < 1)
-                continue;
+    double limit = BRep_Tool::Tolerance(vertex);
+    gp_Pnt pnt = BRep_Tool::Pnt(vertex);
+    Base::Vector3d node(pnt.X(), pnt.Y(), pnt.Z());
 
-            if (measure.Value() < limit)
-                result.insert(aNode->GetID());
+    Bnd_Box box;
+    box.Add(pnt);
+    box.Enlarge(limit);
+
+    limit *= limit; // use square to improve speed
+
+    const FemNodeIndex& index = getNodeIndex();
+    std::vector<std::size_t> candidates;
+    index.getNodesInBox(box, candidates);
+    for (std::vector<std::size_t>::iterator it = candidates.begin(); it != candidates.end(); ++it) {
+        if (Base::DistanceP2(node, index.getNode(*it)) <= limit) {
+            result.insert(index.getNodeId(*it));
         }
     }
 
     return result;
 }
 
-std::set<int> FemMesh::getNodesByVertex(const TopoDS_Vertex &vertex) const
+const FemNodeIndex& FemMesh::getNodeIndex() const
 {
-    std::set<int> result;
+    // rebuild the index if the placement or the number of nodes has changed in the meantime
+    const SMESHDS_Mesh* data = myMesh->GetMeshDS();
+    if (!nodeIndex ||
+        nodeIndex->size() != static_cast<std::size_t>(data->NbNodes()) ||
+        nodeIndex->getTransform() != _Mtrx) {
+        nodeIndex.reset(new FemNodeIndex(data, _Mtrx));
+    }
 
-    double limit = BRep_Tool::Tolerance(vertex);
-    limit *= limit; // use square to improve speed
-    gp_Pnt pnt = BRep_Tool::Pnt(vertex);
-    Base::Vector3d node(pnt.X(), pnt.Y(), pnt.Z());
+    return *nodeIndex;
+}
 
-    // get the current transform of the FemMesh
-    const Base::Matrix4D Mtrx(getTransform());
+void FemMesh::invalidateNodeIndex()
+{
+    nodeIndex.reset();
+}
 
-    SMDS_NodeIteratorPtr aNodeIter = myMesh->GetMeshDS()->nodesIterator();
-    while (aNodeIter->more()) {
-        const SMDS_MeshNode* aNode = aNodeIter->next();
-        Base::Vector3d vec(aNode->X(),aNode->Y(),aNode->Z());
-        vec = Mtrx * vec;
+std::set<int> FemMesh::getNodesByShape(const TopoDS_Shape &shape, const Bnd_Box &box, double limit) const
+{
+    const FemNodeIndex& index = getNodeIndex();
+    std::vector<std::size_t> candidates;
+    index.getNodesInBox(box, candidates);
+
+    // Measure the candidates in chunks running in parallel. Each chunk has
+    // its own extrema algorithm with the shape loaded only once.
+    struct Chunk {
+        std::size_t begin, end;
+        std::vector<int> nodes;
+    };
+
+    std::size_t numCandidates = candidates.size();
+    std::size_t numChunks = std::min(static_cast<std::size_t>(4 * std::max(1, QThread::idealThreadCount())),
+                                     numCandidates / 64);
+    numChunks = std::max<std::size_t>(1, numChunks);
+
+    std::vector<Chunk> chunks(numChunks);
+    for (std::size_t i = 0; i < numChunks; i++) {
+        chunks[i].begin = numCandidates * i / numChunks;
+        chunks[i].end = numCandidates * (i + 1) / numChunks;
+    }
+
+    QtConcurrent::blockingMap(chunks, [&](Chunk& chunk) {
+        BRepExtrema_DistShapeShape measure;
+        measure.LoadS1(shape);
+        for (std::size_t i = chunk.begin; i < chunk.end; i++) {
+            const Base::Vector3d& vec = index.getNode(candidates[i]);
+            // create a vertex
+            BRepBuilderAPI_MakeVertex aBuilder(gp_Pnt(vec.x,vec.y,vec.z));
+            // measure distance
+            measure.LoadS2(aBuilder.Vertex());
+            measure.Perform();
+            if (!measure.IsDone() || measure.NbSolution() < 1)
+                continue;
 
-        if (Base::DistanceP2(node, vec) <= limit) {
-            result.insert(aNode->GetID());
+            if (measure.Value() < limit)
+                chunk.nodes.push_back(index.getNodeId(candidates[i]));
         }
-    }
+    });
+
+    std::set<int> result;
+    for (std::vector<Chunk>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+        result.insert(it->nodes.begin(), it->nodes.end());
 
     return result;
 }
@@ -1171,39 +1324,346 @@ void FemMesh::readNastran(const std::string &Filename)
 
 }
 
-void FemMesh::readAbaqus(const std::string &FileName)
+namespace {
+
+/// An element type of Abaqus/CalculiX input files
+struct AbaqusElementType
 {
-    Base::TimeInfo Start;
-    Base::Console().Log("Start: FemMesh::readAbaqus() =================================\n");
+    SMDSAbs_ElementType type;
+    /// the FreeCAD node i is the CalculiX node order[i], see also FemMesh::writeABAQUS()
+    std::vector<int> order;
+};
 
-    /*
-    Python command to read Abaqus inp mesh file from test suite:
-    from feminout.importInpMesh import read as read_inp
-    femmesh = read_inp(FreeCAD.ConfigGet("AppHomePath") + 'Mod/Fem/femtest/data/mesh/tetra10_mesh.inp')
-    */
+const AbaqusElementType* findAbaqusElementType(const std::string& name)
+{
+    static std::map<std::string, AbaqusElementType> elemTypeMap;
+    if (elemTypeMap.empty()) {
+        // the node order is the same as in the module feminout.importInpMesh
+        AbaqusElementType seg2 = { SMDSAbs_Edge, boost::assign::list_of(0)(1) };
+        AbaqusElementType seg3 = { SMDSAbs_Edge, boost::assign::list_of(0)(2)(1) };
+        AbaqusElementType tria3 = { SMDSAbs_Face, boost::assign::list_of(0)(1)(2) };
+        AbaqusElementType tria6 = { SMDSAbs_Face, boost::assign::list_of(0)(1)(2)(3)(4)(5) };
+        AbaqusElementType quad4 = { SMDSAbs_Face, boost::assign::list_of(0)(1)(2)(3) };
+        AbaqusElementType quad8 = { SMDSAbs_Face, boost::assign::list_of(0)(1)(2)(3)(4)(5)(6)(7) };
+        AbaqusElementType tetra4 = { SMDSAbs_Volume, boost::assign::list_of(1)(0)(2)(3) };
+        AbaqusElementType tetra10 = { SMDSAbs_Volume, boost::assign::list_of(1)(0)(2)(3)(4)(6)(5)(8)(7)(9) };
+        AbaqusElementType hexa8 = { SMDSAbs_Volume, boost::assign::list_of(5)(6)(7)(4)(1)(2)(3)(0) };
+        AbaqusElementType hexa20 = { SMDSAbs_Volume, boost::assign::list_of(5)(6)(7)(4)(1)(2)(3)(0)
+                                     (13)(14)(15)(12)(9)(10)(11)(8)(17)(18)(19)(16) };
+        AbaqusElementType penta6 = { SMDSAbs_Volume, boost::assign::list_of(4)(5)(3)(1)(2)(0) };
+        AbaqusElementType penta15 = { SMDSAbs_Volume, boost::assign::list_of(4)(5)(3)(1)(2)(0)
+                                      (10)(11)(9)(7)(8)(6)(13)(14)(12) };
+
+        const char* seg2Names[] = { "B31", "B31R", "T3D2" };
+        const char* seg3Names[] = { "B32", "B32R", "T3D3" };
+        const char* tria3Names[] = { "S3", "CPS3", "CPE3", "CAX3" };
+        const char* tria6Names[] = { "S6", "CPS6", "CPE6", "CAX6" };
+        const char* quad4Names[] = { "S4", "S4R", "CPS4", "CPS4R", "CPE4", "CPE4R", "CAX4", "CAX4R" };
+        const char* quad8Names[] = { "S8", "S8R", "CPS8", "CPS8R", "CPE8", "CPE8R", "CAX8", "CAX8R" };
+        const char* hexa8Names[] = { "C3D8", "C3D8R", "C3D8I" };
+        const char* hexa20Names[] = { "C3D20", "C3D20R", "C3D20RI" };
+
+        for (const char* name : seg2Names)
+            elemTypeMap[name] = seg2;
+        for (const char* name : seg3Names)
+            elemTypeMap[name] = seg3;
+        for (const char* name : tria3Names)
+            elemTypeMap[name] = tria3;
+        for (const char* name : tria6Names)
+            elemTypeMap[name] = tria6;
+        for (const char* name : quad4Names)
+            elemTypeMap[name] = quad4;
+        for (const char* name : quad8Names)
+            elemTypeMap[name] = quad8;
+        for (const char* name : hexa8Names)
+            elemTypeMap[name] = hexa8;
+        for (const char* name : hexa20Names)
+            elemTypeMap[name] = hexa20;
+        elemTypeMap["C3D4"] = tetra4;
+        elemTypeMap["C3D10"] = tetra10;
+        elemTypeMap["C3D6"] = penta6;
+        elemTypeMap["C3D15"] = penta15;
+    }
+
+    std::map<std::string, AbaqusElementType>::const_iterator it = elemTypeMap.find(name);
+    if (it == elemTypeMap.end())
+        return 0;
+    return &it->second;
+}
 
-    PyObject* module = PyImport_ImportModule("feminout.importInpMesh");
-    if (!module)
-        return;
-    try {
-        Py::Module abaqusmod(module, true);
-        Py::Callable method(abaqusmod.getAttr("read"));
-        Py::Tuple args(1);
-        args.setItem(0, Py::String(FileName));
-        Py::Object mesh(method.apply(args));
-        if (PyObject_TypeCheck(mesh.ptr(), &FemMeshPy::Type)) {
-            FemMeshPy* fempy = static_cast<FemMeshPy*>(mesh.ptr());
-            FemMesh* fem = fempy->getFemMeshPtr();
-            *this = *fem; // the deep copy should be avoided, a pointer swap method could be implemented
-                          // see https://forum.freecadweb.org/viewtopic.php?f=10&t=31999&start=10#p274241
+/*!
+ * Streaming reader for the mesh of Abaqus/CalculiX input files. The nodes and
+ * elements are added to the SMESH data structure while the file is parsed.
+ * Elements referring to nodes that are not defined yet are kept back until
+ * the end of the file.
+ */
+class AbaqusReader
+{
+public:
+    explicit AbaqusReader(SMESHDS_Mesh* meshds)
+        : meshds(meshds)
+        , block(None)
+        , elemType(0)
+        , modelDefinition(true)
+        , numNodes(0)
+        , numElements(0)
+    {
+    }
+
+    void read(const Base::FileInfo& fi)
+    {
+        Base::ifstream inputfile(fi, std::ios::in);
+        if (!inputfile)
+            throw Base::FileException("Cannot open file", fi);
+
+        std::string line;
+        while (std::getline(inputfile, line)) {
+            boost::trim(line);
+            if (line.empty())
+                continue;
+
+            if (line[0] == '*') {
+                // comment
+                if (line.size() > 1 && line[1] == '*')
+                    continue;
+
+                std::string keyword = boost::to_upper_copy(line);
+                if (boost::starts_with(keyword, "*INCLUDE")) {
+                    // the current block continues in the included file
+                    readInclude(fi, line);
+                    continue;
+                }
+
+                block = None;
+                element.clear();
+                if (boost::starts_with(keyword, "*NODE") && modelDefinition) {
+                    block = Nodes;
+                }
+                else if (boost::starts_with(keyword, "*ELEMENT")) {
+                    elemType = findAbaqusElementType(getParameter(keyword, "TYPE"));
+                    if (elemType)
+                        block = Elements;
+                }
+                else if (boost::starts_with(keyword, "*STEP")) {
+                    modelDefinition = false;
+                }
+            }
+            else if (block == Nodes) {
+                readNode(line);
+            }
+            else if (block == Elements) {
+                readElement(line);
+            }
+        }
+    }
+
+    void finish()
+    {
+        std::size_t numMissing = 0;
+        for (std::vector<PendingElement>::iterator it = pending.begin(); it != pending.end(); ++it) {
+            if (!addElement(*it->type, it->nodes))
+                numMissing++;
+        }
+        pending.clear();
+
+        if (numMissing > 0)
+            Base::Console().Warning("%lu elements refer to undefined nodes and were skipped\n",
+                                    static_cast<unsigned long>(numMissing));
+        Base::Console().Log("    imported mesh: %lu nodes, %lu elements\n",
+                            static_cast<unsigned long>(numNodes),
+                            static_cast<unsigned long>(numElements));
+    }
+
+private:
+    enum Block { None, Nodes, Elements };
+    struct PendingElement
+    {
+        const AbaqusElementType* type;
+        std::vector<int> nodes;
+    };
+
+    static std::string getParameter(const std::string& keyword, const char* name)
+    {
+        std::vector<std::string> list;
+        boost::split(list, keyword, boost::is_any_of(","));
+        for (std::vector<std::string>::iterator it = list.begin(); it != list.end(); ++it) {
+            std::string::size_type pos = it->find('=');
+            if (pos != std::string::npos && boost::trim_copy(it->substr(0, pos)) == name)
+                return boost::trim_copy(it->substr(pos + 1));
+        }
+        return std::string();
+    }
+
+    void readInclude(const Base::FileInfo& fi, const std::string& line)
+    {
+        std::string::size_type pos = line.find('=');
+        if (pos == std::string::npos)
+            return;
+        std::string name = boost::trim_copy(line.substr(pos + 1));
+        boost::trim_if(name, boost::is_any_of("\"' "));
+
+        // a relative path refers to the directory of the including file
+        Base::FileInfo include(name);
+        if (!include.exists())
+            include.setFile(fi.dirPath() + "/" + name);
+        read(include);
+    }
+
+    void readNode(const std::string& line)
+    {
+        const char* ptr = line.c_str();
+        char* end;
+        long id = std::strtol(ptr, &end, 10);
+        if (end == ptr)
+            throw Base::BadFormatError("Invalid node line in inp file");
+
+        double coords[3] = { 0.0, 0.0, 0.0 };
+        ptr = end;
+        for (int i = 0; i < 3; i++) {
+            ptr = std::strchr(ptr, ',');
+            if (!ptr)
+                break;
+            coords[i] = std::strtod(++ptr, &end);
+            ptr = end;
+        }
+
+        const SMDS_MeshNode* node = meshds->FindNode(static_cast<int>(id));
+        if (node) {
+            meshds->MoveNode(node, coords[0], coords[1], coords[2]);
         }
         else {
-            throw Base::FileException("Problems reading file");
+            meshds->AddNodeWithID(coords[0], coords[1], coords[2], static_cast<int>(id));
+            numNodes++;
         }
     }
-    catch (Py::Exception& e) {
-        e.clear();
+
+    void readElement(const std::string& line)
+    {
+        // the element id followed by the node ids, possibly spread over several lines
+        const char* ptr = line.c_str();
+        std::size_t count = elemType->order.size() + 1;
+        while (*ptr && element.size() < count) {
+            char* end;
+            long value = std::strtol(ptr, &end, 10);
+            if (end != ptr) {
+                element.push_back(static_cast<int>(value));
+                ptr = end;
+            }
+            while (*ptr == ' ' || *ptr == '\t')
+                ++ptr;
+            if (*ptr == ',')
+                ++ptr;
+            else if (*ptr)
+                throw Base::BadFormatError("Invalid element line in inp file");
+        }
+
+        if (element.size() == count) {
+            if (!addElement(*elemType, element)) {
+                PendingElement elem;
+                elem.type = elemType;
+                elem.nodes = element;
+                pending.push_back(elem);
+            }
+            element.clear();
+        }
     }
+
+    bool addElement(const AbaqusElementType& type, const std::vector<int>& data)
+    {
+        int id = data[0];
+        nodes.clear();
+        for (std::vector<int>::const_iterator it = type.order.begin(); it != type.order.end(); ++it) {
+            const SMDS_MeshNode* node = meshds->FindNode(data[*it + 1]);
+            if (!node)
+                return false;
+            nodes.push_back(node);
+        }
+
+        const SMDS_MeshNode* const* n = &nodes[0];
+        SMDS_MeshElement* elem = 0;
+        switch (type.type) {
+        case SMDSAbs_Edge:
+            if (nodes.size() == 2)
+                elem = meshds->AddEdgeWithID(n[0], n[1], id);
+            else
+                elem = meshds->AddEdgeWithID(n[0], n[1], n[2], id);
+            break;
+        case SMDSAbs_Face:
+            switch (nodes.size()) {
+            case 3:
+                elem = meshds->AddFaceWithID(n[0], n[1], n[2], id);
+                break;
+            case 4:
+                elem = meshds->AddFaceWithID(n[0], n[1], n[2], n[3], id);
+                break;
+            case 6:
+                elem = meshds->AddFaceWithID(n[0], n[1], n[2], n[3], n[4], n[5], id);
+                break;
+            case 8:
+                elem = meshds->AddFaceWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], id);
+                break;
+            }
+            break;
+        default:
+            switch (nodes.size()) {
+            case 4:
+                elem = meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], id);
+                break;
+            case 6:
+                elem = meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], id);
+                break;
+            case 8:
+                elem = meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], id);
+                break;
+            case 10:
+                elem = meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], id);
+                break;
+            case 15:
+                elem = meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9],
+                                               n[10], n[11], n[12], n[13], n[14], id);
+                break;
+            case 20:
+                elem = meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9],
+                                               n[10], n[11], n[12], n[13], n[14], n[15], n[16], n[17], n[18], n[19], id);
+                break;
+            }
+            break;
+        }
+
+        if (elem)
+            numElements++;
+        else
+            Base::Console().Warning("Failed to add element %d of inp file\n", id);
+        return true;
+    }
+
+private:
+    SMESHDS_Mesh* meshds;
+    Block block;
+    const AbaqusElementType* elemType;
+    bool modelDefinition;
+    std::vector<int> element;
+    std::vector<const SMDS_MeshNode*> nodes;
+    std::vector<PendingElement> pending;
+    std::size_t numNodes;
+    std::size_t numElements;
+};
+
+}
+
+void FemMesh::readAbaqus(const std::string &FileName)
+{
+    Base::TimeInfo Start;
+    Base::Console().Log("Start: FemMesh::readAbaqus() =================================\n");
+
+    // fill the SMESH data structure directly while reading the file
+    SMESHDS_Mesh* meshds = this->myMesh->GetMeshDS();
+    meshds->ClearMesh();
+
+    AbaqusReader reader(meshds);
+    reader.read(Base::FileInfo(FileName));
+    reader.finish();
+
     Base::Console().Log("    %f: Done \n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()));
 }
 
@@ -1247,6 +1707,7 @@ void FemMesh::read(const char *FileName)
 {
     Base::FileInfo File(FileName);
     _Mtrx = Base::Matrix4D();
+    invalidateNodeIndex();
 
     // checking on the file
     if (!File.isReadable())
@@ -1855,6 +2316,7 @@ void FemMesh::RestoreDocFile(Base::Reader &reader)
 
     // read the shape from the temp file
     myMesh->UNVToMesh(fi.filePath().c_str());
+    invalidateNodeIndex();
 
     // delete the temp file
     fi.deleteFile();
@@ -1872,6 +2334,8 @@ void FemMesh::transformGeometry(const Base::Matrix4D& rclTrf)
         current_node = clMatrix * current_node;
         myMesh->GetMeshDS()->MoveNode(aNode,current_node.x,current_node.y,current_node.z);
     }
+
+    invalidateNodeIndex();
 }
 
 void FemMesh::setTransform(const Base::Matrix4D& rclTrf)
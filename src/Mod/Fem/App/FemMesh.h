@@ -30,6 +30,7 @@
 
 #include <vector>
 #include <list>
+#include <memory>
 #include <boost/shared_ptr.hpp>
 #include <SMESH_Version.h>
 #include <SMDSAbs_ElementType.hxx>
@@ -42,10 +43,13 @@ class TopoDS_Face;
 class TopoDS_Edge;
 class TopoDS_Vertex;
 class TopoDS_Solid;
+class Bnd_Box;
 
 namespace Fem
 {
 
+class FemNodeIndex;
+
 typedef boost::shared_ptr<SMESH_Hypothesis> SMESH_HypothesisPtr;
 
 /** The representation of a FemMesh
@@ -168,6 +172,11 @@ public:
 
 private:
     void copyMeshData(const FemMesh&);
+    /// the spatial index of the nodes in global coordinates, (re-)built on demand
+    const FemNodeIndex& getNodeIndex() const;
+    void invalidateNodeIndex();
+    /// IDs of all nodes inside the box that are closer to the shape than the limit
+    std::set<int> getNodesByShape(const TopoDS_Shape &shape, const Bnd_Box &box, double limit) const;
     void readNastran(const std::string &Filename);
     void readZ88(const std::string &Filename);
     void readAbaqus(const std::string &Filename);
@@ -179,6 +188,7 @@ private:
 
     std::list<SMESH_HypothesisPtr> hypoth;
     static SMESH_Gen *_mesh_gen;
+    mutable std::unique_ptr<FemNodeIndex> nodeIndex;
 };
 
 } //namespace Part
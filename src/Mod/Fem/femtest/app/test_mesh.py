@@ -220,6 +220,91 @@ class TestMeshCommon(unittest.TestCase):
             )
         )
 
+    # ********************************************************************************************
+    def test_nodes_by_face(
+        self
+    ):
+        import Part
+        # a regular grid of 11 x 11 x 3 nodes, id = (i * 11 + j) * 3 + k + 1
+        femmesh = Fem.FemMesh()
+        node_id = 1
+        for i in range(11):
+            for j in range(11):
+                for k in range(3):
+                    femmesh.addNode(i, j, k, node_id)
+                    node_id += 1
+        face = Part.makePlane(10, 10).Faces[0]
+
+        nodes = femmesh.getNodesByFace(face)
+        self.assertEqual(
+            sorted(nodes),
+            list(range(1, node_id, 3)),
+            "Nodes of the face are unexpected"
+        )
+
+        # the nodes are searched in global coordinates
+        femmesh.Placement = FreeCAD.Placement(FreeCAD.Vector(0, 0, -1), FreeCAD.Rotation())
+        nodes = femmesh.getNodesByFace(face)
+        self.assertEqual(
+            sorted(nodes),
+            list(range(2, node_id, 3)),
+            "Nodes of the face are unexpected after changing the placement"
+        )
+
+        # added nodes are found as well
+        femmesh.addNode(5.5, 5.5, 1, node_id)
+        nodes = femmesh.getNodesByFace(face)
+        self.assertEqual(
+            len(nodes),
+            122,
+            "Added node on the face was not found"
+        )
+        self.assertTrue(
+            node_id in nodes,
+            "Added node on the face was not found"
+        )
+
+    # ********************************************************************************************
+    def test_inp_reader(
+        self
+    ):
+        # the native inp reader has to give the same mesh as the Python reader
+        from feminout.importInpMesh import read as read_inp
+        femmesh = Fem.FemMesh()
+        for i in range(2):
+            for j in range(2):
+                for k in range(3):
+                    femmesh.addNode(i, j, k, 1 + i + 2 * j + 4 * k)
+        femmesh.addVolume([1, 2, 4, 3, 5, 6, 8, 7], 1)
+        femmesh.addVolume([5, 6, 8, 9], 2)
+        femmesh.addVolume([5, 6, 7, 9, 10, 12], 3)
+        femmesh.addFace([9, 10, 12], 4)
+        femmesh.addFace([9, 10, 12, 11], 5)
+        femmesh.addEdge([11, 12], 6)
+
+        inp_file = testtools.get_fem_test_tmp_dir() + "/mixed_mesh.inp"
+        femmesh.writeABAQUS(inp_file, 0, False)
+        native = Fem.read(inp_file)
+        python = read_inp(inp_file)
+
+        self.assertEqual(
+            native.Nodes,
+            python.Nodes,
+            "Nodes of the native inp reader are different"
+        )
+        for elements in ("Volumes", "Faces", "Edges"):
+            self.assertEqual(
+                getattr(native, elements),
+                getattr(python, elements),
+                "{} of the native inp reader are different".format(elements)
+            )
+            for elem in getattr(native, elements):
+                self.assertEqual(
+                    native.getElementNodes(elem),
+                    python.getElementNodes(elem),
+                    "Nodes of element {} of the native inp reader are different".format(elem)
+                )
+
 
 # ************************************************************************************************
 # ************************************************************************************************
@@ -24,10 +24,14 @@
 #include "PreCompiled.h"
 #include <numeric>
 #include <gp_Pnt.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
 #include <BRepClass3d_SolidClassifier.hxx>
 #include <BRepGProp_Face.hxx>
+#include <BRepBndLib.hxx>
+#include <Bnd_Box.hxx>
+#include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
 #include <TopoDS_Vertex.hxx>
 
@@ -54,12 +58,22 @@
 #include <Mod/Points/App/PointsFeature.h>
 #include <Mod/Points/App/PointsGrid.h>
 #include <Mod/Part/App/PartFeature.h>
+#include <Mod/Part/App/TopoShape.h>
 
 #include "InspectionFeature.h"
 
 
 using namespace Inspection;
 
+void InspectNominalGeometry::getDistances(const std::vector<Base::Vector3f>& points, std::vector<float>& distances) const
+{
+    distances.resize(points.size());
+    for (std::size_t i = 0; i < points.size(); i++)
+        distances[i] = getDistance(points[i]);
+}
+
+// ----------------------------------------------------------------
+
 InspectActualMesh::InspectActualMesh(const Mesh::MeshObject& rMesh) : _mesh(rMesh.getKernel())
 {
     Base::Matrix4D tmp;
@@ -182,7 +196,7 @@ namespace Inspection {
             assert((rulX < _ulCtGridsX) && (rulY < _ulCtGridsY) && (rulZ < _ulCtGridsZ));
         }
 
-        void AddFacet (const MeshCore::MeshGeomFacet &rclFacet, unsigned long ulFacetIndex)
+        void FacetCells (const MeshCore::MeshGeomFacet &rclFacet, std::vector<unsigned long> &cells) const
         {
             unsigned long ulX, ulY, ulZ;
             unsigned long ulX1, ulY1, ulZ1, ulX2, ulY2, ulZ2;
@@ -201,19 +215,17 @@ namespace Inspection {
                     for (ulY = ulY1; ulY <= ulY2; ulY++) {
                         for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
                             if (rclFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ)))
-                                _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+                                cells.push_back(CellIndex(ulX, ulY, ulZ));
                         }
                     }
                 }
             }
             else
-                _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
+                cells.push_back(CellIndex(ulX1, ulY1, ulZ1));
         }
 
         void InitGrid (void)
         {
-            unsigned long i, j;
-
             Base::BoundBox3f clBBMesh = _pclMesh->GetBoundBox().Transformed(_transform);
 
             float fLengthX = clBBMesh.LengthX(); 
@@ -228,27 +240,18 @@ namespace Inspection {
 
             _fGridLenZ = (1.0f + fLengthZ) / float(_ulCtGridsZ);
             _fMinZ = clBBMesh.MinZ - 0.5f;
-
-            _aulGrid.clear();
-            _aulGrid.resize(_ulCtGridsX);
-            for (i = 0; i < _ulCtGridsX; i++) {
-                _aulGrid[i].resize(_ulCtGridsY);
-                for (j = 0; j < _ulCtGridsY; j++)
-                    _aulGrid[i][j].resize(_ulCtGridsZ);
-            }
         }
 
         void RebuildGrid (void)
         {
             _ulCtElements = _pclMesh->CountFacets();
             InitGrid();
- 
-            unsigned long i = 0;
-            MeshCore::MeshFacetIterator clFIter(*_pclMesh);
-            clFIter.Transform(_transform);
-            for (clFIter.Init(); clFIter.More(); clFIter.Next()) {
-                AddFacet(*clFIter, i++);
-            }
+
+            BuildGrid(_ulCtElements, [this](unsigned long index, std::vector<unsigned long>& cells) {
+                MeshCore::MeshGeomFacet facet = _pclMesh->GetFacet(index);
+                facet.Transform(_transform);
+                FacetCells(facet, cells);
+            });
         }
 
     private:
@@ -256,19 +259,35 @@ namespace Inspection {
     };
 }
 
-InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offset) : _mesh(rMesh.getKernel())
+InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offset) : _pMesh(&rMesh.getKernel())
 {
     Base::Matrix4D tmp;
-    _clTrf = rMesh.getTransform();
-    _bApply = _clTrf != tmp;
+    Base::Matrix4D clTrf = rMesh.getTransform();
+    _bApply = clTrf != tmp;
 
     // Max. limit of grid elements
     float fMaxGridElements=8000000.0f;
-    Base::BoundBox3f box = _mesh.GetBoundBox().Transformed(rMesh.getTransform());
+    Base::BoundBox3f box = _pMesh->GetBoundBox().Transformed(clTrf);
+
+    // A placement keeps all distances, so the points are moved into the
+    // coordinate system of the mesh instead of moving the mesh. Any other
+    // transformation is applied to a copy of the mesh.
+    if (_bApply) {
+        if (clTrf.hasScale() == 0) {
+            _clInvTrf = clTrf;
+            _clInvTrf.inverseOrthogonal();
+        }
+        else {
+            _transformed.reset(new MeshCore::MeshKernel(*_pMesh));
+            _transformed->Transform(clTrf);
+            _pMesh = _transformed.get();
+            _bApply = false;
+        }
+    }
 
     // estimate the minimum allowed grid length
     float fMinGridLen = (float)pow((box.LengthX()*box.LengthY()*box.LengthZ()/fMaxGridElements), 0.3333f);
-    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(_mesh).GetAverageEdgeLength();
+    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(*_pMesh).GetAverageEdgeLength();
 
     // We want to avoid to get too small grid elements otherwise building up the grid structure would take
     // too much time and memory. 
@@ -277,7 +296,7 @@ InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offs
     fGridLen = std::max<float>(fMinGridLen, fGridLen);
 
     // build up grid structure to speed up algorithms
-    _pGrid = new MeshInspectGrid(_mesh, fGridLen, rMesh.getTransform());
+    _pGrid = new MeshCore::MeshFacetGrid(*_pMesh, fGridLen);
     _box = box;
     _box.Enlarge(offset);
 }
@@ -289,35 +308,43 @@ InspectNominalMesh::~InspectNominalMesh()
 
 float InspectNominalMesh::getDistance(const Base::Vector3f& point) const
 {
-    if (!_box.IsInBox(point))
-        return FLT_MAX; // must be inside bbox
+    std::vector<float> distances;
+    getDistances(std::vector<Base::Vector3f>(1, point), distances);
+    return distances.front();
+}
 
-    std::vector<unsigned long> indices;
-    //_pGrid->GetElements(point, indices);
-    if (indices.empty()) {
-        std::set<unsigned long> inds;
-        _pGrid->MeshGrid::SearchNearestFromPoint(point, inds);
-        indices.insert(indices.begin(), inds.begin(), inds.end());
+void InspectNominalMesh::getDistances(const std::vector<Base::Vector3f>& points, std::vector<float>& distances) const
+{
+    // only points inside the bounding box are searched
+    std::vector<Base::Vector3f> search;
+    std::vector<std::size_t> index;
+    search.reserve(points.size());
+    index.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (_box.IsInBox(points[i])) {
+            search.push_back(_bApply ? _clInvTrf * points[i] : points[i]);
+            index.push_back(i);
+        }
     }
 
-    float fMinDist=FLT_MAX;
-    bool positive = true;
-    for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        MeshCore::MeshGeomFacet geomFace = _mesh.GetFacet(*it);
-        if (_bApply) {
-            geomFace.Transform(_clTrf);
-        }
+    std::vector<unsigned long> facets;
+    _pGrid->SearchNearestFromPoints(search, facets);
 
-        float fDist = geomFace.DistanceToPoint(point);
-        if (fabs(fDist) < fabs(fMinDist)) {
-            fMinDist = fDist;
-            positive = point.DistanceToPlane(geomFace._aclPoints[0], geomFace.GetNormal()) > 0;
-        }
-    }
+    distances.assign(points.size(), FLT_MAX);
+    for (std::size_t i = 0; i < search.size(); i++)
+        distances[index[i]] = getDistance(search[i], facets[i]);
+}
 
-    if (!positive)
-        fMinDist = -fMinDist;
-    return fMinDist;
+float InspectNominalMesh::getDistance(const Base::Vector3f& point, unsigned long facet) const
+{
+    if (facet == ULONG_MAX)
+        return FLT_MAX;
+
+    MeshCore::MeshGeomFacet geomFace = _pMesh->GetFacet(facet);
+    float fDist = geomFace.DistanceToPoint(point);
+    if (point.DistanceToPlane(geomFace._aclPoints[0], geomFace.GetNormal()) <= 0)
+        fDist = -fDist;
+    return fDist;
 }
 
 // ----------------------------------------------------------------
@@ -437,74 +464,233 @@ float InspectNominalPoints::getDistance(const Base::Vector3f& point) const
 
 // ----------------------------------------------------------------
 
-InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float /*radius*/)
-    : _rShape(shape)
-    , isSolid(false)
+namespace Inspection {
+// When having a solid then use its shell because otherwise the distance
+// for inner points will always be zero
+static TopoDS_Shape getDistanceShape(const TopoDS_Shape& shape, bool& isSolid)
 {
-    distss = new BRepExtrema_DistShapeShape();
-    distss->LoadS1(_rShape);
-
-    // When having a solid then use its shell because otherwise the distance
-    // for inner points will always be zero
-    if (!_rShape.IsNull() && _rShape.ShapeType() == TopAbs_SOLID) {
+    isSolid = false;
+    if (!shape.IsNull() && shape.ShapeType() == TopAbs_SOLID) {
         TopExp_Explorer xp;
-        xp.Init(_rShape, TopAbs_SHELL);
+        xp.Init(shape, TopAbs_SHELL);
         if (xp.More()) {
-           distss->LoadS1(xp.Current());
-           isSolid = true;
+            isSolid = true;
+            return xp.Current();
+        }
+    }
+
+    return shape;
+}
+
+/** Holds the OCC state to compute exact distances. It is expensive to set up
+ * and not thread-safe, so a worker keeps it for a whole chunk of points.
+ */
+class InspectNominalShape::Evaluator
+{
+public:
+    Evaluator(const TopoDS_Shape& shape)
+        : shape(shape)
+    {
+        bool isSolid;
+        distss.LoadS1(getDistanceShape(shape, isSolid));
+    }
+
+    float getDistance(const gp_Pnt& pnt3d, bool isSolid)
+    {
+        BRepBuilderAPI_MakeVertex mkVert(pnt3d);
+        distss.LoadS2(mkVert.Vertex());
+
+        float fMinDist=FLT_MAX;
+        if (distss.Perform() && distss.NbSolution() > 0) {
+            fMinDist = (float)distss.Value();
+            // the shape is a solid, check if the vertex is inside
+            if (isSolid) {
+                if (isInside(pnt3d)) {
+                    fMinDist = -fMinDist;
+                }
+
+            }
+            else if (fMinDist > 0) {
+                // check if the distance was compued from a face
+                for (Standard_Integer index = 1; index <= distss.NbSolution(); index++) {
+                    if (distss.SupportTypeShape1(index) == BRepExtrema_IsInFace) {
+                        TopoDS_Shape face = distss.SupportOnShape1(index);
+                        Standard_Real u, v;
+                        distss.ParOnFaceS1(index, u, v);
+                        //gp_Pnt pnt = distss.PointOnShape1(index);
+                        BRepGProp_Face props(TopoDS::Face(face));
+                        gp_Vec normal;
+                        gp_Pnt center;
+                        props.Normal(u, v, center, normal);
+                        gp_Vec dir(center, pnt3d);
+                        Standard_Real scalar = normal.Dot(dir);
+                        if (scalar < 0) {
+                            fMinDist = -fMinDist;
+                        }
+                        break;
+                    }
+                }
+            }
         }
+        return fMinDist;
+    }
 
+    bool isInside(const gp_Pnt& pnt3d)
+    {
+        // the classifier is only set up once
+        const Standard_Real tol = 0.001;
+        if (!classifier)
+            classifier.reset(new BRepClass3d_SolidClassifier(shape));
+        classifier->Perform(pnt3d, tol);
+        return classifier->State() == TopAbs_IN;
     }
-    //distss->SetDeflection(radius);
+
+private:
+    const TopoDS_Shape& shape;
+    BRepExtrema_DistShapeShape distss;
+    std::unique_ptr<BRepClass3d_SolidClassifier> classifier;
+};
+}
+
+InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float radius)
+    : _rShape(shape)
+    , isSolid(false)
+    , _radius(radius)
+    , _deflection(0)
+    , _pMesh(0)
+    , _pGrid(0)
+{
+    TopoDS_Shape distShape = getDistanceShape(_rShape, isSolid);
+    if (distShape.IsNull())
+        return;
+
+    // The tessellation can only rule out points if the distance is measured to faces
+    // only. Free edges or vertices would be missed.
+    TopExp_Explorer xpEdge(distShape, TopAbs_EDGE, TopAbs_FACE);
+    TopExp_Explorer xpVertex(distShape, TopAbs_VERTEX, TopAbs_EDGE);
+    TopExp_Explorer xpFace(distShape, TopAbs_FACE);
+    if (!xpFace.More() || xpEdge.More() || xpVertex.More())
+        return;
+
+    // The deviation of the tessellation is bounded by the deflection. Use a
+    // coarse one as it is only used to rule out points beyond the search radius.
+    Bnd_Box bounds;
+    BRepBndLib::Add(distShape, bounds);
+    if (bounds.IsVoid())
+        return;
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    float diagonal = static_cast<float>(gp_Pnt(xMin, yMin, zMin).Distance(gp_Pnt(xMax, yMax, zMax)));
+    _deflection = std::max<float>(0.1f * _radius, 0.001f * diagonal);
+
+    std::vector<Base::Vector3d> points;
+    std::vector<Data::ComplexGeoData::Facet> facets;
+    // Mesh a copy, the triangulation would otherwise be stored in the faces
+    // of the document's shape and replace the one used for display
+    TopoDS_Shape meshShape = BRepBuilderAPI_Copy(distShape).Shape();
+    Part::TopoShape(meshShape).getFaces(points, facets, _deflection);
+    if (facets.empty())
+        return;
+
+    MeshCore::MeshPointArray meshPoints;
+    meshPoints.reserve(points.size());
+    for (std::vector<Base::Vector3d>::iterator it = points.begin(); it != points.end(); ++it)
+        meshPoints.push_back(MeshCore::MeshPoint(Base::toVector<float>(*it)));
+    MeshCore::MeshFacetArray meshFacets;
+    meshFacets.reserve(facets.size());
+    for (std::vector<Data::ComplexGeoData::Facet>::iterator it = facets.begin(); it != facets.end(); ++it)
+        meshFacets.push_back(MeshCore::MeshFacet(it->I1, it->I2, it->I3));
+
+    _pMesh = new MeshCore::MeshKernel();
+    _pMesh->Adopt(meshPoints, meshFacets);
+
+    // limit the number of grid elements like for mesh nominals
+    Base::BoundBox3f box = _pMesh->GetBoundBox();
+    float fMaxGridElements = 8000000.0f;
+    float fMinGridLen = (float)pow((box.LengthX()*box.LengthY()*box.LengthZ()/fMaxGridElements), 0.3333f);
+    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(*_pMesh).GetAverageEdgeLength();
+    fGridLen = std::max<float>(fMinGridLen, std::max<float>(_radius, fGridLen));
+    _pGrid = new MeshCore::MeshFacetGrid(*_pMesh, fGridLen);
 }
 
 InspectNominalShape::~InspectNominalShape()
 {
-    delete distss;
+    delete _pGrid;
+    delete _pMesh;
 }
 
-float InspectNominalShape::getDistance(const Base::Vector3f& point) const
+std::unique_ptr<InspectNominalShape::Evaluator> InspectNominalShape::acquireEvaluator() const
 {
-    gp_Pnt pnt3d(point.x,point.y,point.z);
-    BRepBuilderAPI_MakeVertex mkVert(pnt3d);
-    distss->LoadS2(mkVert.Vertex());
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_evaluators.empty())
+        return std::unique_ptr<Evaluator>(new Evaluator(_rShape));
+    std::unique_ptr<Evaluator> evaluator = std::move(_evaluators.back());
+    _evaluators.pop_back();
+    return evaluator;
+}
 
-    float fMinDist=FLT_MAX;
-    if (distss->Perform() && distss->NbSolution() > 0) {
-        fMinDist = (float)distss->Value();
-        // the shape is a solid, check if the vertex is inside
-        if (isSolid) {
-            const Standard_Real tol = 0.001;
-            BRepClass3d_SolidClassifier classifier(_rShape);
-            classifier.Perform(pnt3d, tol);
-            if (classifier.State() == TopAbs_IN) {
-                fMinDist = -fMinDist;
-            }
+void InspectNominalShape::releaseEvaluator(std::unique_ptr<Evaluator> evaluator) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _evaluators.push_back(std::move(evaluator));
+}
 
+bool InspectNominalShape::isOutsideSearchRadius(const Base::Vector3f& point, bool& positive) const
+{
+    if (!_pGrid)
+        return false;
+
+    // twice the deflection as the tessellation is not guaranteed to be that exact
+    float margin = _radius + 2.0f * _deflection;
+    if (_pGrid->SearchNearestFromPoint(point, margin) != ULONG_MAX)
+        return false;
+
+    // for open shapes the orientation of the nearest facet decides about the sign
+    positive = true;
+    if (!isSolid) {
+        unsigned long index = _pGrid->SearchNearestFromPoint(point);
+        if (index != ULONG_MAX) {
+            MeshCore::MeshGeomFacet facet = _pMesh->GetFacet(index);
+            positive = point.DistanceToPlane(facet._aclPoints[0], facet.GetNormal()) >= 0;
         }
-        else if (fMinDist > 0) {
-            // check if the distance was compued from a face
-            for (Standard_Integer index = 1; index <= distss->NbSolution(); index++) {
-                if (distss->SupportTypeShape1(index) == BRepExtrema_IsInFace) {
-                    TopoDS_Shape face = distss->SupportOnShape1(index);
-                    Standard_Real u, v;
-                    distss->ParOnFaceS1(index, u, v);
-                    //gp_Pnt pnt = distss->PointOnShape1(index);
-                    BRepGProp_Face props(TopoDS::Face(face));
-                    gp_Vec normal;
-                    gp_Pnt center;
-                    props.Normal(u, v, center, normal);
-                    gp_Vec dir(center, pnt3d);
-                    Standard_Real scalar = normal.Dot(dir);
-                    if (scalar < 0) {
-                        fMinDist = -fMinDist;
-                    }
-                    break;
-                }
+    }
+
+    return true;
+}
+
+float InspectNominalShape::getDistance(const Base::Vector3f& point) const
+{
+    std::vector<float> distances;
+    getDistances(std::vector<Base::Vector3f>(1, point), distances);
+    return distances.front();
+}
+
+void InspectNominalShape::getDistances(const std::vector<Base::Vector3f>& points, std::vector<float>& distances) const
+{
+    distances.resize(points.size());
+    std::unique_ptr<Evaluator> evaluator = acquireEvaluator();
+    try {
+        for (std::size_t i = 0; i < points.size(); i++) {
+            const Base::Vector3f& point = points[i];
+            gp_Pnt pnt3d(point.x,point.y,point.z);
+
+            // exact distances are only needed near the search radius
+            bool positive = true;
+            if (isOutsideSearchRadius(point, positive)) {
+                if (isSolid)
+                    positive = !evaluator->isInside(pnt3d);
+                distances[i] = positive ? FLT_MAX : -FLT_MAX;
+            }
+            else {
+                distances[i] = evaluator->getDistance(pnt3d, isSolid);
             }
         }
     }
-    return fMinDist;
+    catch (...) {
+        releaseEvaluator(std::move(evaluator));
+        throw;
+    }
+    releaseEvaluator(std::move(evaluator));
 }
 
 // ----------------------------------------------------------------
@@ -838,42 +1024,59 @@ App::DocumentObjectExecReturn* Feature::execute(void)
     bool useMultithreading = true;
     unsigned long count = actual->countPoints();
     std::vector<float> vals(count);
-    std::function<DistanceInspectionRMS(int)> fMap = [&](unsigned int index)
+
+    // The points are processed in chunks so that the nominals can reuse
+    // their search state for many points
+    const unsigned long chunkSize = 1024;
+    unsigned long numChunks = (count + chunkSize - 1) / chunkSize;
+    std::function<DistanceInspectionRMS(int)> fMap = [&](unsigned int chunk)
     {
         DistanceInspectionRMS res;
-        Base::Vector3f pnt = actual->getPoint(index);
+        unsigned long begin = chunk * chunkSize;
+        unsigned long end = std::min<unsigned long>(count, begin + chunkSize);
 
-        float fMinDist = FLT_MAX;
+        std::vector<Base::Vector3f> pnts;
+        pnts.reserve(end - begin);
+        for (unsigned long index = begin; index < end; index++)
+            pnts.push_back(actual->getPoint(index));
+
+        std::vector<float> minDists(pnts.size(), FLT_MAX);
+        std::vector<float> dists;
         for (std::vector<InspectNominalGeometry*>::iterator it = inspectNominal.begin(); it != inspectNominal.end(); ++it) {
-            float fDist = (*it)->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist))
-                fMinDist = fDist;
+            (*it)->getDistances(pnts, dists);
+            for (std::size_t i = 0; i < pnts.size(); i++) {
+                if (fabs(dists[i]) < fabs(minDists[i]))
+                    minDists[i] = dists[i];
+            }
         }
 
-        if (fMinDist > this->SearchRadius.getValue())
-            fMinDist = FLT_MAX;
-        else if (-fMinDist > this->SearchRadius.getValue())
-            fMinDist = -FLT_MAX;
-        else {
-            res.m_sumsq += fMinDist * fMinDist;
-            res.m_numv++;
-        }
+        for (std::size_t i = 0; i < pnts.size(); i++) {
+            float fMinDist = minDists[i];
+            if (fMinDist > this->SearchRadius.getValue())
+                fMinDist = FLT_MAX;
+            else if (-fMinDist > this->SearchRadius.getValue())
+                fMinDist = -FLT_MAX;
+            else {
+                res.m_sumsq += fMinDist * fMinDist;
+                res.m_numv++;
+            }
 
-        vals[index] = fMinDist;
+            vals[begin + i] = fMinDist;
+        }
         return res;
     };
 
     DistanceInspectionRMS res;
 
     if (useMultithreading) {
-        // Build vector of increasing indices
-        std::vector<unsigned long> index(count);
+        // Build vector of increasing chunk indices
+        std::vector<unsigned long> index(numChunks);
         std::iota(index.begin(), index.end(), 0);
         // Perform map-reduce operation : compute distances and update sum of squares for RMS computation
         QFuture<DistanceInspectionRMS> future = QtConcurrent::mappedReduced(
             index, fMap, &DistanceInspectionRMS::operator+=);
         // Setup progress bar
-        Base::FutureWatcherProgress progress("Inspecting...", actual->countPoints());
+        Base::FutureWatcherProgress progress("Inspecting...", numChunks);
         QFutureWatcher<DistanceInspectionRMS> watcher;
         QObject::connect(&watcher, SIGNAL(progressValueChanged(int)),
             &progress, SLOT(progressValueChanged(int)));
@@ -888,10 +1091,12 @@ App::DocumentObjectExecReturn* Feature::execute(void)
         // Single-threaded operation
         std::stringstream str;
         str << "Inspecting " << this->Label.getValue() << "...";
-        Base::SequencerLauncher seq(str.str().c_str(), count);
+        Base::SequencerLauncher seq(str.str().c_str(), numChunks);
 
-        for (unsigned int i = 0; i < count; i++)
+        for (unsigned int i = 0; i < numChunks; i++) {
             res += fMap(i);
+            seq.next();
+        }
     }
 
     Base::Console().Message("RMS value for '%s' with search radius [%.4f,%.4f] is: %.4f\n",
@@ -28,15 +28,19 @@
 #include <App/PropertyLinks.h>
 #include <App/DocumentObjectGroup.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Points/App/Points.h>
 
 class TopoDS_Shape;
-class BRepExtrema_DistShapeShape;
 
 namespace MeshCore {
 class MeshKernel;
 class MeshGrid;
+class MeshFacetGrid;
 }
 
 namespace Mesh   { class MeshObject; }
@@ -101,6 +105,10 @@ public:
     InspectNominalGeometry() {}
     virtual ~InspectNominalGeometry() {}
     virtual float getDistance(const Base::Vector3f&) const = 0;
+    /** Calculates the distances of a chunk of points. This is called concurrently for
+     * different chunks, sub-classes can override it to share work over the chunk.
+     */
+    virtual void getDistances(const std::vector<Base::Vector3f>&, std::vector<float>&) const;
 };
 
 class InspectionExport InspectNominalMesh : public InspectNominalGeometry
@@ -109,13 +117,19 @@ public:
     InspectNominalMesh(const Mesh::MeshObject& rMesh, float offset);
     ~InspectNominalMesh();
     virtual float getDistance(const Base::Vector3f&) const;
+    /// Searches the nearest facets of the whole chunk at once
+    virtual void getDistances(const std::vector<Base::Vector3f>&, std::vector<float>&) const;
 
 private:
-    const MeshCore::MeshKernel& _mesh;
-    MeshCore::MeshGrid* _pGrid;
+    float getDistance(const Base::Vector3f& point, unsigned long facet) const;
+
+private:
+    const MeshCore::MeshKernel* _pMesh;
+    std::unique_ptr<MeshCore::MeshKernel> _transformed;
+    MeshCore::MeshFacetGrid* _pGrid;
     Base::BoundBox3f _box;
     bool _bApply;
-    Base::Matrix4D _clTrf;
+    Base::Matrix4D _clInvTrf;
 };
 
 class InspectionExport InspectNominalFastMesh : public InspectNominalGeometry
@@ -152,11 +166,28 @@ public:
     InspectNominalShape(const TopoDS_Shape&, float offset);
     ~InspectNominalShape();
     virtual float getDistance(const Base::Vector3f&) const;
+    virtual void getDistances(const std::vector<Base::Vector3f>&, std::vector<float>&) const;
+
+private:
+    InspectNominalShape(const InspectNominalShape&) = delete;
+    InspectNominalShape& operator=(const InspectNominalShape&) = delete;
+
+    class Evaluator;
+    std::unique_ptr<Evaluator> acquireEvaluator() const;
+    void releaseEvaluator(std::unique_ptr<Evaluator>) const;
+    bool isOutsideSearchRadius(const Base::Vector3f&, bool& positive) const;
 
 private:
-    BRepExtrema_DistShapeShape* distss;
     const TopoDS_Shape& _rShape;
     bool isSolid;
+    float _radius;
+    float _deflection;
+    /// Tessellation of the shape to rule out points beyond the search radius
+    MeshCore::MeshKernel* _pMesh;
+    MeshCore::MeshFacetGrid* _pGrid;
+    /// Extrema and classifier states, each used by one worker at a time
+    mutable std::mutex _mutex;
+    mutable std::vector<std::unique_ptr<Evaluator> > _evaluators;
 };
 
 class InspectionExport PropertyDistanceList: public App::PropertyLists
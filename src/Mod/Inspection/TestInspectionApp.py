@@ -0,0 +1,196 @@
+#**************************************************************************
+#   Copyright (c) 2020 The FreeCAD Developers                             *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import FreeCAD, unittest, random
+import Mesh, Points, Part
+App = FreeCAD
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD Inspection module
+#---------------------------------------------------------------------------
+
+
+def closestPointOnTriangle(p, a, b, c):
+    # see Ericson, Real-Time Collision Detection, 5.1.5
+    ab = b - a
+    ac = c - a
+    ap = p - a
+    d1 = ab.dot(ap)
+    d2 = ac.dot(ap)
+    if d1 <= 0 and d2 <= 0:
+        return a
+    bp = p - b
+    d3 = ab.dot(bp)
+    d4 = ac.dot(bp)
+    if d3 >= 0 and d4 <= d3:
+        return b
+    vc = d1 * d4 - d3 * d2
+    if vc <= 0 and d1 >= 0 and d3 <= 0:
+        return a + ab * (d1 / (d1 - d3))
+    cp = p - c
+    d5 = ab.dot(cp)
+    d6 = ac.dot(cp)
+    if d6 >= 0 and d5 <= d6:
+        return c
+    vb = d5 * d2 - d1 * d6
+    if vb <= 0 and d2 >= 0 and d6 <= 0:
+        return a + ac * (d2 / (d2 - d6))
+    va = d3 * d6 - d5 * d4
+    if va <= 0 and (d4 - d3) >= 0 and (d5 - d6) >= 0:
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))
+    denom = 1.0 / (va + vb + vc)
+    return a + ab * (vb * denom) + ac * (vc * denom)
+
+
+class InspectionMeshCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("InspectionTest")
+
+    def bruteForceDistance(self, mesh, point):
+        # signed distance to the nearest facet, like the inspection does
+        best = None
+        for facet in mesh.Facets:
+            a, b, c = [App.Vector(*p) for p in facet.Points]
+            dist = (closestPointOnTriangle(point, a, b, c) - point).Length
+            if best is None or dist < best[0]:
+                normal = (b - a).cross(c - a)
+                best = (dist, (point - a).dot(normal) > 0)
+        return best[0] if best[1] else -best[0]
+
+    def testMeshDistances(self):
+        # the nominal mesh is searched with its facet grid in batches and
+        # must give the same distances as checking all facets
+        sphere = Mesh.createSphere(10, 12)
+        placement = App.Placement(App.Vector(5, -3, 2), App.Rotation(App.Vector(1, 1, 0), 30))
+        nominal = self.Doc.addObject("Mesh::Feature", "Nominal")
+        nominal.Mesh = sphere
+        nominal.Placement = placement
+
+        random.seed(1)
+        pts = []
+        for i in range(200):
+            # inside, near and outside the bounding box of the mesh
+            vec = App.Vector(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1))
+            pts.append(placement.multVec(vec * random.uniform(0, 25)))
+        actual = self.Doc.addObject("Points::Feature", "Actual")
+        actual.Points = Points.Points([(p.x, p.y, p.z) for p in pts])
+
+        inspect = self.Doc.addObject("Inspection::Feature", "Inspect")
+        inspect.Actual = actual
+        inspect.Nominals = [nominal]
+        inspect.SearchRadius = 100
+        self.Doc.recompute()
+
+        inverse = placement.inverse()
+        distances = inspect.Distances
+        self.assertEqual(len(distances), len(pts))
+        for point, dist in zip(pts, distances):
+            expected = self.bruteForceDistance(sphere, inverse.multVec(point))
+            self.assertAlmostEqual(dist, expected, 3)
+
+    def tearDown(self):
+        FreeCAD.closeDocument("InspectionTest")
+
+
+# distances beyond the search radius
+FLT_MAX = 3.4028234663852886e+38
+
+
+class InspectionShapeCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("InspectionShapeTest")
+
+    def directDistance(self, shape, point, isSolid):
+        '''directDistance(shape, point, isSolid) ... returns the signed distance
+        with BRepExtrema like the inspection, and if the sign was taken from a face.'''
+        vertex = Part.Vertex(point)
+        if isSolid:
+            # the distance to the solid itself would be zero inside
+            dist = shape.Shells[0].distToShape(vertex)[0]
+            return (-dist if shape.isInside(point, 0.001, False) else dist), True
+        dist, pairs, infos = shape.distToShape(vertex)
+        for pair, info in zip(pairs, infos):
+            if info[0] == 'Face':
+                normal = shape.Faces[info[1]].normalAt(*info[2])
+                if dist > 0 and normal.dot(point - pair[0]) < 0:
+                    return -dist, True
+                return dist, True
+        return dist, False
+
+    def inspect(self, shape, radius, count):
+        nominal = self.Doc.addObject("Part::Feature", "Nominal")
+        nominal.Shape = shape
+
+        random.seed(2)
+        box = shape.BoundBox
+        box.enlarge(3 * radius)
+        pts = [App.Vector(random.uniform(box.XMin, box.XMax),
+                          random.uniform(box.YMin, box.YMax),
+                          random.uniform(box.ZMin, box.ZMax)) for i in range(count)]
+        actual = self.Doc.addObject("Points::Feature", "Actual")
+        actual.Points = Points.Points([(p.x, p.y, p.z) for p in pts])
+
+        inspect = self.Doc.addObject("Inspection::Feature", "Inspect")
+        inspect.Actual = actual
+        inspect.Nominals = [nominal]
+        inspect.SearchRadius = radius
+        self.Doc.recompute()
+        self.assertEqual(len(inspect.Distances), count)
+        return pts, inspect.Distances
+
+    def assertDistances(self, shape, isSolid, pts, distances, radius):
+        inside = 0
+        beyond = 0
+        for point, dist in zip(pts, distances):
+            expected, signed = self.directDistance(shape, point, isSolid)
+            if abs(expected) > radius:
+                # ruled out by the tessellation, only the sign is computed. For
+                # open shapes it is taken from the nearest facet, which is only
+                # defined if the point is nearest to the inside of a face
+                self.assertEqual(abs(dist), FLT_MAX)
+                if signed:
+                    self.assertEqual(dist, FLT_MAX if expected > 0 else -FLT_MAX)
+                beyond += 1
+            else:
+                self.assertAlmostEqual(dist, expected, 3)
+                inside += 1
+        # both the exact and the pre-filtered distances are checked
+        self.assertTrue(inside > 100)
+        self.assertTrue(beyond > 100)
+
+    def testSolidDistances(self):
+        # more points than a chunk, so several evaluators are used
+        solid = Part.makeCylinder(5, 10)
+        solid.Placement = App.Placement(App.Vector(5, -3, 2), App.Rotation(App.Vector(1, 1, 0), 30))
+        pts, distances = self.inspect(solid, 2.0, 2500)
+        self.assertDistances(solid, True, pts, distances, 2.0)
+
+    def testOpenShellDistances(self):
+        # a box without its top face, the normals of the faces point outwards
+        box = Part.makeBox(10, 10, 10)
+        shell = Part.makeShell([f for f in box.Faces if f.CenterOfMass.z < 9.9])
+        self.assertFalse(shell.isClosed())
+        pts, distances = self.inspect(shell, 2.0, 2500)
+        self.assertDistances(shell, False, pts, distances, 2.0)
+
+    def tearDown(self):
+        FreeCAD.closeDocument("InspectionShapeTest")
@@ -167,6 +167,340 @@ MeshFacetArray& MeshFacetArray::operator = (const MeshFacetArray &rclFAry)
 
 // -----------------------------------------------------------------
 
+namespace MeshCore {
+// the compact arrays store 32 bit indices and properties
+inline uint32_t CompactValue(unsigned long ulVal)
+{
+    return MeshCompactFacetArray::ToIndex(ulVal);
+}
+
+inline unsigned long ExpandValue(uint32_t uVal)
+{
+    return MeshCompactFacetArray::FromIndex(uVal);
+}
+}
+
+void MeshCompactPointArray::Assign (const MeshPointArray& rclPAry)
+{
+    clear();
+    std::size_t ct = rclPAry.size();
+    _coords.resize(3 * ct);
+
+    bool hasFlags = false, hasProps = false;
+    float* c = ct > 0 ? &_coords[0] : 0;
+    for (MeshPointArray::_TConstIterator it = rclPAry.begin(); it != rclPAry.end(); ++it) {
+        *c++ = it->x;
+        *c++ = it->y;
+        *c++ = it->z;
+        if (it->_ucFlag != 0)
+            hasFlags = true;
+        if (it->_ulProp != 0)
+            hasProps = true;
+    }
+
+    if (hasFlags) {
+        _flags.resize(ct);
+        for (std::size_t i = 0; i < ct; i++)
+            _flags[i] = rclPAry[i]._ucFlag;
+    }
+    if (hasProps) {
+        _props.resize(ct);
+        for (std::size_t i = 0; i < ct; i++)
+            _props[i] = CompactValue(rclPAry[i]._ulProp);
+    }
+}
+
+void MeshCompactPointArray::CopyTo (MeshPointArray& rclPAry) const
+{
+    unsigned long ct = size();
+    rclPAry.clear();
+    rclPAry.resize(ct);
+    for (unsigned long i = 0; i < ct; i++)
+        rclPAry[i] = (*this)[i];
+}
+
+void MeshCompactPointArray::reserve (unsigned long ulSize)
+{
+    _coords.reserve(3 * ulSize);
+    if (!_flags.empty())
+        _flags.reserve(ulSize);
+    if (!_props.empty())
+        _props.reserve(ulSize);
+}
+
+void MeshCompactPointArray::resize (unsigned long ulSize)
+{
+    _coords.resize(3 * ulSize, 0.0f);
+    if (!_flags.empty())
+        _flags.resize(ulSize, 0);
+    if (!_props.empty())
+        _props.resize(ulSize, 0);
+}
+
+void MeshCompactPointArray::clear (void)
+{
+    // swap to release the memory
+    std::vector<float>().swap(_coords);
+    std::vector<unsigned char>().swap(_flags);
+    std::vector<uint32_t>().swap(_props);
+}
+
+void MeshCompactPointArray::push_back (const Base::Vector3f& rclPt)
+{
+    _coords.push_back(rclPt.x);
+    _coords.push_back(rclPt.y);
+    _coords.push_back(rclPt.z);
+    if (!_flags.empty())
+        _flags.push_back(0);
+    if (!_props.empty())
+        _props.push_back(0);
+}
+
+MeshPoint MeshCompactPointArray::operator[] (unsigned long ulIndex) const
+{
+    const float* p = &_coords[3 * ulIndex];
+    MeshPoint pt(p[0], p[1], p[2]);
+    if (!_flags.empty())
+        pt._ucFlag = _flags[ulIndex];
+    if (!_props.empty())
+        pt._ulProp = ExpandValue(_props[ulIndex]);
+    return pt;
+}
+
+void MeshCompactPointArray::Set (unsigned long ulIndex, const MeshPoint& rclPt)
+{
+    SetPoint(ulIndex, rclPt);
+    if (rclPt._ucFlag != 0 || !_flags.empty()) {
+        _flags.resize(size(), 0);
+        _flags[ulIndex] = rclPt._ucFlag;
+    }
+    if (rclPt._ulProp != 0 || !_props.empty())
+        SetProperty(ulIndex, rclPt._ulProp);
+}
+
+void MeshCompactPointArray::SetFlag (unsigned long ulIndex, MeshPoint::TFlagType tF)
+{
+    if (_flags.empty())
+        _flags.resize(size(), 0);
+    _flags[ulIndex] |= static_cast<unsigned char>(tF);
+}
+
+void MeshCompactPointArray::ResetFlag (unsigned long ulIndex, MeshPoint::TFlagType tF)
+{
+    if (!_flags.empty())
+        _flags[ulIndex] &= ~static_cast<unsigned char>(tF);
+}
+
+void MeshCompactPointArray::ResetFlag (MeshPoint::TFlagType tF)
+{
+    for (std::vector<unsigned char>::iterator it = _flags.begin(); it != _flags.end(); ++it)
+        *it &= ~static_cast<unsigned char>(tF);
+}
+
+void MeshCompactPointArray::SetProperty (unsigned long ulIndex, unsigned long ulVal)
+{
+    if (_props.empty()) {
+        if (ulVal == 0)
+            return;
+        _props.resize(size(), 0);
+    }
+    _props[ulIndex] = CompactValue(ulVal);
+}
+
+unsigned long MeshCompactPointArray::GetProperty (unsigned long ulIndex) const
+{
+    return _props.empty() ? 0 : ExpandValue(_props[ulIndex]);
+}
+
+unsigned long MeshCompactPointArray::GetMemSize (void) const
+{
+    return static_cast<unsigned long>(_coords.capacity() * sizeof(float) +
+                                      _flags.capacity() * sizeof(unsigned char) +
+                                      _props.capacity() * sizeof(uint32_t));
+}
+
+Base::BoundBox3f MeshCompactPointArray::GetBoundBox (void) const
+{
+    Base::BoundBox3f clBox;
+    for (std::size_t i = 0; i < _coords.size(); i += 3)
+        clBox.Add(Base::Vector3f(_coords[i], _coords[i+1], _coords[i+2]));
+    return clBox;
+}
+
+void MeshCompactPointArray::Transform (const Base::Matrix4D& mat)
+{
+    unsigned long ct = size();
+    for (unsigned long i = 0; i < ct; i++) {
+        Base::Vector3f pt = GetPoint(i);
+        mat.multVec(pt, pt);
+        SetPoint(i, pt);
+    }
+}
+
+// -----------------------------------------------------------------
+
+void MeshCompactFacetArray::Assign (const MeshFacetArray& rclFAry)
+{
+    clear();
+    std::size_t ct = rclFAry.size();
+    _points.resize(3 * ct);
+    _neighbours.resize(3 * ct);
+
+    bool hasFlags = false, hasProps = false;
+    for (std::size_t i = 0; i < ct; i++) {
+        const MeshFacet& rFace = rclFAry[i];
+        for (int j = 0; j < 3; j++) {
+            _points[3*i+j] = ToIndex(rFace._aulPoints[j]);
+            _neighbours[3*i+j] = ToIndex(rFace._aulNeighbours[j]);
+        }
+        if (rFace._ucFlag != 0)
+            hasFlags = true;
+        if (rFace._ulProp != 0)
+            hasProps = true;
+    }
+
+    if (hasFlags) {
+        _flags.resize(ct);
+        for (std::size_t i = 0; i < ct; i++)
+            _flags[i] = rclFAry[i]._ucFlag;
+    }
+    if (hasProps) {
+        _props.resize(ct);
+        for (std::size_t i = 0; i < ct; i++)
+            _props[i] = CompactValue(rclFAry[i]._ulProp);
+    }
+}
+
+void MeshCompactFacetArray::CopyTo (MeshFacetArray& rclFAry) const
+{
+    unsigned long ct = size();
+    rclFAry.clear();
+    rclFAry.resize(ct);
+    for (unsigned long i = 0; i < ct; i++)
+        rclFAry[i] = (*this)[i];
+}
+
+void MeshCompactFacetArray::reserve (unsigned long ulSize)
+{
+    _points.reserve(3 * ulSize);
+    _neighbours.reserve(3 * ulSize);
+    if (!_flags.empty())
+        _flags.reserve(ulSize);
+    if (!_props.empty())
+        _props.reserve(ulSize);
+}
+
+void MeshCompactFacetArray::resize (unsigned long ulSize)
+{
+    _points.resize(3 * ulSize, UINT32_MAX);
+    _neighbours.resize(3 * ulSize, UINT32_MAX);
+    if (!_flags.empty())
+        _flags.resize(ulSize, 0);
+    if (!_props.empty())
+        _props.resize(ulSize, 0);
+}
+
+void MeshCompactFacetArray::clear (void)
+{
+    // swap to release the memory
+    std::vector<uint32_t>().swap(_points);
+    std::vector<uint32_t>().swap(_neighbours);
+    std::vector<unsigned char>().swap(_flags);
+    std::vector<uint32_t>().swap(_props);
+}
+
+void MeshCompactFacetArray::push_back (const MeshFacet& rclF)
+{
+    _points.resize(_points.size() + 3);
+    _neighbours.resize(_neighbours.size() + 3);
+    if (!_flags.empty())
+        _flags.push_back(0);
+    if (!_props.empty())
+        _props.push_back(0);
+    Set(size() - 1, rclF);
+}
+
+MeshFacet MeshCompactFacetArray::operator[] (unsigned long ulIndex) const
+{
+    MeshFacet face;
+    for (int i = 0; i < 3; i++) {
+        face._aulPoints[i] = FromIndex(_points[3*ulIndex+i]);
+        face._aulNeighbours[i] = FromIndex(_neighbours[3*ulIndex+i]);
+    }
+    if (!_flags.empty())
+        face._ucFlag = _flags[ulIndex];
+    if (!_props.empty())
+        face._ulProp = ExpandValue(_props[ulIndex]);
+    return face;
+}
+
+void MeshCompactFacetArray::Set (unsigned long ulIndex, const MeshFacet& rclF)
+{
+    for (int i = 0; i < 3; i++) {
+        _points[3*ulIndex+i] = ToIndex(rclF._aulPoints[i]);
+        _neighbours[3*ulIndex+i] = ToIndex(rclF._aulNeighbours[i]);
+    }
+    if (rclF._ucFlag != 0 || !_flags.empty()) {
+        _flags.resize(size(), 0);
+        _flags[ulIndex] = rclF._ucFlag;
+    }
+    if (rclF._ulProp != 0 || !_props.empty())
+        SetProperty(ulIndex, rclF._ulProp);
+}
+
+MeshGeomFacet MeshCompactFacetArray::GetGeomFacet (const MeshCompactPointArray& rclPAry,
+                                                   unsigned long ulIndex) const
+{
+    const uint32_t* p = &_points[3 * ulIndex];
+    MeshGeomFacet clFacet(rclPAry.GetPoint(p[0]),
+                          rclPAry.GetPoint(p[1]),
+                          rclPAry.GetPoint(p[2]));
+    clFacet.CalcNormal();
+    return clFacet;
+}
+
+void MeshCompactFacetArray::SetFlag (unsigned long ulIndex, MeshFacet::TFlagType tF)
+{
+    if (_flags.empty())
+        _flags.resize(size(), 0);
+    _flags[ulIndex] |= static_cast<unsigned char>(tF);
+}
+
+void MeshCompactFacetArray::ResetFlag (unsigned long ulIndex, MeshFacet::TFlagType tF)
+{
+    if (!_flags.empty())
+        _flags[ulIndex] &= ~static_cast<unsigned char>(tF);
+}
+
+void MeshCompactFacetArray::ResetFlag (MeshFacet::TFlagType tF)
+{
+    for (std::vector<unsigned char>::iterator it = _flags.begin(); it != _flags.end(); ++it)
+        *it &= ~static_cast<unsigned char>(tF);
+}
+
+void MeshCompactFacetArray::SetProperty (unsigned long ulIndex, unsigned long ulVal)
+{
+    if (_props.empty()) {
+        if (ulVal == 0)
+            return;
+        _props.resize(size(), 0);
+    }
+    _props[ulIndex] = CompactValue(ulVal);
+}
+
+unsigned long MeshCompactFacetArray::GetProperty (unsigned long ulIndex) const
+{
+    return _props.empty() ? 0 : ExpandValue(_props[ulIndex]);
+}
+
+unsigned long MeshCompactFacetArray::GetMemSize (void) const
+{
+    return static_cast<unsigned long>((_points.capacity() + _neighbours.capacity() + _props.capacity()) * sizeof(uint32_t) +
+                                      _flags.capacity() * sizeof(unsigned char));
+}
+
+// -----------------------------------------------------------------
+
 bool MeshGeomEdge::ContainedByOrIntersectBoundingBox ( const Base::BoundBox3f &rclBB ) const
 {
   // Test, ob alle Eckpunkte der Edge sich auf einer der 6 Seiten der BB befinden
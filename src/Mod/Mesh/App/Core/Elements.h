@@ -28,6 +28,7 @@
 #include <vector>
 #include <climits>
 #include <cstring>
+#include <stdint.h>
 
 #include "Definitions.h"
 
@@ -689,6 +690,165 @@ private:
     MeshFacetArray& rFacets;
 };
 
+/**
+ * The MeshCompactPointArray class is a memory saving alternative to MeshPointArray.
+ * The coordinates are packed into one float array while flags and properties are kept
+ * in side arrays that are only allocated when used. So, a point takes 12 bytes instead
+ * of the 24 bytes of MeshPoint on LP64 platforms and the coordinates can be traversed
+ * cache-friendly. Properties are stored with 32 bits where ULONG_MAX is preserved.
+ *
+ * Elements are accessed by value. Algorithms that work on MeshPointArray can be used
+ * with a temporary copy, see CopyTo().
+ */
+class MeshExport MeshCompactPointArray
+{
+public:
+    /** @name Construction */
+    //@{
+    MeshCompactPointArray (void) { }
+    explicit MeshCompactPointArray (const MeshPointArray& rclPAry)
+    { Assign(rclPAry); }
+    //@}
+
+    /** @name Conversion */
+    //@{
+    /// Replaces the content with the points of \a rclPAry
+    void Assign (const MeshPointArray& rclPAry);
+    /// Writes all points with their flags and properties to \a rclPAry
+    void CopyTo (MeshPointArray& rclPAry) const;
+    //@}
+
+    /** @name Element access */
+    //@{
+    unsigned long size (void) const
+    { return static_cast<unsigned long>(_coords.size() / 3); }
+    bool empty (void) const
+    { return _coords.empty(); }
+    void reserve (unsigned long ulSize);
+    void resize (unsigned long ulSize);
+    void clear (void);
+    void push_back (const Base::Vector3f& rclPt);
+    /// Returns the point with its flags and property
+    MeshPoint operator[] (unsigned long ulIndex) const;
+    /// Sets the point with its flags and property
+    void Set (unsigned long ulIndex, const MeshPoint& rclPt);
+    Base::Vector3f GetPoint (unsigned long ulIndex) const
+    { const float* p = &_coords[3*ulIndex]; return Base::Vector3f(p[0], p[1], p[2]); }
+    void SetPoint (unsigned long ulIndex, const Base::Vector3f& rclPt)
+    { float* p = &_coords[3*ulIndex]; p[0] = rclPt.x; p[1] = rclPt.y; p[2] = rclPt.z; }
+    /// Returns the packed xyz coordinates of all points
+    const float* GetCoordinates (void) const
+    { return _coords.empty() ? 0 : &_coords[0]; }
+    //@}
+
+    /** @name Flag state and property */
+    //@{
+    void SetFlag (unsigned long ulIndex, MeshPoint::TFlagType tF);
+    void ResetFlag (unsigned long ulIndex, MeshPoint::TFlagType tF);
+    bool IsFlag (unsigned long ulIndex, MeshPoint::TFlagType tF) const
+    { return !_flags.empty() && (_flags[ulIndex] & static_cast<unsigned char>(tF)) == static_cast<unsigned char>(tF); }
+    /// Resets the flag for all points
+    void ResetFlag (MeshPoint::TFlagType tF);
+    void SetProperty (unsigned long ulIndex, unsigned long ulVal);
+    unsigned long GetProperty (unsigned long ulIndex) const;
+    //@}
+
+    /// Returns the number of required memory in bytes
+    unsigned long GetMemSize (void) const;
+    Base::BoundBox3f GetBoundBox (void) const;
+    void Transform (const Base::Matrix4D&);
+
+private:
+    std::vector<float>         _coords; /**< Packed xyz coordinates. */
+    std::vector<unsigned char> _flags;  /**< Flags, empty as long as none is set. */
+    std::vector<uint32_t>      _props;  /**< Properties, empty as long as none is set. */
+};
+
+/**
+ * The MeshCompactFacetArray class is a memory saving alternative to MeshFacetArray.
+ * Point and neighbour indices are stored with 32 bits in two packed arrays, where
+ * ULONG_MAX is preserved, and flags and properties are kept in side arrays that are
+ * only allocated when used. So, a facet takes 24 bytes instead of the 64 bytes of
+ * MeshFacet on LP64 platforms.
+ *
+ * Elements are accessed by value. Algorithms that work on MeshFacetArray can be used
+ * with a temporary copy, see CopyTo().
+ */
+class MeshExport MeshCompactFacetArray
+{
+public:
+    /** @name Construction */
+    //@{
+    MeshCompactFacetArray (void) { }
+    explicit MeshCompactFacetArray (const MeshFacetArray& rclFAry)
+    { Assign(rclFAry); }
+    //@}
+
+    /** @name Conversion */
+    //@{
+    /// Replaces the content with the facets of \a rclFAry
+    void Assign (const MeshFacetArray& rclFAry);
+    /// Writes all facets with their flags and properties to \a rclFAry
+    void CopyTo (MeshFacetArray& rclFAry) const;
+    //@}
+
+    /** @name Element access */
+    //@{
+    unsigned long size (void) const
+    { return static_cast<unsigned long>(_points.size() / 3); }
+    bool empty (void) const
+    { return _points.empty(); }
+    void reserve (unsigned long ulSize);
+    void resize (unsigned long ulSize);
+    void clear (void);
+    void push_back (const MeshFacet& rclF);
+    /// Returns the facet with its flags and property
+    MeshFacet operator[] (unsigned long ulIndex) const;
+    /// Sets the facet with its flags and property
+    void Set (unsigned long ulIndex, const MeshFacet& rclF);
+    unsigned long GetPoint (unsigned long ulIndex, unsigned short usSide) const
+    { return FromIndex(_points[3*ulIndex+usSide]); }
+    unsigned long GetNeighbour (unsigned long ulIndex, unsigned short usSide) const
+    { return FromIndex(_neighbours[3*ulIndex+usSide]); }
+    /// Returns the geometric facet of the facet at position \a ulIndex
+    MeshGeomFacet GetGeomFacet (const MeshCompactPointArray& rclPAry, unsigned long ulIndex) const;
+    /// Returns the packed corner point indices of all facets
+    const uint32_t* GetPointIndices (void) const
+    { return _points.empty() ? 0 : &_points[0]; }
+    /// Returns the packed neighbour indices of all facets
+    const uint32_t* GetNeighbourIndices (void) const
+    { return _neighbours.empty() ? 0 : &_neighbours[0]; }
+    //@}
+
+    /** @name Flag state and property */
+    //@{
+    void SetFlag (unsigned long ulIndex, MeshFacet::TFlagType tF);
+    void ResetFlag (unsigned long ulIndex, MeshFacet::TFlagType tF);
+    bool IsFlag (unsigned long ulIndex, MeshFacet::TFlagType tF) const
+    { return !_flags.empty() && (_flags[ulIndex] & static_cast<unsigned char>(tF)) == static_cast<unsigned char>(tF); }
+    /// Resets the flag for all facets
+    void ResetFlag (MeshFacet::TFlagType tF);
+    void SetProperty (unsigned long ulIndex, unsigned long ulVal);
+    unsigned long GetProperty (unsigned long ulIndex) const;
+    //@}
+
+    /// Returns the number of required memory in bytes
+    unsigned long GetMemSize (void) const;
+
+    /// Converts an index to its 32 bit representation
+    static uint32_t ToIndex (unsigned long ulIndex)
+    { return ulIndex == ULONG_MAX ? UINT32_MAX : static_cast<uint32_t>(ulIndex); }
+    /// Converts a 32 bit index back
+    static unsigned long FromIndex (uint32_t uIndex)
+    { return uIndex == UINT32_MAX ? ULONG_MAX : static_cast<unsigned long>(uIndex); }
+
+private:
+    std::vector<uint32_t>      _points;     /**< Corner point indices, three per facet. */
+    std::vector<uint32_t>      _neighbours; /**< Neighbour facet indices, three per facet. */
+    std::vector<unsigned char> _flags;      /**< Flags, empty as long as none is set. */
+    std::vector<uint32_t>      _props;      /**< Properties, empty as long as none is set. */
+};
+
 inline MeshPoint::MeshPoint (float x, float y, float z)
 #ifdef _MSC_VER
 : Vector3f(x, y, z),
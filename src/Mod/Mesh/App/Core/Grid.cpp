@@ -25,8 +25,13 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <atomic>
+# include <memory>
 #endif
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include "Grid.h"
 #include "Iterator.h"
 
@@ -36,6 +41,34 @@
 
 using namespace MeshCore;
 
+namespace {
+// Calls func(chunk, begin, end) for \a threads ranges of [0, count) with the global thread pool
+template<typename Func>
+void parallelRanges(std::size_t count, std::size_t threads, Func func)
+{
+  if (threads <= 1 || count == 0)
+  {
+    func(std::size_t(0), std::size_t(0), count);
+    return;
+  }
+
+  std::vector<std::size_t> chunks(threads);
+  for (std::size_t i = 0; i < threads; i++)
+    chunks[i] = i;
+  QtConcurrent::blockingMap(chunks, [&func, count, threads](const std::size_t& i) {
+    func(i, i * count / threads, (i + 1) * count / threads);
+  });
+}
+
+// small workloads are not worth the overhead of threads
+std::size_t threadCount(std::size_t count, std::size_t minCount)
+{
+  if (count < minCount)
+    return 1;
+  return static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+}
+}
+
 MeshGrid::MeshGrid (const MeshKernel &rclM)
 : _pclMesh(&rclM),
   _ulCtElements(0),
@@ -62,7 +95,8 @@ void MeshGrid::Attach (const MeshKernel &rclM)
 
 void MeshGrid::Clear (void)
 {
-  _aulGrid.clear();
+  _aulGridOffsets.clear();
+  _aulGridElements.clear();
   _pclMesh = NULL;  
 }
 
@@ -93,8 +127,6 @@ void MeshGrid::InitGrid (void)
 {
   assert(_pclMesh != NULL);
 
-  unsigned long i, j;
-
   // Grid Laengen berechnen wenn nicht initialisiert
   //
   if ((_ulCtGridsX == 0) || (_ulCtGridsY == 0) || (_ulCtGridsZ == 0))
@@ -128,13 +160,70 @@ void MeshGrid::InitGrid (void)
   }
 
   // Daten-Struktur anlegen
-  _aulGrid.clear();
-  _aulGrid.resize(_ulCtGridsX);
-  for (i = 0; i < _ulCtGridsX; i++)
+  std::size_t ulCtCells = static_cast<std::size_t>(_ulCtGridsX) * _ulCtGridsY * _ulCtGridsZ;
+  _aulGridOffsets.assign(ulCtCells + 1, 0);
+  _aulGridElements.clear();
+}
+
+void MeshGrid::BuildGrid (unsigned long ulCtElements, const CellFunction& cellsOf)
+{
+  std::size_t ulCtCells = static_cast<std::size_t>(_ulCtGridsX) * _ulCtGridsY * _ulCtGridsZ;
+  std::size_t threads = threadCount(ulCtElements, 10000);
+
+  // counting pass, the found grid elements are kept to call cellsOf only once per element
+  struct Chunk
+  {
+    std::vector<unsigned long> cells;
+    std::vector<unsigned long> elements;
+  };
+  std::vector<Chunk> chunks(threads);
+  std::unique_ptr<std::atomic<unsigned long>[]> counts(new std::atomic<unsigned long>[ulCtCells]);
+  for (std::size_t i = 0; i < ulCtCells; i++)
+    counts[i].store(0, std::memory_order_relaxed);
+
+  parallelRanges(ulCtElements, threads, [&](std::size_t c, std::size_t begin, std::size_t end) {
+    Chunk& chunk = chunks[c];
+    std::vector<unsigned long> cells;
+    for (std::size_t i = begin; i < end; i++)
+    {
+      cells.clear();
+      cellsOf(static_cast<unsigned long>(i), cells);
+      for (std::vector<unsigned long>::iterator it = cells.begin(); it != cells.end(); ++it)
+      {
+        chunk.cells.push_back(*it);
+        chunk.elements.push_back(static_cast<unsigned long>(i));
+        counts[*it].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  _aulGridOffsets.resize(ulCtCells + 1);
+  unsigned long ulPos = 0;
+  for (std::size_t i = 0; i < ulCtCells; i++)
   {
-    _aulGrid[i].resize(_ulCtGridsY);
-    for (j = 0; j < _ulCtGridsY; j++)
-      _aulGrid[i][j].resize(_ulCtGridsZ);
+    _aulGridOffsets[i] = ulPos;
+    ulPos += counts[i].load(std::memory_order_relaxed);
+    counts[i].store(_aulGridOffsets[i], std::memory_order_relaxed);
+  }
+  _aulGridOffsets[ulCtCells] = ulPos;
+
+  // filling pass
+  _aulGridElements.resize(ulPos);
+  parallelRanges(ulCtElements, threads, [&](std::size_t c, std::size_t, std::size_t) {
+    Chunk& chunk = chunks[c];
+    for (std::size_t i = 0; i < chunk.cells.size(); i++)
+      _aulGridElements[counts[chunk.cells[i]].fetch_add(1, std::memory_order_relaxed)] = chunk.elements[i];
+    std::vector<unsigned long>().swap(chunk.cells);
+    std::vector<unsigned long>().swap(chunk.elements);
+  });
+
+  // the chunks are filled concurrently, so the order inside a grid element is arbitrary
+  if (threads > 1)
+  {
+    parallelRanges(ulCtCells, threads, [&](std::size_t, std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; i++)
+        std::sort(_aulGridElements.begin() + _aulGridOffsets[i], _aulGridElements.begin() + _aulGridOffsets[i+1]);
+    });
   }
 }
 
@@ -155,7 +244,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsig
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(raulElements.end(), CellBegin(i, j, k), CellEnd(i, j, k));
       }
     }
   }  
@@ -190,7 +279,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::vector<unsig
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
         if (Base::DistanceP2(GetBoundBox(i, j, k).GetCenter(), rclOrg) < fMinDistP2)
-          raulElements.insert(raulElements.end(), _aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+          raulElements.insert(raulElements.end(), CellBegin(i, j, k), CellEnd(i, j, k));
       }
     }
   }  
@@ -221,7 +310,7 @@ unsigned long MeshGrid::Inside (const Base::BoundBox3f &rclBB, std::set<unsigned
     {
       for (k = ulMinZ; k <= ulMaxZ; k++)
       {
-        raulElements.insert(_aulGrid[i][j][k].begin(), _aulGrid[i][j][k].end());
+        raulElements.insert(CellBegin(i, j, k), CellEnd(i, j, k));
       }
     }
   }  
@@ -478,7 +567,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(CellBegin(nX, i, j), CellEnd(nX, i, j));
           }
           nX++;
         }
@@ -492,7 +581,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsY; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[nX][i][j].begin(), _aulGrid[nX][i][j].end());
+              raclInd.insert(CellBegin(nX, i, j), CellEnd(nX, i, j));
           }
           nX++;
         }
@@ -506,7 +595,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(CellBegin(i, nY, j), CellEnd(i, nY, j));
           }
           nY++;
         }
@@ -520,7 +609,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsZ; j++)
-              raclInd.insert(_aulGrid[i][nY][j].begin(), _aulGrid[i][nY][j].end());
+              raclInd.insert(CellBegin(i, nY, j), CellEnd(i, nY, j));
           }
           nY--;
         }
@@ -534,7 +623,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(CellBegin(i, j, nZ), CellEnd(i, j, nZ));
           }
           nZ++;
         }
@@ -548,7 +637,7 @@ void MeshGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt, std::set<uns
           for (unsigned long i = 0; i < _ulCtGridsX; i++)
           {
             for (unsigned long j = 0; j < _ulCtGridsY; j++)
-              raclInd.insert(_aulGrid[i][j][nZ].begin(), _aulGrid[i][j][nZ].end());
+              raclInd.insert(CellBegin(i, j, nZ), CellEnd(i, j, nZ));
           }
           nZ--;
         }
@@ -644,11 +733,12 @@ void MeshGrid::GetHull (unsigned long ulX, unsigned long ulY, unsigned long ulZ,
 unsigned long MeshGrid::GetElements (unsigned long ulX, unsigned long ulY, unsigned long ulZ,  
                                      std::set<unsigned long> &raclInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  if (rclSet.size() > 0)
+  const unsigned long* pBegin = CellBegin(ulX, ulY, ulZ);
+  const unsigned long* pEnd = CellEnd(ulX, ulY, ulZ);
+  if (pBegin != pEnd)
   {
-    raclInd.insert(rclSet.begin(), rclSet.end());
-    return rclSet.size();
+    raclInd.insert(pBegin, pEnd);
+    return static_cast<unsigned long>(pEnd - pBegin);
   }
 
   return 0;
@@ -660,9 +750,7 @@ unsigned long MeshGrid::GetElements(const Base::Vector3f &rclPoint, std::vector<
   if (!CheckPosition(rclPoint, ulX, ulY, ulZ))
     return 0;
 
-  aulFacets.resize(_aulGrid[ulX][ulY][ulZ].size());
-
-  std::copy(_aulGrid[ulX][ulY][ulZ].begin(), _aulGrid[ulX][ulY][ulZ].end(), aulFacets.begin());
+  aulFacets.assign(CellBegin(ulX, ulY, ulZ), CellEnd(ulX, ulY, ulZ));
   return aulFacets.size();
 }
 
@@ -767,15 +855,9 @@ void MeshFacetGrid::RebuildGrid (void)
   InitGrid();
  
   // Daten-Struktur fuellen
-  MeshFacetIterator clFIter(*_pclMesh);
-
-  unsigned long i = 0;
-  for (clFIter.Init(); clFIter.More(); clFIter.Next())
-  {
-//    AddFacet(*clFIter, i++, 2.0f);
-    AddFacet(*clFIter, i++);
-  }
-
+  BuildGrid(_ulCtElements, [this](unsigned long ulIndex, std::vector<unsigned long>& raulCells) {
+    FacetCells(_pclMesh->GetFacet(ulIndex), raulCells);
+  });
 }
 
 unsigned long MeshFacetGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt) const
@@ -1006,8 +1088,8 @@ void MeshFacetGrid::SearchNearestFacetInGrid(unsigned long ulX, unsigned long ul
                                              const Base::Vector3f &rclPt, float &rfMinDist,
                                              unsigned long &rulFacetInd) const
 {
-  const std::set<unsigned long> &rclSet = _aulGrid[ulX][ulY][ulZ];
-  for (std::set<unsigned long>::const_iterator pI = rclSet.begin(); pI != rclSet.end(); ++pI)
+  const unsigned long* pEnd = CellEnd(ulX, ulY, ulZ);
+  for (const unsigned long* pI = CellBegin(ulX, ulY, ulZ); pI != pEnd; ++pI)
   {
     float fDist = _pclMesh->GetFacet(*pI).DistanceToPoint(rclPt);
     if (fDist < rfMinDist)
@@ -1018,6 +1100,52 @@ void MeshFacetGrid::SearchNearestFacetInGrid(unsigned long ulX, unsigned long ul
   }
 }
 
+void MeshFacetGrid::SearchNearestFromPoints (const std::vector<Base::Vector3f> &rclPts, std::vector<unsigned long> &raulFacets,
+                                             float fMaxSearchArea) const
+{
+  raulFacets.resize(rclPts.size());
+  parallelRanges(rclPts.size(), threadCount(rclPts.size(), 256),
+                 [&](std::size_t, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+    {
+      if (fMaxSearchArea > 0.0f)
+        raulFacets[i] = SearchNearestFromPoint(rclPts[i], fMaxSearchArea);
+      else
+        raulFacets[i] = SearchNearestFromPoint(rclPts[i]);
+    }
+  });
+}
+
+unsigned long MeshFacetGrid::SearchInSphere (const Base::Vector3f &rclCenter, float fRadius,
+                                             std::vector<unsigned long> &raulFacets) const
+{
+  Base::BoundBox3f clBB(rclCenter.x - fRadius, rclCenter.y - fRadius, rclCenter.z - fRadius,
+                        rclCenter.x + fRadius, rclCenter.y + fRadius, rclCenter.z + fRadius);
+
+  std::vector<unsigned long> aulElements;
+  Inside(clBB, aulElements, true);
+
+  raulFacets.clear();
+  for (std::vector<unsigned long>::const_iterator pI = aulElements.begin(); pI != aulElements.end(); ++pI)
+  {
+    if (_pclMesh->GetFacet(*pI).DistanceToPoint(rclCenter) <= fRadius)
+      raulFacets.push_back(*pI);
+  }
+
+  return raulFacets.size();
+}
+
+void MeshFacetGrid::SearchInSpheres (const std::vector<Base::Vector3f> &rclCenters, float fRadius,
+                                     std::vector<std::vector<unsigned long> > &raulFacets) const
+{
+  raulFacets.resize(rclCenters.size());
+  parallelRanges(rclCenters.size(), threadCount(rclCenters.size(), 256),
+                 [&](std::size_t, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+      SearchInSphere(rclCenters[i], fRadius, raulFacets[i]);
+  });
+}
+
 //----------------------------------------------------------------------------
 
 MeshPointGrid::MeshPointGrid (const MeshKernel &rclM) 
@@ -1052,13 +1180,12 @@ MeshPointGrid::MeshPointGrid (const MeshKernel &rclM, float fGridLen)
           std::max<unsigned long>(static_cast<unsigned long>(clBBMesh.LengthZ() / fGridLen), 1));
 }
 
-void MeshPointGrid::AddPoint (const MeshPoint &rclPt, unsigned long ulPtIndex, float fEpsilon)
+void MeshPointGrid::PointCells (const MeshPoint &rclPt, std::vector<unsigned long> &raulCells) const
 {
-  (void)fEpsilon;
   unsigned long ulX, ulY, ulZ;
   Pos(Base::Vector3f(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
   if ( (ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ) )
-    _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
+    raulCells.push_back(CellIndex(ulX, ulY, ulZ));
 }
 
 void MeshPointGrid::Validate (const MeshKernel &rclMesh)
@@ -1109,14 +1236,10 @@ void MeshPointGrid::RebuildGrid (void)
   InitGrid();
  
   // Daten-Struktur fuellen
-
-  MeshPointIterator cPIter(*_pclMesh);
-
-  unsigned long i = 0;
-  for (cPIter.Init(); cPIter.More(); cPIter.Next())
-  {
-    AddPoint(*cPIter, i++);
-  }
+  const MeshPointArray& rPoints = _pclMesh->GetPoints();
+  BuildGrid(_ulCtElements, [this, &rPoints](unsigned long ulIndex, std::vector<unsigned long>& raulCells) {
+    PointCells(rPoints[ulIndex], raulCells);
+  });
 }
 
 void MeshPointGrid::Pos (const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const
@@ -1140,6 +1263,40 @@ unsigned long MeshPointGrid::FindElements (const Base::Vector3f &rclPoint, std::
   return 0;
 }
 
+unsigned long MeshPointGrid::SearchInSphere (const Base::Vector3f &rclCenter, float fRadius,
+                                             std::vector<unsigned long> &raulPoints) const
+{
+  Base::BoundBox3f clBB(rclCenter.x - fRadius, rclCenter.y - fRadius, rclCenter.z - fRadius,
+                        rclCenter.x + fRadius, rclCenter.y + fRadius, rclCenter.z + fRadius);
+
+  // each point is only in one grid element
+  std::vector<unsigned long> aulElements;
+  Inside(clBB, aulElements, false);
+
+  raulPoints.clear();
+  float fRadiusP2 = fRadius * fRadius;
+  const MeshPointArray& rPoints = _pclMesh->GetPoints();
+  for (std::vector<unsigned long>::const_iterator pI = aulElements.begin(); pI != aulElements.end(); ++pI)
+  {
+    if (Base::DistanceP2(rPoints[*pI], rclCenter) <= fRadiusP2)
+      raulPoints.push_back(*pI);
+  }
+
+  std::sort(raulPoints.begin(), raulPoints.end());
+  return raulPoints.size();
+}
+
+void MeshPointGrid::SearchInSpheres (const std::vector<Base::Vector3f> &rclCenters, float fRadius,
+                                     std::vector<std::vector<unsigned long> > &raulPoints) const
+{
+  raulPoints.resize(rclCenters.size());
+  parallelRanges(rclCenters.size(), threadCount(rclCenters.size(), 256),
+                 [&](std::size_t, std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+      SearchInSphere(rclCenters[i], fRadius, raulPoints[i]);
+  });
+}
+
 // ----------------------------------------------------------------
 
 MeshGridIterator::MeshGridIterator (const MeshGrid &rclG)
@@ -1178,7 +1335,7 @@ bool MeshGridIterator::InitOnRay (const Base::Vector3f &rclPt, const Base::Vecto
   if ((_rclGrid.GetBoundBox().IsInBox(rclPt)) == true)
   {  // Voxel bestimmen, indem der Startpunkt liegt
     _rclGrid.Position(rclPt, _ulX, _ulY, _ulZ);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.CellBegin(_ulX, _ulY, _ulZ), _rclGrid.CellEnd(_ulX, _ulY, _ulZ));
     _bValidRay = true;
   }
   else
@@ -1191,7 +1348,7 @@ bool MeshGridIterator::InitOnRay (const Base::Vector3f &rclPt, const Base::Vecto
       else
         _rclGrid.Position(cP1, _ulX, _ulY, _ulZ);
 
-      raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+      raulElements.insert(raulElements.end(), _rclGrid.CellBegin(_ulX, _ulY, _ulZ), _rclGrid.CellEnd(_ulX, _ulY, _ulZ));
       _bValidRay = true;
     }
   }
@@ -1242,7 +1399,7 @@ bool MeshGridIterator::NextOnRay (std::vector<unsigned long> &raulElements)
   if ((_bValidRay == true) && (_rclGrid.CheckPos(_ulX, _ulY, _ulZ) == true))
   {
     GridElement pos(_ulX, _ulY, _ulZ); _cSearchPositions.insert(pos);
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end()); 
+    raulElements.insert(raulElements.end(), _rclGrid.CellBegin(_ulX, _ulY, _ulZ), _rclGrid.CellEnd(_ulX, _ulY, _ulZ)); 
   }
   else
     _bValidRay = false;  // Strahl ausgetreten
@@ -25,6 +25,7 @@
 #define MESH_GRID_H
 
 #include <set>
+#include <functional>
 
 #include "MeshKernel.h"
 #include <Base/Vector3D.h>
@@ -125,7 +126,7 @@ public:
   bool GetPositionToIndex(unsigned long id, unsigned long& ulX, unsigned long& ulY, unsigned long& ulZ) const;
   /** Returns the number of elements in a given grid. */
   unsigned long GetCtElements(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
-  { return static_cast<unsigned long>(_aulGrid[ulX][ulY][ulZ].size()); }
+  { return static_cast<unsigned long>(CellEnd(ulX, ulY, ulZ) - CellBegin(ulX, ulY, ulZ)); }
   /** Validates the grid structure and rebuilds it if needed. Must be implemented in sub-classes. */
   virtual void Validate (const MeshKernel &rclM) = 0;
   /** Verifies the grid structure and returns false if inconsistencies are found. */
@@ -155,9 +156,24 @@ protected:
   virtual void RebuildGrid (void) = 0;
   /** Returns the number of stored elements. Must be implemented in sub-classes. */
   virtual unsigned long HasElements (void) const = 0;
+  /** Function that appends the indices of all grid elements the element with the given index belongs to. */
+  typedef std::function<void (unsigned long, std::vector<unsigned long>&)> CellFunction;
+  /** Fills the grid structure with \a ulCtElements elements. The elements are distributed over several threads
+   * for large meshes, so \a cellsOf must be thread-safe. The elements of each grid element are sorted. */
+  void BuildGrid (unsigned long ulCtElements, const CellFunction& cellsOf);
+  /** Returns the index of the given grid position without any checks. */
+  unsigned long CellIndex (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return (ulZ * _ulCtGridsY + ulY) * _ulCtGridsX + ulX; }
+  /** Returns the first element of the given grid position. */
+  const unsigned long* CellBegin (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return _aulGridElements.data() + _aulGridOffsets[CellIndex(ulX, ulY, ulZ)]; }
+  /** Returns the end of the elements of the given grid position. */
+  const unsigned long* CellEnd (unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
+  { return _aulGridElements.data() + _aulGridOffsets[CellIndex(ulX, ulY, ulZ) + 1]; }
 
 protected:
-  std::vector<std::vector<std::vector<std::set<unsigned long> > > >  _aulGrid;   /**< Grid data structure. */
+  std::vector<unsigned long> _aulGridOffsets;  /**< Offsets of the grid elements into _aulGridElements. */
+  std::vector<unsigned long> _aulGridElements; /**< Element indices of all grid elements. */
   const MeshKernel* _pclMesh;     /**< The mesh kernel. */
   unsigned long     _ulCtElements;/**< Number of grid elements for validation issues. */
   unsigned long     _ulCtGridsX;  /**< Number of grid elements in z. */
@@ -210,6 +226,15 @@ public:
    * are introduced into the search. */
   void SearchNearestFacetInHull (unsigned long ulX, unsigned long ulY, unsigned long ulZ, unsigned long ulDistance, 
                                  const Base::Vector3f &rclPt, unsigned long &rulFacetInd, float &rfMinDist) const;
+  /** Searches for the nearest facet of each point in parallel. If \a fMaxSearchArea is positive only facets within
+   * this distance are considered and ULONG_MAX is set for points without such a facet. */
+  void SearchNearestFromPoints (const std::vector<Base::Vector3f> &rclPts, std::vector<unsigned long> &raulFacets,
+                                float fMaxSearchArea = 0.0f) const;
+  /** Searches for all facets with a distance to \a rclCenter of at most \a fRadius. */
+  unsigned long SearchInSphere (const Base::Vector3f &rclCenter, float fRadius, std::vector<unsigned long> &raulFacets) const;
+  /** Does the same as SearchInSphere() for each center in parallel. */
+  void SearchInSpheres (const std::vector<Base::Vector3f> &rclCenters, float fRadius,
+                        std::vector<std::vector<unsigned long> > &raulFacets) const;
   //@}
 
   /** Validates the grid structure and rebuilds it if needed. */
@@ -224,10 +249,8 @@ protected:
   inline void Pos (const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
   /** Returns the grid numbers to the given point \a rclPoint. */
   inline void PosWithCheck (const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
-  /** Adds a new facet element to the grid structure. \a rclFacet is the geometric facet and \a ulFacetIndex 
-   * the corresponding index in the mesh kernel. The facet is added to each grid element that intersects 
-   * the facet. */
-  inline void AddFacet (const MeshGeomFacet &rclFacet, unsigned long ulFacetIndex, float fEpsilon = 0.0f);
+  /** Appends the indices of all grid elements that intersect the facet \a rclFacet to \a raulCells. */
+  inline void FacetCells (const MeshGeomFacet &rclFacet, std::vector<unsigned long> &raulCells) const;
   /** Returns the number of stored elements. */
   unsigned long HasElements (void) const
   { return _pclMesh->CountFacets(); }
@@ -260,6 +283,11 @@ public:
 
   /** Finds all points that lie in the same grid as the point \a rclPoint. */
   unsigned long FindElements(const Base::Vector3f &rclPoint, std::set<unsigned long>& aulElements) const;
+  /** Searches for all points with a distance to \a rclCenter of at most \a fRadius. */
+  unsigned long SearchInSphere (const Base::Vector3f &rclCenter, float fRadius, std::vector<unsigned long> &raulPoints) const;
+  /** Does the same as SearchInSphere() for each center in parallel. */
+  void SearchInSpheres (const std::vector<Base::Vector3f> &rclCenters, float fRadius,
+                        std::vector<std::vector<unsigned long> > &raulPoints) const;
   /** Validates the grid structure and rebuilds it if needed. */
   virtual void Validate (const MeshKernel &rclM);
   /** Validates the grid structure and rebuilds it if needed. */
@@ -268,9 +296,8 @@ public:
   virtual bool Verify() const;
 
 protected:
-  /** Adds a new point element to the grid structure. \a rclPt is the geometric point and \a ulPtIndex 
-   * the corresponding index in the mesh kernel. */
-  void AddPoint (const MeshPoint &rclPt, unsigned long ulPtIndex, float fEpsilon = 0.0f);
+  /** Appends the index of the grid element that contains the point \a rclPt to \a raulCells. */
+  void PointCells (const MeshPoint &rclPt, std::vector<unsigned long> &raulCells) const;
   /** Returns the grid numbers to the given point \a rclPoint. */
   void Pos(const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
   /** Returns the number of stored elements. */
@@ -295,7 +322,7 @@ public:
   /** Returns indices of the elements in the current grid. */
   void GetElements (std::vector<unsigned long> &raulElements) const
   {
-    raulElements.insert(raulElements.end(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].begin(), _rclGrid._aulGrid[_ulX][_ulY][_ulZ].end());
+    raulElements.insert(raulElements.end(), _rclGrid.CellBegin(_ulX, _ulY, _ulZ), _rclGrid.CellEnd(_ulX, _ulY, _ulZ));
   }
   /** Returns the number of elements in the current grid. */
   unsigned long GetCtElements() const
@@ -434,38 +461,8 @@ inline void MeshFacetGrid::PosWithCheck (const Base::Vector3f &rclPoint, unsigne
   assert((rulX < _ulCtGridsX) && (rulY < _ulCtGridsY) && (rulZ < _ulCtGridsZ));
 }
 
-inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned long ulFacetIndex, float /*fEpsilon*/)
+inline void MeshFacetGrid::FacetCells (const MeshGeomFacet &rclFacet, std::vector<unsigned long> &raulCells) const
 {
-#if 0
-  unsigned long  i, ulX, ulY, ulZ, ulX1, ulY1, ulZ1, ulX2, ulY2, ulZ2;
-  
-  ulX1 = ulY1 = ulZ1 = ULONG_MAX;
-  ulX2 = ulY2 = ulZ2 = 0;
-
-  for (i = 0; i < 3; i++)
-  {
-    Pos(rclFacet._aclPoints[i], ulX, ulY, ulZ);
-    _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
-    ulX1 = RSmin<unsigned long>(ulX1, ulX); ulY1 = RSmin<unsigned long>(ulY1, ulY); ulZ1 = RSmin<unsigned long>(ulZ1, ulZ);
-    ulX2 = RSmax<unsigned long>(ulX2, ulX); ulY2 = RSmax<unsigned long>(ulY2, ulY); ulZ2 = RSmax<unsigned long>(ulZ2, ulZ);
-  }
-  
-  // falls Facet ueber mehrere BB reicht
-  if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2))
-  {
-    for (ulX = ulX1; ulX <= ulX2; ulX++)
-    {
-      for (ulY = ulY1; ulY <= ulY2; ulY++)
-      {
-        for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++)
-        {
-          if (CMeshFacetFunc::BBoxContainFacet(GetBoundBox(ulX, ulY, ulZ), rclFacet) == true)
-            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
-        }
-      }
-    }
-  }
-#else
   unsigned long ulX, ulY, ulZ;
 
   unsigned long ulX1, ulY1, ulZ1, ulX2, ulY2, ulZ2;
@@ -476,22 +473,8 @@ inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned lon
   clBB.Add(rclFacet._aclPoints[1]);
   clBB.Add(rclFacet._aclPoints[2]);
 
-  //float fDiagonalLength = clBB.CalcDiagonalLength();
-
-  //clBB.Enlarge(fEpsilon*fDiagonalLength);
-
   Pos(Base::Vector3f(clBB.MinX,clBB.MinY,clBB.MinZ), ulX1, ulY1, ulZ1);
   Pos(Base::Vector3f(clBB.MaxX,clBB.MaxY,clBB.MaxZ), ulX2, ulY2, ulZ2);
-  
-  /*
-  if (ulX1 > 0) ulX1--;
-  if (ulY1 > 0) ulY1--;
-  if (ulZ1 > 0) ulZ1--;
-  
-  if (ulX2 < (_ulCtGridsX-1)) ulX2++;
-  if (ulY2 < (_ulCtGridsY-1)) ulY2++;
-  if (ulZ2 < (_ulCtGridsZ-1)) ulZ2++;
-  */
 
   // falls Facet ueber mehrere BB reicht
   if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2))
@@ -503,15 +486,13 @@ inline void MeshFacetGrid::AddFacet (const MeshGeomFacet &rclFacet, unsigned lon
         for (ulZ = ulZ1; ulZ <= ulZ2; ulZ++)
         {
           if ( rclFacet.IntersectBoundingBox( GetBoundBox(ulX, ulY, ulZ) ) )
-            _aulGrid[ulX][ulY][ulZ].insert(ulFacetIndex);
+            raulCells.push_back(CellIndex(ulX, ulY, ulZ));
         }
       }
     }
   }
   else
-    _aulGrid[ulX1][ulY1][ulZ1].insert(ulFacetIndex);
-
-#endif
+    raulCells.push_back(CellIndex(ulX1, ulY1, ulZ1));
 }
 
 } // namespace MeshCore
@@ -49,6 +49,11 @@
 #include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
+#include <unordered_map>
+
+#include <QFile>
+#include <QThread>
+#include <QtConcurrentMap>
 
 
 using namespace MeshCore;
@@ -80,6 +85,14 @@ char *ltrim (char *psz)
     return psz;
 }
 
+// Checks the beginning of the facet data for keywords of an ASCII STL file
+static bool hasAsciiSTLKeywords(char* szBuf)
+{
+    upper(szBuf);
+    return (strstr(szBuf, "SOLID") != NULL)  || (strstr(szBuf, "FACET") != NULL)    || (strstr(szBuf, "NORMAL") != NULL) ||
+           (strstr(szBuf, "VERTEX") != NULL) || (strstr(szBuf, "ENDFACET") != NULL) || (strstr(szBuf, "ENDLOOP") != NULL);
+}
+
 std::string& upper(std::string& str)
 {
     for (std::string::iterator it = str.begin(); it != str.end(); ++it)
@@ -169,7 +182,11 @@ bool MeshInput::LoadAny(const char* FileName)
         // read file
         bool ok = false;
         if (fi.hasExtension("stl") || fi.hasExtension("ast")) {
-            ok = LoadSTL(str);
+            // binary STL files are read directly from the mapped file
+            bool mapped = false;
+            ok = LoadMappedBinarySTL(FileName, mapped);
+            if (!mapped)
+                ok = LoadSTL(str);
         }
         else if (fi.hasExtension("iv")) {
             ok = LoadInventor( str );
@@ -254,11 +271,9 @@ bool MeshInput::LoadSTL (std::istream &rstrIn)
     if (!rstrIn.read(szBuf, ulBytes))
         return (ulCt==0);
     szBuf[ulBytes] = 0;
-    upper(szBuf);
 
     try {
-        if ((strstr(szBuf, "SOLID") == NULL)  && (strstr(szBuf, "FACET") == NULL)    && (strstr(szBuf, "NORMAL") == NULL) &&
-            (strstr(szBuf, "VERTEX") == NULL) && (strstr(szBuf, "ENDFACET") == NULL) && (strstr(szBuf, "ENDLOOP") == NULL)) {
+        if (!hasAsciiSTLKeywords(szBuf)) {
             // probably binary STL
             buf->pubseekoff(0, std::ios::beg, std::ios::in);
             return LoadBinarySTL(rstrIn);
@@ -1421,6 +1436,249 @@ bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
     return true;
 }
 
+namespace MeshCore {
+namespace STL {
+
+/// Vertex key of the hash based point merge
+struct VertexKey
+{
+    float x, y, z;
+
+    bool operator==(const VertexKey& rhs) const
+    {
+        return x == rhs.x && y == rhs.y && z == rhs.z;
+    }
+};
+
+struct VertexKeyHash
+{
+    std::size_t operator()(const VertexKey& k) const
+    {
+        uint32_t b[3];
+        std::memcpy(b, &k, sizeof(b));
+        uint64_t h = b[0];
+        h = h * 0x9E3779B97F4A7C15ULL + b[1];
+        h = h * 0x9E3779B97F4A7C15ULL + b[2];
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+};
+
+/// Runs \a func for all indices in [0, count) with the global thread pool
+template<typename Func>
+void parallelFor(std::size_t count, Func func)
+{
+    std::vector<std::size_t> items(count);
+    for (std::size_t i = 0; i < count; i++)
+        items[i] = i;
+    QtConcurrent::blockingMap(items, [&func](std::size_t& i) { func(i); });
+}
+
+/**
+ * The MappedReader class builds the mesh structure from a binary STL file that is
+ * completely in memory, e.g. mapped. Vertices are merged by a hash map that is split
+ * into buckets which are processed in parallel. Like MeshFastBuilder only points with
+ * identical coordinates are merged. The points are ordered by their first occurrence.
+ */
+class MappedReader
+{
+public:
+    MappedReader(const char* data, uint32_t ctFacets)
+      : data(data), ctFacets(ctFacets)
+    {
+        ctVerts = 3 * static_cast<std::size_t>(ctFacets);
+        // small files are not worth the overhead of threads
+        if (ctVerts < 300000)
+            threads = 1;
+        else
+            threads = static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+        buckets = threads > 1 ? 8 * threads : 1;
+    }
+
+    void Build(MeshPointArray& rPoints, MeshFacetArray& rFacets)
+    {
+        rFacets.clear();
+        rFacets.resize(ctFacets);
+        MergeVertices(rFacets);
+        NumberPoints(rPoints, rFacets);
+    }
+
+private:
+    VertexKey Vertex(std::size_t v) const
+    {
+        // 80 bytes header, 4 bytes count, 50 bytes per facet starting with the normal
+        VertexKey k;
+        std::memcpy(&k, data + 84 + 50 * (v / 3) + 12 + 12 * (v % 3), sizeof(k));
+        // treat -0.0 and 0.0 as equal
+        if (k.x == 0.0f) k.x = 0.0f;
+        if (k.y == 0.0f) k.y = 0.0f;
+        if (k.z == 0.0f) k.z = 0.0f;
+        return k;
+    }
+
+    std::size_t Bucket(const VertexKey& k) const
+    {
+        return VertexKeyHash()(k) % buckets;
+    }
+
+    std::size_t ChunkBegin(std::size_t c) const
+    {
+        return c * ctVerts / threads;
+    }
+
+    static unsigned long& Slot(MeshFacetArray& rFacets, std::size_t v)
+    {
+        return rFacets[v / 3]._aulPoints[v % 3];
+    }
+
+    /// Sets the point index of each vertex to the index of its first occurrence
+    void MergeVertices(MeshFacetArray& rFacets)
+    {
+        // count the vertices per chunk and bucket
+        std::vector<std::size_t> offsets(threads * buckets, 0);
+        parallelFor(threads, [&](std::size_t c) {
+            std::size_t* count = &offsets[c * buckets];
+            for (std::size_t v = ChunkBegin(c); v < ChunkBegin(c + 1); v++)
+                count[Bucket(Vertex(v))]++;
+        });
+
+        // make the counts to offsets so that each bucket keeps the vertex order
+        std::vector<std::size_t> bucketStart(buckets + 1, 0);
+        std::size_t pos = 0;
+        for (std::size_t b = 0; b < buckets; b++) {
+            bucketStart[b] = pos;
+            for (std::size_t c = 0; c < threads; c++) {
+                std::size_t ct = offsets[c * buckets + b];
+                offsets[c * buckets + b] = pos;
+                pos += ct;
+            }
+        }
+        bucketStart[buckets] = pos;
+
+        std::vector<unsigned long> order(ctVerts);
+        parallelFor(threads, [&](std::size_t c) {
+            std::size_t* offset = &offsets[c * buckets];
+            for (std::size_t v = ChunkBegin(c); v < ChunkBegin(c + 1); v++)
+                order[offset[Bucket(Vertex(v))]++] = static_cast<unsigned long>(v);
+        });
+
+        // each bucket owns a distinct set of coordinates
+        first.assign(ctVerts, 0);
+        parallelFor(buckets, [&](std::size_t b) {
+            std::unordered_map<VertexKey, unsigned long, VertexKeyHash> map;
+            map.reserve(bucketStart[b + 1] - bucketStart[b]);
+            for (std::size_t i = bucketStart[b]; i < bucketStart[b + 1]; i++) {
+                unsigned long v = order[i];
+                unsigned long rep = map.emplace(Vertex(v), v).first->second;
+                Slot(rFacets, v) = rep;
+                if (rep == v)
+                    first[v] = 1;
+            }
+        });
+    }
+
+    /// Creates the points and replaces the vertex references by point indices
+    void NumberPoints(MeshPointArray& rPoints, MeshFacetArray& rFacets)
+    {
+        std::vector<std::size_t> base(threads + 1, 0);
+        parallelFor(threads, [&](std::size_t c) {
+            std::size_t ct = 0;
+            for (std::size_t v = ChunkBegin(c); v < ChunkBegin(c + 1); v++)
+                ct += first[v];
+            base[c + 1] = ct;
+        });
+        for (std::size_t c = 0; c < threads; c++)
+            base[c + 1] += base[c];
+
+        rPoints.clear();
+        rPoints.resize(base[threads]);
+        parallelFor(threads, [&](std::size_t c) {
+            std::size_t index = base[c];
+            for (std::size_t v = ChunkBegin(c); v < ChunkBegin(c + 1); v++) {
+                if (first[v]) {
+                    VertexKey k = Vertex(v);
+                    rPoints[index].Set(k.x, k.y, k.z);
+                    Slot(rFacets, v) = static_cast<unsigned long>(index++);
+                }
+            }
+        });
+
+        // the first occurrences are numbered now, so the others can look them up
+        parallelFor(threads, [&](std::size_t c) {
+            for (std::size_t v = ChunkBegin(c); v < ChunkBegin(c + 1); v++) {
+                if (!first[v])
+                    Slot(rFacets, v) = Slot(rFacets, Slot(rFacets, v));
+            }
+        });
+
+        std::vector<unsigned char>().swap(first);
+    }
+
+private:
+    const char* data;
+    uint32_t ctFacets;
+    std::size_t ctVerts;
+    std::size_t threads;
+    std::size_t buckets;
+    std::vector<unsigned char> first;
+};
+
+}
+}
+
+/** Loads a binary STL file that is completely in memory. */
+bool MeshInput::LoadBinarySTL (const char* pData, std::size_t ulSize)
+{
+    if (!pData || ulSize < 84)
+        return false;
+
+    uint32_t ulCt = 0;
+    std::memcpy(&ulCt, pData + 80, sizeof(ulCt));
+
+    // compare the calculated with the read value
+    uint64_t ulFac = (ulSize - 84) / 50;
+    if (ulCt > ulFac)
+        return false;// not a valid STL file
+
+    MeshPointArray rPoints;
+    MeshFacetArray rFacets;
+    STL::MappedReader reader(pData, ulCt);
+    reader.Build(rPoints, rFacets);
+    _rclMesh.Adopt(rPoints, rFacets, true);
+
+    return true;
+}
+
+/** Maps a binary STL file into memory and loads it. If the file cannot be mapped
+ * or is an ASCII STL file false is returned and \a mapped is set to false.
+ */
+bool MeshInput::LoadMappedBinarySTL (const char* FileName, bool& mapped)
+{
+    mapped = false;
+    QFile file(QString::fromUtf8(FileName));
+    if (!file.open(QIODevice::ReadOnly) || file.size() < 84)
+        return false;
+
+    const char* data = reinterpret_cast<const char*>(file.map(0, file.size()));
+    if (!data)
+        return false;
+
+    std::size_t size = static_cast<std::size_t>(file.size());
+    uint32_t ulCt;
+    std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+    // see LoadSTL()
+    std::size_t ulBytes = ulCt > 1 ? 100 : 50;
+    char szBuf[200];
+    if (size >= 84 + ulBytes) {
+        std::memcpy(szBuf, data + 84, ulBytes);
+        szBuf[ulBytes] = 0;
+        if (hasAsciiSTLKeywords(szBuf))
+            return false;
+    }
+
+    mapped = true;
+    return LoadBinarySTL(data, size);
+}
+
 /** Loads the mesh object from an XML file. */
 void MeshInput::LoadXML (Base::XMLReader &reader)
 {
@@ -1847,6 +2105,10 @@ bool MeshOutput::SaveAny(const char* FileName, MeshIO::Format format) const
         fileformat = GetFormat(FileName);
     }
 
+    // binary STL files are written directly to the mapped file
+    if (fileformat == MeshIO::BSTL && SaveMappedBinarySTL(FileName))
+        return true;
+
     Base::ofstream str(file, std::ios::out | std::ios::binary);
 
     if (fileformat == MeshIO::BMS) {
@@ -2095,6 +2357,75 @@ bool MeshOutput::SaveBinarySTL (std::ostream &rstrOut) const
     return true;
 }
 
+/** Saves the mesh object as binary STL into a buffer of at least 84 + 50 * CountFacets() bytes. */
+bool MeshOutput::SaveBinarySTL (char* pData, std::size_t ulSize) const
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    std::size_t ctFacets = rFacets.size();
+    if (!pData || ulSize < 84 + 50 * ctFacets)
+        return false;
+
+    // stl_header has a length of 80
+    std::memset(pData, ' ', 80);
+    std::memcpy(pData, stl_header.c_str(), std::min<std::size_t>(80, stl_header.size()));
+
+    uint32_t uCtFts = (uint32_t)ctFacets;
+    std::memcpy(pData + 80, &uCtFts, sizeof(uCtFts));
+
+    // the facets are written to disjoint parts of the buffer
+    std::size_t threads = ctFacets < 100000 ? 1 : static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    STL::parallelFor(threads, [&](std::size_t c) {
+        std::size_t end = (c + 1) * ctFacets / threads;
+        for (std::size_t i = c * ctFacets / threads; i < end; i++) {
+            const MeshFacet& rFace = rFacets[i];
+            MeshGeomFacet clFacet(rPoints[rFace._aulPoints[0]],
+                                  rPoints[rFace._aulPoints[1]],
+                                  rPoints[rFace._aulPoints[2]]);
+            if (apply_transform)
+                clFacet.Transform(_transform);
+
+            float buf[12];
+            Base::Vector3f normal = clFacet.GetNormal();
+            buf[0] = normal.x; buf[1] = normal.y; buf[2] = normal.z;
+            for (int j = 0; j < 3; j++) {
+                buf[3*j+3] = clFacet._aclPoints[j].x;
+                buf[3*j+4] = clFacet._aclPoints[j].y;
+                buf[3*j+5] = clFacet._aclPoints[j].z;
+            }
+
+            char* facet = pData + 84 + 50 * i;
+            std::memcpy(facet, buf, sizeof(buf));
+            // attribute
+            facet[48] = 0;
+            facet[49] = 0;
+        }
+    });
+
+    return true;
+}
+
+/** Maps the file into memory and saves the mesh object as binary STL. If the file
+ * cannot be mapped false is returned.
+ */
+bool MeshOutput::SaveMappedBinarySTL (const char* FileName) const
+{
+    qint64 size = 84 + 50 * static_cast<qint64>(_rclMesh.CountFacets());
+    QFile file(QString::fromUtf8(FileName));
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return false;
+    if (!file.resize(size))
+        return false;
+
+    char* data = reinterpret_cast<char*>(file.map(0, size));
+    if (!data)
+        return false;
+
+    bool ok = SaveBinarySTL(data, static_cast<std::size_t>(size));
+    file.unmap(reinterpret_cast<uchar*>(data));
+    return ok;
+}
+
 /** Saves an OBJ file. */
 bool MeshOutput::SaveOBJ (std::ostream &out) const
 {
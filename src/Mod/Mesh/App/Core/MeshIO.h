@@ -108,6 +108,12 @@ public:
     bool LoadAsciiSTL (std::istream &rstrIn);
     /** Loads a binary STL file. */
     bool LoadBinarySTL (std::istream &rstrIn);
+    /** Loads a binary STL file that is completely in memory. The vertices are merged in parallel. */
+    bool LoadBinarySTL (const char* pData, std::size_t ulSize);
+    /** Maps a binary STL file into memory and loads it. \a mapped is false if the file
+     * cannot be mapped or is an ASCII STL file.
+     */
+    bool LoadMappedBinarySTL (const char* FileName, bool& mapped);
     /** Loads an OBJ Mesh file. */
     bool LoadOBJ (std::istream &rstrIn);
     /** Loads the materials of an OBJ file. */
@@ -174,6 +180,12 @@ public:
     bool SaveAsciiSTL (std::ostream &rstrOut) const;
     /** Saves the mesh object into a binary STL file. */
     bool SaveBinarySTL (std::ostream &rstrOut) const;
+    /** Saves the mesh object as binary STL into a buffer of at least 84 + 50 * CountFacets() bytes.
+     * The facets are written in parallel.
+     */
+    bool SaveBinarySTL (char* pData, std::size_t ulSize) const;
+    /** Saves the mesh object into a binary STL file that is mapped into memory. */
+    bool SaveMappedBinarySTL (const char* FileName) const;
     /** Saves the mesh object into an OBJ file. */
     bool SaveOBJ (std::ostream &rstrOut) const;
     /** Saves the materials of an OBJ file. */
@@ -100,6 +100,30 @@ void MeshKernel::Adopt(MeshPointArray& rPoints, MeshFacetArray& rFacets, bool ch
         RebuildNeighbours();
 }
 
+void MeshKernel::Adopt(MeshCompactPointArray& rPoints, MeshCompactFacetArray& rFacets, bool checkNeighbourHood)
+{
+    MeshPointArray points;
+    rPoints.CopyTo(points);
+    rPoints.clear();
+
+    MeshFacetArray facets;
+    rFacets.CopyTo(facets);
+    rFacets.clear();
+
+    Adopt(points, facets, checkNeighbourHood);
+}
+
+void MeshKernel::Compact(MeshCompactPointArray& rPoints, MeshCompactFacetArray& rFacets)
+{
+    rPoints.Assign(_aclPointArray);
+    MeshPointArray().swap(_aclPointArray);
+
+    rFacets.Assign(_aclFacetArray);
+    MeshFacetArray().swap(_aclFacetArray);
+
+    _clBoundBox.SetVoid();
+}
+
 void MeshKernel::Swap(MeshKernel& mesh)
 {
     this->_aclPointArray.swap(mesh._aclPointArray);
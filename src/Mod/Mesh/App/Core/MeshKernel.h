@@ -395,6 +395,14 @@ public:
      * Especially for huge meshes this saves memory and increases speed.
      */
     void Adopt(MeshPointArray& rPoints, MeshFacetArray& rFaces, bool checkNeighbourHood=false);
+    /** Expands the compact arrays into the mesh structure. The compact arrays are cleared
+     * element group by element group to keep the peak memory low.
+     */
+    void Adopt(MeshCompactPointArray& rPoints, MeshCompactFacetArray& rFaces, bool checkNeighbourHood=false);
+    /** Moves the mesh structure into the compact arrays and clears the kernel afterwards.
+     * This is useful to keep huge meshes in memory that are not edited for a while.
+     */
+    void Compact(MeshCompactPointArray& rPoints, MeshCompactFacetArray& rFaces);
     /// Swaps the content of this kernel and \a mesh
     void Swap(MeshKernel& mesh);
     /// Transform the data structure with the given transformation matrix.
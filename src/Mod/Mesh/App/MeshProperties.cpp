@@ -451,6 +451,7 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
     // before calling hasSetValue()
     Base::Reference<MeshObject> tmp(_meshObject);
     aboutToSetValue();
+    _LazyFile.reset();
     _meshObject = mesh;
     hasSetValue();
 }
@@ -458,6 +459,7 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
+    _LazyFile.reset();
     *_meshObject = mesh;
     hasSetValue();
 }
@@ -465,12 +467,14 @@ void PropertyMeshKernel::setValue(const MeshObject& mesh)
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    _LazyFile.reset();
     _meshObject->setKernel(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
+    loadDocFile();
     aboutToSetValue();
     _meshObject->swap(mesh);
     hasSetValue();
@@ -478,6 +482,7 @@ void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
+    loadDocFile();
     aboutToSetValue();
     _meshObject->swap(mesh);
     hasSetValue();
@@ -485,21 +490,25 @@ void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 
 const MeshObject& PropertyMeshKernel::getValue(void)const 
 {
+    loadDocFile();
     return *_meshObject;
 }
 
 const MeshObject* PropertyMeshKernel::getValuePtr(void)const 
 {
+    loadDocFile();
     return (MeshObject*)_meshObject;
 }
 
 const Data::ComplexGeoData* PropertyMeshKernel::getComplexData() const
 {
+    loadDocFile();
     return (MeshObject*)_meshObject;
 }
 
 Base::BoundBox3d PropertyMeshKernel::getBoundingBox() const
 {
+    loadDocFile();
     return _meshObject->getBoundBox();
 }
 
@@ -507,12 +516,15 @@ unsigned int PropertyMeshKernel::getMemSize (void) const
 {
     unsigned int size = 0;
     size += _meshObject->getMemSize();
+    size += _CompactPoints.GetMemSize();
+    size += _CompactFacets.GetMemSize();
     
     return size;
 }
 
 MeshObject* PropertyMeshKernel::startEditing()
 {
+    loadDocFile();
     aboutToSetValue();
     return (MeshObject*)_meshObject;
 }
@@ -524,6 +536,7 @@ void PropertyMeshKernel::finishEditing()
 
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
+    loadDocFile();
     aboutToSetValue();
     _meshObject->transformGeometry(rclMat);
     hasSetValue();
@@ -531,6 +544,7 @@ void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 
 void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned long, Base::Vector3f> >& inds)
 {
+    loadDocFile();
     aboutToSetValue();
     MeshCore::MeshKernel& kernel = _meshObject->getKernel();
     for (std::vector<std::pair<unsigned long, Base::Vector3f> >::const_iterator it = inds.begin(); it != inds.end(); ++it)
@@ -540,6 +554,7 @@ void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned lo
 
 PyObject *PropertyMeshKernel::getPyObject(void)
 {
+    loadDocFile();
     if (!meshPyObject) {
         meshPyObject = new MeshPy(&*_meshObject);
         meshPyObject->setConst(); // set immutable
@@ -576,6 +591,9 @@ void PropertyMeshKernel::setPyObject(PyObject *value)
 void PropertyMeshKernel::Save (Base::Writer &writer) const
 {
     if (writer.isForceXML()) {
+        if (_LazyFile)
+            _LazyFile->load();
+        adoptCompactMesh();
         writer.Stream() << writer.ind() << "<Mesh>" << std::endl;
         MeshCore::MeshOutput saver(_meshObject->getKernel());
         saver.SaveXML(writer);
@@ -614,29 +632,77 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
 
 void PropertyMeshKernel::SaveDocFile (Base::Writer &writer) const
 {
+    // don't write an empty mesh if the file couldn't be read
+    if (_LazyFile)
+        _LazyFile->load();
+    adoptCompactMesh();
     _meshObject->save(writer.Stream());
 }
 
 void PropertyMeshKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    _LazyFile.reset();
     _meshObject->load(reader);
     hasSetValue();
 }
 
+bool PropertyMeshKernel::RestoreDocFileLazily(const std::shared_ptr<Base::LazyDocFile>& file)
+{
+    // read the mesh without notification as it only becomes visible now
+    file->setRestoreFunction([this](Base::Reader& reader) {
+        this->_meshObject->load(reader);
+    });
+    _LazyFile = file;
+    return true;
+}
+
+void PropertyMeshKernel::loadDocFile() const
+{
+    if (_LazyFile && !_LazyFile->isLoaded()) {
+        try {
+            _LazyFile->load();
+        }
+        catch (const Base::Exception&) {
+            // already reported, keep the data empty
+        }
+    }
+    adoptCompactMesh();
+}
+
+void PropertyMeshKernel::adoptCompactMesh() const
+{
+    if (!_CompactPoints.empty() || !_CompactFacets.empty()) {
+        _meshObject->getKernel().Adopt(_CompactPoints, _CompactFacets);
+    }
+}
+
 App::Property *PropertyMeshKernel::Copy(void) const
 {
+    loadDocFile();
     // Note: Copy the content, do NOT reference the same mesh object
     PropertyMeshKernel *prop = new PropertyMeshKernel();
     *(prop->_meshObject) = *(this->_meshObject);
+    prop->_meshObject->getKernel().Compact(prop->_CompactPoints, prop->_CompactFacets);
     return prop;
 }
 
 void PropertyMeshKernel::Paste(const App::Property &from)
 {
     // Note: Copy the content, do NOT reference the same mesh object
-    aboutToSetValue();
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
+    if (prop._LazyFile)
+        prop.loadDocFile();
+    aboutToSetValue();
+    _LazyFile.reset();
+    _CompactPoints.clear();
+    _CompactFacets.clear();
     *(this->_meshObject) = *(prop._meshObject);
+    if (!prop._CompactPoints.empty() || !prop._CompactFacets.empty()) {
+        // expand a copy and keep the pasted property compact, e.g. for redo
+        MeshCore::MeshCompactPointArray points(prop._CompactPoints);
+        MeshCore::MeshCompactFacetArray facets(prop._CompactFacets);
+        _meshObject->getKernel().Adopt(points, facets);
+    }
     hasSetValue();
 }
@@ -244,14 +244,29 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool RestoreDocFileLazily(const std::shared_ptr<Base::LazyDocFile>&);
+    /// Large meshes are saved notably faster with little loss of compression
+    DocFileCompression getDocFileCompression() const {
+        return FastCompression;
+    }
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
     //@}
 
+private:
+    /// read the mesh if its restore has been deferred
+    void loadDocFile() const;
+    /// expand the mesh of a copy that is kept in the compact arrays
+    void adoptCompactMesh() const;
+
 private:
     Base::Reference<MeshObject> _meshObject;
     MeshPy* meshPyObject;
+    std::shared_ptr<Base::LazyDocFile> _LazyFile;
+    // copies mostly live in the undo/redo stack, they keep the mesh compact until it is used
+    mutable MeshCore::MeshCompactPointArray _CompactPoints;
+    mutable MeshCore::MeshCompactFacetArray _CompactFacets;
 };
 
 } // namespace Mesh
@@ -230,3 +230,66 @@ class PolynomialFitCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+
+class BinarySTLCases(unittest.TestCase):
+    def setUp(self):
+        self.fileName = tempfile.gettempdir() + os.sep + "binary_mesh.stl"
+
+    def testRoundTrip(self):
+        # a fine sphere to exceed the limit of the parallel merge
+        mesh = Mesh.createSphere(10.0, 300)
+        mesh.write(self.fileName)
+        self.assertEqual(os.path.getsize(self.fileName), 84 + 50 * mesh.CountFacets)
+
+        copy = Mesh.Mesh(self.fileName)
+        self.assertEqual(copy.CountPoints, mesh.CountPoints)
+        self.assertEqual(copy.CountFacets, mesh.CountFacets)
+        self.assertTrue(copy.isSolid())
+        self.assertAlmostEqual(copy.Volume, mesh.Volume, 3)
+
+    def testEmptyMesh(self):
+        Mesh.Mesh().write(self.fileName)
+        self.assertEqual(os.path.getsize(self.fileName), 84)
+        self.assertEqual(Mesh.Mesh(self.fileName).CountFacets, 0)
+
+    def tearDown(self):
+        os.remove(self.fileName)
+
+
+class CompactMeshCases(unittest.TestCase):
+    """The undo/redo copies keep the mesh in the compact arrays"""
+    def setUp(self):
+        self.doc = FreeCAD.newDocument("CompactMeshTest")
+        self.doc.UndoMode = 1
+
+    def meshData(self, mesh):
+        points, facets = mesh.Topology
+        return points, facets, [f.NeighbourIndices for f in mesh.Facets]
+
+    def testUndoRedo(self):
+        # an open mesh to have facets without neighbours
+        mesh = Mesh.createSphere(10.0, 50)
+        mesh.removeFacets(list(range(0, mesh.CountFacets, 7)))
+        self.assertFalse(mesh.isSolid())
+        original = self.meshData(mesh)
+
+        self.doc.openTransaction("Create")
+        feature = self.doc.addObject("Mesh::Feature", "Mesh")
+        feature.Mesh = mesh
+        self.doc.commitTransaction()
+
+        self.doc.openTransaction("Modify")
+        feature.Mesh = Mesh.createBox(1.0, 2.0, 3.0)
+        self.doc.commitTransaction()
+        modified = self.meshData(feature.Mesh)
+
+        self.doc.undo()
+        self.assertEqual(self.meshData(feature.Mesh), original)
+        self.doc.redo()
+        self.assertEqual(self.meshData(feature.Mesh), modified)
+        self.doc.undo()
+        self.assertEqual(self.meshData(feature.Mesh), original)
+
+    def tearDown(self):
+        FreeCAD.closeDocument("CompactMeshTest")
@@ -29,6 +29,7 @@
 #include <Base/Tools.h>
 #include <Mod/Mesh/App/Mesh.h>
 #include <Mod/Part/App/TopoShape.h>
+#include <Mod/Part/App/Tessellator.h>
 
 #include <TopoDS_Shape.hxx>
 #include <BRepTools.hxx>
@@ -188,6 +189,8 @@ Mesh::MeshObject* Mesher::createMesh() const
     // OCC standard mesher
     if (method == Standard) {
         if (!shape.IsNull()) {
+            // a background job may still mesh the faces
+            Part::Tessellator::waitForDone();
             BRepTools::Clean(shape);
             BRepMesh_IncrementalMesh aMesh(shape, deflection, relative, angularDeflection);
         }
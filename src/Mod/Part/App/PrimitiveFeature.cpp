@@ -102,6 +102,13 @@ short Primitive::mustExecute(void) const
     return Feature::mustExecute();
 }
 
+bool Primitive::canRecomputeConcurrently() const
+{
+    // The shape is built from the own properties only, but attaching it
+    // reads the support shapes through the (not thread safe) shape cache
+    return Support.getSize() == 0;
+}
+
 App::DocumentObjectExecReturn* Primitive::execute(void) {
     return Part::Feature::execute();
 }
@@ -44,6 +44,7 @@ public:
     /// recalculate the feature
     App::DocumentObjectExecReturn *execute(void) override;
     short mustExecute() const override;
+    bool canRecomputeConcurrently() const override;
     PyObject* getPyObject() override;
     //@}
 
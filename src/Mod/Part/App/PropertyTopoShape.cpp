@@ -85,6 +85,7 @@ PropertyPartShape::~PropertyPartShape()
 void PropertyPartShape::setValue(const TopoShape& sh)
 {
     aboutToSetValue();
+    _LazyFile.reset();
     _Shape = sh;
     hasSetValue();
 }
@@ -92,27 +93,32 @@ void PropertyPartShape::setValue(const TopoShape& sh)
 void PropertyPartShape::setValue(const TopoDS_Shape& sh)
 {
     aboutToSetValue();
+    _LazyFile.reset();
     _Shape.setShape(sh);
     hasSetValue();
 }
 
 const TopoDS_Shape& PropertyPartShape::getValue(void)const
 {
+    loadDocFile();
     return _Shape.getShape();
 }
 
 const TopoShape& PropertyPartShape::getShape() const
 {
+    loadDocFile();
     return this->_Shape;
 }
 
 const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 {
+    loadDocFile();
     return &(this->_Shape);
 }
 
 Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 {
+    loadDocFile();
     Base::BoundBox3d box;
     if (_Shape.getShape().IsNull())
         return box;
@@ -139,6 +145,7 @@ Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 
 void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 {
+    loadDocFile();
     aboutToSetValue();
     _Shape.transformGeometry(rclTrf);
     hasSetValue();
@@ -146,6 +153,7 @@ void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 
 PyObject *PropertyPartShape::getPyObject(void)
 {
+    loadDocFile();
     Base::PyObjectBase* prop;
     const TopoDS_Shape& sh = _Shape.getShape();
     if (sh.IsNull()) {
@@ -205,6 +213,7 @@ void PropertyPartShape::setPyObject(PyObject *value)
 
 App::Property *PropertyPartShape::Copy(void) const
 {
+    loadDocFile();
     PropertyPartShape *prop = new PropertyPartShape();
     prop->_Shape = this->_Shape;
     if (!_Shape.getShape().IsNull()) {
@@ -217,8 +226,11 @@ App::Property *PropertyPartShape::Copy(void) const
 
 void PropertyPartShape::Paste(const App::Property &from)
 {
+    const PropertyPartShape& prop = dynamic_cast<const PropertyPartShape&>(from);
+    prop.loadDocFile();
     aboutToSetValue();
-    _Shape = dynamic_cast<const PropertyPartShape&>(from)._Shape;
+    _LazyFile.reset();
+    _Shape = prop._Shape;
     hasSetValue();
 }
 
@@ -315,6 +327,9 @@ static Standard_Boolean  BRepTools_Write(const TopoDS_Shape& Sh, const Standard_
 
 void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
 {
+    // don't write an empty shape if the file couldn't be read
+    if (_LazyFile)
+        _LazyFile->load();
     // If the shape is empty we simply store nothing. The file size will be 0 which
     // can be checked when reading in the data.
     if (_Shape.getShape().IsNull())
@@ -383,12 +398,39 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
 }
 
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
+{
+    setValue(readDocFile(reader));
+}
+
+bool PropertyPartShape::RestoreDocFileLazily(const std::shared_ptr<Base::LazyDocFile>& file)
+{
+    // read the shape without notification as it only becomes visible now
+    file->setRestoreFunction([this](Base::Reader& reader) {
+        this->_Shape = readDocFile(reader);
+    });
+    _LazyFile = file;
+    return true;
+}
+
+void PropertyPartShape::loadDocFile() const
+{
+    if (_LazyFile && !_LazyFile->isLoaded()) {
+        try {
+            _LazyFile->load();
+        }
+        catch (const Base::Exception&) {
+            // already reported, keep the data empty
+        }
+    }
+}
+
+TopoShape PropertyPartShape::readDocFile(Base::Reader &reader) const
 {
     Base::FileInfo brep(reader.getFileName());
     if (brep.hasExtension("bin")) {
         TopoShape shape;
         shape.importBinary(reader);
-        setValue(shape);
+        return shape;
     }
     else {
         bool direct = App::GetApplication().GetParameterGroupByPath
@@ -432,13 +474,13 @@ void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 
             // delete the temp file
             fi.deleteFile();
-            setValue(shape);
+            return TopoShape(shape);
         }
         else {
             BRep_Builder builder;
             TopoDS_Shape shape;
             BRepTools::Read(shape, reader, builder);
-            setValue(shape);
+            return TopoShape(shape);
         }
     }
 }
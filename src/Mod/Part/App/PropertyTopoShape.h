@@ -82,6 +82,7 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool RestoreDocFileLazily(const std::shared_ptr<Base::LazyDocFile>&);
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
@@ -91,8 +92,14 @@ public:
     /// Get valid paths for this property; used by auto completer
     virtual void getPaths(std::vector<App::ObjectIdentifier> & paths) const;
 
+private:
+    /// read the shape if its restore has been deferred
+    void loadDocFile() const;
+    TopoShape readDocFile(Base::Reader &reader) const;
+
 private:
     TopoShape _Shape;
+    std::shared_ptr<Base::LazyDocFile> _LazyFile;
 };
 
 struct PartExport ShapeHistory {
@@ -0,0 +1,248 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD Developers                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <map>
+# include <mutex>
+# include <tuple>
+# include <vector>
+# include <Bnd_Box.hxx>
+# include <BRepBndLib.hxx>
+# include <BRepMesh_IncrementalMesh.hxx>
+# include <BRep_Tool.hxx>
+# include <Poly_Triangulation.hxx>
+# include <TopExp_Explorer.hxx>
+# include <TopLoc_Location.hxx>
+# include <TopoDS.hxx>
+# include <TopoDS_Face.hxx>
+# include <TopoDS_TShape.hxx>
+#endif
+
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "Tessellator.h"
+
+using namespace Part;
+
+namespace {
+
+class TessellationTask : public QRunnable
+{
+public:
+    TessellationTask(const TopoDS_Shape &shape, double deflection, double angularDeflection)
+        : shape(shape), deflection(deflection), angularDeflection(angularDeflection)
+    {
+        result = promise.get_future().share();
+        finished = finishedPromise.get_future().share();
+    }
+
+    virtual void run() override
+    {
+        try {
+            BRepMesh_IncrementalMesh aMesh(shape, deflection,
+                                           /*isRelative*/ Standard_False,
+                                           angularDeflection,
+                                           /*isInParallel*/ Standard_True);
+            promise.set_value();
+        }
+        catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+        finishedPromise.set_value();
+    }
+
+    TopoDS_Shape shape;
+    double deflection;
+    double angularDeflection;
+    std::promise<void> promise;
+    std::promise<void> finishedPromise;
+    Tessellator::Future result;
+    Tessellator::Future finished;
+};
+
+typedef std::tuple<const TopoDS_TShape*, double, double> TessellationKey;
+
+const TopoDS_TShape *getTShape(const TopoDS_Shape &shape)
+{
+    return shape.TShape().operator->();
+}
+
+struct TessellationEntry
+{
+    // Keeps the TShape of the key alive, so that its address is not reused
+    Handle(TopoDS_TShape) shape;
+    Tessellator::Future result;
+    unsigned long age;
+};
+
+const std::size_t MaxTessellationEntries = 1024;
+
+std::mutex TessellationMutex;
+std::map<TessellationKey, TessellationEntry> TessellationCache;
+// Signals the end of the job that was requested last, whether it succeeded or not
+Tessellator::Future LastTessellation;
+unsigned long TessellationAge = 0;
+
+QThreadPool *tessellationPool()
+{
+    static QThreadPool *pool;
+    if (!pool) {
+        pool = new QThreadPool;
+        // Shapes may share faces, so only mesh one shape at a time
+        pool->setMaxThreadCount(1);
+    }
+    return pool;
+}
+
+bool isReady(const Tessellator::Future &future)
+{
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool hasFailed(const Tessellator::Future &future)
+{
+    try {
+        future.get();
+        return false;
+    }
+    catch (...) {
+        return true;
+    }
+}
+
+// Check that the triangulation has neither been removed since, e.g. by
+// BRepTools::Clean(), nor been replaced by a coarser one. Like BRepMesh, accept
+// a triangulation that is up to 10% coarser than requested.
+bool isMeshed(const TopoDS_Shape &shape, double deflection)
+{
+    TopLoc_Location loc;
+    for (TopExp_Explorer xp(shape, TopAbs_FACE); xp.More(); xp.Next()) {
+        Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(xp.Current()), loc);
+        if (mesh.IsNull() || mesh->Deflection() > 1.1 * deflection)
+            return false;
+    }
+    return true;
+}
+
+void pruneTessellationCache()
+{
+    if (TessellationCache.size() <= MaxTessellationEntries)
+        return;
+
+    std::vector<std::pair<unsigned long, TessellationKey> > finished;
+    for (auto &v : TessellationCache) {
+        if (isReady(v.second.result))
+            finished.emplace_back(v.second.age, v.first);
+    }
+    std::sort(finished.begin(), finished.end());
+    for (auto &v : finished) {
+        if (TessellationCache.size() <= MaxTessellationEntries/2)
+            break;
+        TessellationCache.erase(v.second);
+    }
+}
+
+} // namespace
+
+Tessellator::Future Tessellator::meshAsync(const TopoDS_Shape &shape, double deflection,
+                                           double angularDeflection)
+{
+    if (shape.IsNull()) {
+        std::promise<void> done;
+        done.set_value();
+        return done.get_future().share();
+    }
+
+    std::lock_guard<std::mutex> lock(TessellationMutex);
+
+    TessellationKey key(getTShape(shape), deflection, angularDeflection);
+    auto it = TessellationCache.find(key);
+    if (it != TessellationCache.end()) {
+        if (!isReady(it->second.result))
+            return it->second.result;
+        // The faces can only be looked at while no job is meshing, as they may
+        // be shared with the shape of that job. Otherwise queue the shape again,
+        // BRepMesh skips the faces that are still meshed.
+        if (isReady(LastTessellation) && !hasFailed(it->second.result) && isMeshed(shape, deflection)) {
+            it->second.age = ++TessellationAge;
+            return it->second.result;
+        }
+        TessellationCache.erase(it);
+    }
+
+    TessellationTask *task = new TessellationTask(shape, deflection, angularDeflection);
+    TessellationEntry &entry = TessellationCache[key];
+    entry.shape = shape.TShape();
+    entry.result = task->result;
+    entry.age = ++TessellationAge;
+    LastTessellation = task->finished;
+    Future result = task->result;
+    tessellationPool()->start(task);
+
+    pruneTessellationCache();
+    return result;
+}
+
+void Tessellator::mesh(const TopoDS_Shape &shape, double deflection, double angularDeflection)
+{
+    Future result = meshAsync(shape, deflection, angularDeflection);
+    result.get();
+}
+
+void Tessellator::waitForDone()
+{
+    Future last;
+    {
+        std::lock_guard<std::mutex> lock(TessellationMutex);
+        last = LastTessellation;
+    }
+    if (last.valid())
+        last.wait();
+}
+
+void Tessellator::clear()
+{
+    std::lock_guard<std::mutex> lock(TessellationMutex);
+
+    for (auto it = TessellationCache.begin(); it != TessellationCache.end();) {
+        if (isReady(it->second.result))
+            it = TessellationCache.erase(it);
+        else
+            ++it;
+    }
+}
+
+double Tessellator::getDeflection(const TopoDS_Shape &shape, double deviation)
+{
+    Bnd_Box bounds;
+    BRepBndLib::Add(shape.Located(TopLoc_Location()), bounds);
+    bounds.SetGap(0.0);
+    if (bounds.IsVoid())
+        return deviation;
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    return ((xMax-xMin)+(yMax-yMin)+(zMax-zMin))/300.0 * deviation;
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD Developers                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef PART_TESSELLATOR_H
+#define PART_TESSELLATOR_H
+
+#include <future>
+#include <TopoDS_Shape.hxx>
+
+namespace Part {
+
+/** Tessellation service for shapes.
+ *
+ * BRepMesh_IncrementalMesh stores the triangulation in the faces of a shape,
+ * so all instances of a shape that only differ by their TopLoc_Location share
+ * it. The service remembers which TShape has been meshed with which
+ * deflection, and skips meshing it again for any of its instances as long
+ * as its faces still have a triangulation that is fine enough.
+ *
+ * Meshing runs on a background thread. BRepMesh itself meshes the faces in
+ * parallel, while the jobs are run one at a time in the order they were
+ * requested, because different shapes may share faces. Hence once the future
+ * of a job is ready, the triangulation of all previously requested shapes can
+ * be read, too.
+ */
+class PartExport Tessellator
+{
+public:
+    typedef std::shared_future<void> Future;
+
+    /** Start meshing \a shape in the background and return immediately.
+     * The future rethrows any exception raised by the mesher.
+     */
+    static Future meshAsync(const TopoDS_Shape &shape, double deflection,
+                            double angularDeflection = 0.5);
+    /// Mesh \a shape, or wait until the pending meshing of it has finished
+    static void mesh(const TopoDS_Shape &shape, double deflection,
+                     double angularDeflection = 0.5);
+    /** Wait until all pending jobs have finished. Call it before removing the
+     * triangulation of a shape, e.g. with BRepTools::Clean(), as a pending job
+     * may mesh the same faces.
+     */
+    static void waitForDone();
+    /// Forget all meshed shapes
+    static void clear();
+
+    /** Deflection for a deviation relative to the size of \a shape.
+     * The size is measured without the location of \a shape, so that all
+     * instances of a shape get the same deflection.
+     */
+    static double getDeflection(const TopoDS_Shape &shape, double deviation);
+};
+
+} //namespace Part
+
+
+#endif // PART_TESSELLATOR_H
@@ -201,6 +201,7 @@
 #include "ProgressIndicator.h"
 #include "modelRefine.h"
 #include "Tools.h"
+#include "Tessellator.h"
 #include "encodeFilename.h"
 #include "FaceMakerBullseye.h"
 #include "BRepOffsetAPI_MakeOffsetFix.h"
@@ -969,10 +970,7 @@ void TopoShape::exportStl(const char *filename, double deflection) const
         writer.SetDeflection(deflection);
     }
 #else
-    BRepMesh_IncrementalMesh aMesh(this->_Shape, deflection,
-                                   /*isRelative*/ Standard_False,
-                                   /*theAngDeflection*/ 0.5,
-                                   /*isInParallel*/ true);
+    Tessellator::mesh(this->_Shape, deflection);
 #endif
     writer.Write(this->_Shape,encodeFilename(filename).c_str());
 }
@@ -991,10 +989,7 @@ void TopoShape::exportFaceSet(double dev, double ca,
     bool supportFaceColors = (numFaces == colors.size());
 
     std::size_t index=0;
-    BRepMesh_IncrementalMesh MESH(this->_Shape, dev,
-                                  /*isRelative*/ Standard_False,
-                                  /*theAngDeflection*/ 0.5,
-                                  /*isInParallel*/ true);
+    Tessellator::mesh(this->_Shape, dev);
     for (ex.Init(this->_Shape, TopAbs_FACE); ex.More(); ex.Next(), index++) {
         // get the shape and mesh it
         const TopoDS_Face& aFace = TopoDS::Face(ex.Current());
@@ -3317,10 +3312,7 @@ void TopoShape::getFaces(std::vector<Base::Vector3d> &aPoints,
         return;
 
     // get the meshes of all faces and then merge them
-    BRepMesh_IncrementalMesh aMesh(this->_Shape, accuracy,
-                                   /*isRelative*/ Standard_False,
-                                   /*theAngDeflection*/ 0.5,
-                                   /*isInParallel*/ true);
+    Tessellator::mesh(this->_Shape, accuracy);
     std::vector<Domain> domains;
     getDomains(domains);
 
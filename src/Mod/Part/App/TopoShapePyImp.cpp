@@ -24,7 +24,6 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <sstream>
-# include <BRepMesh_IncrementalMesh.hxx>
 # include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBuilderAPI_Sewing.hxx>
 # include <BRepBuilderAPI_Transform.hxx>
@@ -84,6 +83,7 @@
 #include <Mod/Part/App/TopoShapePy.cpp>
 
 #include "OCCError.h"
+#include "Tessellator.h"
 #include <Mod/Part/App/GeometryPy.h>
 #include <Mod/Part/App/TopoShapeFacePy.h>
 #include <Mod/Part/App/TopoShapeEdgePy.h>
@@ -306,7 +306,7 @@ PyObject* TopoShapePy::writeInventor(PyObject * args, PyObject * keywds)
     }
 
     std::stringstream result;
-    BRepMesh_IncrementalMesh(getTopoShapePtr()->getShape(),dev);
+    Tessellator::mesh(getTopoShapePtr()->getShape(),dev);
     if (mode == 0)
         getTopoShapePtr()->exportFaceSet(dev, angle, faceColors, result);
     else if (mode == 1)
@@ -1913,8 +1913,10 @@ PyObject* TopoShapePy::tessellate(PyObject *args)
             return 0;
         std::vector<Base::Vector3d> Points;
         std::vector<Data::ComplexGeoData::Facet> Facets;
-        if (PyObject_IsTrue(ok))
+        if (PyObject_IsTrue(ok)) {
+            Tessellator::waitForDone();
             BRepTools::Clean(getTopoShapePtr()->getShape());
+        }
         getTopoShapePtr()->getFaces(Points, Facets,tolerance);
         Py::Tuple tuple(2);
         Py::List vertex;
@@ -25,12 +25,9 @@
 
 #ifndef _PreComp_
 # include <sstream>
-# include <Bnd_Box.hxx>
 # include <Poly_Polygon3D.hxx>
-# include <BRepBndLib.hxx>
 # include <BRepBuilderAPI_MakeVertex.hxx>
 # include <BRepExtrema_DistShapeShape.hxx>
-# include <BRepMesh_IncrementalMesh.hxx>
 # include <BRep_Tool.hxx>
 # include <BRepTools.hxx>
 # include <BRepAdaptor_Curve.hxx>
@@ -463,9 +460,16 @@ void ViewProviderPartExt::onChanged(const App::Property* prop)
     else {
         // if the object was invisible and has been changed, recreate the visual
         if (prop == &Visibility && (isUpdateForced() || Visibility.getValue()) && VisualTouched) {
-            updateVisual();
-            // The material has to be checked again (#0001736)
-            onChanged(&DiffuseColor);
+            if (isRestoring()) {
+                // Mesh the shape in the background while the rest of the document
+                // is restored, finishRestoring() then recreates the visual
+                tessellate();
+            }
+            else {
+                updateVisual();
+                // The material has to be checked again (#0001736)
+                onChanged(&DiffuseColor);
+            }
         }
     }
 
@@ -927,6 +931,16 @@ void ViewProviderPartExt::reload()
         updateVisual();
 }
 
+void ViewProviderPartExt::finishRestoring()
+{
+    ViewProviderGeometryObject::finishRestoring();
+    if (VisualTouched && (isUpdateForced() || Visibility.getValue())) {
+        updateVisual();
+        // The material has to be checked again (#0001736)
+        onChanged(&DiffuseColor);
+    }
+}
+
 void ViewProviderPartExt::updateData(const App::Property* prop)
 {
     const char *propName = prop?prop->getName():"";
@@ -985,6 +999,25 @@ void ViewProviderPartExt::unsetEdit(int ModNum)
     }
 }
 
+Part::Tessellator::Future ViewProviderPartExt::tessellate(const TopoDS_Shape &shape) const
+{
+    Standard_Real deflection = Part::Tessellator::getDeflection(shape, Deviation.getValue());
+    Standard_Real AngDeflectionRads = AngularDeflection.getValue() / 180.0 * M_PI;
+    return Part::Tessellator::meshAsync(shape, deflection, AngDeflectionRads);
+}
+
+void ViewProviderPartExt::tessellate()
+{
+    try {
+        TopoDS_Shape cShape = Part::Feature::getShape(getObject());
+        if (!cShape.IsNull())
+            tessellate(cShape);
+    }
+    catch (...) {
+        // updateVisual() reports any error
+    }
+}
+
 void ViewProviderPartExt::updateVisual()
 {
     Gui::SoUpdateVBOAction action;
@@ -1020,23 +1053,8 @@ void ViewProviderPartExt::updateVisual()
     std::set<int> faceEdges;
 
     try {
-        // calculating the deflection value
-        Bnd_Box bounds;
-        BRepBndLib::Add(cShape, bounds);
-        bounds.SetGap(0.0);
-        Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
-        bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
-        Standard_Real deflection = ((xMax-xMin)+(yMax-yMin)+(zMax-zMin))/300.0 *
-            Deviation.getValue();
-
         // create or use the mesh on the data structure
-#if OCC_VERSION_HEX >= 0x060600
-        Standard_Real AngDeflectionRads = AngularDeflection.getValue() / 180.0 * M_PI;
-        BRepMesh_IncrementalMesh(cShape,deflection,Standard_False,
-                AngDeflectionRads,Standard_True);
-#else
-        BRepMesh_IncrementalMesh(cShape,deflection);
-#endif
+        tessellate(cShape).get();
         // We must reset the location here because the transformation data
         // are set in the placement property
         TopLoc_Location aLoc;
@@ -34,6 +34,7 @@
 #include <Gui/ViewProviderGeometryObject.h>
 #include <map>
 #include <Mod/Part/App/PartFeature.h>
+#include <Mod/Part/App/Tessellator.h>
 
 class TopoDS_Shape;
 class TopoDS_Edge;
@@ -99,6 +100,7 @@ public:
     void reload();
 
     virtual void updateData(const App::Property*) override;
+    virtual void finishRestoring() override;
 
     /** @name Selection handling
      * This group of methods do the selection handling.
@@ -156,6 +158,9 @@ protected:
     virtual void onChanged(const App::Property* prop) override;
     bool loadParameter();
     void updateVisual();
+    /// Start meshing the shape with the deflection of this view provider
+    Part::Tessellator::Future tessellate(const TopoDS_Shape &shape) const;
+    void tessellate();
     void getNormals(const TopoDS_Face&  theFace, const Handle(Poly_Triangulation)& aPolyTri,
                     TColgp_Array1OfDir& theNormals);
 
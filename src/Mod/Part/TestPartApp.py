@@ -52,6 +52,75 @@ class PartTestCases(unittest.TestCase):
         #self.Doc.addObject("Part::Feature","Face").Shape = result
         #self.assertTrue(isinstance(result.Surface, Part.BSplineSurface))
 
+    def testTessellateInstances(self):
+        cylinder = Part.makeCylinder(5, 10)
+        points, facets = cylinder.tessellate(0.1)
+        self.assertTrue(len(facets) > 0)
+
+        # a placed instance shares the triangulation of the shape
+        moved = cylinder.translated(App.Vector(100, 0, 0))
+        movedPoints, movedFacets = moved.tessellate(0.1)
+        self.assertEqual(facets, movedFacets)
+        for p, q in zip(points, movedPoints):
+            self.assertAlmostEqual((q - p - App.Vector(100, 0, 0)).Length, 0)
+
+        # the shape is meshed again after its triangulation has been removed
+        cleanPoints, cleanFacets = cylinder.tessellate(0.1, True)
+        self.assertEqual(len(facets), len(cleanFacets))
+
+    def testTessellateCoarserThenFiner(self):
+        cylinder = Part.makeCylinder(5, 10)
+        finePoints, fineFacets = cylinder.tessellate(0.01)
+
+        # mesh it coarser, replacing the cached fine triangulation
+        coarsePoints, coarseFacets = cylinder.tessellate(1.0, True)
+        self.assertTrue(len(coarseFacets) < len(fineFacets))
+
+        # the coarse triangulation must not be taken for the fine one
+        points, facets = cylinder.tessellate(0.01)
+        self.assertEqual(len(facets), len(fineFacets))
+        self.assertEqual(len(points), len(finePoints))
+
+        # a coarser request may use the finer triangulation
+        points, facets = cylinder.tessellate(1.0)
+        self.assertEqual(len(facets), len(fineFacets))
+
+    def testParallelRecompute(self):
+        param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+        parallel = param.GetBool("ParallelRecompute", False)
+        threads = param.GetInt("RecomputeThreads", 0)
+        param.SetBool("ParallelRecompute", True)
+        param.SetInt("RecomputeThreads", 4)
+        try:
+            boxes = []
+            for i in range(8):
+                box = self.Doc.addObject("Part::Box","Box")
+                box.Length = i + 1
+                box.Placement.Base = App.Vector(20 * i, 0, 0)
+                boxes.append(box)
+            cylinder = self.Doc.addObject("Part::Cylinder","Cylinder")
+            cylinder.Radius = 2
+            compound = self.Doc.addObject("Part::Compound","Compound")
+            compound.Links = boxes + [cylinder]
+            self.Doc.recompute()
+
+            # the primitives are recomputed in worker threads and must give
+            # the same shapes as the serial recompute
+            for i, box in enumerate(boxes):
+                self.assertTrue('Invalid' not in box.State)
+                self.assertAlmostEqual(box.Shape.Volume, Part.makeBox(i + 1, 10, 10).Volume)
+                self.assertAlmostEqual(box.Shape.BoundBox.XMin, 20 * i)
+            self.assertAlmostEqual(cylinder.Shape.Volume, Part.makeCylinder(2, 10).Volume)
+            self.assertEqual(len(compound.Shape.Solids), 9)
+
+            boxes[0].Length = 0
+            self.Doc.recompute()
+            self.assertTrue('Invalid' in boxes[0].State)
+            self.assertTrue('Invalid' not in boxes[1].State)
+        finally:
+            param.SetBool("ParallelRecompute", parallel)
+            param.SetInt("RecomputeThreads", threads)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartTest")
@@ -34,6 +34,9 @@
 # include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBndLib.hxx>
 # include <Bnd_Box.hxx>
+# include <TopTools_ListOfShape.hxx>
+# include <TopTools_ListIteratorOfListOfShape.hxx>
+# include <Standard_Version.hxx>
 #endif
 
 
@@ -270,60 +273,76 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
             return new App::DocumentObjectExecReturn("Only additive and subtractive features can be transformed");
         }
 
-        // Transform the add/subshape and collect the resulting shapes for overlap testing
-        /*typedef std::vector<std::vector<gp_Trsf>::const_iterator> trsf_it_vec;
-        trsf_it_vec v_transformations;
-        std::vector<TopoDS_Shape> v_transformedShapes;*/
+        // Transform the add/subshape. BRepBuilderAPI_Transform only copies the geometry if the
+        // transformation is not a rigid motion, otherwise the copies share the tool shape and
+        // just carry the transformation as their location.
+        std::vector<std::vector<gp_Trsf>::const_iterator> v_transformations;
+        std::vector<TopoDS_Shape> v_transformedShapes;
+        std::vector<Bnd_Box> v_bounds;
 
         std::vector<gp_Trsf>::const_iterator t = transformations.begin();
         ++t; // Skip first transformation, which is always the identity transformation
         for (; t != transformations.end(); ++t) {
-            // Make an explicit copy of the shape because the "true" parameter to BRepBuilderAPI_Transform
-            // seems to be pretty broken
-            BRepBuilderAPI_Copy copy(shape);
-            shape = copy.Shape();
-            if (shape.IsNull())
-                return new App::DocumentObjectExecReturn("Transformed: Linked shape object is empty");
-
-            BRepBuilderAPI_Transform mkTrf(shape, *t, false); // No need to copy, now
+            BRepBuilderAPI_Transform mkTrf(shape, *t, false);
             if (!mkTrf.IsDone())
                 return new App::DocumentObjectExecReturn("Transformation failed", (*o));
+            if (mkTrf.Shape().IsNull())
+                return new App::DocumentObjectExecReturn("Transformed: Linked shape object is empty");
 
-            // Check for intersection with support
+            Bnd_Box bound;
+            BRepBndLib::Add(mkTrf.Shape(), bound);
+            bound.SetGap(0.0);
+            v_transformations.push_back(t);
+            v_transformedShapes.push_back(mkTrf.Shape());
+            v_bounds.push_back(bound);
+        }
+
+        // A transformed shape must intersect the support, i.e.
+        // 1. The original support
+        // 2. Any extra support gained by any previous transformation of any previous feature (multi-feature transform)
+        // 3. Any extra support gained by any other transformation of this feature (feature multi-transform)
+        //
+        // Instead of fusing/cutting the transformations one by one, all shapes that intersect the current
+        // support are combined with it in one boolean operation. When fusing, the shapes left over are
+        // checked again against the grown support until no more of them can be attached.
+        std::vector<bool> pending(v_transformedShapes.size(), true);
+        std::size_t numPending = pending.size();
+        while (numPending > 0) {
+            Bnd_Box supportBound;
+            BRepBndLib::Add(support, supportBound);
+            supportBound.SetGap(0.0);
+
+            TopTools_ListOfShape shapeTools;
             try {
+                for (std::size_t i = 0; i < v_transformedShapes.size(); ++i) {
+                    if (!pending[i])
+                        continue;
+                    // Shapes whose bounding box is out of the support's cannot intersect it, so
+                    // skip the expensive check
+                    if (supportBound.IsOut(v_bounds[i]))
+                        continue;
+                    if (!Part::checkIntersection(support, v_transformedShapes[i], false, true))
+                        continue;
+                    shapeTools.Append(v_transformedShapes[i]);
+                    pending[i] = false;
+                    --numPending;
+                }
+            } catch (Standard_Failure& e) {
+                std::string msg("Transformation: Intersection check failed");
+                if (e.GetMessageString() != NULL)
+                    msg += std::string(": '") + e.GetMessageString() + "'";
+                return new App::DocumentObjectExecReturn(msg.c_str());
+            }
+            if (shapeTools.IsEmpty())
+                break;
 
-                if (!Part::checkIntersection(support, mkTrf.Shape(), false, true)) {
-#ifdef FC_DEBUG // do not write this in release mode because a message appears already in the task view
-                    Base::Console().Warning("Transformed shape does not intersect support %s: Removed\n", (*o)->getNameInDocument());
-#endif
-                    nointersect_trsfms[*o].insert(t);
-                } else {
-                    // We cannot wait to fuse a transformation with the support until all the transformations are done,
-                    // because the "support" potentially changes with every transformation, basically when checking intersection
-                    // above you need:
-                    // 1. The original support
-                    // 2. Any extra support gained by any previous transformation of any previous feature (multi-feature transform)
-                    // 3. Any extra support gained by any previous transformation of this feature (feature multi-trasform)
-                    //
-                    // Therefore, if the transformation succeeded, then we fuse it with the support now, before checking the intersection
-                    // of the next transformation.
-                    
-                    /*v_transformations.push_back(t);
-                    v_transformedShapes.push_back(mkTrf.Shape());*/
-
-                    // Note: Transformations that do not intersect the support are ignored in the overlap tests
-                    
-                    //insert scheme here.
-                    /*TopoDS_Compound compoundTool;
-                    std::vector<TopoDS_Shape> individualTools;
-                    divideTools(v_transformedShapes, individualTools, compoundTool);*/
-                    
-                    // Fuse/Cut the compounded transformed shapes with the support
-                    //TopoDS_Shape result;
-                    TopoDS_Shape current = support;
-                    
+            TopoDS_Shape current = support;
+
+            try {
+#if OCC_VERSION_HEX <= 0x060800
+                for (TopTools_ListIteratorOfListOfShape it(shapeTools); it.More(); it.Next()) {
                     if (fuse) {
-                        BRepAlgoAPI_Fuse mkFuse(current, mkTrf.Shape());
+                        BRepAlgoAPI_Fuse mkFuse(current, it.Value());
                         if (!mkFuse.IsDone())
                             return new App::DocumentObjectExecReturn("Fusion with support failed", *o);
                         // we have to get the solids (fuse sometimes creates compounds)
@@ -331,46 +350,65 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
                         // lets check if the result is a solid
                         if (current.IsNull())
                             return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
-
-                        /*std::vector<TopoDS_Shape>::const_iterator individualIt;
-                        for (individualIt = individualTools.begin(); individualIt != individualTools.end(); ++individualIt)
-                        {
-                            BRepAlgoAPI_Fuse mkFuse2(current, *individualIt);
-                            if (!mkFuse2.IsDone())
-                                return new App::DocumentObjectExecReturn("Fusion with support failed", *o);
-                            // we have to get the solids (fuse sometimes creates compounds)
-                            current = this->getSolid(mkFuse2.Shape());
-                            // lets check if the result is a solid
-                            if (current.IsNull())
-                                return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
-                        }*/
                     } else {
-                        BRepAlgoAPI_Cut mkCut(current, mkTrf.Shape());
+                        BRepAlgoAPI_Cut mkCut(current, it.Value());
                         if (!mkCut.IsDone())
                             return new App::DocumentObjectExecReturn("Cut out of support failed", *o);
                         current = mkCut.Shape();
-                        /*std::vector<TopoDS_Shape>::const_iterator individualIt;
-                        for (individualIt = individualTools.begin(); individualIt != individualTools.end(); ++individualIt)
-                        {
-                            BRepAlgoAPI_Cut mkCut2(current, *individualIt);
-                            if (!mkCut2.IsDone())
-                                return new App::DocumentObjectExecReturn("Cut out of support failed", *o);
-                            current = this->getSolid(mkCut2.Shape());
-                            if (current.IsNull())
-                                return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
-                        }*/
                     }
-                    support = current; // Use result of this operation for fuse/cut of next original
                 }
+#else
+                TopTools_ListOfShape shapeArguments;
+                shapeArguments.Append(support);
+
+                if (fuse) {
+                    BRepAlgoAPI_Fuse mkFuse;
+# if OCC_VERSION_HEX >= 0x060900
+                    mkFuse.SetRunParallel(true);
+# endif
+                    mkFuse.SetArguments(shapeArguments);
+                    mkFuse.SetTools(shapeTools);
+                    mkFuse.Build();
+                    if (!mkFuse.IsDone())
+                        return new App::DocumentObjectExecReturn("Fusion with support failed", *o);
+                    // we have to get the solids (fuse sometimes creates compounds)
+                    current = this->getSolid(mkFuse.Shape());
+                    // lets check if the result is a solid
+                    if (current.IsNull())
+                        return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
+                } else {
+                    BRepAlgoAPI_Cut mkCut;
+# if OCC_VERSION_HEX >= 0x060900
+                    mkCut.SetRunParallel(true);
+# endif
+                    mkCut.SetArguments(shapeArguments);
+                    mkCut.SetTools(shapeTools);
+                    mkCut.Build();
+                    if (!mkCut.IsDone())
+                        return new App::DocumentObjectExecReturn("Cut out of support failed", *o);
+                    current = mkCut.Shape();
+                }
+#endif
             } catch (Standard_Failure& e) {
-                // Note: Ignoring this failure is probably pointless because if the intersection check fails, the later
-                // fuse operation of the transformation result will also fail
-        
-                std::string msg("Transformation: Intersection check failed");
+                std::string msg(fuse ? "Fusion with support failed" : "Cut out of support failed");
                 if (e.GetMessageString() != NULL)
                     msg += std::string(": '") + e.GetMessageString() + "'";
-                return new App::DocumentObjectExecReturn(msg.c_str());
+                return new App::DocumentObjectExecReturn(msg.c_str(), *o);
             }
+            support = current; // Use result of this operation for fuse/cut of next original
+
+            // Cutting only removes material, so nothing that missed the support can hit it now
+            if (!fuse)
+                break;
+        }
+
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            if (!pending[i])
+                continue;
+#ifdef FC_DEBUG // do not write this in release mode because a message appears already in the task view
+            Base::Console().Warning("Transformed shape does not intersect support %s: Removed\n", (*o)->getNameInDocument());
+#endif
+            nointersect_trsfms[*o].insert(v_transformations[i]);
         }
     }
     support = refineShapeIfActive(support);
@@ -378,7 +416,7 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
     for (rej_it_map::const_iterator it = nointersect_trsfms.begin(); it != nointersect_trsfms.end(); ++it)
         for (trsf_it::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
             rejected[it->first].push_back(**it2);
-
+
     int solidCount = countSolids(support);
     if (solidCount > 1) {
         return new App::DocumentObjectExecReturn("Transformed: Result has multiple solids. This is not supported at this time.");
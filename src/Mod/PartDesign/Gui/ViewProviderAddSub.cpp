@@ -30,9 +30,6 @@
 # include <Inventor/nodes/SoNormal.h>
 # include <Inventor/nodes/SoMaterial.h>
 # include <Inventor/nodes/SoPickStyle.h>
-# include <Bnd_Box.hxx>
-# include <BRepBndLib.hxx>
-# include <BRepMesh_IncrementalMesh.hxx>
 # include <BRep_Tool.hxx>
 # include <TopExp_Explorer.hxx>
 # include <TopoDS.hxx>
@@ -119,23 +116,8 @@ void ViewProviderAddSub::updateAddSubShapeIndicator() {
     std::set<int> faceEdges;
 
     try {
-        // calculating the deflection value
-        Bnd_Box bounds;
-        BRepBndLib::Add(cShape, bounds);
-        bounds.SetGap(0.0);
-        Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
-        bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
-        Standard_Real deflection = ((xMax-xMin)+(yMax-yMin)+(zMax-zMin))/300.0 *
-            Deviation.getValue();
-
         // create or use the mesh on the data structure
-#if OCC_VERSION_HEX >= 0x060600
-        Standard_Real AngDeflectionRads = AngularDeflection.getValue() / 180.0 * M_PI;
-        BRepMesh_IncrementalMesh(cShape,deflection,Standard_False,
-                                    AngDeflectionRads,Standard_True);
-#else
-        BRepMesh_IncrementalMesh(cShape,deflection);
-#endif
+        tessellate(cShape).get();
         // We must reset the location here because the transformation data
         // are set in the placement property
         TopLoc_Location aLoc;
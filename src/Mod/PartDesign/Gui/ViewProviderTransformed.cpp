@@ -24,10 +24,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
-# include <Bnd_Box.hxx>
 # include <BRep_Tool.hxx>
-# include <BRepBndLib.hxx>
-# include <BRepMesh_IncrementalMesh.hxx>
 # include <Standard_Version.hxx>
 # include <TopExp_Explorer.hxx>
 # include <TopoDS.hxx>
@@ -207,25 +204,9 @@ void ViewProviderTransformed::recomputeFeature(bool recompute)
         TopoDS_Shape cShape(shape);
 
         try {
-            // calculating the deflection value
-            Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
-            {
-                Bnd_Box bounds;
-                BRepBndLib::Add(cShape, bounds);
-                bounds.SetGap(0.0);
-                bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
-            }
-            Standard_Real deflection = ((xMax-xMin)+(yMax-yMin)+(zMax-zMin))/300.0 * Deviation.getValue();
-
             // create or use the mesh on the data structure
             // Note: This DOES have an effect on cShape
-#if OCC_VERSION_HEX >= 0x060600
-            Standard_Real AngDeflectionRads = AngularDeflection.getValue() / 180.0 * M_PI;
-            BRepMesh_IncrementalMesh(cShape,deflection,Standard_False,
-                                        AngDeflectionRads,Standard_True);
-#else
-            BRepMesh_IncrementalMesh(cShape,deflection);
-#endif
+            tessellate(cShape).get();
             // We must reset the location here because the transformation data
             // are set in the placement property
             TopLoc_Location aLoc;
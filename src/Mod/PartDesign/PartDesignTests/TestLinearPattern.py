@@ -19,6 +19,7 @@
 #   USA                                                                   *
 #**************************************************************************
 import unittest
+from math import pi
 
 import FreeCAD
 import TestSketcherApp
@@ -138,6 +139,54 @@ class TestLinearPattern(unittest.TestCase):
         self.Doc.recompute()
         self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 1e4)
 
+    def testOverlappingLinearPattern(self):
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=10.00
+        self.Box.Width=10.00
+        self.Box.Height=10.00
+        self.Doc.recompute()
+        self.LinearPattern = self.Doc.addObject("PartDesign::LinearPattern","LinearPattern")
+        self.LinearPattern.Originals = [self.Box]
+        self.LinearPattern.Direction = (self.Doc.X_Axis,[""])
+        self.LinearPattern.Length = 40.0
+        self.LinearPattern.Occurrences = 9
+        self.Body.addObject(self.LinearPattern)
+        self.Doc.recompute()
+        self.assertTrue(self.LinearPattern.isValid())
+        self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 5e3)
+
+    def testSubtractiveLinearPattern(self):
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=100.00
+        self.Box.Width=20.00
+        self.Box.Height=10.00
+        self.Doc.recompute()
+        self.Cylinder = self.Doc.addObject('PartDesign::SubtractiveCylinder','Cylinder')
+        self.Cylinder.Radius = 2
+        self.Cylinder.Height = 10
+        self.Cylinder.Placement.Base = FreeCAD.Vector(5, 10, 0)
+        self.Body.addObject(self.Cylinder)
+        self.Doc.recompute()
+        self.LinearPattern = self.Doc.addObject("PartDesign::LinearPattern","LinearPattern")
+        self.LinearPattern.Originals = [self.Cylinder]
+        self.LinearPattern.Direction = (self.Doc.X_Axis,[""])
+        self.LinearPattern.Length = 90.0
+        self.LinearPattern.Occurrences = 10
+        self.Body.addObject(self.LinearPattern)
+        self.Doc.recompute()
+        self.assertTrue(self.LinearPattern.isValid())
+        self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 2e4 - 10 * pi * 4 * 10)
+        # the holes beyond the end of the box miss the support and are left out
+        self.LinearPattern.Length = 120.0
+        self.LinearPattern.Occurrences = 13
+        self.Doc.recompute()
+        self.assertTrue(self.LinearPattern.isValid())
+        self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 2e4 - 10 * pi * 4 * 10)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartDesignTestLinearPattern")
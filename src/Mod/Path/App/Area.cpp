@@ -23,6 +23,7 @@
 
 #ifndef _PreComp_
 # include <cfloat>
+# include <mutex>
 # include <boost/version.hpp>
 # include <boost/config.hpp>
 # if defined(BOOST_MSVC) && (BOOST_VERSION == 105500)
@@ -84,6 +85,9 @@
 # include <TopTools_HSequenceOfShape.hxx>
 #endif
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include <Base/Exception.h>
 #include <Base/Tools.h>
 
@@ -1343,6 +1347,112 @@ int Area::project(TopoDS_Shape &shape_out,
     return skips;
 }
 
+namespace {
+
+typedef std::pair<short, std::vector<TopoDS_Shape> > SectionSolids;
+
+/** Outcome of slicing one section height
+ *
+ * Log messages are collected and replayed in height order by the calling
+ * thread, because sections may be sliced in worker threads.
+ */
+struct SectionResult {
+    shared_ptr<Area> area;
+    std::vector<std::pair<int,std::string> > messages;
+    bool cached = false;
+};
+
+#define SECTION_MSG(_res,_level,_msg) do {\
+    if(FC_LOG_INSTANCE.isEnabled(_level)) {\
+        std::ostringstream str;\
+        str << _msg;\
+        (_res).messages.emplace_back(_level,str.str());\
+    }\
+}while(0)
+
+/** Identifies the input of Area::makeSections() */
+struct SectionCacheKey {
+    std::vector<std::pair<short,TopoDS_Shape> > shapes;
+    gp_Trsf trsf;
+    AreaParams params;
+    bool project;
+    double tolerance;
+
+    bool operator==(const SectionCacheKey &other) const {
+        if(project!=other.project
+                || tolerance!=other.tolerance
+                || shapes.size()!=other.shapes.size()
+                || params!=other.params)
+            return false;
+        for(int r=1;r<=3;++r) {
+            for(int c=1;c<=4;++c) {
+                if(trsf.Value(r,c)!=other.trsf.Value(r,c))
+                    return false;
+            }
+        }
+        for(size_t i=0;i<shapes.size();++i) {
+            if(shapes[i].first!=other.shapes[i].first ||
+               !shapes[i].second.IsEqual(other.shapes[i].second))
+                return false;
+        }
+        return true;
+    }
+};
+
+typedef std::map<double,shared_ptr<Area> > SectionMap;
+
+/** Least recently used cache of the sections made by Area::makeSections()
+ *
+ * The sections are keyed by height, with a null area marking a discarded
+ * section. The key holds on to the input shapes, so a recomputed (i.e.
+ * different) input shape never matches a stale entry.
+ */
+class SectionCache {
+public:
+    SectionMap find(const SectionCacheKey &key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(auto it=entries.begin();it!=entries.end();++it) {
+            if(it->first == key) {
+                entries.splice(entries.begin(),entries,it);
+                return it->second;
+            }
+        }
+        return SectionMap();
+    }
+
+    void update(const SectionCacheKey &key, SectionMap &&sections) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(auto it=entries.begin();it!=entries.end();++it) {
+            if(it->first == key) {
+                entries.erase(it);
+                break;
+            }
+        }
+        if(sections.size() > MaxSections)
+            return;
+        entries.emplace_front(key,std::move(sections));
+        if(entries.size() > MaxEntries)
+            entries.pop_back();
+    }
+
+private:
+    enum {
+        MaxEntries = 8,
+        MaxSections = 1024,
+    };
+    std::mutex mutex;
+    std::list<std::pair<SectionCacheKey,SectionMap> > entries;
+};
+
+SectionCache &sectionCache() {
+    // Intentionally leaked, so that the cached shapes are not released after
+    // OCC has been torn down on exit
+    static SectionCache *cache = new SectionCache;
+    return *cache;
+}
+
+} // anonymous namespace
+
 std::vector<shared_ptr<Area> > Area::makeSections(
         PARAM_ARGS(PARAM_FARG,AREA_PARAMS_SECTION_EXTRA),
         const std::vector<double> &_heights,
@@ -1359,7 +1469,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     if(plane.IsNull())
         throw Base::ValueError("failed to obtain section plane");
 
-    FC_TIME_INIT2(t,t1);
+    FC_TIME_INIT(t);
 
     TopLoc_Location loc(trsf);
 
@@ -1474,20 +1584,61 @@ std::vector<shared_ptr<Area> > Area::makeSections(
     std::vector<shared_ptr<Area> > sections;
     sections.reserve(heights.size());
 
-    std::list<Shape> projectedShapes;
-    if(project) {
-        projectedShapes = getProjectedShapes(trsf,false);
-        if(projectedShapes.empty()) {
-            AREA_ERR("empty projection");
-            return sections;
-        }
-    }
-
     tolerance *= 2.0;
     bool can_retry = fabs(tolerance)>Precision::Confusion();
     TopLoc_Location locInverse(loc.Inverted());
 
+    // Reuse the sections of a previous call with the same input, so that a
+    // recompute changing only some of the heights (e.g. a different step
+    // down) does not slice the whole model again.
+    SectionCacheKey key;
+    key.shapes.reserve(myShapes.size());
+    for(const Shape &s : myShapes)
+        key.shapes.emplace_back(s.op,s.shape);
+    key.trsf = trsf;
+    key.params = myParams;
+    key.project = project;
+    key.tolerance = tolerance;
+    SectionMap cached = sectionCache().find(key);
+
+    std::vector<SectionResult> results(heights.size());
+    std::vector<size_t> pending;
+    pending.reserve(heights.size());
     for(size_t i=0;i<heights.size();++i) {
+        auto it = cached.find(heights[i]);
+        if(it == cached.end()) {
+            pending.push_back(i);
+            continue;
+        }
+        results[i].cached = true;
+        if(it->second)
+            results[i].area = std::make_shared<Area>(*it->second,false);
+    }
+    AREA_TRACE("cached sections " << heights.size()-pending.size() << '/' << heights.size());
+
+    std::list<Shape> projectedShapes;
+    std::vector<SectionSolids> solids;
+    if(project) {
+        if(pending.size()) {
+            projectedShapes = getProjectedShapes(trsf,false);
+            if(projectedShapes.empty()) {
+                AREA_ERR("empty projection");
+                return sections;
+            }
+        }
+    }else{
+        solids.reserve(myShapes.size());
+        for(const Shape &s : myShapes) {
+            solids.emplace_back(s.op,std::vector<TopoDS_Shape>());
+            for(TopExp_Explorer xp(s.shape.Moved(loc), TopAbs_SOLID); xp.More(); xp.Next())
+                solids.back().second.push_back(xp.Current());
+        }
+    }
+
+    // Slice one section. This may run in a worker thread, so it must not use
+    // the console directly. showShape() is only active at trace log level,
+    // which forces all sections to be sliced in the calling thread.
+    auto makeSection = [&](size_t i, const std::vector<SectionSolids> &input, SectionResult &res) {
         double z = heights[i];
         bool retried = !can_retry;
         while(true) {
@@ -1508,24 +1659,24 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                     TopLoc_Location wloc(t);
                     area->add(s.shape.Moved(wloc).Moved(locInverse),s.op);
                 }
-                sections.push_back(area);
+                res.area = area;
                 break;
             }
 
-            for(auto it=myShapes.begin();it!=myShapes.end();++it) {
-                const auto &s = *it;
+            for(size_t j=0;j<input.size();++j) {
+                const auto &s = input[j];
                 BRep_Builder builder;
                 TopoDS_Compound comp;
                 builder.MakeCompound(comp);
 
-                for(TopExp_Explorer xp(s.shape.Moved(loc), TopAbs_SOLID); xp.More(); xp.Next()) {
-                    showShape(xp.Current(),0,"section_%u_shape",i);
+                for(const TopoDS_Shape &solid : s.second) {
+                    showShape(solid,0,"section_%u_shape",i);
                     std::list<TopoDS_Wire> wires;
-                    Part::CrossSection section(a,b,c,xp.Current());
+                    Part::CrossSection section(a,b,c,solid);
                     wires = section.slice(-d);
                     showShapes(wires,0,"section_%u_wire",i);
                     if(wires.empty()) {
-                        AREA_LOG("Section returns no wires");
+                        SECTION_MSG(res,FC_LOGLEVEL_LOG,"Section returns no wires");
                         continue;
                     }
 
@@ -1540,7 +1691,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                         mkFace.Build();
                         const TopoDS_Shape &shape = mkFace.Shape();
                         if (shape.IsNull())
-                            AREA_WARN("FaceMakerBullseye return null shape on section");
+                            SECTION_MSG(res,FC_LOGLEVEL_WARN,"FaceMakerBullseye return null shape on section");
                         else {
                             showShape(shape,0,"section_%u_face",i);
                             for(auto it=wires.begin(),itNext=it;it!=wires.end();it=itNext) {
@@ -1555,7 +1706,7 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                             }
                         }
                     }catch (Base::Exception &e){
-                        AREA_WARN("FaceMakerBullseye failed on section: " << e.what());
+                        SECTION_MSG(res,FC_LOGLEVEL_WARN,"FaceMakerBullseye failed on section: " << e.what());
                     }
                     for(const TopoDS_Wire &wire : wires)
                         builder.Add(comp,wire);
@@ -1565,33 +1716,106 @@ std::vector<shared_ptr<Area> > Area::makeSections(
                 if(TopExp_Explorer(comp,TopAbs_EDGE).More()) {
                     const TopoDS_Shape &shape = comp.Moved(locInverse);
                     showShape(shape,0,"section_%u_result",i);
-                    area->add(shape,s.op);
+                    area->add(shape,s.first);
                 }else if(area->myShapes.empty()){
-                    auto itNext = it;
-                    if(++itNext != myShapes.end() &&
-                        (itNext->op==OperationIntersection ||
-                        itNext->op==OperationDifference))
+                    if(j+1 < input.size() &&
+                        (input[j+1].first==OperationIntersection ||
+                         input[j+1].first==OperationDifference))
                     {
                         break;
                     }
                 }
             }
             if(area->myShapes.size()){
-                sections.push_back(area);
-                FC_TIME_LOG(t1,"makeSection " << z);
-                showShape(area->getShape(),0,"section_%u_final",i);
+                res.area = area;
+                // getShape() builds the area with the global CArea parameters,
+                // only do it when showShape() is active, i.e. in the calling thread
+                if(FC_LOG_INSTANCE.level()>FC_LOGLEVEL_TRACE)
+                    showShape(area->getShape(),0,"section_%u_final",i);
                 break;
             }
             if(retried) {
-                AREA_WARN("Discard empty section");
+                SECTION_MSG(res,FC_LOGLEVEL_WARN,"Discard empty section");
                 break;
             }else{
-                AREA_TRACE("retry section " <<z<<"->"<<z+tolerance);
+                SECTION_MSG(res,FC_LOGLEVEL_TRACE,"retry section " <<z<<"->"<<z+tolerance);
                 z += tolerance;
                 retried = true;
             }
         }
+    };
+
+    // Each task slices every 'threads'-th pending height, interleaved so that
+    // the usually more complex middle sections are spread over all threads.
+    int threads = 1;
+    if(!project && pending.size()>1 && FC_LOG_INSTANCE.level()<=FC_LOGLEVEL_TRACE)
+        threads = std::max(1,std::min(QThread::idealThreadCount(),(int)pending.size()));
+
+    struct SectionTask {
+        size_t first;
+        std::vector<SectionSolids> solids;
+        std::exception_ptr error;
+    };
+    std::vector<SectionTask> tasks(threads);
+    for(int k=0;k<threads;++k)
+        tasks[k].first = k;
+
+    auto runTask = [&](SectionTask &task) {
+        try {
+            const std::vector<SectionSolids> *input = &solids;
+            if(threads > 1) {
+                // OCC shapes share their topology and geometry data, give
+                // each thread its own copy to slice
+                task.solids = solids;
+                for(auto &s : task.solids) {
+                    for(auto &solid : s.second)
+                        solid = BRepBuilderAPI_Copy(solid).Shape();
+                }
+                input = &task.solids;
+            }
+            for(size_t k=task.first;k<pending.size();k+=threads)
+                makeSection(pending[k],*input,results[pending[k]]);
+        } catch (...) {
+            task.error = std::current_exception();
+        }
+    };
+    if(threads > 1)
+        QtConcurrent::blockingMap(tasks,runTask);
+    else if(pending.size())
+        runTask(tasks[0]);
+
+    for(size_t i=0;i<results.size();++i) {
+        SectionResult &res = results[i];
+        for(const auto &msg : res.messages) {
+            switch(msg.first) {
+            case FC_LOGLEVEL_WARN:
+                AREA_WARN(msg.second);
+                break;
+            case FC_LOGLEVEL_LOG:
+                AREA_LOG(msg.second);
+                break;
+            default:
+                AREA_TRACE(msg.second);
+            }
+        }
+    }
+    for(const auto &task : tasks) {
+        if(task.error)
+            std::rethrow_exception(task.error);
+    }
+
+    for(size_t i=0;i<results.size();++i) {
+        SectionResult &res = results[i];
+        if(!res.cached) {
+            // Cache a shallow copy, because the returned section will be
+            // built (and therefore modified) by the caller
+            cached[heights[i]] = res.area?std::make_shared<Area>(*res.area,false):shared_ptr<Area>();
+        }
+        if(res.area)
+            sections.push_back(res.area);
     }
+    sectionCache().update(key,std::move(cached));
+
     FC_TIME_LOG(t,"makeSection count: " << sections.size()<<", total");
     return sections;
 }
@@ -3139,14 +3363,20 @@ static inline void addParameter(bool verbose, Command &cmd, const char *name,
         cmd.Parameters[name] = relative?d:next;
 }
 
-static inline void addGCode(bool verbose, Toolpath &path, const gp_Pnt &last,
+static inline void addGCode(bool verbose, Command &cmd, const gp_Pnt &last,
         const gp_Pnt &next, const char *name)
 {
-    Command cmd;
     cmd.Name = name;
     addParameter(verbose,cmd,"X",last.X(),next.X());
     addParameter(verbose,cmd,"Y",last.Y(),next.Y());
     addParameter(verbose,cmd,"Z",last.Z(),next.Z());
+}
+
+static inline void addGCode(bool verbose, Toolpath &path, const gp_Pnt &last,
+        const gp_Pnt &next, const char *name)
+{
+    Command cmd;
+    addGCode(verbose,cmd,last,next,name);
     path.addCommand(cmd);
     return;
 }
@@ -3154,12 +3384,13 @@ static inline void addGCode(bool verbose, Toolpath &path, const gp_Pnt &last,
 static inline void addG1(bool verbose,Toolpath &path, const gp_Pnt &last,
         const gp_Pnt &next, double f, double &last_f)
 {
-    addGCode(verbose,path,last,next,"G1");
+    Command cmd;
+    addGCode(verbose,cmd,last,next,"G1");
     if(f>Precision::Confusion()) {
-        Command *cmd = path.getCommands().back();
-        addParameter(verbose,*cmd,"F",last_f,f);
+        addParameter(verbose,cmd,"F",last_f,f);
         last_f = f;
     }
+    path.addCommand(cmd);
     return;
 }
 
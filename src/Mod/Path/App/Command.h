@@ -60,6 +60,9 @@ namespace Path
         double getValue(const std::string &name) const; // returns the value of a given parameter
         void scaleBy(double factor); // scales the receiver - use for imperial/metric conversions
 
+        // writes a parameter value to the stream the way toGCode() formats it
+        static void writeValue(std::ostream &str, double value, int precision, bool padzero);
+
         // this assumes the name is upper case
         inline double getParam(const std::string &name, double fallback = 0.0) const {
             auto it = Parameters.find(name);
@@ -24,6 +24,11 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
+# include <cctype>
+# include <cstdlib>
+# include <sstream>
+# include <boost/algorithm/string.hpp>
 # include <boost/regex.hpp>
 #endif
 
@@ -47,107 +52,473 @@ using namespace Base;
 
 TYPESYSTEM_SOURCE(Path::Toolpath , Base::Persistence)
 
-Toolpath::Toolpath()
+namespace {
+
+// slots 0-25 are the upper case letters, everything else is kept in extraSlots
+const std::uint16_t LetterSlots = 26;
+const std::uint16_t SlotA = 'A' - 'A';
+const std::uint16_t SlotB = 'B' - 'A';
+const std::uint16_t SlotC = 'C' - 'A';
+const std::uint16_t SlotI = 'I' - 'A';
+const std::uint16_t SlotJ = 'J' - 'A';
+const std::uint16_t SlotK = 'K' - 'A';
+const std::uint16_t SlotN = 'N' - 'A';
+const std::uint16_t SlotX = 'X' - 'A';
+const std::uint16_t SlotY = 'Y' - 'A';
+const std::uint16_t SlotZ = 'Z' - 'A';
+
+const std::string &letterName(std::uint16_t slot)
 {
+    static const std::vector<std::string> letters = [] {
+        std::vector<std::string> l;
+        for (char c = 'A'; c <= 'Z'; ++c)
+            l.push_back(std::string(1, c));
+        return l;
+    }();
+    return letters[slot];
 }
 
-Toolpath::Toolpath(const Toolpath& otherPath)
-    : vpcCommands(otherPath.vpcCommands.size())
-    , center(otherPath.center)
+bool isUpperLetter(const std::string &name)
 {
-    *this = otherPath;
-    recalculate();
+    return name.size() == 1 && name[0] >= 'A' && name[0] <= 'Z';
 }
 
-Toolpath::~Toolpath()
+// Same result as std::atof() for the values written by the G-code
+// parser. Plain decimals with up to 15 digits are exact in a double and
+// a single division by an exact power of ten rounds correctly, anything
+// else is left to std::atof().
+double toDouble(const std::string &value)
 {
-    clear();
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    const char *it = value.c_str();
+    bool negative = (*it == '-');
+    if (negative)
+        ++it;
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int decimals = -1;
+    for (; *it; ++it) {
+        if (*it >= '0' && *it <= '9') {
+            if (++digits > 15)
+                return std::atof(value.c_str());
+            mantissa = mantissa * 10 + (*it - '0');
+            if (decimals >= 0)
+                ++decimals;
+        } else if (*it == '.' && decimals < 0) {
+            decimals = 0;
+        } else {
+            return std::atof(value.c_str());
+        }
+    }
+    if (!digits)
+        return std::atof(value.c_str());
+    double result = static_cast<double>(mantissa);
+    if (decimals > 0)
+        result /= powers[decimals];
+    return negative ? -result : result;
 }
 
-Toolpath &Toolpath::operator=(const Toolpath& otherPath)
+void upperCase(std::string &name)
 {
-    if (this == &otherPath)
-        return *this;
+    for (std::string::iterator it = name.begin(); it != name.end(); ++it)
+        *it = std::toupper(static_cast<unsigned char>(*it));
+}
 
-    clear();
-    vpcCommands.resize(otherPath.vpcCommands.size());
-    int i = 0;
-    for (std::vector<Command*>::const_iterator it=otherPath.vpcCommands.begin();it!=otherPath.vpcCommands.end();++it,i++) {
-        vpcCommands[i] = new Command(**it);
+std::string toUpper(const std::string &name)
+{
+    for (std::string::const_iterator it = name.begin(); it != name.end(); ++it) {
+        if (std::islower(static_cast<unsigned char>(*it))) {
+            std::string upper(name);
+            boost::to_upper(upper);
+            return upper;
+        }
     }
-    center = otherPath.center;
-    recalculate();
-    return *this;
+    return name;
+}
+
+}
+
+// CommandView
+
+CommandView::CommandView(const Toolpath &tp, unsigned int index)
+    : tp(tp), index(index)
+{
+}
+
+const std::string &CommandView::getName(void) const
+{
+    return tp.names[tp.opcodes[index]];
+}
+
+bool CommandView::has(const std::string &attr) const
+{
+    int slot = tp.findSlot(toUpper(attr));
+    if (slot < 0)
+        return false;
+    switch (slot) {
+    case SlotX:
+        return (tp.axisFlags[index] & Toolpath::HasX) != 0;
+    case SlotY:
+        return (tp.axisFlags[index] & Toolpath::HasY) != 0;
+    case SlotZ:
+        return (tp.axisFlags[index] & Toolpath::HasZ) != 0;
+    default:
+        return tp.findParameter(index, slot) >= 0;
+    }
+}
+
+double CommandView::getValue(const std::string &attr) const
+{
+    return getParam(toUpper(attr));
+}
+
+double CommandView::getParam(const std::string &name, double fallback) const
+{
+    int slot = tp.findSlot(name);
+    if (slot < 0)
+        return fallback;
+    return tp.getParameter(index, slot, fallback);
+}
+
+Base::Placement CommandView::getPlacement(const Base::Vector3d pos) const
+{
+    Rotation rot;
+    rot.setYawPitchRoll(tp.getParameter(index, SlotA, 0.0),
+                        tp.getParameter(index, SlotB, 0.0),
+                        tp.getParameter(index, SlotC, 0.0));
+    return Placement(getPosition(pos), rot);
+}
+
+Base::Vector3d CommandView::getPosition(const Base::Vector3d &pos) const
+{
+    return tp.getPosition(index, pos);
+}
+
+Base::Vector3d CommandView::getCenter(void) const
+{
+    return tp.getCenter(index);
+}
+
+std::map<std::string,double> CommandView::getParameters(void) const
+{
+    std::map<std::string,double> params;
+    for (std::uint32_t i = tp.paramOffsets[index]; i < tp.paramOffsets[index+1]; ++i)
+        params[tp.getSlotName(tp.paramSlots[i])] = tp.paramValues[i];
+    std::uint8_t flags = tp.axisFlags[index];
+    const Vector3d &axis = tp.axes[index];
+    if (flags & Toolpath::HasX)
+        params[letterName(SlotX)] = axis.x;
+    if (flags & Toolpath::HasY)
+        params[letterName(SlotY)] = axis.y;
+    if (flags & Toolpath::HasZ)
+        params[letterName(SlotZ)] = axis.z;
+    return params;
+}
+
+std::string CommandView::toGCode(int precision, bool padzero) const
+{
+    std::stringstream str;
+    writeGCode(str, precision, padzero);
+    return str.str();
+}
+
+void CommandView::writeGCode(std::ostream &str, int precision, bool padzero) const
+{
+    // same output as Command::toGCode(): parameters ordered by name, no line numbers
+    static const std::uint16_t axisSlots[] = {SlotX, SlotY, SlotZ};
+    static const std::uint8_t axisMasks[] = {Toolpath::HasX, Toolpath::HasY, Toolpath::HasZ};
+
+    std::uint8_t flags = tp.axisFlags[index];
+    const Vector3d &axis = tp.axes[index];
+    int nextAxis = 0;
+    auto writeAxes = [&](const std::string *before) {
+        for (; nextAxis < 3; ++nextAxis) {
+            const std::string &name = letterName(axisSlots[nextAxis]);
+            if (before && !(name < *before))
+                break;
+            if (flags & axisMasks[nextAxis]) {
+                str << " " << name;
+                Command::writeValue(str, axis[nextAxis], precision, padzero);
+            }
+        }
+    };
+
+    str << getName();
+    for (std::uint32_t i = tp.paramOffsets[index]; i < tp.paramOffsets[index+1]; ++i) {
+        std::uint16_t slot = tp.paramSlots[i];
+        if (slot == SlotN)
+            continue;
+        const std::string &name = tp.getSlotName(slot);
+        writeAxes(&name);
+        str << " " << name;
+        Command::writeValue(str, tp.paramValues[i], precision, padzero);
+    }
+    writeAxes(nullptr);
+}
+
+Command CommandView::toCommand(void) const
+{
+    return Command(getName().c_str(), getParameters());
+}
+
+// Toolpath
+
+Toolpath::Toolpath()
+    : paramOffsets(1, 0)
+{
+}
+
+Toolpath::Toolpath(const Toolpath&) = default;
+
+Toolpath::~Toolpath()
+{
 }
 
+Toolpath &Toolpath::operator=(const Toolpath&) = default;
+
 void Toolpath::clear(void)
 {
-    for(std::vector<Command*>::iterator it = vpcCommands.begin();it!=vpcCommands.end();++it)
-        delete ( *it );
-    vpcCommands.clear();
+    opcodes.clear();
+    axisFlags.clear();
+    axes.clear();
+    paramOffsets.assign(1, 0);
+    paramSlots.clear();
+    paramValues.clear();
+    names.clear();
+    motions.clear();
+    nameIndex.clear();
+    extraSlots.clear();
     recalculate();
 }
 
+std::uint32_t Toolpath::internName(const std::string &name)
+{
+    auto it = nameIndex.find(name);
+    if (it != nameIndex.end())
+        return it->second;
+
+    Motion motion = NoMotion;
+    if ( (name == "G0") || (name == "G00") )
+        motion = Rapid;
+    else if ( (name == "G1") || (name == "G01") )
+        motion = Feed;
+    else if ( (name == "G2") || (name == "G02") )
+        motion = ArcCW;
+    else if ( (name == "G3") || (name == "G03") )
+        motion = ArcCCW;
+
+    std::uint32_t id = names.size();
+    names.push_back(name);
+    motions.push_back(motion);
+    nameIndex[name] = id;
+    return id;
+}
+
+std::uint16_t Toolpath::internSlot(const std::string &name)
+{
+    int slot = findSlot(name);
+    if (slot >= 0)
+        return slot;
+    extraSlots.push_back(name);
+    return LetterSlots + extraSlots.size() - 1;
+}
+
+std::uint16_t Toolpath::letterSlot(char c)
+{
+    c = std::toupper(static_cast<unsigned char>(c));
+    if (c >= 'A' && c <= 'Z')
+        return c - 'A';
+    return internSlot(std::string(1, c));
+}
+
+int Toolpath::findSlot(const std::string &name) const
+{
+    if (isUpperLetter(name))
+        return name[0] - 'A';
+    for (std::size_t i = 0; i < extraSlots.size(); ++i) {
+        if (extraSlots[i] == name)
+            return LetterSlots + i;
+    }
+    return -1;
+}
+
+const std::string &Toolpath::getSlotName(std::uint16_t slot) const
+{
+    if (slot < LetterSlots)
+        return letterName(slot);
+    return extraSlots[slot - LetterSlots];
+}
+
+int Toolpath::findParameter(unsigned int pos, std::uint16_t slot) const
+{
+    for (std::uint32_t i = paramOffsets[pos]; i < paramOffsets[pos+1]; ++i) {
+        if (paramSlots[i] == slot)
+            return i;
+    }
+    return -1;
+}
+
+double Toolpath::getParameter(unsigned int pos, std::uint16_t slot, double fallback) const
+{
+    switch (slot) {
+    case SlotX:
+        return (axisFlags[pos] & HasX) ? axes[pos].x : fallback;
+    case SlotY:
+        return (axisFlags[pos] & HasY) ? axes[pos].y : fallback;
+    case SlotZ:
+        return (axisFlags[pos] & HasZ) ? axes[pos].z : fallback;
+    default:
+        int i = findParameter(pos, slot);
+        return i < 0 ? fallback : paramValues[i];
+    }
+}
+
+Base::Vector3d Toolpath::getPosition(unsigned int pos, const Base::Vector3d &last) const
+{
+    std::uint8_t flags = axisFlags[pos];
+    const Vector3d &axis = axes[pos];
+    return Vector3d((flags & HasX) ? axis.x : last.x,
+                    (flags & HasY) ? axis.y : last.y,
+                    (flags & HasZ) ? axis.z : last.z);
+}
+
+Base::Vector3d Toolpath::getCenter(unsigned int pos) const
+{
+    return Vector3d(getParameter(pos, SlotI, 0.0),
+                    getParameter(pos, SlotJ, 0.0),
+                    getParameter(pos, SlotK, 0.0));
+}
+
+void Toolpath::storeCommand(unsigned int pos, std::uint32_t name, ParameterList &params)
+{
+    // the parameters behave like a map: ordered by name and the last value
+    // given for a name wins. There are only a few per command, so a stable
+    // insertion sort does without any allocation.
+    auto less = [this](std::uint16_t a, std::uint16_t b) {
+        if (a < LetterSlots && b < LetterSlots)
+            return a < b;
+        return getSlotName(a) < getSlotName(b);
+    };
+    for (std::size_t i = 1; i < params.size(); ++i) {
+        ParameterList::value_type p = params[i];
+        std::size_t j = i;
+        for (; j > 0 && less(p.first, params[j-1].first); --j)
+            params[j] = params[j-1];
+        params[j] = p;
+    }
+
+    std::uint8_t flags = 0;
+    Vector3d axis;
+    std::uint32_t first = paramOffsets[pos];
+    std::uint32_t count = 0;
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        if (i + 1 < params.size() && params[i+1].first == params[i].first)
+            continue;
+        switch (params[i].first) {
+        case SlotX:
+            flags |= HasX;
+            axis.x = params[i].second;
+            break;
+        case SlotY:
+            flags |= HasY;
+            axis.y = params[i].second;
+            break;
+        case SlotZ:
+            flags |= HasZ;
+            axis.z = params[i].second;
+            break;
+        default:
+            paramSlots.insert(paramSlots.begin() + first + count, params[i].first);
+            paramValues.insert(paramValues.begin() + first + count, params[i].second);
+            ++count;
+            break;
+        }
+    }
+
+    opcodes.insert(opcodes.begin() + pos, name);
+    axisFlags.insert(axisFlags.begin() + pos, flags);
+    axes.insert(axes.begin() + pos, axis);
+    paramOffsets.insert(paramOffsets.begin() + pos + 1, first + count);
+    for (std::size_t i = pos + 2; i < paramOffsets.size(); ++i)
+        paramOffsets[i] += count;
+}
+
 void Toolpath::addCommand(const Command &Cmd)
 {
-    Command *tmp = new Command(Cmd);
-    vpcCommands.push_back(tmp);
-    recalculate();
+    insertCommand(Cmd, getSize());
 }
 
 void Toolpath::insertCommand(const Command &Cmd, int pos)
 {
-    if (pos == -1) {
-        addCommand(Cmd);
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        Command *tmp = new Command(Cmd);
-        vpcCommands.insert(vpcCommands.begin()+pos,tmp);
-    } else {
+    if (pos == -1)
+        pos = getSize();
+    if (pos < 0 || pos > static_cast<int>(getSize()))
         throw Base::IndexError("Index not in range");
-    }
+
+    ParameterList params;
+    params.reserve(Cmd.Parameters.size());
+    for (std::map<std::string,double>::const_iterator it = Cmd.Parameters.begin(); it != Cmd.Parameters.end(); ++it)
+        params.push_back(std::make_pair(internSlot(it->first), it->second));
+    storeCommand(pos, internName(Cmd.Name), params);
     recalculate();
 }
 
 void Toolpath::deleteCommand(int pos)
 {
-    if (pos == -1) {
-        //delete(*vpcCommands.rbegin()); // causes crash
-        vpcCommands.pop_back();
-    } else if (pos <= static_cast<int>(vpcCommands.size())) {
-        vpcCommands.erase (vpcCommands.begin()+pos);
-    } else {
+    if (pos == -1)
+        pos = static_cast<int>(getSize()) - 1;
+    if (pos < 0 || pos >= static_cast<int>(getSize()))
         throw Base::IndexError("Index not in range");
-    }
+
+    std::uint32_t first = paramOffsets[pos];
+    std::uint32_t count = paramOffsets[pos+1] - first;
+    paramSlots.erase(paramSlots.begin() + first, paramSlots.begin() + first + count);
+    paramValues.erase(paramValues.begin() + first, paramValues.begin() + first + count);
+    paramOffsets.erase(paramOffsets.begin() + pos + 1);
+    for (std::size_t i = pos + 1; i < paramOffsets.size(); ++i)
+        paramOffsets[i] -= count;
+    opcodes.erase(opcodes.begin() + pos);
+    axisFlags.erase(axisFlags.begin() + pos);
+    axes.erase(axes.begin() + pos);
     recalculate();
 }
 
-double Toolpath::getLength()
+double Toolpath::getLength() const
 {
-    if(vpcCommands.size()==0)
+    if(getSize()==0)
         return 0;
     double l = 0;
     Vector3d last(0,0,0);
     Vector3d next;
-    for(std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        next = (*it)->getPlacement(last).getPosition();
-        if ( (name == "G0") || (name == "G00") || (name == "G1") || (name == "G01") ) {
+    for(unsigned int i = 0; i < getSize(); ++i) {
+        switch (motions[opcodes[i]]) {
+        case Rapid:
+        case Feed:
             // straight line
+            next = getPosition(i, last);
             l += (next - last).Length();
             last = next;
-        } else if ( (name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+            break;
+        case ArcCW:
+        case ArcCCW: {
             // arc
-            Vector3d center = (*it)->getCenter();
+            next = getPosition(i, last);
+            Vector3d center = getCenter(i);
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
             last = next;
+            break;
+        }
+        default:
+            break;
         }
     }
     return l;
 }
 
-double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double vRapid)
+double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double vRapid) const
 {
     // check the feedrates are set
     if ((hFeed == 0) || (vFeed == 0)){
@@ -163,40 +534,40 @@ double Toolpath::getCycleTime(double hFeed, double vFeed, double hRapid, double
         vRapid = vFeed;
     }
 
-    if(vpcCommands.size()==0)
+    if(getSize()==0)
         return 0;
     double l = 0;
     double time = 0;
     bool verticalMove = false;
     Vector3d last(0,0,0);
     Vector3d next;
-    for(std::vector<Command*>::const_iterator it = vpcCommands.begin();it!=vpcCommands.end();++it) {
-        std::string name = (*it)->Name;
-        float feedrate = (*it)->getParam("F");
+    for(unsigned int i = 0; i < getSize(); ++i) {
+        Motion motion = static_cast<Motion>(motions[opcodes[i]]);
+        float feedrate;
 
         l = 0;
         verticalMove = false;
         feedrate = hFeed;
-        next = (*it)->getPlacement(last).getPosition();
+        next = getPosition(i, last);
 
         if (last.z != next.z){
             verticalMove = true;
             feedrate = vFeed;
         }
 
-        if ((name == "G0") || (name == "G00")){
+        if (motion == Rapid){
             // Rapid Move
             l += (next - last).Length();
             feedrate = hRapid;
             if(verticalMove){
                 feedrate = vRapid;
             }
-        }else if ((name == "G1") || (name == "G01")) {
+        }else if (motion == Feed) {
             // Feed Move
             l += (next - last).Length();
-        }else if ((name == "G2") || (name == "G02") || (name == "G3") || (name == "G03") ) {
+        }else if ((motion == ArcCW) || (motion == ArcCCW)) {
             // Arc Move
-            Vector3d center = (*it)->getCenter();
+            Vector3d center = getCenter(i);
             double radius = (last - center).Length();
             double angle = (next - center).GetAngle(last - center);
             l += angle * radius;
@@ -280,21 +651,91 @@ Base::BoundBox3d Toolpath::getBoundBox() const
     return visitor.bb;
 }
 
-static void bulkAddCommand(const std::string &gcodestr, std::vector<Command*> &commands, bool &inches)
+void Toolpath::bulkAddCommand(const char *begin, const char *end, ParameterList &params, std::string &value, bool &inches)
 {
-    Command *cmd = new Command();
-    cmd->setFromGCode(gcodestr);
-    if ("G20" == cmd->Name) {
+    // parses a single command the same way Command::setFromGCode() does,
+    // but straight into the columns
+    enum { None, CommandMode, ArgumentMode, CommentMode } mode = None;
+    std::string name;
+    char key = 0;
+    params.clear();
+    value.clear();
+    for (const char *it = begin; it != end; ++it) {
+        unsigned char c = *it;
+        if ( (std::isdigit(c)) || (c == '-') || (c == '.') ) {
+            value += c;
+        } else if (std::isalpha(c)) {
+            if (mode == CommandMode) {
+                if (key && !value.empty()) {
+                    name = key + value;
+                    upperCase(name);
+                    key = 0;
+                    value.clear();
+                } else {
+                    throw Base::BadFormatError("Badly formatted GCode command");
+                }
+                mode = ArgumentMode;
+            } else if (mode == None) {
+                mode = CommandMode;
+            } else if (mode == ArgumentMode) {
+                if (key && !value.empty()) {
+                    params.push_back(std::make_pair(letterSlot(key), toDouble(value)));
+                    key = 0;
+                    value.clear();
+                } else {
+                    throw Base::BadFormatError("Badly formatted GCode argument");
+                }
+            } else if (mode == CommentMode) {
+                value += c;
+            }
+            key = c;
+        } else if (c == '(') {
+            mode = CommentMode;
+        } else if (c == ')') {
+            key = '(';
+            value += ')';
+        } else {
+            // add non-ascii characters only if this is a comment
+            if (mode == CommentMode) {
+                value += c;
+            }
+        }
+    }
+    if (key && !value.empty()) {
+        if ( (mode == CommandMode) || (mode == CommentMode) ) {
+            name = key + value;
+            if (mode == CommandMode)
+                upperCase(name);
+        } else {
+            params.push_back(std::make_pair(letterSlot(key), toDouble(value)));
+        }
+    } else {
+        throw Base::BadFormatError("Badly formatted GCode argument");
+    }
+
+    if ("G20" == name) {
         inches = true;
-        delete cmd;
-    } else if ("G21" == cmd->Name) {
+    } else if ("G21" == name) {
         inches = false;
-        delete cmd;
     } else {
         if (inches) {
-            cmd->scaleBy(25.4);
+            // same axes as Command::scaleBy()
+            for (ParameterList::iterator it = params.begin(); it != params.end(); ++it) {
+                switch (getSlotName(it->first)[0]) {
+                    case 'X':
+                    case 'Y':
+                    case 'Z':
+                    case 'I':
+                    case 'J':
+                    case 'R':
+                    case 'Q':
+                    case 'F':
+                        it->second *= 25.4;
+                        break;
+                }
+            }
         }
-        commands.push_back(cmd);
+        storeCommand(getSize(), internName(name), params);
     }
 }
 
@@ -305,66 +746,68 @@ void Toolpath::setFromGCode(const std::string instr)
     // remove comments
     //boost::regex e("\\(.*?\\)");
     //std::string str = boost::regex_replace(instr, e, "");
-    std::string str(instr);
+    const char *str = instr.c_str();
+    const char *strEnd = str + instr.size();
+    static const char separators[] = "(gGmM";
+    auto findSeparator = [strEnd](const char *from) {
+        return std::find_first_of(from, strEnd, separators, separators + sizeof(separators) - 1);
+    };
+
+    ParameterList params;
+    std::string value;
 
     // split input string by () or G or M commands
-    std::string mode = "command";
-    std::size_t found = str.find_first_of("(gGmM");
-    int last = -1;
+    bool comment = false;
+    const char *found = findSeparator(str);
+    const char *last = nullptr;
     bool inches = false;
-    while (found != std::string::npos)
+    while (found != strEnd)
     {
-        if (str[found] == '(') {
+        if (*found == '(') {
             // start of comment
-            if ( (last > -1) && (mode == "command") ) {
+            if ( last && !comment ) {
                 // before opening a comment, add the last found command
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+                bulkAddCommand(last, found, params, value, inches);
             }
-            mode = "comment";
+            comment = true;
             last = found;
-            found = str.find_first_of(')', found+1);
-        } else if (str[found] == ')') {
+            found = std::find(found+1, strEnd, ')');
+        } else if (*found == ')') {
             // end of comment
-            std::string gcodestr = str.substr(last, found-last+1);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-            last = -1;
-            found = str.find_first_of("(gGmM", found+1);
-            mode = "command";
-        } else if (mode == "command") {
+            bulkAddCommand(last, found+1, params, value, inches);
+            last = nullptr;
+            found = findSeparator(found+1);
+            comment = false;
+        } else if (!comment) {
             // command
-            if (last > -1) {
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
+            if (last) {
+                bulkAddCommand(last, found, params, value, inches);
             }
             last = found;
-            found = str.find_first_of("(gGmM", found+1);
+            found = findSeparator(found+1);
         }
     }
     // add the last command found, if any
-    if (last > -1) {
-        if (mode == "command") {
-            std::string gcodestr = str.substr(last,std::string::npos);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-        }
+    if (last && !comment) {
+        bulkAddCommand(last, strEnd, params, value, inches);
     }
     recalculate();
 }
 
 std::string Toolpath::toGCode(void) const
 {
-    std::string result;
-    for (std::vector<Command*>::const_iterator it=vpcCommands.begin();it!=vpcCommands.end();++it) {
-        result += (*it)->toGCode();
-        result += "\n";
+    std::stringstream str;
+    for (unsigned int i = 0; i < getSize(); ++i) {
+        getCommand(i).writeGCode(str);
+        str << "\n";
     }
-    return result;
+    return str.str();
 }
 
 void Toolpath::recalculate(void) // recalculates the path cache
 {
 
-    if(vpcCommands.size()==0)
+    if(getSize()==0)
         return;
 
     // TODO recalculate the KDL stuff. At the moment, this is unused.
@@ -428,7 +871,12 @@ void Toolpath::recalculate(void) // recalculates the path cache
 
 unsigned int Toolpath::getMemSize (void) const
 {
-    return toGCode().size();
+    return opcodes.capacity() * sizeof(std::uint32_t)
+         + axisFlags.capacity() * sizeof(std::uint8_t)
+         + axes.capacity() * sizeof(Base::Vector3d)
+         + paramOffsets.capacity() * sizeof(std::uint32_t)
+         + paramSlots.capacity() * sizeof(std::uint16_t)
+         + paramValues.capacity() * sizeof(double);
 }
 
 void Toolpath::setCenter(const Base::Vector3d &c)
@@ -449,7 +897,7 @@ void Toolpath::Save (Writer &writer) const
         writer.incInd();
         saveCenter(writer, center);
         for(unsigned int i = 0; i < getSize(); i++) {
-            vpcCommands[i]->Save(writer);
+            getCommand(i).toCommand().Save(writer);
         }
         writer.decInd();
     } else {
@@ -464,9 +912,10 @@ void Toolpath::Save (Writer &writer) const
 
 void Toolpath::SaveDocFile (Base::Writer &writer) const
 {
-    if (toGCode().empty())
-        return;
-    writer.Stream() << toGCode();
+    for (unsigned int i = 0; i < getSize(); ++i) {
+        getCommand(i).writeGCode(writer.Stream());
+        writer.Stream() << "\n";
+    }
 }
 
 void Toolpath::Restore(XMLReader &reader)
@@ -24,6 +24,10 @@
 #ifndef PATH_Path_H
 #define PATH_Path_H
 
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "Command.h"
 //#include "Mod/Robot/App/kdl_cp/path_composite.hpp"
 //#include "Mod/Robot/App/kdl_cp/frames_io.hpp"
@@ -34,8 +38,42 @@
 namespace Path
 {
 
-    /** The representation of a CNC Toolpath */
-    
+    class Toolpath;
+
+    /** A read-only view on one command stored in a Toolpath
+     *
+     * The view does not copy anything, it refers to the columns of the path
+     * and is only valid as long as the path is not modified.
+     */
+    class PathExport CommandView
+    {
+        public:
+            CommandView(const Toolpath &tp, unsigned int index);
+
+            const std::string &getName(void) const; // returns the command name
+            bool has(const std::string&) const; // returns true if the given string exists in the parameters
+            double getValue(const std::string &name) const; // returns the value of a given parameter
+            double getParam(const std::string &name, double fallback = 0.0) const; // this assumes the name is upper case
+            Base::Placement getPlacement (const Base::Vector3d pos = Base::Vector3d()) const; // returns a placement from the x,y,z,a,b,c parameters
+            Base::Vector3d getPosition (const Base::Vector3d &pos) const; // returns the x,y,z parameters, missing ones are taken from pos
+            Base::Vector3d getCenter (void) const; // returns a 3d vector from the i,j,k parameters
+            std::map<std::string,double> getParameters(void) const; // returns a copy of all parameters
+            std::string toGCode (int precision=6, bool padzero=true) const; // returns a GCode string representation of the command
+            void writeGCode (std::ostream &str, int precision=6, bool padzero=true) const; // writes the GCode representation to a stream
+            Command toCommand(void) const; // returns a standalone copy of the command
+
+        private:
+            const Toolpath &tp;
+            unsigned int index;
+    };
+
+    /** The representation of a CNC Toolpath
+     *
+     * The commands are stored column-wise: one interned name (opcode) per
+     * command, dense X/Y/Z coordinates and a compact list of all other
+     * parameters, each referring to an interned parameter slot. Use
+     * getCommand() to access a command through a CommandView.
+     */
     class PathExport Toolpath : public Base::Persistence
     {
         TYPESYSTEM_HEADER();
@@ -59,17 +97,16 @@ namespace Path
             void addCommand(const Command &Cmd); // adds a command at the end
             void insertCommand(const Command &Cmd, int); // inserts a command
             void deleteCommand(int); // deletes a command
-            double getLength(void); // return the Length (mm) of the Path
-            double getCycleTime(double, double, double, double); // return the Cycle Time (s) of the Path
+            double getLength(void) const; // return the Length (mm) of the Path
+            double getCycleTime(double, double, double, double) const; // return the Cycle Time (s) of the Path
             void recalculate(void); // recalculates the points
             void setFromGCode(const std::string); // sets the path from the contents of the given GCode string
             std::string toGCode(void) const; // gets a gcode string representation from the Path
             Base::BoundBox3d getBoundBox(void) const;
             
             // shortcut functions
-            unsigned int getSize(void) const { return vpcCommands.size(); }
-            const std::vector<Command*> &getCommands(void) const { return vpcCommands; }
-            const Command &getCommand(unsigned int pos)    const { return *vpcCommands[pos]; }
+            unsigned int getSize(void) const { return opcodes.size(); }
+            CommandView getCommand(unsigned int pos) const { return CommandView(*this, pos); }
         
             // support for rotation
             const Base::Vector3d& getCenter() const { return center; }
@@ -78,8 +115,50 @@ namespace Path
             static const int SchemaVersion = 2;
 
         protected:
-            std::vector<Command*> vpcCommands;
+            enum Motion {
+                NoMotion,
+                Rapid,
+                Feed,
+                ArcCW,
+                ArcCCW
+            };
+            enum Axis {
+                HasX = 1,
+                HasY = 2,
+                HasZ = 4
+            };
+            typedef std::vector<std::pair<std::uint16_t,double> > ParameterList;
+
+            std::uint32_t internName(const std::string &name);
+            std::uint16_t internSlot(const std::string &name);
+            std::uint16_t letterSlot(char c);
+            int findSlot(const std::string &name) const;
+            const std::string &getSlotName(std::uint16_t slot) const;
+            int findParameter(unsigned int pos, std::uint16_t slot) const;
+            double getParameter(unsigned int pos, std::uint16_t slot, double fallback) const;
+            Base::Vector3d getPosition(unsigned int pos, const Base::Vector3d &last) const;
+            Base::Vector3d getCenter(unsigned int pos) const;
+            void storeCommand(unsigned int pos, std::uint32_t name, ParameterList &params);
+            void bulkAddCommand(const char *begin, const char *end, ParameterList &params, std::string &value, bool &inches);
+
+            // one entry per command
+            std::vector<std::uint32_t> opcodes;         // index into names
+            std::vector<std::uint8_t> axisFlags;        // which of X/Y/Z are set
+            std::vector<Base::Vector3d> axes;           // X/Y/Z values
+            std::vector<std::uint32_t> paramOffsets;    // first entry in paramSlots, getSize()+1 entries
+            // all other parameters of all commands
+            std::vector<std::uint16_t> paramSlots;      // index into the parameter names
+            std::vector<double> paramValues;
+            // interned command names and the motion they describe
+            std::vector<std::string> names;
+            std::vector<std::uint8_t> motions;
+            std::unordered_map<std::string,std::uint32_t> nameIndex;
+            // parameter names that are not a single upper case letter
+            std::vector<std::string> extraSlots;
+
             Base::Vector3d center;
+
+            friend class CommandView;
             //KDL::Path_Composite *pcPath;
             
         /*
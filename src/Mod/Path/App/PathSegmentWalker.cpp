@@ -142,8 +142,8 @@ void PathSegmentWalker::walk(PathSegmentVisitor &cb, const Base::Vector3d &start
     for (unsigned int  i = 0; i < tp.getSize(); i++) {
         std::deque<Base::Vector3d> points;
 
-        const Path::Command &cmd = tp.getCommand(i);
-        const std::string &name = cmd.Name;
+        const Path::CommandView cmd = tp.getCommand(i);
+        const std::string &name = cmd.getName();
         Base::Vector3d next = cmd.getPlacement().getPosition();
         double a = A;
         double b = B;
@@ -381,6 +381,10 @@ def Execute(op,obj):
         if hasattr(obj, 'KeepToolDownRatio'):
             keepToolDownRatio = float(obj.KeepToolDownRatio)
 
+        threadCount = 0
+        if hasattr(obj, 'ThreadCount'):
+            threadCount = obj.ThreadCount
+
         # put here all properties that influence calculation of adaptive base paths,
 
         inputStateObject = {
@@ -432,6 +436,7 @@ def Execute(op,obj):
             a2d.tolerance = float(obj.Tolerance)
             a2d.forceInsideOut = obj.ForceInsideOut
             a2d.opType = opType
+            a2d.threadCount = threadCount
 
             # EXECUTE
             results = a2d.Execute(stockPath2d,path2d,progressFn)
@@ -505,6 +510,7 @@ class PathAdaptive(PathOp.ObjectOp):
         obj.setEditorMode('AdaptiveOutputState', 2) #hide this property
         obj.addProperty("App::PropertyAngle", "HelixAngle", "Adaptive",  "Helix ramp entry angle (degrees)")
         obj.addProperty("App::PropertyLength", "HelixDiameterLimit", "Adaptive", "Limit helix entry diameter, if limit larger than tool diameter or 0, tool diameter is used")
+        obj.addProperty("App::PropertyInteger", "ThreadCount", "Adaptive", "Number of separate regions processed concurrently, 0 uses one thread per hardware thread (hardware concurrency)")
 
 
     def opSetDefaultValues(self, obj, job):
@@ -524,6 +530,7 @@ class PathAdaptive(PathOp.ObjectOp):
         obj.StockToLeave = 0
         obj.KeepToolDownRatio = 3.0
         obj.UseHelixArcs = False
+        obj.ThreadCount = 0
 
     def opExecute(self, obj):
         '''opExecute(obj) ... called whenever the receiver needs to be recalculated.
@@ -142,7 +142,8 @@ class PathSimulation:
         self.icmd = 0
         self.curpos = FreeCAD.Placement(self.initialPos, self.stdrot)
         self.cutTool.Placement = self.curpos
-        self.opCommands = self.operation.Path.Commands
+        self.opPath = self.operation.Path
+        self.opCommands = self.opPath.Commands
 
     def SimulateMill(self):
         self.job = self.jobs[self.taskForm.form.comboJobs.currentIndex()]
@@ -245,28 +246,33 @@ class PathSimulation:
             return
         self.busy = True
 
-        cmd = self.opCommands[self.icmd]
-        # for cmd in job.Path.Commands:
-        if cmd.Name in ['G0', 'G1', 'G2', 'G3']:
-            self.curpos = self.voxSim.ApplyCommand(self.curpos, cmd)
-            if not self.disableAnim:
-                self.cutTool.Placement = self.curpos
-                (self.cutMaterial.Mesh, self.cutMaterialIn.Mesh) = self.voxSim.GetResultMesh()
-        if cmd.Name in ['G81', 'G82', 'G83']:
-            extendcommands = []
-            if self.firstDrill:
-                extendcommands.append(Path.Command('G0', {"X": 0.0, "Y": 0.0, "Z": cmd.r}))
-                self.firstDrill = False
-            extendcommands.append(Path.Command('G0', {"X": cmd.x, "Y": cmd.y, "Z": cmd.r}))
-            extendcommands.append(Path.Command('G1', {"X": cmd.x, "Y": cmd.y, "Z": cmd.z}))
-            extendcommands.append(Path.Command('G1', {"X": cmd.x, "Y": cmd.y, "Z": cmd.r}))
-            for ecmd in extendcommands:
-                self.curpos = self.voxSim.ApplyCommand(self.curpos, ecmd)
+        count = self.FastForwardCount() if self.disableAnim else 0
+        if count > 0:
+            self.curpos = self.voxSim.ApplyPath(self.curpos, self.opPath, self.icmd, count)
+        else:
+            count = 1
+            cmd = self.opCommands[self.icmd]
+            # for cmd in job.Path.Commands:
+            if cmd.Name in ['G0', 'G1', 'G2', 'G3']:
+                self.curpos = self.voxSim.ApplyCommand(self.curpos, cmd)
                 if not self.disableAnim:
                     self.cutTool.Placement = self.curpos
                     (self.cutMaterial.Mesh, self.cutMaterialIn.Mesh) = self.voxSim.GetResultMesh()
-        self.icmd += 1
-        self.iprogress += 1
+            if cmd.Name in ['G81', 'G82', 'G83']:
+                extendcommands = []
+                if self.firstDrill:
+                    extendcommands.append(Path.Command('G0', {"X": 0.0, "Y": 0.0, "Z": cmd.r}))
+                    self.firstDrill = False
+                extendcommands.append(Path.Command('G0', {"X": cmd.x, "Y": cmd.y, "Z": cmd.r}))
+                extendcommands.append(Path.Command('G1', {"X": cmd.x, "Y": cmd.y, "Z": cmd.z}))
+                extendcommands.append(Path.Command('G1', {"X": cmd.x, "Y": cmd.y, "Z": cmd.r}))
+                for ecmd in extendcommands:
+                    self.curpos = self.voxSim.ApplyCommand(self.curpos, ecmd)
+                    if not self.disableAnim:
+                        self.cutTool.Placement = self.curpos
+                        (self.cutMaterial.Mesh, self.cutMaterialIn.Mesh) = self.voxSim.GetResultMesh()
+        self.icmd += count
+        self.iprogress += count
         self.UpdateProgress()
         if self.icmd >= len(self.opCommands):
             self.ioperation += 1
@@ -277,6 +283,16 @@ class PathSimulation:
                 self.SetupOperation(self.ioperation)
         self.busy = False
 
+    # number of commands to cut in one batch when fast forwarding, stops
+    # before the first drill cycle which needs an extra rapid move
+    def FastForwardCount(self):
+        end = min(self.icmd + 10000, len(self.opCommands))
+        if self.firstDrill:
+            for i in range(self.icmd, end):
+                if self.opCommands[i].Name in ['G81', 'G82', 'G83']:
+                    return i - self.icmd
+        return end - self.icmd
+
     def PerformCut(self):
         if (self.isVoxel):
             self.PerformCutVoxel()
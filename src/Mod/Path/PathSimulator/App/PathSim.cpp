@@ -53,14 +53,18 @@ PathSim::~PathSim()
 		delete m_tool;
 }
 
-void PathSim::BeginSimulation(Part::TopoShape * stock, float resolution)
+void PathSim::BeginSimulation(Part::TopoShape * stock, float resolution, bool multiDexel)
 {
 	Base::BoundBox3d bbox = stock->getBoundBox();
-	m_stock = new cStock(bbox.MinX, bbox.MinY, bbox.MinZ, bbox.LengthX(), bbox.LengthY(), bbox.LengthZ(), resolution);
+	delete m_stock;
+	m_stock = nullptr;
+	m_stock = new cStock(bbox.MinX, bbox.MinY, bbox.MinZ, bbox.LengthX(), bbox.LengthY(), bbox.LengthZ(), resolution, multiDexel);
 }
 
 void PathSim::SetToolShape(const TopoDS_Shape& toolShape, float resolution)
 {
+	delete m_tool;
+	m_tool = nullptr;
 	m_tool = new cSimTool(toolShape, resolution);	
 }
 
@@ -95,6 +99,49 @@ Base::Placement * PathSim::ApplyCommand(Base::Placement * pos, Command * cmd)
 	return plc;
 }
 
+Base::Placement * PathSim::ApplyPath(Base::Placement * pos, const Toolpath & path, unsigned int start, unsigned int count)
+{
+	// Collect the moves of all commands, so that the stock can apply them in
+	// one concurrent batch. Drill cycles are expanded the same way as done by
+	// the simulator GUI.
+	std::vector<cSimMove> moves;
+	Point3D curPos(*pos);
+	unsigned int end = std::min(path.getSize(), start + count);
+	for (unsigned int i = start; i < end; i++)
+	{
+		CommandView cmd = path.getCommand(i);
+		const std::string & name = cmd.getName();
+		Point3D toPos = curPos;
+		toPos.UpdateCmd(cmd);
+		if (name == "G0" || name == "G1")
+			moves.push_back(cSimMove(cSimMove::Linear, curPos, toPos));
+		else if (name == "G2" || name == "G3")
+		{
+			Vector3d vcent = cmd.getCenter();
+			Point3D cent(vcent);
+			moves.push_back(cSimMove(name == "G3" ? cSimMove::ArcCCW : cSimMove::ArcCW, curPos, toPos, cent));
+		}
+		else if (name == "G81" || name == "G82" || name == "G83")
+		{
+			float r = cmd.getParam("R", curPos.z);
+			Point3D retract(toPos.x, toPos.y, r);
+			moves.push_back(cSimMove(cSimMove::Linear, curPos, retract));
+			moves.push_back(cSimMove(cSimMove::Linear, retract, toPos));
+			moves.push_back(cSimMove(cSimMove::Linear, toPos, retract));
+			toPos = retract;
+		}
+		else
+			continue;
+		curPos = toPos;
+	}
+	if (m_tool != NULL)
+		m_stock->ApplyMoves(moves, *m_tool);
+
+	Base::Placement *plc = new Base::Placement(*pos);
+	plc->setPosition(Vector3d(curPos.x, curPos.y, curPos.z));
+	return plc;
+}
+
 
 
 
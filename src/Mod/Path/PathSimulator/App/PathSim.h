@@ -31,6 +31,7 @@
 #include <TopoDS.hxx>
 #include <TopoDS_Shape.hxx>
 #include <Mod/Path/App/Command.h>
+#include <Mod/Path/App/Path.h>
 #include <Mod/Part/App/TopoShape.h>
 #include "VolSim.h"
 
@@ -49,9 +50,10 @@ namespace PathSimulator
 			PathSim();
 			~PathSim();
             
-			void BeginSimulation(Part::TopoShape * stock, float resolution);
+			void BeginSimulation(Part::TopoShape * stock, float resolution, bool multiDexel = false);
 			void SetToolShape(const TopoDS_Shape& toolShape, float resolution);
 			Base::Placement * ApplyCommand(Base::Placement * pos, Command * cmd);
+			Base::Placement * ApplyPath(Base::Placement * pos, const Toolpath & path, unsigned int start, unsigned int count);
 
 		public:
 			cStock * m_stock;
@@ -27,6 +27,7 @@
 #include <Base/VectorPy.h>
 #include <Mod/Part/App/TopoShapePy.h>
 #include <Mod/Path/App/CommandPy.h>
+#include <Mod/Path/App/PathPy.h>
 #include <Mod/Mesh/App/MeshPy.h>
 #include "Mod/Path/PathSimulator/App/PathSim.h"
 
@@ -57,14 +58,15 @@ int PathSimPy::PyInit(PyObject* /*args*/, PyObject* /*kwd*/)
 
 PyObject* PathSimPy::BeginSimulation(PyObject * args, PyObject * kwds)
 {
-	static char *kwlist[] = { "stock", "resolution", NULL };
+	static char *kwlist[] = { "stock", "resolution", "multiDexel", NULL };
 	PyObject *pObjStock;
 	float resolution;
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!f", kwlist, &(Part::TopoShapePy::Type), &pObjStock, &resolution))
+	PyObject *multiDexel = Py_False;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!f|O!", kwlist, &(Part::TopoShapePy::Type), &pObjStock, &resolution, &PyBool_Type, &multiDexel))
 		return 0;
 	PathSim *sim = getPathSimPtr();
 	Part::TopoShape *stock = static_cast<Part::TopoShapePy*>(pObjStock)->getTopoShapePtr();
-	sim->BeginSimulation(stock, resolution);
+	sim->BeginSimulation(stock, resolution, PyObject_IsTrue(multiDexel) ? true : false);
 	Py_IncRef(Py_None);
 	return Py_None;
 }
@@ -122,6 +124,30 @@ PyObject* PathSimPy::ApplyCommand(PyObject * args, PyObject * kwds)
 	return newposPy;
 }
 
+PyObject* PathSimPy::ApplyPath(PyObject * args, PyObject * kwds)
+{
+	static char *kwlist[] = { "position", "path", "start", "count", NULL };
+	PyObject *pObjPlace;
+	PyObject *pObjPath;
+	int start = 0;
+	int count = -1;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!O!|ii", kwlist, &(Base::PlacementPy::Type), &pObjPlace, &(Path::PathPy::Type), &pObjPath, &start, &count))
+		return 0;
+	PathSim *sim = getPathSimPtr();
+	if (sim->m_stock == NULL)
+	{
+		PyErr_SetString(PyExc_RuntimeError, "Simulation has no stock object");
+		return 0;
+	}
+	Base::Placement *pos = static_cast<Base::PlacementPy*>(pObjPlace)->getPlacementPtr();
+	const Path::Toolpath *path = static_cast<Path::PathPy*>(pObjPath)->getToolpathPtr();
+	if (start < 0)
+		start = 0;
+	unsigned int num = count < 0 ? path->getSize() : (unsigned int)count;
+	Base::Placement *newpos = sim->ApplyPath(pos, *path, start, num);
+	return new Base::PlacementPy(newpos);
+}
+
 Py::Object PathSimPy::getTool(void) const
 {
     //return Py::Object();
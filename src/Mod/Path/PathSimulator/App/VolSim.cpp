@@ -25,7 +25,10 @@
 
 #include <BRepCheck_Analyzer.hxx>
 #include <BRepClass3d_SolidClassifier.hxx>
+#include <IntCurvesFace_ShapeIntersector.hxx>
+#include <gp_Lin.hxx>
 #include <gp_Pnt.hxx>
+#include <QtConcurrentMap>
 
 #ifndef _PreComp_
 # include <algorithm>
@@ -36,8 +39,8 @@
 //************************************************************************************************************
 // stock
 //************************************************************************************************************
-cStock::cStock(float px, float py, float pz, float lx, float ly, float lz, float res)
-	: m_px(px), m_py(py), m_pz(pz), m_lx(lx), m_ly(ly), m_lz(lz), m_res(res)
+cStock::cStock(float px, float py, float pz, float lx, float ly, float lz, float res, bool multiDexel)
+	: m_px(px), m_py(py), m_pz(pz), m_lx(lx), m_ly(ly), m_lz(lz), m_res(res), m_multiDexel(multiDexel)
 {
 	m_x = (int)(m_lx / res) + 1;
 	m_y = (int)(m_ly / res) + 1;
@@ -50,6 +53,11 @@ cStock::cStock(float px, float py, float pz, float lx, float ly, float lz, float
 			m_stock[x][y] = m_plane;
 			m_attr[x][y] = 0;
 		}
+	m_tx = (m_x + SIM_TILE_SIZE - 1) >> SIM_TILE_SHIFT;
+	m_ty = (m_y + SIM_TILE_SIZE - 1) >> SIM_TILE_SHIFT;
+	m_tiles.resize(m_tx * m_ty);
+	if (m_multiDexel)
+		m_dexels.assign(m_x * m_y, cDexel(1, std::make_pair(m_pz, m_plane)));
 }
 
 cStock::~cStock()
@@ -57,7 +65,7 @@ cStock::~cStock()
 }
 
 
-float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz)
+float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz, const cSimRect & rect)
 {
 	float z = m_stock[xp][yp];
 	bool xr_ok = true;
@@ -71,7 +79,7 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 		if (xr_ok)
 		{
 			int tx = xp + x_size;
-			if (tx >= m_x)
+			if (tx >= rect.x2)
 				xr_ok = false;
 			else
 			{
@@ -92,7 +100,7 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 		if (xl_ok)
 		{
 			int tx = xp - 1;
-			if (tx < 0)
+			if (tx < rect.x1)
 				xl_ok = false;
 			else
 			{
@@ -116,7 +124,7 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 		if (yu_ok)
 		{
 			int ty = yp + y_size;
-			if (ty >= m_y)
+			if (ty >= rect.y2)
 				yu_ok = false;
 			else
 			{
@@ -137,7 +145,7 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 		if (yd_ok)
 		{
 			int ty = yp - 1;
-			if (ty < 0)
+			if (ty < rect.y1)
 				yd_ok = false;
 			else
 			{
@@ -160,23 +168,23 @@ float cStock::FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool s
 	return z;
 }
 
-int cStock::TesselTop(int xp, int yp)
+int cStock::TesselTop(int xp, int yp, const cSimRect & rect, cTile & tile)
 {
 	int x_size, y_size;
-	float z = FindRectTop(xp, yp, x_size, y_size, true);
+	float z = FindRectTop(xp, yp, x_size, y_size, true, rect);
 	bool farRect = false;
 	while (y_size / x_size > 5)
 	{
 		farRect = true;
 		yp += x_size * 5;
-		z = FindRectTop(xp, yp, x_size, y_size, true);
+		z = FindRectTop(xp, yp, x_size, y_size, true, rect);
 	}
 
 	while (x_size / y_size > 5)
 	{
 		farRect = true;
 		xp += y_size * 5;
-		z = FindRectTop(xp, yp, x_size, y_size, false);
+		z = FindRectTop(xp, yp, x_size, y_size, false, rect);
 	}
 
 	// mark all points inside
@@ -192,9 +200,9 @@ int cStock::TesselTop(int xp, int yp)
 		Point3D ptl(xp, yp + y_size, z);
 		Point3D ptr(xp + x_size, yp + y_size, z);
 		if (fabs(m_pz + m_lz - z) < SIM_EPSILON)
-			AddQuad(pbl, pbr, ptr, ptl, facetsOuter);
+			AddQuad(pbl, pbr, ptr, ptl, tile.facetsOuter);
 		else
-			AddQuad(pbl, pbr, ptr, ptl, facetsInner);
+			AddQuad(pbl, pbr, ptr, ptl, tile.facetsInner);
 	}
 
 	if (farRect)
@@ -204,7 +212,7 @@ int cStock::TesselTop(int xp, int yp)
 }
 
 
-void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz)
+void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz, const cSimRect & rect)
 {
 	bool xr_ok = true;
 	bool xl_ok = scanHoriz;
@@ -217,7 +225,7 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 		if (xr_ok)
 		{
 			int tx = xp + x_size;
-			if (tx >= m_x)
+			if (tx >= rect.x2)
 				xr_ok = false;
 			else
 			{
@@ -238,7 +246,7 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 		if (xl_ok)
 		{
 			int tx = xp - 1;
-			if (tx < 0)
+			if (tx < rect.x1)
 				xl_ok = false;
 			else
 			{
@@ -262,7 +270,7 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 		if (yu_ok)
 		{
 			int ty = yp + y_size;
-			if (ty >= m_y)
+			if (ty >= rect.y2)
 				yu_ok = false;
 			else
 			{
@@ -283,7 +291,7 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 		if (yd_ok)
 		{
 			int ty = yp - 1;
-			if (ty < 0)
+			if (ty < rect.y1)
 				yd_ok = false;
 			else
 			{
@@ -306,23 +314,23 @@ void cStock::FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool sc
 }
 
 
-int cStock::TesselBot(int xp, int yp)
+int cStock::TesselBot(int xp, int yp, const cSimRect & rect, cTile & tile)
 {
 	int x_size, y_size;
-	FindRectBot(xp, yp, x_size, y_size, true);
+	FindRectBot(xp, yp, x_size, y_size, true, rect);
 	bool farRect = false;
 	while (y_size / x_size > 5)
 	{
 		farRect = true;
 		yp += x_size * 5;
-		FindRectTop(xp, yp, x_size, y_size, true);
+		FindRectTop(xp, yp, x_size, y_size, true, rect);
 	}
 
 	while (x_size / y_size > 5)
 	{
 		farRect = true;
 		xp += y_size * 5;
-		FindRectTop(xp, yp, x_size, y_size, false);
+		FindRectTop(xp, yp, x_size, y_size, false, rect);
 	}
 
 	// mark all points inside
@@ -335,7 +343,7 @@ int cStock::TesselBot(int xp, int yp)
 	Point3D pbr(xp + x_size, yp, m_pz);
 	Point3D ptl(xp, yp + y_size, m_pz);
 	Point3D ptr(xp + x_size, yp + y_size, m_pz);
-	AddQuad(pbl, ptl, ptr, pbr, facetsOuter);
+	AddQuad(pbl, ptl, ptr, pbr, tile.facetsOuter);
 
 	if (farRect)
 		return -1;
@@ -344,33 +352,34 @@ int cStock::TesselBot(int xp, int yp)
 }
 
 
-int cStock::TesselSidesX(int yp)
+int cStock::TesselSidesX(int yp, const cSimRect & rect, cTile & tile)
 {
 	float lastz1 = m_pz;
 	if (yp < m_y)
-		lastz1 = std::max(m_stock[0][yp], m_pz);
+		lastz1 = std::max(m_stock[rect.x1][yp], m_pz);
 	float lastz2 = m_pz;
 	if (yp > 0)
-		lastz2 = std::max(m_stock[0][yp - 1], m_pz);
+		lastz2 = std::max(m_stock[rect.x1][yp - 1], m_pz);
 
-	std::vector<MeshCore::MeshGeomFacet> *facets = &facetsInner;
+	std::vector<MeshCore::MeshGeomFacet> *facets = &tile.facetsInner;
 	if (yp == 0 || yp == m_y)
-		facets = &facetsOuter;
+		facets = &tile.facetsOuter;
 
 	//bool lastzclip = (lastz - m_pz) < m_res;
-	int lastpoint = 0;
-	for (int x = 1; x <= m_x; x++)
+	int lastpoint = rect.x1;
+	for (int x = rect.x1 + 1; x <= rect.x2; x++)
 	{
 		float newz1 = m_pz;
-		if (yp < m_y && x < m_x)
+		if (yp < m_y && x < rect.x2)
 			newz1 = std::max(m_stock[x][yp], m_pz);
 		float newz2 = m_pz;
-		if (yp > 0 && x < m_x)
+		if (yp > 0 && x < rect.x2)
 			newz2 = std::max(m_stock[x][yp - 1], m_pz);
 
 		if (fabs(lastz1 - lastz2) > m_res)
 		{
-			if (fabs(newz1 - lastz1) < m_res && fabs(newz2 - lastz2) < m_res)
+			// the wall is always closed at the end of the tile
+			if (x < rect.x2 && fabs(newz1 - lastz1) < m_res && fabs(newz2 - lastz2) < m_res)
 				continue;
 			Point3D pbl(lastpoint, yp, lastz1);
 			Point3D pbr(x, yp, lastz1);
@@ -385,33 +394,33 @@ int cStock::TesselSidesX(int yp)
 	return 0;
 }
 
-int cStock::TesselSidesY(int xp)
+int cStock::TesselSidesY(int xp, const cSimRect & rect, cTile & tile)
 {
 	float lastz1 = m_pz;
 	if (xp < m_x)
-		lastz1 = std::max(m_stock[xp][0], m_pz);
+		lastz1 = std::max(m_stock[xp][rect.y1], m_pz);
 	float lastz2 = m_pz;
 	if (xp > 0)
-		lastz2 = std::max(m_stock[xp - 1][0], m_pz);
+		lastz2 = std::max(m_stock[xp - 1][rect.y1], m_pz);
 
-	std::vector<MeshCore::MeshGeomFacet> *facets = &facetsInner;
+	std::vector<MeshCore::MeshGeomFacet> *facets = &tile.facetsInner;
 	if (xp == 0 || xp == m_x)
-		facets = &facetsOuter;
+		facets = &tile.facetsOuter;
 
 	//bool lastzclip = (lastz - m_pz) < m_res;
-	int lastpoint = 0;
-	for (int y = 1; y <= m_y; y++)
+	int lastpoint = rect.y1;
+	for (int y = rect.y1 + 1; y <= rect.y2; y++)
 	{
 		float newz1 = m_pz;
-		if (xp < m_x && y < m_y)
+		if (xp < m_x && y < rect.y2)
 			newz1 = std::max(m_stock[xp][y], m_pz);
 		float newz2 = m_pz;
-		if (xp > 0 && y < m_y)
+		if (xp > 0 && y < rect.y2)
 			newz2 = std::max(m_stock[xp - 1][y], m_pz);
 
 		if (fabs(lastz1 - lastz2) > m_res)
 		{
-			if (fabs(newz1 - lastz1) < m_res && fabs(newz2 - lastz2) < m_res)
+			if (y < rect.y2 && fabs(newz1 - lastz1) < m_res && fabs(newz2 - lastz2) < m_res)
 				continue;
 			Point3D pbr(xp, lastpoint, lastz1);
 			Point3D pbl(xp, y, lastz1);
@@ -449,48 +458,260 @@ void cStock::AddQuad(Point3D & p1, Point3D & p2, Point3D & p3, Point3D & p4, std
 	facets.push_back(facet);
 }
 
-void cStock::Tessellate(Mesh::MeshObject & meshOuter, Mesh::MeshObject & meshInner)
+cSimRect cStock::GetTileRect(int tx, int ty)
 {
+	int x = tx << SIM_TILE_SHIFT;
+	int y = ty << SIM_TILE_SHIFT;
+	return cSimRect(x, y, std::min(m_x, x + SIM_TILE_SIZE), std::min(m_y, y + SIM_TILE_SIZE));
+}
+
+void cStock::TessellateTile(int tx, int ty)
+{
+	cTile & tile = m_tiles[tx * m_ty + ty];
+	tile.facetsOuter.clear();
+	tile.facetsInner.clear();
+	if (m_multiDexel)
+	{
+		TessellateDexelTile(tx, ty);
+		return;
+	}
+
+	cSimRect rect = GetTileRect(tx, ty);
+
 	// reset attribs
-	for (int y = 0; y < m_y; y++)
-	for (int x = 0; x < m_x; x++)
+	for (int y = rect.y1; y < rect.y2; y++)
+	for (int x = rect.x1; x < rect.x2; x++)
 		m_attr[x][y] = 0;
 
-	facetsOuter.clear();
-	facetsInner.clear();
-
-	for (int y = 0; y < m_y; y++)
+	for (int y = rect.y1; y < rect.y2; y++)
 	{
-		for (int x = 0; x < m_x; x++)
+		for (int x = rect.x1; x < rect.x2; x++)
 		{
 			int attr = m_attr[x][y];
 			if ((attr & SIM_TESSEL_TOP) == 0)
-				x += TesselTop(x, y);
+				x += TesselTop(x, y, rect, tile);
 		}
 	}
-	for (int y = 0; y < m_y; y++)
+	for (int y = rect.y1; y < rect.y2; y++)
 	{
-		for (int x = 0; x < m_x; x++)
+		for (int x = rect.x1; x < rect.x2; x++)
 		{
 			if ((m_stock[x][y] - m_pz) < m_res)
 				m_attr[x][y] |= SIM_TESSEL_BOT;
 			if ((m_attr[x][y] & SIM_TESSEL_BOT) == 0)
-				x += TesselBot(x, y);
+				x += TesselBot(x, y, rect, tile);
+		}
+	}
+
+	// a tile owns the walls on its lower x and y borders, the last tiles
+	// also the outer walls on their upper borders
+	int ye = rect.y2 == m_y ? m_y : rect.y2 - 1;
+	int xe = rect.x2 == m_x ? m_x : rect.x2 - 1;
+	for (int y = rect.y1; y <= ye; y++)
+		TesselSidesX(y, rect, tile);
+	for (int x = rect.x1; x <= xe; x++)
+		TesselSidesY(x, rect, tile);
+}
+
+// append the parts of the intervals in a that are not covered by b to result
+static void SubtractDexel(const cDexel & a, const cDexel & b, cDexel & result)
+{
+	size_t j = 0;
+	for (auto & seg : a)
+	{
+		float lo = seg.first;
+		while (j < b.size() && b[j].second <= lo)
+			j++;
+		for (size_t k = j; lo < seg.second; k++)
+		{
+			if (k >= b.size() || b[k].first >= seg.second)
+			{
+				result.push_back(std::make_pair(lo, seg.second));
+				break;
+			}
+			if (b[k].first > lo)
+				result.push_back(std::make_pair(lo, b[k].first));
+			lo = std::max(lo, b[k].second);
+		}
+	}
+}
+
+// remove the interval lo..hi from the material of a stock column
+static bool CutDexel(cDexel & dexel, float lo, float hi)
+{
+	bool cut = false;
+	for (size_t i = 0; i < dexel.size();)
+	{
+		std::pair<float, float> seg = dexel[i];
+		if (seg.second <= lo || seg.first >= hi)
+		{
+			i++;
+			continue;
+		}
+		cut = true;
+		if (seg.first < lo && seg.second > hi)
+		{
+			dexel[i].second = lo;
+			dexel.insert(dexel.begin() + i + 1, std::make_pair(hi, seg.second));
+			break;
+		}
+		if (seg.first < lo)
+		{
+			dexel[i].second = lo;
+			i++;
+		}
+		else if (seg.second > hi)
+		{
+			dexel[i].first = hi;
+			i++;
+		}
+		else
+			dexel.erase(dexel.begin() + i);
+	}
+	return cut;
+}
+
+// add the walls between two neighbouring columns. The wall runs from p1 to p2 and faces d1 where d2 has material
+void cStock::AddDexelSides(const cDexel & d1, const cDexel & d2, Point3D & p1, Point3D & p2, std::vector<MeshCore::MeshGeomFacet> & facets)
+{
+	cDexel walls;
+	SubtractDexel(d2, d1, walls);
+	size_t facing = walls.size();
+	SubtractDexel(d1, d2, walls);
+	for (size_t i = 0; i < walls.size(); i++)
+	{
+		float z1 = walls[i].first;
+		float z2 = walls[i].second;
+		if (z2 - z1 < SIM_EPSILON)
+			continue;
+		if (i >= facing)
+			std::swap(z1, z2);
+		Point3D pbl(p1.x, p1.y, z1);
+		Point3D ptl(p1.x, p1.y, z2);
+		Point3D ptr(p2.x, p2.y, z2);
+		Point3D pbr(p2.x, p2.y, z1);
+		AddQuad(pbl, ptl, ptr, pbr, facets);
+	}
+}
+
+void cStock::TessellateDexelTile(int tx, int ty)
+{
+	cTile & tile = m_tiles[tx * m_ty + ty];
+	cSimRect rect = GetTileRect(tx, ty);
+
+	for (int x = rect.x1; x < rect.x2; x++)
+	{
+		for (int y = rect.y1; y < rect.y2; y++)
+		{
+			for (auto & seg : m_dexels[x * m_y + y])
+			{
+				Point3D pbl(x, y, seg.second);
+				Point3D pbr(x + 1, y, seg.second);
+				Point3D ptl(x, y + 1, seg.second);
+				Point3D ptr(x + 1, y + 1, seg.second);
+				if (fabs(m_plane - seg.second) < SIM_EPSILON)
+					AddQuad(pbl, pbr, ptr, ptl, tile.facetsOuter);
+				else
+					AddQuad(pbl, pbr, ptr, ptl, tile.facetsInner);
+				pbl.z = pbr.z = ptl.z = ptr.z = seg.first;
+				if (fabs(seg.first - m_pz) < SIM_EPSILON)
+					AddQuad(pbl, ptl, ptr, pbr, tile.facetsOuter);
+				else
+					AddQuad(pbl, ptl, ptr, pbr, tile.facetsInner);
+			}
 		}
 	}
-	for (int y = 0; y <= m_y; y++)
-		TesselSidesX(y);
-	for (int x = 0; x <= m_x; x++)
-		TesselSidesY(x);
+
+	// same wall ownership as in TessellateTile
+	const cDexel empty;
+	int ye = rect.y2 == m_y ? m_y : rect.y2 - 1;
+	int xe = rect.x2 == m_x ? m_x : rect.x2 - 1;
+	for (int y = rect.y1; y <= ye; y++)
+	{
+		std::vector<MeshCore::MeshGeomFacet> & facets = (y == 0 || y == m_y) ? tile.facetsOuter : tile.facetsInner;
+		for (int x = rect.x1; x < rect.x2; x++)
+		{
+			const cDexel & d1 = y < m_y ? m_dexels[x * m_y + y] : empty;
+			const cDexel & d2 = y > 0 ? m_dexels[x * m_y + y - 1] : empty;
+			Point3D p1(x, y, 0);
+			Point3D p2(x + 1, y, 0);
+			AddDexelSides(d1, d2, p1, p2, facets);
+		}
+	}
+	for (int x = rect.x1; x <= xe; x++)
+	{
+		std::vector<MeshCore::MeshGeomFacet> & facets = (x == 0 || x == m_x) ? tile.facetsOuter : tile.facetsInner;
+		for (int y = rect.y1; y < rect.y2; y++)
+		{
+			const cDexel & d1 = x < m_x ? m_dexels[x * m_y + y] : empty;
+			const cDexel & d2 = x > 0 ? m_dexels[(x - 1) * m_y + y] : empty;
+			Point3D p1(x, y + 1, 0);
+			Point3D p2(x, y, 0);
+			AddDexelSides(d1, d2, p1, p2, facets);
+		}
+	}
+}
+
+void cStock::Tessellate(Mesh::MeshObject & meshOuter, Mesh::MeshObject & meshInner)
+{
+	// a tile also depends on the tiles below and left of it, as it owns the
+	// walls shared with them
+	std::vector<int> tiles;
+	for (int tx = 0; tx < m_tx; tx++)
+	{
+		for (int ty = 0; ty < m_ty; ty++)
+		{
+			if (m_tiles[tx * m_ty + ty].dirty
+				|| (tx > 0 && m_tiles[(tx - 1) * m_ty + ty].dirty)
+				|| (ty > 0 && m_tiles[tx * m_ty + ty - 1].dirty))
+				tiles.push_back(tx * m_ty + ty);
+		}
+	}
+	QtConcurrent::blockingMap(tiles, [this](int & i) {
+		TessellateTile(i / m_ty, i % m_ty);
+	});
+	for (auto & tile : m_tiles)
+		tile.dirty = false;
+
+	std::size_t numOuter = 0, numInner = 0;
+	for (auto & tile : m_tiles)
+	{
+		numOuter += tile.facetsOuter.size();
+		numInner += tile.facetsInner.size();
+	}
+	std::vector<MeshCore::MeshGeomFacet> facetsOuter, facetsInner;
+	facetsOuter.reserve(numOuter);
+	facetsInner.reserve(numInner);
+	for (auto & tile : m_tiles)
+	{
+		facetsOuter.insert(facetsOuter.end(), tile.facetsOuter.begin(), tile.facetsOuter.end());
+		facetsInner.insert(facetsInner.end(), tile.facetsInner.begin(), tile.facetsInner.end());
+	}
 	meshOuter.addFacets(facetsOuter);
 	meshInner.addFacets(facetsInner);
-	facetsOuter.clear();
-	facetsInner.clear();
 }
 
+inline void cStock::CutPixel(int x, int y, float z, float ztop, const cSimRect & clip)
+{
+	if (!clip.contains(x, y))
+		return;
+	bool cut;
+	if (m_multiDexel)
+		cut = CutDexel(m_dexels[x * m_y + y], z, ztop);
+	else
+	{
+		float & height = m_stock[x][y];
+		cut = height > z;
+		if (cut)
+			height = z;
+	}
+	if (cut)
+		m_tiles[(x >> SIM_TILE_SHIFT) * m_ty + (y >> SIM_TILE_SHIFT)].dirty = true;
+}
 
 void cStock::CreatePocket(float cxf, float cyf, float radf, float height)
 {
+	cSimRect clip(0, 0, m_x, m_y);
 	int cx = (int)((cxf - m_px) / m_res);
 	int cy = (int)((cyf - m_py) / m_res);
 	int rad = (int)(radf / m_res);
@@ -504,12 +725,17 @@ void cStock::CreatePocket(float cxf, float cyf, float radf, float height)
 		for (int x = xs; x < xe; x++)
 		{
 			if (((x - cx)*(x - cx) + (y - cy) * (y - cy)) < drad)
-				if (m_stock[x][y] > height) m_stock[x][y] = height;
+				CutPixel(x, y, height, FLT_MAX, clip);
 		}
 	}
 }
 
 void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
+{
+	ApplyLinearTool(p1, p2, tool, cSimRect(0, 0, m_x, m_y));
+}
+
+void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool, const cSimRect & clip)
 {
 	// translate coordinates
 	Point3D pi1 = ToInner(p1);
@@ -531,24 +757,20 @@ void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
 		Point3D sideWay(-perpDirX * SIM_WALK_RES, -perpDirY * SIM_WALK_RES, 0);
 		int lenSteps = (int)(path.len / SIM_WALK_RES) + 1;
 		int radSteps = (int)(rad * 2 / SIM_WALK_RES) + 1;
-		float zstep = (pi2.z - pi1.z) / radSteps;
+		float zstep = (pi2.z - pi1.z) / lenSteps;
 		float tstep = 2.0 / radSteps;
 		float t = -1;
 		for (int j = 0; j < radSteps; j++)
 		{
 			float z = pi1.z + tool.GetToolProfileAt(t);
+			float ztop = pi1.z + tool.GetToolTopAt(t);
 			Point3D p = start;
 			for (int i = 0; i < lenSteps; i++)
 			{
-				int x = (int)p.x;
-				int y = (int)p.y;
-				if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-				{
-					if (m_stock[x][y] > z)
-						m_stock[x][y] = z;
-				}
+				CutPixel((int)p.x, (int)p.y, z, ztop, clip);
 				p.Add(mainWay);
 				z += zstep;
+				ztop += zstep;
 			}
 			t += tstep;
 			start.Add(sideWay);
@@ -564,21 +786,21 @@ void cStock::ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool & tool)
 		float rotang = 180 * SIM_WALK_RES / (3.1415926535 * r);
 		cupCirc.SetRotationAngle(-rotang);
 		float z = pi2.z + tool.GetToolProfileAt(r / rad);
+		float ztop = pi2.z + tool.GetToolTopAt(r / rad);
 		for (float a = 0; a < cupAngle; a += rotang)
 		{
-			int x = (int)(pi2.x + cupCirc.x);
-			int y = (int)(pi2.y + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
-			}
+			CutPixel((int)(pi2.x + cupCirc.x), (int)(pi2.y + cupCirc.y), z, ztop, clip);
 			cupCirc.Rotate();
 		}
 	}
 }
 
 void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool & tool, bool isCCW)
+{
+	ApplyCircularTool(p1, p2, cent, tool, isCCW, cSimRect(0, 0, m_x, m_y));
+}
+
+void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool & tool, bool isCCW, const cSimRect & clip)
 {
 	// translate coordinates
 	Point3D pi1 = ToInner(p1);
@@ -624,17 +846,13 @@ void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimT
 			rotang = -rotang;
 		cupCirc.SetRotationAngleRad(rotang);
 		float z = pi1.z + tool.GetToolProfileAt(t);
+		float ztop = pi1.z + tool.GetToolTopAt(t);
 		float zstep = (pi2.z - pi1.z) / ndivs;
 		for (int i = 0; i< ndivs; i++)
 		{
-			int x = (int)(cpx + cupCirc.x);
-			int y = (int)(cpy + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
-			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
-			}
+			CutPixel((int)(cpx + cupCirc.x), (int)(cpy + cupCirc.y), z, ztop, clip);
 			z += zstep;
+			ztop += zstep;
 			cupCirc.Rotate();
 		}
 		t += tstep;
@@ -652,18 +870,110 @@ void cStock::ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimT
 			rotang = -rotang;
 		cupCirc.SetRotationAngleRad(rotang);
 		float z = pi2.z + tool.GetToolProfileAt(r / rad);
+		float ztop = pi2.z + tool.GetToolTopAt(r / rad);
 		for (int i = 0; i < ndivs; i++)
 		{
-			int x = (int)(pi2.x + cupCirc.x);
-			int y = (int)(pi2.y + cupCirc.y);
-			if (x >= 0 && y >= 0 && x < m_x && y < m_y)
+			CutPixel((int)(pi2.x + cupCirc.x), (int)(pi2.y + cupCirc.y), z, ztop, clip);
+			cupCirc.Rotate();
+		}
+	}
+}
+
+// get the pixels a move may cut, false if it misses the stock
+bool cStock::GetMoveRect(cSimMove & move, float rad, cSimRect & rect)
+{
+	Point3D pi1 = ToInner(move.p1);
+	Point3D pi2 = ToInner(move.p2);
+	float xmin = std::min(pi1.x, pi2.x);
+	float xmax = std::max(pi1.x, pi2.x);
+	float ymin = std::min(pi1.y, pi2.y);
+	float ymax = std::max(pi1.y, pi2.y);
+	if (move.type != cSimMove::Linear)
+	{
+		// simply take the full circle
+		float cx = pi1.x + move.cent.x / m_res;
+		float cy = pi1.y + move.cent.y / m_res;
+		float crad = sqrt(move.cent.x * move.cent.x + move.cent.y * move.cent.y) / m_res;
+		xmin = std::min(xmin, cx - crad);
+		xmax = std::max(xmax, cx + crad);
+		ymin = std::min(ymin, cy - crad);
+		ymax = std::max(ymax, cy + crad);
+	}
+	// the tool walks stay within its radius plus a walk step around the path
+	int margin = (int)rad + 2;
+	rect.x1 = std::max(0, (int)floor(xmin) - margin);
+	rect.y1 = std::max(0, (int)floor(ymin) - margin);
+	rect.x2 = std::min(m_x, (int)floor(xmax) + margin + 1);
+	rect.y2 = std::min(m_y, (int)floor(ymax) + margin + 1);
+	return rect.x1 < rect.x2 && rect.y1 < rect.y2;
+}
+
+void cStock::ApplyMoves(std::vector<cSimMove> & moves, cSimTool & tool)
+{
+	// Cutting only ever removes material, so the order of the moves does not
+	// matter. A move no larger than a tile is assigned to the tile holding
+	// the lower left corner of its pixels, and so cuts at most that tile and
+	// the three tiles above and right of it. Tiles that are two apart in both
+	// directions therefore never cut the same pixels, which allows applying
+	// all moves of every other tile concurrently, in four passes.
+	// Larger moves are applied afterwards, clipped to each tile they touch.
+	float rad = tool.radius / m_res;
+	std::vector< std::vector<int> > tileMoves(m_tiles.size());
+	std::vector< std::vector<int> > clipMoves(m_tiles.size());
+	for (int i = 0; i < (int)moves.size(); i++)
+	{
+		cSimRect rect;
+		if (!GetMoveRect(moves[i], rad, rect))
+			continue;
+		int tx1 = rect.x1 >> SIM_TILE_SHIFT;
+		int ty1 = rect.y1 >> SIM_TILE_SHIFT;
+		if (rect.x2 - rect.x1 <= SIM_TILE_SIZE && rect.y2 - rect.y1 <= SIM_TILE_SIZE)
+		{
+			tileMoves[tx1 * m_ty + ty1].push_back(i);
+			continue;
+		}
+		for (int tx = tx1; tx <= (rect.x2 - 1) >> SIM_TILE_SHIFT; tx++)
+			for (int ty = ty1; ty <= (rect.y2 - 1) >> SIM_TILE_SHIFT; ty++)
+				clipMoves[tx * m_ty + ty].push_back(i);
+	}
+
+	auto applyMove = [&](cSimMove & move, const cSimRect & clip) {
+		if (move.type == cSimMove::Linear)
+			ApplyLinearTool(move.p1, move.p2, tool, clip);
+		else
+			ApplyCircularTool(move.p1, move.p2, move.cent, tool, move.type == cSimMove::ArcCCW, clip);
+	};
+
+	cSimRect all(0, 0, m_x, m_y);
+	std::vector<int> tiles;
+	for (int pass = 0; pass < 4; pass++)
+	{
+		tiles.clear();
+		for (int tx = pass & 1; tx < m_tx; tx += 2)
+		{
+			for (int ty = pass >> 1; ty < m_ty; ty += 2)
 			{
-				if (m_stock[x][y] > z)
-					m_stock[x][y] = z;
+				if (!tileMoves[tx * m_ty + ty].empty())
+					tiles.push_back(tx * m_ty + ty);
 			}
-			cupCirc.Rotate();
 		}
+		QtConcurrent::blockingMap(tiles, [&](int & i) {
+			for (int m : tileMoves[i])
+				applyMove(moves[m], all);
+		});
+	}
+
+	tiles.clear();
+	for (int i = 0; i < (int)clipMoves.size(); i++)
+	{
+		if (!clipMoves[i].empty())
+			tiles.push_back(i);
 	}
+	QtConcurrent::blockingMap(tiles, [&](int & i) {
+		cSimRect clip = GetTileRect(i / m_ty, i % m_ty);
+		for (int m : clipMoves[i])
+			applyMove(moves[m], clip);
+	});
 }
 
 
@@ -714,6 +1024,14 @@ void Point3D::UpdateCmd(Path::Command & cmd)
 		z = cmd.getPlacement().getPosition()[2];
 }
 
+void Point3D::UpdateCmd(const Path::CommandView & cmd)
+{
+	Base::Vector3d pos = cmd.getPosition(Base::Vector3d(x, y, z));
+	x = pos.x;
+	y = pos.y;
+	z = pos.z;
+}
+
 //************************************************************************************************************
 // Simulation tool
 //************************************************************************************************************
@@ -742,6 +1060,10 @@ cSimTool::cSimTool(const TopoDS_Shape& toolShape, float res){
  	
 	int radValue = (int)(radius / res) + 1;
 
+	// used to find the top of undercutting tools
+	IntCurvesFace_ShapeIntersector intersector;
+	intersector.Load(toolShape, res);
+
 	// Measure the performance of the profile extraction
 	//auto start = std::chrono::high_resolution_clock::now(); 
 
@@ -768,6 +1090,22 @@ cSimTool::cSimTool(const TopoDS_Shape& toolShape, float res){
 				toolShapePoint shapePoint;
 				shapePoint.radiusPos = pnt.x;
 				shapePoint.heightPos = pnt.z;
+
+				// the material above ends where the line next leaves the tool,
+				// unless that is at the top of the tool (i.e. the shank)
+				shapePoint.topPos = FLT_MAX;
+				intersector.Perform(gp_Lin(gp_Pnt(pnt.x, 0, zMin - 1), gp_Dir(0, 0, 1)), 0, zMax - zMin + 2);
+				intersector.SortResult();
+				for (int i = 1; i <= intersector.NbPnt(); i++)
+				{
+					double z = intersector.Pnt(i).Z();
+					if (z > pnt.z + res)
+					{
+						if (z < zMax - res)
+							shapePoint.topPos = z;
+						break;
+					}
+				}
 				m_toolShape.push_back(shapePoint);
 				break;
 			}
@@ -793,6 +1131,18 @@ float cSimTool::GetToolProfileAt(float pos)  // pos is -1..1 location along the
 	}
 }
 
+float cSimTool::GetToolTopAt(float pos)  // pos is -1..1 location along the radius of the tool (0 is center)
+{
+	try{
+		float radPos = std::abs(pos) * radius;
+		toolShapePoint test; test.radiusPos = radPos;
+		auto it = std::lower_bound(m_toolShape.begin(), m_toolShape.end(), test, toolShapePoint::less_than());
+		return it->topPos;
+	}catch(...){
+		return FLT_MAX;
+	}
+}
+
 bool cSimTool::isInside(const TopoDS_Shape& toolShape, Base::Vector3d pnt, float res)
 {
     bool checkFace = true;
@@ -26,18 +26,23 @@
 #ifndef PATHSIMULATOR_VolSim_H
 #define PATHSIMULATOR_VolSim_H
 
+#include <cfloat>
 #include <vector>
 #include <Mod/Mesh/App/Mesh.h>
 #include <Mod/Path/App/Command.h>
+#include <Mod/Path/App/Path.h>
 
 #define SIM_EPSILON 0.00001
 #define SIM_TESSEL_TOP		1
 #define SIM_TESSEL_BOT		2
 #define SIM_WALK_RES		0.6   // step size in pixel units (to make sure all pixels in the path are visited)
+#define SIM_TILE_SHIFT		6     // stock is processed in tiles of 64 x 64 pixels
+#define SIM_TILE_SIZE		(1 << SIM_TILE_SHIFT)
 
 struct toolShapePoint {
   float radiusPos;
   float heightPos;
+  float topPos;     // top of the tool material starting at heightPos, FLT_MAX if it reaches the holder
   
   struct less_than{
   	bool operator()(const toolShapePoint &a, const toolShapePoint &b){
@@ -56,6 +61,7 @@ struct Point3D
 	inline void Add(Point3D & p) { x += p.x; y += p.y; z += p.z; }
 	inline void Rotate() { float tx = x;  x = x * cosa - y * sina; y = tx * sina + y * cosa; }
 	void UpdateCmd(Path::Command & cmd);
+	void UpdateCmd(const Path::CommandView & cmd);
 	void SetRotationAngle(float angle);
 	void SetRotationAngleRad(float angle);
 	float x, y, z;
@@ -104,6 +110,7 @@ public:
 	~cSimTool() {}
 
 	float GetToolProfileAt(float pos);
+	float GetToolTopAt(float pos);
 	bool isInside(const TopoDS_Shape& toolShape, Base::Vector3d pnt, float res);
 
 	std::vector< toolShapePoint > m_toolShape;
@@ -136,37 +143,81 @@ private:
 	int height;
 };
 
+// pixel rectangle [x1, x2) x [y1, y2)
+struct cSimRect
+{
+	cSimRect() : x1(0), y1(0), x2(0), y2(0) {}
+	cSimRect(int x1, int y1, int x2, int y2) : x1(x1), y1(y1), x2(x2), y2(y2) {}
+	inline bool contains(int x, int y) const { return x >= x1 && y >= y1 && x < x2 && y < y2; }
+	int x1, y1, x2, y2;
+};
+
+// a single tool move, as applied by cStock::ApplyMoves
+struct cSimMove
+{
+	enum MoveType { Linear, ArcCW, ArcCCW };
+	cSimMove(MoveType type, Point3D & p1, Point3D & p2) : type(type), p1(p1), p2(p2) {}
+	cSimMove(MoveType type, Point3D & p1, Point3D & p2, Point3D & cent) : type(type), p1(p1), p2(p2), cent(cent) {}
+	MoveType type;
+	Point3D p1, p2;
+	Point3D cent;   // arc center, relative to p1
+};
+
+// material of a single stock column in multi dexel mode, as sorted (bottom, top) intervals
+typedef std::vector< std::pair<float, float> > cDexel;
+
 class cStock
 {
 public:
-	cStock(float px, float py, float pz, float lx, float ly, float lz, float res);
+	cStock(float px, float py, float pz, float lx, float ly, float lz, float res, bool multiDexel = false);
 	~cStock();
 	void Tessellate(Mesh::MeshObject & meshOuter, Mesh::MeshObject & meshInner);
     void CreatePocket(float x, float y, float rad, float height);
     void ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool &tool);
     void ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool &tool, bool isCCW);
+    void ApplyMoves(std::vector<cSimMove> & moves, cSimTool &tool);
     inline Point3D ToInner(Point3D & p) {
 		return Point3D((p.x - m_px) / m_res, (p.y - m_py) / m_res, p.z);
 	}
 
 private:
-	float FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz);
-	void FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz);
+	// Each tile caches its own facets, and is only tessellated again after
+	// it (or a neighbour sharing its side walls) was cut.
+	struct cTile
+	{
+		cTile() : dirty(true) {}
+		bool dirty;
+		std::vector<MeshCore::MeshGeomFacet> facetsOuter;
+		std::vector<MeshCore::MeshGeomFacet> facetsInner;
+	};
+
+	void ApplyLinearTool(Point3D & p1, Point3D & p2, cSimTool &tool, const cSimRect & clip);
+	void ApplyCircularTool(Point3D & p1, Point3D & p2, Point3D & cent, cSimTool &tool, bool isCCW, const cSimRect & clip);
+	bool GetMoveRect(cSimMove & move, float rad, cSimRect & rect);
+	inline void CutPixel(int x, int y, float z, float ztop, const cSimRect & clip);
+	cSimRect GetTileRect(int tx, int ty);
+	void TessellateTile(int tx, int ty);
+	void TessellateDexelTile(int tx, int ty);
+	float FindRectTop(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz, const cSimRect & rect);
+	void FindRectBot(int & xp, int & yp, int & x_size, int & y_size, bool scanHoriz, const cSimRect & rect);
 	void SetFacetPoints(MeshCore::MeshGeomFacet & facet, Point3D & p1, Point3D & p2, Point3D & p3);
 	void AddQuad(Point3D & p1, Point3D & p2, Point3D & p3, Point3D & p4, std::vector<MeshCore::MeshGeomFacet> & facets);
-	int TesselTop(int x, int y);
-	int TesselBot(int x, int y);
-	int TesselSidesX(int yp);
-	int TesselSidesY(int xp);
+	int TesselTop(int x, int y, const cSimRect & rect, cTile & tile);
+	int TesselBot(int x, int y, const cSimRect & rect, cTile & tile);
+	int TesselSidesX(int yp, const cSimRect & rect, cTile & tile);
+	int TesselSidesY(int xp, const cSimRect & rect, cTile & tile);
+	void AddDexelSides(const cDexel & d1, const cDexel & d2, Point3D & p1, Point3D & p2, std::vector<MeshCore::MeshGeomFacet> & facets);
 	Array2D<float>  m_stock;
 	Array2D<char> m_attr;
+	std::vector<cDexel> m_dexels;   // m_x * m_y columns, only used in multi dexel mode
+	std::vector<cTile> m_tiles;     // m_tx * m_ty tiles
 	float m_px, m_py, m_pz;  // stock zero position
 	float m_lx, m_ly, m_lz;  // stock dimensions
 	float m_res;        // resoulution
 	float m_plane;		// stock plane height
 	int m_x, m_y;            // stock array size
-	std::vector<MeshCore::MeshGeomFacet> facetsOuter;
-	std::vector<MeshCore::MeshGeomFacet> facetsInner;
+	int m_tx, m_ty;          // tile array size
+	bool m_multiDexel;
 };
 
 class cVolSim
@@ -0,0 +1,80 @@
+# -*- coding: utf-8 -*-
+
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2020 FreeCAD Developers                                 *
+# *                                                                         *
+# *   This program is free software; you can redistribute it and/or modify  *
+# *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+# *   as published by the Free Software Foundation; either version 2 of     *
+# *   the License, or (at your option) any later version.                   *
+# *   for detail see the LICENCE text file.                                 *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU Library General Public License for more details.                  *
+# *                                                                         *
+# *   You should have received a copy of the GNU Library General Public     *
+# *   License along with this program; if not, write to the Free Software   *
+# *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+# *   USA                                                                   *
+# *                                                                         *
+# ***************************************************************************
+
+import area
+import threading
+import PathTests.PathTestUtils as PathTestUtils
+
+
+def square(x, y, size):
+    return [[x, y], [x + size, y], [x + size, y + size], [x, y + size]]
+
+def island(x, y, size):
+    return list(reversed(square(x, y, size)))
+
+def outputs(results):
+    '''outputs(results) ... returns the adaptive outputs as plain python values.'''
+    return [(r.HelixCenterPoint, r.StartPoint, r.AdaptivePaths, r.ReturnMotionType) for r in results]
+
+
+class TestPathAdaptive(PathTestUtils.PathTestBase):
+    '''Adaptive2d processes separate regions concurrently, the result must not depend on it.'''
+
+    def execute(self, paths, threadCount, stop=False):
+        a2d = area.Adaptive2d()
+        a2d.toolDiameter = 5
+        a2d.stepOverFactor = 0.2
+        a2d.helixRampDiameter = 5
+        a2d.tolerance = 0.1
+        a2d.opType = area.AdaptiveOperationType.ClearingInside
+        a2d.threadCount = threadCount
+        callers = set()
+        def progressFn(tpaths):
+            callers.add(threading.current_thread().ident)
+            return stop
+        results = a2d.Execute([square(-10, -10, 130)], paths, progressFn)
+        return outputs(results), callers
+
+    def test00(self):
+        '''Verify concurrent regions produce the same paths as serial processing.'''
+        # separate pockets, one of them with an island
+        paths = [square(0, 0, 40), square(60, 0, 30), square(0, 60, 50), island(15, 75, 20), square(70, 60, 25)]
+
+        serial, callers = self.execute(paths, 1)
+        self.assertTrue(len(serial) >= 4)
+        for threadCount in [2, 4, 0]:
+            concurrent, callers = self.execute(paths, threadCount)
+            self.assertEqual(concurrent, serial)
+            self.assertEqual(callers, set([threading.current_thread().ident]))
+
+    def test01(self):
+        '''Verify a stop request from the progress callback reaches the concurrent regions.'''
+        paths = [square(0, 0, 50), square(60, 0, 50), square(0, 60, 50), square(60, 60, 50)]
+
+        complete, callers = self.execute(paths, 1)
+        stopped, callers = self.execute(paths, 4, True)
+        self.assertEqual(callers, set([threading.current_thread().ident]))
+        pathCount = lambda out: sum(len(o[2]) for o in out)
+        self.assertTrue(pathCount(stopped) <= pathCount(complete))
+        self.assertTrue(len(stopped) <= len(complete))
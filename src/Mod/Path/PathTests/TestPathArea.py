@@ -0,0 +1,103 @@
+# -*- coding: utf-8 -*-
+
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2020 FreeCAD Developers                                 *
+# *                                                                         *
+# *   This program is free software; you can redistribute it and/or modify  *
+# *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+# *   as published by the Free Software Foundation; either version 2 of     *
+# *   the License, or (at your option) any later version.                   *
+# *   for detail see the LICENCE text file.                                 *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU Library General Public License for more details.                  *
+# *                                                                         *
+# *   You should have received a copy of the GNU Library General Public     *
+# *   License along with this program; if not, write to the Free Software   *
+# *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+# *   USA                                                                   *
+# *                                                                         *
+# ***************************************************************************
+
+import Part
+import Path
+import PathTests.PathTestUtils as PathTestUtils
+
+from FreeCAD import Vector
+
+# section heights below and above the step of the test solid
+Heights = [2, 5, 8, 12, 20, 28]
+
+def stepSolid():
+    '''stepSolid() ... returns a 20x10 block of height 10 with a 10x10 column of height 30 on it.'''
+    return Part.makeBox(20, 10, 10).fuse(Part.makeBox(10, 10, 30)).removeSplitter()
+
+def makeArea(shape):
+    area = Path.Area()
+    area.setPlane(Part.makeCircle(10))
+    area.add(shape)
+    return area
+
+def sectionShapes(area, heights):
+    return [sec.getShape() for sec in area.makeSections(mode=0, project=False, heights=heights)]
+
+
+class TestPathArea(PathTestUtils.PathTestBase):
+    '''Area::makeSections() caches its sections, the result must not depend on it.'''
+
+    def assertSections(self, sections, expected):
+        self.assertEqual(len(sections), len(expected))
+        for shape, exp in zip(sections, expected):
+            self.assertRoughly(shape.Area, exp.Area)
+            self.assertCoincide(shape.BoundBox.getPoint(0), exp.BoundBox.getPoint(0))
+            self.assertCoincide(shape.BoundBox.getPoint(6), exp.BoundBox.getPoint(6))
+
+    def test00(self):
+        '''Verify repeated and partially changed sections match uncached ones.'''
+        solid = stepSolid()
+        area = makeArea(solid)
+        first = sectionShapes(area, Heights)
+        for shape, z in zip(first, Heights):
+            self.assertRoughly(shape.Area, 200 if z < 10 else 100)
+            self.assertRoughly(shape.BoundBox.ZMin, z)
+
+        # a copy of the solid has a new shape, so its sections are not cached
+        self.assertSections(sectionShapes(area, Heights), first)
+        self.assertSections(sectionShapes(makeArea(solid.copy()), Heights), first)
+
+        heights = [3, 5, 8, 15, 20]
+        self.assertSections(sectionShapes(area, heights), sectionShapes(makeArea(solid.copy()), heights))
+
+    def test01(self):
+        '''Verify changed shapes and placements are sectioned again.'''
+        solid = stepSolid()
+        sectionShapes(makeArea(solid), Heights)
+
+        moved = solid.copy()
+        moved.translate(Vector(0, 0, 5))
+        heights = [8, 12, 20, 28]
+        for shape, z in zip(sectionShapes(makeArea(moved), heights), heights):
+            self.assertRoughly(shape.Area, 200 if z < 15 else 100)
+            self.assertRoughly(shape.BoundBox.ZMin, z)
+
+        column = Part.makeBox(10, 10, 30)
+        for shape in sectionShapes(makeArea(column), Heights):
+            self.assertRoughly(shape.Area, 100)
+
+        area = makeArea(solid)
+        area.setParams(Fill=0)
+        for shape in sectionShapes(area, Heights):
+            self.assertEqual(len(shape.Faces), 0)
+
+    def test02(self):
+        '''Verify changing a returned section does not change the cached one.'''
+        solid = stepSolid()
+        area = makeArea(solid)
+        section = area.makeSections(mode=0, project=False, heights=[5])[0]
+        section.add(Part.Face(Part.makePolygon([Vector(0, 0, 5), Vector(5, 0, 5), Vector(5, 5, 5), Vector(0, 5, 5), Vector(0, 0, 5)])), op=1)
+        self.assertRoughly(section.getShape().Area, 175)
+
+        self.assertRoughly(sectionShapes(area, [5])[0].Area, 200)
@@ -156,6 +156,29 @@ G0 Z0.500000
         self.assertEqual(len(table.Tools), 2)
         self.assertEqual(str(table.Tools), '{1: Tool 12.7mm Drill Bit, 2: Tool my other tool}' )
 
+    def test30(self):
+        """Test Path commands with comments, units and edits"""
+
+        p = Path.Path()
+        p.setFromGCode("G20\n(start)\nG0 X1 Y2\nG1 Z-0.5 F10\nG21\nG2 X0 Y0 I1 J0\n")
+        self.assertEqual(p.Size, 4)
+        self.assertEqual(p.toGCode(), '(start)\nG0 X25.400000 Y50.800000\nG1 F254.000000 Z-12.700000\nG2 I1.000000 J0.000000 X0.000000 Y0.000000\n')
+
+        cmds = p.Commands
+        self.assertEqual(cmds[0].Name, '(start)')
+        self.assertEqual(cmds[2].Parameters, {'F': 254.0, 'Z': -12.7})
+        self.assertEqual(cmds[3].Parameters, {'I': 1.0, 'J': 0.0, 'X': 0.0, 'Y': 0.0})
+
+        p.insertCommand(Path.Command("M3", {"S": 1000}), 1)
+        p.deleteCommand(0)
+        self.assertEqual(p.toGCode(), 'M3 S1000.000000\nG0 X25.400000 Y50.800000\nG1 F254.000000 Z-12.700000\nG2 I1.000000 J0.000000 X0.000000 Y0.000000\n')
+        self.assertEqual(str(p.Commands[0]), 'Command M3 [ S:1000 ]')
+
+        # a rebuilt path is identical
+        p2 = Path.Path(p.Commands)
+        self.assertEqual(p2.toGCode(), p.toGCode())
+        self.assertEqual(p2.Length, p.Length)
+
     def test50(self):
         """Test Path.Length calculation"""
         commands = []
@@ -0,0 +1,118 @@
+# -*- coding: utf-8 -*-
+
+# ***************************************************************************
+# *                                                                         *
+# *   Copyright (c) 2020 FreeCAD Developers                                 *
+# *                                                                         *
+# *   This program is free software; you can redistribute it and/or modify  *
+# *   it under the terms of the GNU Lesser General Public License (LGPL)    *
+# *   as published by the Free Software Foundation; either version 2 of     *
+# *   the License, or (at your option) any later version.                   *
+# *   for detail see the LICENCE text file.                                 *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU Library General Public License for more details.                  *
+# *                                                                         *
+# *   You should have received a copy of the GNU Library General Public     *
+# *   License along with this program; if not, write to the Free Software   *
+# *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+# *   USA                                                                   *
+# *                                                                         *
+# ***************************************************************************
+
+import FreeCAD
+import Part
+import Path
+import PathSimulator
+import PathTests.PathTestUtils as PathTestUtils
+
+# 0.5mm pixels make 64 pixel tiles of 32mm, the stock is 7x5 tiles
+Resolution = 0.5
+
+def makePath():
+    '''makePath() ... returns moves within single tiles, across tile borders and spanning several tiles.'''
+    cmds = [Path.Command('G0', {'X': 10, 'Y': 10, 'Z': 25})]
+    cmds.append(Path.Command('G1', {'Z': 15}))
+    for i in range(8):
+        y = 10 + 15 * i
+        x = 190 if i % 2 == 0 else 10
+        cmds.append(Path.Command('G1', {'X': x, 'Y': y}))
+        cmds.append(Path.Command('G1', {'Y': y + 15}))
+    cmds.append(Path.Command('G0', {'Z': 25}))
+    # short moves and arcs around a tile corner
+    cmds.append(Path.Command('G0', {'X': 60, 'Y': 64}))
+    cmds.append(Path.Command('G1', {'Z': 8}))
+    for i in range(12):
+        cmds.append(Path.Command('G1', {'X': 60 + 1.5 * i, 'Y': 64 + (i % 2)}))
+    cmds.append(Path.Command('G1', {'X': 75, 'Y': 64}))
+    cmds.append(Path.Command('G2', {'X': 90, 'Y': 64, 'I': 7.5, 'J': 0}))
+    cmds.append(Path.Command('G3', {'X': 60, 'Y': 64, 'I': -15, 'J': 0}))
+    cmds.append(Path.Command('G0', {'Z': 25}))
+    return Path.Path(cmds)
+
+def triangles(mesh):
+    '''triangles(mesh) ... returns the sorted facets of mesh as point coordinates.'''
+    points, facets = mesh.Topology
+    pts = [(round(p.x, 6), round(p.y, 6), round(p.z, 6)) for p in points]
+    return sorted(tuple(sorted(pts[i] for i in f)) for f in facets)
+
+
+class TestPathSimulator(PathTestUtils.PathTestBase):
+    '''The stock is cut and tessellated in tiles, the result must not depend on it.'''
+
+    def simulator(self):
+        sim = PathSimulator.PathSim()
+        sim.BeginSimulation(Part.makeBox(200, 150, 20), Resolution)
+        sim.SetToolShape(Part.makeCylinder(3, 20), 0.05)
+        return sim
+
+    def assertMeshes(self, meshes, expected):
+        for mesh, exp in zip(meshes, expected):
+            self.assertEqual(mesh.CountFacets, exp.CountFacets)
+            self.assertEqual(triangles(mesh), triangles(exp))
+
+    def test00(self):
+        '''Verify a batch of moves cuts the same stock as single commands.'''
+        path = makePath()
+
+        # one command at a time, with tessellations in between
+        serial = self.simulator()
+        pos = FreeCAD.Placement()
+        for i, cmd in enumerate(path.Commands):
+            pos = serial.ApplyCommand(pos, cmd)
+            if i % 7 == 0:
+                serial.GetResultMesh()
+        expected = serial.GetResultMesh()
+        self.assertTrue(expected[0].CountFacets > 0)
+
+        batch = self.simulator()
+        batchPos = batch.ApplyPath(FreeCAD.Placement(), path)
+        self.assertCoincide(batchPos.Base, pos.Base)
+        self.assertMeshes(batch.GetResultMesh(), expected)
+
+        # in chunks, like the simulator's fast forward
+        chunked = self.simulator()
+        chunkPos = FreeCAD.Placement()
+        for start in range(0, path.Size, 5):
+            chunkPos = chunked.ApplyPath(chunkPos, path, start, 5)
+            chunked.GetResultMesh()
+        self.assertCoincide(chunkPos.Base, pos.Base)
+        self.assertMeshes(chunked.GetResultMesh(), expected)
+
+    def test01(self):
+        '''Verify incremental tessellation matches tessellating the final stock.'''
+        path = makePath()
+
+        incremental = self.simulator()
+        pos = FreeCAD.Placement()
+        for cmd in path.Commands:
+            pos = incremental.ApplyCommand(pos, cmd)
+            incremental.GetResultMesh()
+
+        final = self.simulator()
+        pos = FreeCAD.Placement()
+        for cmd in path.Commands:
+            pos = final.ApplyCommand(pos, cmd)
+        self.assertMeshes(incremental.GetResultMesh(), final.GetResultMesh())
@@ -25,6 +25,9 @@
 import TestApp
 
 from PathTests.TestPathLog   import TestPathLog
+from PathTests.TestPathAdaptive  import TestPathAdaptive
+from PathTests.TestPathArea  import TestPathArea
+from PathTests.TestPathSimulator  import TestPathSimulator
 from PathTests.TestPathPreferences  import TestPathPreferences
 from PathTests.TestPathCore  import TestPathCore
 #from PathTests.TestPathPost  import PathPostTestCases
@@ -62,4 +65,7 @@ False if TestPathDeburr.__name__ else True
 False if TestPathHelix.__name__ else True
 False if TestPathPreferences.__name__ else True
 False if TestPathToolBit.__name__ else True
+False if TestPathAdaptive.__name__ else True
+False if TestPathArea.__name__ else True
+False if TestPathSimulator.__name__ else True
 
@@ -25,6 +25,13 @@
 #include <cstring>
 #include <ctime>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <thread>
 
 namespace ClipperLib
 {
@@ -1113,7 +1120,8 @@ class Interpolation
 
 	double getRandomAngle()
 	{
-		return MIN_ANGLE + (MAX_ANGLE - MIN_ANGLE) * double(rand()) / double(RAND_MAX);
+		// own generator per region - rand() would make the result depend on the other regions' workers
+		return MIN_ANGLE + (MAX_ANGLE - MIN_ANGLE) * double(random() - random.min()) / double(random.max() - random.min());
 	}
 	size_t getPointCount()
 	{
@@ -1123,6 +1131,7 @@ class Interpolation
   private:
 	vector<double> angles;
 	vector<double> areas;
+	std::minstd_rand random;
 };
 
 //***************************************
@@ -1804,6 +1813,7 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 		clipof.AddPaths(inputPaths, JoinType::jtRound, EndType::etClosedPolygon);
 		Paths paths;
 		clipof.Execute(paths, -toolRadiusScaled - finishPassOffsetScaled - cornerRoundingOffset);
+		std::vector<Region> regions;
 		for (const auto &current : paths)
 		{
 			int nesting = getPathNestingLevel(current, paths);
@@ -1828,14 +1838,16 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 				clipof.Clear();
 				clipof.AddPaths(toolBoundPaths, JoinType::jtRound, EndType::etClosedPolygon);
 				clipof.Execute(boundPaths, toolRadiusScaled + finishPassOffsetScaled);
-				ProcessPolyNode(boundPaths, toolBoundPaths);
+				regions.push_back(Region(boundPaths, toolBoundPaths));
 			}
 		}
+		ProcessRegions(regions);
 	}
 
 	if (opType == OperationType::otProfilingInside || opType == OperationType::otProfilingOutside)
 	{
 		double offset = opType == OperationType::otProfilingInside ? -2 * (helixRampRadiusScaled + toolRadiusScaled) - RESOLUTION_FACTOR : 2 * (helixRampRadiusScaled + toolRadiusScaled) + RESOLUTION_FACTOR;
+		std::vector<Region> regions;
 		for (const auto &current : inputPaths)
 		{
 			int nesting = getPathNestingLevel(current, inputPaths);
@@ -1887,14 +1899,121 @@ std::list<AdaptiveOutput> Adaptive2d::Execute(const DPaths &stockPaths, const DP
 					clipof.AddPaths(toolBoundPaths, JoinType::jtRound, EndType::etClosedPolygon);
 					clipof.Execute(boundPaths, toolRadiusScaled + finishPassOffsetScaled);
 
-					ProcessPolyNode(boundPaths, toolBoundPaths);
+					regions.push_back(Region(boundPaths, toolBoundPaths));
 				}
 			}
 		}
+		ProcessRegions(regions);
 	}
 	return results;
 }
 
+//********************************************
+// Adaptive2d - processing of separate regions
+//********************************************
+
+void Adaptive2d::ProcessRegions(const std::vector<Region> &regions)
+{
+	size_t workerCount = threadCount > 0 ? size_t(threadCount) : size_t(std::thread::hardware_concurrency());
+#ifdef DEV_MODE
+	workerCount = 1; // perf counters and debug drawing are not thread safe
+#endif
+	workerCount = std::min(workerCount, regions.size());
+
+	if (workerCount > 1)
+	{
+		ProcessRegionsConcurrently(regions, workerCount);
+		return;
+	}
+	for (const auto &region : regions)
+		ProcessPolyNode(region.first, region.second);
+}
+
+// Each worker processes whole regions with its own copy of the Adaptive2d state. Progress paths
+// are handed over to this thread, which is the only one that calls the progress callback (it is
+// usually implemented in python). The outputs are appended in region order, so the result does
+// not depend on the number of workers.
+void Adaptive2d::ProcessRegionsConcurrently(const std::vector<Region> &regions, size_t workerCount)
+{
+	std::vector<std::list<AdaptiveOutput>> regionResults(regions.size());
+	std::atomic<size_t> nextRegion(0);
+	std::atomic<bool> stop(false);
+	std::mutex mutex;
+	std::condition_variable workerFinished;
+	TPaths pendingProgress;
+	size_t finishedWorkers = 0;
+	std::exception_ptr error;
+
+	std::function<bool(TPaths)> forwardProgress = [&](TPaths progressPaths) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto &pth : progressPaths)
+			pendingProgress.push_back(std::move(pth));
+		return stop.load();
+	};
+
+	auto worker = [&]() {
+		Adaptive2d local(*this);
+		local.results.clear();
+		local.progressCallback = &forwardProgress;
+		try
+		{
+			for (size_t i = nextRegion++; i < regions.size() && !stop; i = nextRegion++)
+			{
+				local.current_region = int(i);
+				local.lastProgressTime = clock();
+				local.ProcessPolyNode(regions[i].first, regions[i].second);
+				regionResults[i].swap(local.results);
+			}
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error)
+				error = std::current_exception();
+			stop = true;
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		finishedWorkers++;
+		workerFinished.notify_one();
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < workerCount; i++)
+		workers.emplace_back(worker);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		bool finished = finishedWorkers == workers.size();
+		if (!pendingProgress.empty())
+		{
+			TPaths progressPaths;
+			progressPaths.swap(pendingProgress);
+			lock.unlock();
+			if (progressCallback && (*progressCallback)(progressPaths))
+			{
+				stopProcessing = true;
+				stop = true;
+			}
+			lock.lock();
+		}
+		if (finished)
+			break;
+		// report collected progress at the usual interval, or as soon as all workers are done
+		workerFinished.wait_for(lock, std::chrono::milliseconds(1000 * PROGRESS_TICKS / CLOCKS_PER_SEC),
+								[&]() { return finishedWorkers == workers.size(); });
+	}
+	lock.unlock();
+
+	for (auto &w : workers)
+		w.join();
+	if (error)
+		std::rethrow_exception(error);
+
+	for (auto &regionResult : regionResults)
+		results.splice(results.end(), regionResult);
+}
+
 bool Adaptive2d::FindEntryPoint(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &boundPaths,
 								ClearedArea &clearedArea /*output-initial cleared area by helix*/,
 								IntPoint &entryPoint /*output*/,
@@ -2167,15 +2286,16 @@ bool Adaptive2d::ResolveLinkPath(const IntPoint &startPoint, const IntPoint &end
 	double par;
 
 	// put a time limit on the resolving the link path
-	clock_t time_limit = (clock_t)(max(keepToolDownDistRatio, 3.0) * CLOCKS_PER_SEC / 6);
+	// (wall time - clock() counts the cpu time of all worker threads when regions are processed concurrently)
+	auto time_limit = std::chrono::milliseconds(long(max(keepToolDownDistRatio, 3.0) * 1000 / 6));
 
-	clock_t time_out = clock() + time_limit;
+	auto time_out = std::chrono::steady_clock::now() + time_limit;
 
 	while (!queue.empty())
 	{
 		if (stopProcessing)
 			return false;
-		if (clock() > time_out)
+		if (std::chrono::steady_clock::now() > time_out)
 		{
 			cout << "Unable to resolve tool down linking path (limit reached)." << endl;
 			return false;
@@ -2601,7 +2721,6 @@ void Adaptive2d::ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths)
 {
 	Perf_ProcessPolyNode.Start();
 	current_region++;
-	cout << "** Processing region: " << current_region << endl;
 
 	// node paths are already constrained to tool boundary path for adaptive path before finishing pass
 	Clipper clip;
@@ -22,6 +22,7 @@
 #include "clipper.hpp"
 #include <vector>
 #include <list>
+#include <functional>
 #include <time.h>
 
 #ifndef ADAPTIVE_HPP
@@ -80,7 +81,7 @@ struct AdaptiveOutput
 	int ReturnMotionType; // MotionType enum, problem with serialization if enum is used
 };
 
-// used to isolate state -> enable potential adding of multi-threaded processing of separate regions
+// used to isolate state -> separate regions are processed by copies of this class in worker threads
 
 class Adaptive2d
 {
@@ -94,6 +95,7 @@ class Adaptive2d
 	bool forceInsideOut = true;
 	double keepToolDownDistRatio = 3.0; // keep tool down distance ratio
 	OperationType opType = OperationType::otClearingInside;
+	int threadCount = 1; // number of regions processed concurrently, 0 - one per hardware thread
 
 	std::list<AdaptiveOutput> Execute(const DPaths &stockPaths, const DPaths &paths, std::function<bool(TPaths)> progressCallbackFn);
 
@@ -123,6 +125,9 @@ class Adaptive2d
 	std::function<bool(TPaths)> *progressCallback = NULL;
 	Path toolGeometry; // tool geometry at coord 0,0, should not be modified
 
+	typedef std::pair<Paths, Paths> Region; // bound paths, tool bound paths
+	void ProcessRegions(const std::vector<Region> &regions);
+	void ProcessRegionsConcurrently(const std::vector<Region> &regions, size_t workerCount);
 	void ProcessPolyNode(Paths boundPaths, Paths toolBoundPaths);
 	bool FindEntryPoint(TPaths &progressPaths, const Paths &toolBoundPaths, const Paths &bound, ClearedArea &cleared /*output*/,
 						IntPoint &entryPoint /*output*/, IntPoint &toolPos, DoublePoint &toolDir);
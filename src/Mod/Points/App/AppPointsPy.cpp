@@ -97,6 +97,10 @@ private:
                 throw Py::RuntimeError("Unsupported file extension");
             }
 
+            // optionally thin out the cloud while reading it
+            ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+                ("User parameter:BaseApp/Preferences/Mod/Points");
+            reader->setVoxelSize(hGrp->GetFloat("VoxelSize", 0.0));
             reader->read(EncodedName);
 
             App::Document *pcDoc = App::GetApplication().newDocument("Unnamed");
@@ -209,6 +213,10 @@ private:
                 throw Py::RuntimeError("Unsupported file extension");
             }
 
+            // optionally thin out the cloud while reading it
+            ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+                ("User parameter:BaseApp/Preferences/Mod/Points");
+            reader->setVoxelSize(hGrp->GetFloat("VoxelSize", 0.0));
             reader->read(EncodedName);
 
             App::Document *pcDoc = App::GetApplication().getDocument(DocName);
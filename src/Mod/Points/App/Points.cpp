@@ -24,6 +24,7 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <cmath>
+# include <cstring>
 # include <iostream>
 #endif
 
@@ -33,7 +34,9 @@
 #include <Base/Exception.h>
 #include <Base/Matrix.h>
 #include <Base/Persistence.h>
+#include <Base/Reader.h>
 #include <Base/Stream.h>
+#include <Base/Swap.h>
 #include <Base/Writer.h>
 
 #include "Points.h"
@@ -204,6 +207,30 @@ void PointKernel::Restore(Base::XMLReader &reader)
 void PointKernel::RestoreDocFile(Base::Reader &reader)
 {
     Base::InputStream str(reader);
+
+    // the file is directly accessible if it was stored uncompressed, the
+    // data can be copied as is only if the stream doesn't swap the bytes
+    // and the machine uses the same byte order as the file
+    const char* data = reader.getData();
+    std::size_t size = reader.getDataSize();
+    bool swap = str.byteOrder() != Base::Stream::LittleEndian
+             || Base::SwapOrder() != LOW_ENDIAN;
+    if (data && !swap && size >= sizeof(uint32_t)) {
+        uint32_t uCt = 0;
+        std::memcpy(&uCt, data, sizeof(uint32_t));
+        const std::size_t pointSize = 3 * sizeof(float);
+        if (size - sizeof(uint32_t) >= std::size_t(uCt) * pointSize) {
+            _Points.resize(uCt);
+            const char* ptr = data + sizeof(uint32_t);
+            for (unsigned long i=0; i < uCt; i++, ptr += pointSize) {
+                float xyz[3];
+                std::memcpy(xyz, ptr, pointSize);
+                _Points[i].Set(xyz[0],xyz[1],xyz[2]);
+            }
+            return;
+        }
+    }
+
     uint32_t uCt = 0;
     str >> uCt;
     _Points.resize(uCt);
@@ -102,6 +102,10 @@ public:
     void SaveDocFile (Base::Writer &writer) const;
     void Restore(Base::XMLReader &reader);
     void RestoreDocFile(Base::Reader &reader);
+    /// Point coordinates hardly compress, so store them as is
+    DocFileCompression getDocFileCompression() const {
+        return NoCompression;
+    }
     void save(const char* file) const;
     void save(std::ostream&) const;
     void load(const char* file);
@@ -26,7 +26,10 @@
 #ifdef FC_OS_LINUX
 # include <unistd.h>
 #endif
+# include <cstring>
+# include <memory>
 # include <sstream>
+# include <unordered_map>
 #endif
 
 
@@ -39,12 +42,16 @@
 #include <Base/Console.h>
 #include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/Swap.h>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/regex.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <QThread>
+#include <QtConcurrentMap>
 
 using namespace Points;
 
@@ -123,6 +130,8 @@ Reader::Reader()
 {
     width = 0;
     height = 0;
+    voxelSize = 0.0;
+    multithreaded = true;
 }
 
 Reader::~Reader()
@@ -131,6 +140,7 @@ Reader::~Reader()
 
 void Reader::clear()
 {
+    points.clear();
     intensity.clear();
     colors.clear();
     normals.clear();
@@ -191,6 +201,26 @@ int Reader::getHeight() const
     return height;
 }
 
+void Reader::setVoxelSize(double size)
+{
+    voxelSize = size;
+}
+
+double Reader::getVoxelSize() const
+{
+    return voxelSize;
+}
+
+void Reader::setMultithreaded(bool on)
+{
+    multithreaded = on;
+}
+
+bool Reader::isMultithreaded() const
+{
+    return multithreaded;
+}
+
 // ----------------------------------------------------------------------------
 
 AscReader::AscReader()
@@ -240,73 +270,6 @@ public:
 
 typedef boost::shared_ptr<Converter> ConverterPtr;
 
-class DataStreambuf : public std::streambuf
-{
-public:
-    explicit DataStreambuf(const std::vector<char>& data) : _buffer(data) {
-        _beg = 0;
-        _end = data.size();
-        _cur = 0;
-    }
-    ~DataStreambuf() {
-    }
-
-protected:
-    virtual int_type uflow() {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur++]) & 0x000000ff;
-    }
-    virtual int_type underflow() {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur]) & 0x000000ff;
-    }
-    virtual int_type pbackfail(int_type ch) {
-        if (_cur == _beg || (ch != traits_type::eof() && ch != _buffer[_cur-1]))
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[--_cur]) & 0x000000ff;
-    }
-    virtual std::streamsize showmanyc() {
-        return _end - _cur;
-    }
-    virtual pos_type seekoff(std::streambuf::off_type off,
-        std::ios_base::seekdir way,
-        std::ios_base::openmode = 
-            std::ios::in | std::ios::out) {
-        int p_pos=-1;
-        if (way == std::ios_base::beg)
-            p_pos = _beg;
-        else if (way == std::ios_base::end)
-            p_pos = _end;
-        else if (way == std::ios_base::cur)
-            p_pos = _cur;
-
-        if (p_pos > _end)
-            return traits_type::eof();
-
-        if (((p_pos + off) > _end) || ((p_pos + off) < _beg))
-            return traits_type::eof();
-
-        _cur = p_pos+ off;
-
-        return ((p_pos+off) - _beg);
-    }
-    virtual pos_type seekpos(std::streambuf::pos_type pos,
-        std::ios_base::openmode which =
-        std::ios::in | std::ios::out) {
-        (void)which;
-        return seekoff(pos, std::ios_base::beg);
-    }
-
-private:
-    const std::vector<char>& _buffer;
-    int _beg, _end, _cur;
-};
-
 //Taken from https://github.com/PointCloudLibrary/pcl/blob/master/io/src/lzf.cpp
 unsigned int 
 lzfDecompress (const void *const in_data,  unsigned int in_len,
@@ -491,6 +454,634 @@ lzfDecompress (const void *const in_data,  unsigned int in_len,
 
   return (static_cast<unsigned int> (op - static_cast<unsigned char*> (out_data)));
 }
+
+// ----------------------------------------------------------------------------
+
+/*!
+ * Location and encoding of one field of a binary point record.
+ * Interleaved records (PLY, PCD binary) use the record size as stride while the
+ * column-wise layout of PCD binary_compressed uses the size of the field itself.
+ */
+struct BinaryField
+{
+    std::size_t offset;
+    std::size_t stride;
+    char type; // 'I', 'U' or 'F'
+    int size;
+};
+
+/*!
+ * Typed access to a block of binary point records. The values are read directly
+ * from the raw buffer without any intermediate copy.
+ */
+class BinaryRecords
+{
+public:
+    BinaryRecords(const char* data, const std::vector<BinaryField>& fields,
+                  bool swapByteOrder, std::size_t first = 0)
+        : data(data), fields(fields), swapByteOrder(swapByteOrder), first(first)
+    {
+    }
+    double value(std::size_t index, std::size_t field) const
+    {
+        const BinaryField& f = fields[field];
+        const char* ptr = data + f.offset + (first + index) * f.stride;
+        switch (f.size) {
+        case 1:
+            if (f.type == 'I')
+                return static_cast<double>(load<int8_t>(ptr));
+            return static_cast<double>(load<uint8_t>(ptr));
+        case 2:
+            if (f.type == 'I')
+                return static_cast<double>(load<int16_t>(ptr));
+            return static_cast<double>(load<uint16_t>(ptr));
+        case 4:
+            if (f.type == 'I')
+                return static_cast<double>(load<int32_t>(ptr));
+            else if (f.type == 'U')
+                return static_cast<double>(load<uint32_t>(ptr));
+            return static_cast<double>(load<float>(ptr));
+        default:
+            return load<double>(ptr);
+        }
+    }
+    /// the raw bit pattern of a 32-bit field, e.g. a packed colour
+    uint32_t bits(std::size_t index, std::size_t field) const
+    {
+        const BinaryField& f = fields[field];
+        if (f.size != 4)
+            return static_cast<uint32_t>(value(index, field));
+        return load<uint32_t>(data + f.offset + (first + index) * f.stride);
+    }
+
+    static BinaryField makeField(char type, int size)
+    {
+        bool valid = false;
+        switch (size) {
+        case 1:
+        case 2:
+            valid = (type == 'I' || type == 'U');
+            break;
+        case 4:
+            valid = (type == 'I' || type == 'U' || type == 'F');
+            break;
+        case 8:
+            valid = (type == 'F');
+            break;
+        }
+
+        if (!valid)
+            throw Base::BadFormatError("Unexpected type");
+
+        BinaryField field;
+        field.offset = 0;
+        field.stride = 0;
+        field.type = type;
+        field.size = size;
+        return field;
+    }
+    /// Sets offset and stride of interleaved records and returns the record size
+    static std::size_t interleave(std::vector<BinaryField>& fields)
+    {
+        std::size_t offset = 0;
+        for (std::vector<BinaryField>::iterator it = fields.begin(); it != fields.end(); ++it) {
+            it->offset = offset;
+            offset += it->size;
+        }
+        for (std::vector<BinaryField>::iterator it = fields.begin(); it != fields.end(); ++it) {
+            it->stride = offset;
+        }
+        return offset;
+    }
+    /// Sets offset and stride of \a numPoints records stored field by field and returns the data size
+    static std::size_t columns(std::vector<BinaryField>& fields, std::size_t numPoints)
+    {
+        std::size_t offset = 0;
+        for (std::vector<BinaryField>::iterator it = fields.begin(); it != fields.end(); ++it) {
+            it->offset = offset;
+            it->stride = it->size;
+            offset += it->size * numPoints;
+        }
+        return offset;
+    }
+
+private:
+    template <typename T>
+    T load(const char* ptr) const
+    {
+        T v;
+        memcpy(&v, ptr, sizeof(T));
+        if (swapByteOrder)
+            SwapEndian<T>(v);
+        return v;
+    }
+
+private:
+    const char* data;
+    const std::vector<BinaryField>& fields;
+    bool swapByteOrder;
+    std::size_t first;
+};
+
+/*!
+ * A block of records parsed from an ASCII file. Floating point fields of packed
+ * colours are stored as text and thus converted back to their bit pattern.
+ */
+class AsciiRecords
+{
+public:
+    AsciiRecords(const std::vector<char>& types)
+        : types(types)
+    {
+    }
+    void clear()
+    {
+        values.clear();
+    }
+    std::size_t size() const
+    {
+        return types.empty() ? 0 : values.size() / types.size();
+    }
+    bool addLine(std::string& line)
+    {
+        // since the file is loaded in binary mode we may get the CR at the end
+        boost::trim(line);
+        if (line.empty())
+            return false;
+        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
+
+        std::size_t numFields = types.size();
+        for (std::size_t col = 0; col < numFields; col++) {
+            if (col < list.size())
+                values.push_back(boost::lexical_cast<double>(list[col]));
+            else
+                values.push_back(0.0);
+        }
+        return true;
+    }
+    double value(std::size_t index, std::size_t field) const
+    {
+        return values[index * types.size() + field];
+    }
+    uint32_t bits(std::size_t index, std::size_t field) const
+    {
+        if (types[field] != 'F')
+            return static_cast<uint32_t>(value(index, field));
+        float f = static_cast<float>(value(index, field));
+        uint32_t u;
+        memcpy(&u, &f, sizeof(uint32_t));
+        return u;
+    }
+
+private:
+    const std::vector<char>& types;
+    std::vector<double> values;
+    std::vector<std::string> list;
+};
+
+/*!
+ * Maps the fields of a point record to the point, normal, intensity and colour arrays.
+ */
+struct PointFields
+{
+    enum ColorType {
+        NoColor,
+        ColorUInt8,       // separate red, green, blue (alpha) fields in [0,255]
+        ColorFloat,       // separate red, green, blue (alpha) fields in [0,1]
+        ColorPacked       // a single integer or float field with the bit pattern of packed argb values
+    };
+
+    explicit PointFields(const std::vector<std::string>& fields)
+    {
+        x = find(fields, "x");
+        y = find(fields, "y");
+        z = find(fields, "z");
+        normal_x = find(fields, "normal_x", "nx");
+        normal_y = find(fields, "normal_y", "ny");
+        normal_z = find(fields, "normal_z", "nz");
+        greyvalue = find(fields, "intensity");
+        red = green = blue = alpha = rgba = none();
+        color = NoColor;
+    }
+
+    static std::size_t none()
+    {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    static std::size_t find(const std::vector<std::string>& fields, const char* name, const char* alt = 0)
+    {
+        std::vector<std::string>::const_iterator it = std::find(fields.begin(), fields.end(), name);
+        if (it == fields.end() && alt)
+            it = std::find(fields.begin(), fields.end(), alt);
+        if (it == fields.end())
+            return none();
+        return std::distance(fields.begin(), it);
+    }
+
+    bool hasData() const
+    {
+        return (x != none() && y != none() && z != none());
+    }
+    bool hasNormal() const
+    {
+        return hasData() && (normal_x != none() && normal_y != none() && normal_z != none());
+    }
+    bool hasIntensity() const
+    {
+        return hasData() && (greyvalue != none());
+    }
+    bool hasColor() const
+    {
+        return hasData() && (color != NoColor);
+    }
+
+    std::size_t x, y, z;
+    std::size_t normal_x, normal_y, normal_z;
+    std::size_t greyvalue;
+    std::size_t red, green, blue, alpha;
+    std::size_t rgba;
+    ColorType color;
+};
+
+/*!
+ * Merges all points falling into the same cubic cell into their centroid.
+ * Normals, intensities and colours of a cell are averaged as well. The cells
+ * are kept in the order of the first point that hit them so that the result
+ * does not depend on the number of threads used for decoding.
+ */
+class VoxelFilter
+{
+public:
+    explicit VoxelFilter(double size)
+        : size(size)
+    {
+    }
+    void add(const std::vector<Base::Vector3f>& points,
+             const std::vector<Base::Vector3f>& normals,
+             const std::vector<float>& intensity,
+             const std::vector<App::Color>& colors,
+             std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            const Base::Vector3f& p = points[i];
+            if (!boost::math::isfinite(p.x) || !boost::math::isfinite(p.y) || !boost::math::isfinite(p.z))
+                continue;
+
+            Key key;
+            key.x = static_cast<int64_t>(std::floor(p.x / size));
+            key.y = static_cast<int64_t>(std::floor(p.y / size));
+            key.z = static_cast<int64_t>(std::floor(p.z / size));
+
+            auto it = cells.insert(std::make_pair(key, voxels.size()));
+            if (it.second)
+                voxels.push_back(Voxel());
+
+            Voxel& v = voxels[it.first->second];
+            v.point += Base::toVector<double>(p);
+            if (!normals.empty())
+                v.normal += Base::toVector<double>(normals[i]);
+            if (!intensity.empty())
+                v.intensity += intensity[i];
+            if (!colors.empty()) {
+                const App::Color& c = colors[i];
+                v.r += c.r;
+                v.g += c.g;
+                v.b += c.b;
+                v.a += c.a;
+            }
+            v.count++;
+        }
+    }
+    void extract(std::vector<Base::Vector3f>& points,
+                 std::vector<Base::Vector3f>& normals,
+                 std::vector<float>& intensity,
+                 std::vector<App::Color>& colors,
+                 bool hasNormal, bool hasIntensity, bool hasColor) const
+    {
+        std::size_t numVoxels = voxels.size();
+        points.resize(numVoxels);
+        if (hasNormal)
+            normals.resize(numVoxels);
+        if (hasIntensity)
+            intensity.resize(numVoxels);
+        if (hasColor)
+            colors.resize(numVoxels);
+
+        for (std::size_t i = 0; i < numVoxels; i++) {
+            const Voxel& v = voxels[i];
+            double w = 1.0 / static_cast<double>(v.count);
+            points[i] = Base::toVector<float>(v.point * w);
+            if (hasNormal) {
+                Base::Vector3d n = v.normal;
+                if (n.Length() > 0.0)
+                    n.Normalize();
+                normals[i] = Base::toVector<float>(n);
+            }
+            if (hasIntensity)
+                intensity[i] = static_cast<float>(v.intensity * w);
+            if (hasColor) {
+                colors[i].set(static_cast<float>(v.r * w), static_cast<float>(v.g * w),
+                              static_cast<float>(v.b * w), static_cast<float>(v.a * w));
+            }
+        }
+    }
+
+private:
+    struct Key
+    {
+        int64_t x, y, z;
+        bool operator == (const Key& k) const
+        {
+            return x == k.x && y == k.y && z == k.z;
+        }
+    };
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& k) const
+        {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, k.x);
+            boost::hash_combine(seed, k.y);
+            boost::hash_combine(seed, k.z);
+            return seed;
+        }
+    };
+    struct Voxel
+    {
+        Voxel() : intensity(0), r(0), g(0), b(0), a(0), count(0)
+        {
+        }
+        Base::Vector3d point;
+        Base::Vector3d normal;
+        double intensity;
+        double r, g, b, a;
+        std::size_t count;
+    };
+
+    double size;
+    std::unordered_map<Key, std::size_t, KeyHash> cells;
+    std::vector<Voxel> voxels;
+};
+
+/*!
+ * Decodes blocks of point records straight into the typed arrays of a reader.
+ * Each block is converted with several threads if enabled. If a voxel size is
+ * set the block is decoded into scratch arrays and merged into a VoxelFilter
+ * so that only the downsampled cloud is ever held in memory.
+ */
+class PointsDecoder
+{
+public:
+    /// number of records decoded at once
+    static const std::size_t BlockSize = 65536;
+
+    PointsDecoder(const PointFields& fields, std::size_t numPoints,
+                  double voxelSize, bool multithreaded,
+                  std::vector<Base::Vector3f>& points,
+                  std::vector<Base::Vector3f>& normals,
+                  std::vector<float>& intensity,
+                  std::vector<App::Color>& colors)
+        : fields(fields)
+        , multithreaded(multithreaded)
+        , decoded(0)
+        , points(points)
+        , normals(normals)
+        , intensity(intensity)
+        , colors(colors)
+    {
+        if (voxelSize > 0.0) {
+            filter.reset(new VoxelFilter(voxelSize));
+        }
+        else if (fields.hasData()) {
+            points.resize(numPoints);
+            if (fields.hasNormal())
+                normals.resize(numPoints);
+            if (fields.hasIntensity())
+                intensity.resize(numPoints);
+            if (fields.hasColor())
+                colors.resize(numPoints);
+        }
+    }
+
+    template <typename Records>
+    void decode(const Records& records, std::size_t count)
+    {
+        if (!fields.hasData() || count == 0)
+            return;
+
+        std::size_t offset = decoded;
+        if (filter) {
+            offset = 0;
+            blockPoints.resize(count);
+            if (fields.hasNormal())
+                blockNormals.resize(count);
+            if (fields.hasIntensity())
+                blockIntensity.resize(count);
+            if (fields.hasColor())
+                blockColors.resize(count);
+        }
+
+        std::vector<Base::Vector3f>& pts = filter ? blockPoints : points;
+        std::vector<Base::Vector3f>& nor = filter ? blockNormals : normals;
+        std::vector<float>& grey = filter ? blockIntensity : intensity;
+        std::vector<App::Color>& col = filter ? blockColors : colors;
+
+        std::vector<std::pair<std::size_t, std::size_t> > ranges;
+        std::size_t numRanges = 1;
+        if (multithreaded)
+            numRanges = std::max<std::size_t>(1, std::min<std::size_t>(
+                static_cast<std::size_t>(QThread::idealThreadCount()), count / 4096));
+        for (std::size_t i = 0; i < numRanges; i++)
+            ranges.emplace_back(count * i / numRanges, count * (i + 1) / numRanges);
+
+        const PointFields& f = fields;
+        auto store = [&](const std::pair<std::size_t, std::size_t>& range) {
+            for (std::size_t i = range.first; i < range.second; i++) {
+                std::size_t index = offset + i;
+                pts[index].Set(static_cast<float>(records.value(i, f.x)),
+                               static_cast<float>(records.value(i, f.y)),
+                               static_cast<float>(records.value(i, f.z)));
+                if (f.hasNormal()) {
+                    nor[index].Set(static_cast<float>(records.value(i, f.normal_x)),
+                                   static_cast<float>(records.value(i, f.normal_y)),
+                                   static_cast<float>(records.value(i, f.normal_z)));
+                }
+                if (f.hasIntensity()) {
+                    grey[index] = static_cast<float>(records.value(i, f.greyvalue));
+                }
+                if (f.hasColor()) {
+                    col[index] = color(records, i);
+                }
+            }
+        };
+
+        if (ranges.size() > 1)
+            QtConcurrent::blockingMap(ranges, store);
+        else
+            store(ranges.front());
+
+        if (filter) {
+            filter->add(blockPoints, blockNormals, blockIntensity, blockColors, count);
+        }
+
+        decoded += count;
+    }
+
+    /// Finishes reading and returns the number of points
+    std::size_t finish()
+    {
+        if (filter) {
+            filter->extract(points, normals, intensity, colors,
+                            fields.hasNormal(), fields.hasIntensity(), fields.hasColor());
+        }
+        else if (decoded < points.size()) {
+            // the file contains fewer records than announced
+            points.resize(decoded);
+            if (fields.hasNormal())
+                normals.resize(decoded);
+            if (fields.hasIntensity())
+                intensity.resize(decoded);
+            if (fields.hasColor())
+                colors.resize(decoded);
+        }
+
+        return points.size();
+    }
+
+    bool isDownsampled() const
+    {
+        return filter.get() != nullptr;
+    }
+
+private:
+    template <typename Records>
+    App::Color color(const Records& records, std::size_t i) const
+    {
+        const PointFields& f = fields;
+        switch (f.color) {
+        case PointFields::ColorUInt8:
+        {
+            float a = 1.0f;
+            if (f.alpha != PointFields::none())
+                a = static_cast<float>(records.value(i, f.alpha));
+            return App::Color(static_cast<float>(records.value(i, f.red))/255.0f,
+                              static_cast<float>(records.value(i, f.green))/255.0f,
+                              static_cast<float>(records.value(i, f.blue))/255.0f,
+                              a/255.0f);
+        }
+        case PointFields::ColorFloat:
+        {
+            float a = 1.0f;
+            if (f.alpha != PointFields::none())
+                a = static_cast<float>(records.value(i, f.alpha));
+            return App::Color(static_cast<float>(records.value(i, f.red)),
+                              static_cast<float>(records.value(i, f.green)),
+                              static_cast<float>(records.value(i, f.blue)),
+                              a);
+        }
+        case PointFields::ColorPacked:
+        {
+            uint32_t packed = records.bits(i, f.rgba);
+            uint32_t a = (packed >> 24) & 0xff;
+            uint32_t r = (packed >> 16) & 0xff;
+            uint32_t g = (packed >> 8) & 0xff;
+            uint32_t b = packed & 0xff;
+            return App::Color(static_cast<float>(r)/255.0f,
+                              static_cast<float>(g)/255.0f,
+                              static_cast<float>(b)/255.0f,
+                              static_cast<float>(a)/255.0f);
+        }
+        default:
+            return App::Color();
+        }
+    }
+
+private:
+    const PointFields& fields;
+    bool multithreaded;
+    std::size_t decoded;
+    std::unique_ptr<VoxelFilter> filter;
+
+    std::vector<Base::Vector3f>& points;
+    std::vector<Base::Vector3f>& normals;
+    std::vector<float>& intensity;
+    std::vector<App::Color>& colors;
+
+    std::vector<Base::Vector3f> blockPoints;
+    std::vector<Base::Vector3f> blockNormals;
+    std::vector<float> blockIntensity;
+    std::vector<App::Color> blockColors;
+};
+
+const std::size_t PointsDecoder::BlockSize;
+
+/*!
+ * Reads \a numPoints interleaved binary records in blocks and passes them to the decoder.
+ */
+void readBinaryRecords(std::istream& inp, std::size_t numPoints,
+                       const std::vector<BinaryField>& fields, std::size_t recordSize,
+                       bool swapByteOrder, PointsDecoder& decoder)
+{
+    std::vector<char> buffer(std::min(numPoints, PointsDecoder::BlockSize) * recordSize);
+    std::size_t done = 0;
+    while (done < numPoints) {
+        std::size_t count = std::min(numPoints - done, PointsDecoder::BlockSize);
+        std::streamsize bytes = static_cast<std::streamsize>(count * recordSize);
+        inp.read(&buffer[0], bytes);
+        if (inp.gcount() != bytes)
+            throw Base::BadFormatError("Unexpected end of file");
+
+        BinaryRecords records(&buffer[0], fields, swapByteOrder);
+        decoder.decode(records, count);
+        done += count;
+    }
+}
+
+/*!
+ * Reads at most \a numPoints lines of ASCII records in blocks and passes them to the decoder.
+ */
+void readAsciiRecords(std::istream& inp, std::size_t numPoints,
+                      const std::vector<char>& types, PointsDecoder& decoder)
+{
+    AsciiRecords records(types);
+    std::string line;
+    std::size_t row = 0;
+    while (row < numPoints && std::getline(inp, line)) {
+        if (records.addLine(line)) {
+            ++row;
+            if (records.size() == PointsDecoder::BlockSize) {
+                decoder.decode(records, records.size());
+                records.clear();
+            }
+        }
+    }
+
+    decoder.decode(records, records.size());
+}
+
+/// Maps a PLY number type to the PCD type characters used by BinaryField
+char plyNumberType(const std::string& t)
+{
+    if (t == "char" || t == "int8" || t == "short" || t == "int16" || t == "int" || t == "int32")
+        return 'I';
+    if (t == "uchar" || t == "uint8" || t == "ushort" || t == "uint16" || t == "uint" || t == "uint32")
+        return 'U';
+    if (t == "float" || t == "float32" || t == "double" || t == "float64")
+        return 'F';
+    throw Base::BadFormatError("Unexpected type");
+}
+
+/// Creates the record layout of the PCD fields
+std::vector<BinaryField> pcdLayout(const std::vector<std::string>& types,
+                                   const std::vector<int>& sizes)
+{
+    std::vector<BinaryField> layout;
+    for (std::size_t j=0; j<types.size(); j++) {
+        char t = types[j].empty() ? '\0' : types[j][0];
+        layout.push_back(BinaryRecords::makeField(t, sizes[j]));
+    }
+    return layout;
+}
 }
 
 PlyReader::PlyReader()
@@ -517,142 +1108,37 @@ void PlyReader::read(const std::string& filename)
     std::size_t offset = 0;
     std::size_t numPoints = readHeader(inp, format, offset, fields, types, sizes);
 
-    Eigen::MatrixXd data(numPoints, fields.size());
+    // rgb(a) fields
+    PointFields map(fields);
+    map.red = PointFields::find(fields, "red");
+    map.green = PointFields::find(fields, "green");
+    map.blue = PointFields::find(fields, "blue");
+    map.alpha = PointFields::find(fields, "alpha");
+    if (map.red != PointFields::none() &&
+        map.green != PointFields::none() &&
+        map.blue != PointFields::none()) {
+        const std::string& t = types[map.red];
+        if (t == "uchar" || t == "uint8")
+            map.color = PointFields::ColorUInt8;
+        else if (t == "float" || t == "float32")
+            map.color = PointFields::ColorFloat;
+    }
+
+    // decode the records straight into the point, normal, intensity and colour arrays
+    PointsDecoder decoder(map, numPoints, voxelSize, multithreaded,
+                          points.getBasicPoints(), normals, intensity, colors);
     if (format == "ascii") {
-        readAscii(inp, offset, data);
+        readAscii(inp, offset, numPoints, types, decoder);
     }
     else if (format == "binary_little_endian") {
-        readBinary(false, inp, offset, types, sizes, data);
+        readBinary(false, inp, offset, numPoints, types, sizes, decoder);
     }
     else if (format == "binary_big_endian") {
-        readBinary(true, inp, offset, types, sizes, data);
-    }
-
-    std::vector<std::string>::iterator it;
-    std::size_t max_size = std::numeric_limits<std::size_t>::max();
-
-    // x field
-    std::size_t x = max_size;
-    it = std::find(fields.begin(), fields.end(), "x");
-    if (it != fields.end())
-        x = std::distance(fields.begin(), it);
-
-    // y field
-    std::size_t y = max_size;
-    it = std::find(fields.begin(), fields.end(), "y");
-    if (it != fields.end())
-        y = std::distance(fields.begin(), it);
-
-    // z field
-    std::size_t z = max_size;
-    it = std::find(fields.begin(), fields.end(), "z");
-    if (it != fields.end())
-        z = std::distance(fields.begin(), it);
-
-    // normal x field
-    std::size_t normal_x = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_x");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nx");
-    if (it != fields.end())
-        normal_x = std::distance(fields.begin(), it);
-
-    // normal y field
-    std::size_t normal_y = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_y");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "ny");
-    if (it != fields.end())
-        normal_y = std::distance(fields.begin(), it);
-
-    // normal z field
-    std::size_t normal_z = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_z");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nz");
-    if (it != fields.end())
-        normal_z = std::distance(fields.begin(), it);
-
-    // intensity field
-    std::size_t greyvalue = max_size;
-    it = std::find(fields.begin(), fields.end(), "intensity");
-    if (it != fields.end())
-        greyvalue = std::distance(fields.begin(), it);
-
-    // rgb(a) field
-    std::size_t red = max_size, green = max_size, blue = max_size, alpha = max_size;
-    it = std::find(fields.begin(), fields.end(), "red");
-    if (it != fields.end())
-        red = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "green");
-    if (it != fields.end())
-        green = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "blue");
-    if (it != fields.end())
-        blue = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "alpha");
-    if (it != fields.end())
-        alpha = std::distance(fields.begin(), it);
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (red != max_size && green != max_size && blue != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
-        }
+        readBinary(true, inp, offset, numPoints, types, sizes, decoder);
     }
 
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.emplace_back(data(i,normal_x),data(i,normal_y),data(i,normal_z));
-        }
-    }
-
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
-    }
-
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        float a = 1.0;
-        if (types[red] == "uchar") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.emplace_back(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f);
-            }
-        }
-        else if (types[red] == "float") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.emplace_back(r, g, b, a);
-            }
-        }
-    }
+    decoder.finish();
 }
-
 std::size_t PlyReader::readHeader(std::istream& in,
                                   std::string& format,
                                   std::size_t& offset,
@@ -821,100 +1307,40 @@ std::size_t PlyReader::readHeader(std::istream& in,
     return numPoints;
 }
 
-void PlyReader::readAscii(std::istream& inp, std::size_t offset, Eigen::MatrixXd& data)
+void PlyReader::readAscii(std::istream& inp, std::size_t offset, std::size_t numPoints,
+                          const std::vector<std::string>& types,
+                          PointsDecoder& decoder)
 {
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
+    std::vector<char> numberTypes;
+    for (std::vector<std::string>::const_iterator it = types.begin(); it != types.end(); ++it)
+        numberTypes.push_back(plyNumberType(*it));
 
-        // since the file is loaded in binary mode we may get the CR at the end
+    // skip the lines of elements coming before 'vertex'
+    std::string line;
+    while (offset > 0 && std::getline(inp, line)) {
         boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
+        if (!line.empty())
+            offset--;
     }
+
+    readAsciiRecords(inp, numPoints, numberTypes, decoder);
 }
 
 void PlyReader::readBinary(bool swapByteOrder,
                            std::istream& inp,
                            std::size_t offset,
+                           std::size_t numPoints,
                            const std::vector<std::string>& types,
                            const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
+                           PointsDecoder& decoder)
 {
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        std::string t = types[j];
-        switch (sizes[j]) {
-        case 1:
-            if (t == "char" || t == "int8")
-                converters.push_back(convert_int8);
-            else if (t == "uchar" || t == "uint8")
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == "short" || t == "int16")
-                converters.push_back(convert_int16);
-            else if (t == "ushort" || t == "uint16")
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == "int" || t == "int32")
-                converters.push_back(convert_int32);
-            else if (t == "uint" || t == "uint32")
-                converters.push_back(convert_uint32);
-            else if (t == "float" || t == "float32")
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == "double" || t == "float64")
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
+    std::vector<BinaryField> layout;
+    for (std::size_t j=0; j<types.size(); j++) {
+        layout.push_back(BinaryRecords::makeField(plyNumberType(types[j]), sizes[j]));
     }
 
+    std::size_t neededSize = BinaryRecords::interleave(layout);
+
     std::streamoff ulSize = 0;
     std::streamoff ulCurr = 0;
     std::streambuf* buf = inp.rdbuf();
@@ -922,18 +1348,11 @@ void PlyReader::readBinary(bool swapByteOrder,
         ulCurr = buf->pubseekoff(static_cast<std::streamoff>(offset), std::ios::cur, std::ios::in);
         ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
         buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
+        if (ulCurr + static_cast<std::streamoff>(neededSize*numPoints) > ulSize)
             throw Base::BadFormatError("File expects too many elements");
     }
 
-    Base::InputStream str(inp);
-    str.setByteOrder(swapByteOrder ? Base::Stream::BigEndian : Base::Stream::LittleEndian);
-    for (std::size_t i=0; i<numPoints; i++) {
-        for (std::size_t j=0; j<numFields; j++) {
-            double value = converters[j]->toDouble(str);
-            data(i, j) = value;
-        }
-    }
+    readBinaryRecords(inp, numPoints, layout, neededSize, swapByteOrder, decoder);
 }
 
 // ----------------------------------------------------------------------------
@@ -961,156 +1380,35 @@ void PcdReader::read(const std::string& filename)
     std::vector<int> sizes;
     std::size_t numPoints = readHeader(inp, format, fields, types, sizes);
 
-    Eigen::MatrixXd data(numPoints, fields.size());
+    // rgb(a) field
+    PointFields map(fields);
+    map.rgba = PointFields::find(fields, "rgb", "rgba");
+    if (map.rgba != PointFields::none()) {
+        if (types[map.rgba] == "U" || types[map.rgba] == "F")
+            map.color = PointFields::ColorPacked;
+    }
+
+    // decode the records straight into the point, normal, intensity and colour arrays
+    PointsDecoder decoder(map, numPoints, voxelSize, multithreaded,
+                          points.getBasicPoints(), normals, intensity, colors);
     if (format == "ascii") {
-        readAscii(inp, data);
+        readAscii(inp, numPoints, types, decoder);
     }
     else if (format == "binary") {
-        readBinary(false, inp, types, sizes, data);
+        readBinary(inp, numPoints, types, sizes, decoder);
     }
     else if (format == "binary_compressed") {
-        unsigned int c, u;
-        Base::InputStream str(inp);
-        str >> c >> u;
-
-        std::vector<char> compressed(c);
-        inp.read(&compressed[0], c);
-        std::vector<char> uncompressed(u);
-        if (lzfDecompress(&compressed[0], c, &uncompressed[0], u) == u) {
-            DataStreambuf ibuf(uncompressed);
-            std::istream istr(0);
-            istr.rdbuf(&ibuf);
-            readBinary(true, istr, types, sizes, data);
-        }
-        else {
-            throw Base::BadFormatError("Failed to decompress binary data");
-        }
-    }
-
-    std::vector<std::string>::iterator it;
-    std::size_t max_size = std::numeric_limits<std::size_t>::max();
-
-    // x field
-    std::size_t x = max_size;
-    it = std::find(fields.begin(), fields.end(), "x");
-    if (it != fields.end())
-        x = std::distance(fields.begin(), it);
-
-    // y field
-    std::size_t y = max_size;
-    it = std::find(fields.begin(), fields.end(), "y");
-    if (it != fields.end())
-        y = std::distance(fields.begin(), it);
-
-    // z field
-    std::size_t z = max_size;
-    it = std::find(fields.begin(), fields.end(), "z");
-    if (it != fields.end())
-        z = std::distance(fields.begin(), it);
-
-    // normal x field
-    std::size_t normal_x = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_x");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nx");
-    if (it != fields.end())
-        normal_x = std::distance(fields.begin(), it);
-
-    // normal y field
-    std::size_t normal_y = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_y");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "ny");
-    if (it != fields.end())
-        normal_y = std::distance(fields.begin(), it);
-
-    // normal z field
-    std::size_t normal_z = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_z");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nz");
-    if (it != fields.end())
-        normal_z = std::distance(fields.begin(), it);
-
-    // intensity field
-    std::size_t greyvalue = max_size;
-    it = std::find(fields.begin(), fields.end(), "intensity");
-    if (it != fields.end())
-        greyvalue = std::distance(fields.begin(), it);
-
-    // rgb(a) field
-    std::size_t rgba = max_size;
-    it = std::find(fields.begin(), fields.end(), "rgb");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "rgba");
-    if (it != fields.end())
-        rgba = std::distance(fields.begin(), it);
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (rgba != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
-        }
-    }
-
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.emplace_back(data(i,normal_x),data(i,normal_y),data(i,normal_z));
-        }
+        readCompressed(inp, numPoints, types, sizes, decoder);
     }
 
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
-    }
-
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        if (types[rgba] == "U") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                uint32_t packed = static_cast<uint32_t>(data(i,rgba));
-                uint32_t a = (packed >> 24) & 0xff;
-                uint32_t r = (packed >> 16) & 0xff;
-                uint32_t g = (packed >> 8) & 0xff;
-                uint32_t b = packed & 0xff;
-                colors.emplace_back(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f);
-            }
-        }
-        else if (types[rgba] == "F") {
-            union RGBA {
-                uint32_t u;
-                float f;
-            };
+    std::size_t numRead = decoder.finish();
 
-            union RGBA v;
-            for (std::size_t i=0; i<numPoints; i++) {
-                v.f = static_cast<float>(data(i,rgba));
-                uint32_t packed = v.u;
-                uint32_t a = (packed >> 24) & 0xff;
-                uint32_t r = (packed >> 16) & 0xff;
-                uint32_t g = (packed >> 8) & 0xff;
-                uint32_t b = packed & 0xff;
-                colors.emplace_back(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f);
-            }
-        }
+    // a downsampled cloud has lost its grid structure
+    if (decoder.isDownsampled()) {
+        this->width = static_cast<int>(numRead);
+        this->height = 1;
     }
 }
-
 std::size_t PcdReader::readHeader(std::istream& in,
                                   std::string& format,
                                   std::vector<std::string>& fields,
@@ -1183,93 +1481,25 @@ std::size_t PcdReader::readHeader(std::istream& in,
     return points;
 }
 
-void PcdReader::readAscii(std::istream& inp, Eigen::MatrixXd& data)
+void PcdReader::readAscii(std::istream& inp, std::size_t numPoints,
+                          const std::vector<std::string>& types,
+                          PointsDecoder& decoder)
 {
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
+    std::vector<char> numberTypes;
+    for (std::vector<std::string>::const_iterator it = types.begin(); it != types.end(); ++it)
+        numberTypes.push_back(it->empty() ? 'F' : (*it)[0]);
 
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
+    readAsciiRecords(inp, numPoints, numberTypes, decoder);
 }
 
-void PcdReader::readBinary(bool transpose,
-                           std::istream& inp,
+void PcdReader::readBinary(std::istream& inp,
+                           std::size_t numPoints,
                            const std::vector<std::string>& types,
                            const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
+                           PointsDecoder& decoder)
 {
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        char t = types[j][0];
-        switch (sizes[j]) {
-        case 1:
-            if (t == 'I')
-                converters.push_back(convert_int8);
-            else if (t == 'U')
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == 'I')
-                converters.push_back(convert_int16);
-            else if (t == 'U')
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == 'I')
-                converters.push_back(convert_int32);
-            else if (t == 'U')
-                converters.push_back(convert_uint32);
-            else if (t == 'F')
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == 'F')
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
+    std::vector<BinaryField> layout = pcdLayout(types, sizes);
+    std::size_t neededSize = BinaryRecords::interleave(layout);
 
     std::streamoff ulSize = 0;
     std::streamoff ulCurr = 0;
@@ -1278,26 +1508,44 @@ void PcdReader::readBinary(bool transpose,
         ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
         ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
         buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
+        if (ulCurr + static_cast<std::streamoff>(neededSize*numPoints) > ulSize)
             throw Base::BadFormatError("File expects too many elements");
     }
 
+    readBinaryRecords(inp, numPoints, layout, neededSize, false, decoder);
+}
+
+void PcdReader::readCompressed(std::istream& inp,
+                               std::size_t numPoints,
+                               const std::vector<std::string>& types,
+                               const std::vector<int>& sizes,
+                               PointsDecoder& decoder)
+{
+    unsigned int c, u;
     Base::InputStream str(inp);
-    if (transpose) {
-        for (std::size_t j=0; j<numFields; j++) {
-            for (std::size_t i=0; i<numPoints; i++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
+    str >> c >> u;
+    if (c == 0 || u == 0)
+        throw Base::BadFormatError("Failed to decompress binary data");
+
+    std::vector<char> compressed(c);
+    inp.read(&compressed[0], c);
+    std::vector<char> uncompressed(u);
+    if (lzfDecompress(&compressed[0], c, &uncompressed[0], u) != u) {
+        throw Base::BadFormatError("Failed to decompress binary data");
     }
-    else {
-        for (std::size_t i=0; i<numPoints; i++) {
-            for (std::size_t j=0; j<numFields; j++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
+
+    // free the compressed data before decoding
+    std::vector<char>().swap(compressed);
+
+    // the data is stored field by field
+    std::vector<BinaryField> layout = pcdLayout(types, sizes);
+    if (BinaryRecords::columns(layout, numPoints) > uncompressed.size())
+        throw Base::BadFormatError("File expects too many elements");
+
+    for (std::size_t first = 0; first < numPoints; first += PointsDecoder::BlockSize) {
+        std::size_t count = std::min(numPoints - first, PointsDecoder::BlockSize);
+        BinaryRecords records(&uncompressed[0], layout, false, first);
+        decoder.decode(records, count);
     }
 }
 
@@ -30,6 +30,7 @@
 
 namespace Points
 {
+class PointsDecoder;
 
 /** The Points algorithms container class
  */
@@ -63,6 +64,15 @@ public:
     bool isStructured() const;
     int getWidth() const;
     int getHeight() const;
+    /** Downsample the cloud while reading it. All points falling into the same
+     * cube of edge length \a size are merged into their centroid. A size <= 0
+     * disables downsampling, which is the default.
+     */
+    void setVoxelSize(double size);
+    double getVoxelSize() const;
+    /** Decode the records of binary files with several threads. Enabled by default. */
+    void setMultithreaded(bool on);
+    bool isMultithreaded() const;
 
 protected:
     PointKernel points;
@@ -70,6 +80,8 @@ protected:
     std::vector<App::Color> colors;
     std::vector<Base::Vector3f> normals;
     int width, height;
+    double voxelSize;
+    bool multithreaded;
 };
 
 class AscReader : public Reader
@@ -91,11 +103,14 @@ private:
     std::size_t readHeader(std::istream&, std::string& format, std::size_t& offset,
         std::vector<std::string>& fields, std::vector<std::string>& types,
         std::vector<int>& sizes);
-    void readAscii(std::istream&, std::size_t offset, Eigen::MatrixXd& data);
+    void readAscii(std::istream&, std::size_t offset, std::size_t numPoints,
+        const std::vector<std::string>& types,
+        PointsDecoder& decoder);
     void readBinary(bool swapByteOrder, std::istream&, std::size_t offset,
+        std::size_t numPoints,
         const std::vector<std::string>& types,
         const std::vector<int>& sizes,
-        Eigen::MatrixXd& data);
+        PointsDecoder& decoder);
 };
 
 class PcdReader : public Reader
@@ -108,11 +123,17 @@ public:
 private:
     std::size_t readHeader(std::istream&, std::string& format, std::vector<std::string>& fields,
         std::vector<std::string>& types, std::vector<int>& sizes);
-    void readAscii(std::istream&, Eigen::MatrixXd& data);
-    void readBinary(bool transpose, std::istream&,
+    void readAscii(std::istream&, std::size_t numPoints,
+        const std::vector<std::string>& types,
+        PointsDecoder& decoder);
+    void readBinary(std::istream&, std::size_t numPoints,
+        const std::vector<std::string>& types,
+        const std::vector<int>& sizes,
+        PointsDecoder& decoder);
+    void readCompressed(std::istream&, std::size_t numPoints,
         const std::vector<std::string>& types,
         const std::vector<int>& sizes,
-        Eigen::MatrixXd& data);
+        PointsDecoder& decoder);
 };
 
 class Writer
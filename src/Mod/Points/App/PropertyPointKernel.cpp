@@ -31,6 +31,7 @@
 
 #include <Base/Exception.h>
 #include <Base/Matrix.h>
+#include <Base/Reader.h>
 #include <Base/Stream.h>
 #include <Base/Writer.h>
 
@@ -54,27 +55,32 @@ PropertyPointKernel::~PropertyPointKernel()
 void PropertyPointKernel::setValue(const PointKernel& m)
 {
     aboutToSetValue();
+    _LazyFile.reset();
     *_cPoints = m;
     hasSetValue();
 }
 
 const PointKernel& PropertyPointKernel::getValue(void) const 
 {
+    loadDocFile();
     return *_cPoints;
 }
 
 const Data::ComplexGeoData* PropertyPointKernel::getComplexData() const
 {
+    loadDocFile();
     return _cPoints;
 }
 
 Base::BoundBox3d PropertyPointKernel::getBoundingBox() const
 {
+    loadDocFile();
     return _cPoints->getBoundBox();
 }
 
 PyObject *PropertyPointKernel::getPyObject(void)
 {
+    loadDocFile();
     PointsPy* points = new PointsPy(&*_cPoints);
     points->setConst(); // set immutable
     return points;
@@ -95,6 +101,9 @@ void PropertyPointKernel::setPyObject(PyObject *value)
 
 void PropertyPointKernel::Save (Base::Writer &writer) const
 {
+    // don't write empty points if the file couldn't be read
+    if (_LazyFile)
+        _LazyFile->load();
     _cPoints->Save(writer);
 }
 
@@ -128,12 +137,36 @@ void PropertyPointKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyPointKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    _LazyFile.reset();
     _cPoints->RestoreDocFile(reader);
     hasSetValue();
 }
 
+bool PropertyPointKernel::RestoreDocFileLazily(const std::shared_ptr<Base::LazyDocFile>& file)
+{
+    // read the points without notification as they only become visible now
+    file->setRestoreFunction([this](Base::Reader& reader) {
+        this->_cPoints->RestoreDocFile(reader);
+    });
+    _LazyFile = file;
+    return true;
+}
+
+void PropertyPointKernel::loadDocFile() const
+{
+    if (_LazyFile && !_LazyFile->isLoaded()) {
+        try {
+            _LazyFile->load();
+        }
+        catch (const Base::Exception&) {
+            // already reported, keep the data empty
+        }
+    }
+}
+
 App::Property *PropertyPointKernel::Copy(void) const 
 {
+    loadDocFile();
     PropertyPointKernel* prop = new PropertyPointKernel();
     (*prop->_cPoints) = (*this->_cPoints);
     return prop;
@@ -141,8 +174,10 @@ App::Property *PropertyPointKernel::Copy(void) const
 
 void PropertyPointKernel::Paste(const App::Property &from)
 {
-    aboutToSetValue();
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
+    prop.loadDocFile();
+    aboutToSetValue();
+    _LazyFile.reset();
     *(this->_cPoints) = *(prop._cPoints);
     hasSetValue();
 }
@@ -154,6 +189,7 @@ unsigned int PropertyPointKernel::getMemSize (void) const
 
 PointKernel* PropertyPointKernel::startEditing()
 {
+    loadDocFile();
     aboutToSetValue();
     return static_cast<PointKernel*>(_cPoints);
 }
@@ -165,6 +201,8 @@ void PropertyPointKernel::finishEditing()
 
 void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndices )
 {
+    loadDocFile();
+
     // We need a sorted array
     std::vector<unsigned long> uSortedInds = uIndices;
     std::sort(uSortedInds.begin(), uSortedInds.end());
@@ -193,6 +231,7 @@ void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndi
 
 void PropertyPointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
+    loadDocFile();
     aboutToSetValue();
     _cPoints->transformGeometry(rclMat);
     hasSetValue();
@@ -75,6 +75,7 @@ public:
     void Restore(Base::XMLReader &reader);
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool RestoreDocFileLazily(const std::shared_ptr<Base::LazyDocFile>&);
     //@}
 
     /** @name Modification */
@@ -86,8 +87,13 @@ public:
     void removeIndices( const std::vector<unsigned long>& );
     //@}
 
+private:
+    /// read the points if their restore has been deferred
+    void loadDocFile() const;
+
 private:
     Base::Reference<PointKernel> _cPoints;
+    std::shared_ptr<Base::LazyDocFile> _LazyFile;
 };
 
 } // namespace Points
@@ -30,3 +30,5 @@
 # Append the open handler
 FreeCAD.addImportType("Point formats (*.asc *.pcd *.ply)","Points")
 FreeCAD.addExportType("Point formats (*.asc *.pcd *.ply)","Points")
+
+FreeCAD.__unit_test__ += [ "TestPointsApp" ]
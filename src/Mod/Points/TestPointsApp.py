@@ -0,0 +1,299 @@
+#**************************************************************************
+#   Copyright (c) 2020 The FreeCAD Developers                             *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import FreeCAD, os, unittest, tempfile, struct, math
+import Points
+
+#---------------------------------------------------------------------------
+# define the test cases to test the point cloud readers of the Points module
+#---------------------------------------------------------------------------
+
+
+def lzfLiterals(data):
+    # LZF stream made of literal runs only, which every LZF decoder accepts
+    out = bytearray()
+    for i in range(0, len(data), 32):
+        chunk = data[i:i+32]
+        out.append(len(chunk) - 1)
+        out += chunk
+    return bytes(out)
+
+
+def floatBits(packed):
+    # PCL stores packed colours as the bit pattern of a float
+    return struct.unpack("<f", struct.pack("<I", packed))[0]
+
+
+class PointsReaderCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("PointsReaderTest")
+        self.files = []
+        self.param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Points")
+        self.voxelSize = self.param.GetFloat("VoxelSize", 0.0)
+        self.param.SetFloat("VoxelSize", 0.0)
+
+    def fileName(self, name):
+        path = tempfile.gettempdir() + os.sep + name
+        self.files.append(path)
+        return path
+
+    def writePly(self, name, fmt, props, rows, count=None, extra=None):
+        # props is a list of (type, name, struct code)
+        path = self.fileName(name)
+        header = "ply\nformat %s 1.0\ncomment written by TestPointsApp\n" % fmt
+        if extra:
+            header += "element camera 1\nproperty float view_px\nproperty float view_py\n"
+        header += "element vertex %d\n" % (len(rows) if count is None else count)
+        for t, n, c in props:
+            header += "property %s %s\n" % (t, n)
+        if not extra:
+            header += "element face 0\nproperty list uchar int vertex_indices\n"
+        header += "end_header\n"
+        with open(path, "wb") as f:
+            f.write(header.encode("ascii"))
+            if fmt == "ascii":
+                if extra:
+                    f.write(b"1.5 2.5\n")
+                for r in rows:
+                    f.write((" ".join(repr(v) for v in r) + "\n").encode("ascii"))
+            else:
+                order = "<" if fmt == "binary_little_endian" else ">"
+                if extra:
+                    f.write(struct.pack(order + "ff", 1.5, 2.5))
+                code = order + "".join(c for t, n, c in props)
+                for r in rows:
+                    f.write(struct.pack(code, *r))
+        return path
+
+    def writePcd(self, name, fmt, fields, rows, width=None, height=1, count=None):
+        # fields is a list of (name, size, type, struct code)
+        path = self.fileName(name)
+        numPoints = len(rows) if count is None else count
+        if width is None:
+            width = numPoints // height
+        header = "# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\n"
+        header += "FIELDS %s\n" % " ".join(f[0] for f in fields)
+        header += "SIZE %s\n" % " ".join(str(f[1]) for f in fields)
+        header += "TYPE %s\n" % " ".join(f[2] for f in fields)
+        header += "COUNT %s\n" % " ".join("1" for f in fields)
+        header += "WIDTH %d\nHEIGHT %d\nVIEWPOINT 0 0 0 1 0 0 0\n" % (width, height)
+        header += "POINTS %d\nDATA %s\n" % (numPoints, fmt)
+        with open(path, "wb") as f:
+            f.write(header.encode("ascii"))
+            if fmt == "ascii":
+                for r in rows:
+                    f.write((" ".join("%.9g" % v for v in r) + "\n").encode("ascii"))
+            elif fmt == "binary":
+                code = "<" + "".join(fd[3] for fd in fields)
+                for r in rows:
+                    f.write(struct.pack(code, *r))
+            else:
+                # the values are stored field by field
+                data = bytearray()
+                for i, fd in enumerate(fields):
+                    for r in rows:
+                        data += struct.pack("<" + fd[3], r[i])
+                compressed = lzfLiterals(bytes(data))
+                f.write(struct.pack("<II", len(compressed), len(data)))
+                f.write(compressed)
+        return path
+
+    def read(self, path):
+        Points.insert(path, self.Doc.Name)
+        return self.Doc.Objects[-1]
+
+    def checkPoints(self, obj, expected):
+        pts = obj.Points.Points
+        self.assertEqual(len(pts), len(expected))
+        for p, e in zip(pts, expected):
+            self.assertAlmostEqual(p.x, e[0], 5)
+            self.assertAlmostEqual(p.y, e[1], 5)
+            self.assertAlmostEqual(p.z, e[2], 5)
+
+    def checkNormals(self, obj, expected):
+        self.assertEqual(len(obj.Normal), len(expected))
+        for n, e in zip(obj.Normal, expected):
+            self.assertAlmostEqual((n - FreeCAD.Vector(*e)).Length, 0.0, 5)
+
+    def checkColors(self, obj, expected):
+        self.assertEqual(len(obj.Color), len(expected))
+        for c, e in zip(obj.Color, expected):
+            for i in range(4):
+                self.assertAlmostEqual(c[i], e[i], 5)
+
+    def cloud(self, numPoints):
+        # values that are exact in single precision
+        pts = [(0.25 * (i % 97), 0.5 * (i % 31) - 4.0, -0.125 * (i % 13)) for i in range(numPoints)]
+        nor = [(1.0, 0.0, 0.0), (0.0, 1.0, 0.0), (0.0, 0.0, 1.0)]
+        nor = [nor[i % 3] for i in range(numPoints)]
+        rgba = [(i % 256, (7 * i) % 256, (13 * i) % 256, 255 - (i % 256)) for i in range(numPoints)]
+        return pts, nor, rgba
+
+    def testPlyAscii(self):
+        pts, nor, rgba = self.cloud(50)
+        props = [("float", "x", "f"), ("float", "y", "f"), ("float", "z", "f"),
+                 ("float", "nx", "f"), ("float", "ny", "f"), ("float", "nz", "f"),
+                 ("uchar", "red", "B"), ("uchar", "green", "B"), ("uchar", "blue", "B"), ("uchar", "alpha", "B")]
+        rows = [p + n + c for p, n, c in zip(pts, nor, rgba)]
+        obj = self.read(self.writePly("ascii_cloud.ply", "ascii", props, rows, extra=True))
+        self.checkPoints(obj, pts)
+        self.checkNormals(obj, nor)
+        self.checkColors(obj, [[v / 255.0 for v in c] for c in rgba])
+
+    def testPlyBinary(self):
+        # more than one block of records, decoded by several threads, with mixed number types
+        pts, nor, rgba = self.cloud(70000)
+        props = [("double", "x", "d"), ("float", "y", "f"), ("float", "z", "f"),
+                 ("float", "nx", "f"), ("float", "ny", "f"), ("float", "nz", "f"),
+                 ("short", "confidence", "h"), ("float", "intensity", "f")]
+        rows = [p + n + (-(i % 1000), 0.5 * (i % 5)) for i, (p, n) in enumerate(zip(pts, nor))]
+        for fmt in ("binary_little_endian", "binary_big_endian"):
+            obj = self.read(self.writePly(fmt + ".ply", fmt, props, rows, extra=True))
+            self.checkPoints(obj, pts)
+            self.checkNormals(obj, nor)
+            self.assertEqual(obj.Intensity, [r[-1] for r in rows])
+
+    def testPcdAscii(self):
+        pts, nor, rgba = self.cloud(40)
+        # packed colours as unsigned integer and as float, the latter without alpha like PCL writes it
+        packedU = [(a << 24) | (r << 16) | (g << 8) | b for r, g, b, a in rgba]
+        packedF = [(r << 16) | (g << 8) | b for r, g, b, a in rgba]
+        fields = [("x", 4, "F", "f"), ("y", 4, "F", "f"), ("z", 4, "F", "f"), ("rgba", 4, "U", "I")]
+        obj = self.read(self.writePcd("ascii_rgba.pcd", "ascii", fields,
+                                      [p + (c,) for p, c in zip(pts, packedU)]))
+        self.checkPoints(obj, pts)
+        self.checkColors(obj, [[v / 255.0 for v in c] for c in rgba])
+
+        fields = [("x", 4, "F", "f"), ("y", 4, "F", "f"), ("z", 4, "F", "f"), ("rgb", 4, "F", "f")]
+        obj = self.read(self.writePcd("ascii_rgb.pcd", "ascii", fields,
+                                      [p + (floatBits(c),) for p, c in zip(pts, packedF)]))
+        self.checkPoints(obj, pts)
+        self.checkColors(obj, [[r / 255.0, g / 255.0, b / 255.0, 0.0] for r, g, b, a in rgba])
+
+    def testPcdBinary(self):
+        # an organized cloud keeps its grid
+        pts, nor, rgba = self.cloud(12)
+        packed = [(a << 24) | (r << 16) | (g << 8) | b for r, g, b, a in rgba]
+        fields = [("x", 4, "F", "f"), ("y", 4, "F", "f"), ("z", 4, "F", "f"),
+                  ("normal_x", 4, "F", "f"), ("normal_y", 4, "F", "f"), ("normal_z", 4, "F", "f"),
+                  ("rgb", 4, "F", "I"), ("intensity", 2, "U", "H")]
+        rows = [p + n + (c, i) for i, (p, n, c) in enumerate(zip(pts, nor, packed))]
+        for fmt in ("binary", "binary_compressed"):
+            obj = self.read(self.writePcd(fmt + ".pcd", fmt, fields, rows, height=3))
+            self.assertEqual(obj.Width, 4)
+            self.assertEqual(obj.Height, 3)
+            self.checkPoints(obj, pts)
+            self.checkNormals(obj, nor)
+            self.checkColors(obj, [[v / 255.0 for v in c] for c in rgba])
+            self.assertEqual(obj.Intensity, list(range(12)))
+
+    def testPcdCompressedBlocks(self):
+        # the columns of more than one block of records
+        pts, nor, rgba = self.cloud(70000)
+        fields = [("x", 4, "F", "f"), ("y", 4, "F", "f"), ("z", 4, "F", "f"), ("intensity", 4, "F", "f")]
+        rows = [p + (0.25 * (i % 9),) for i, p in enumerate(pts)]
+        obj = self.read(self.writePcd("compressed_blocks.pcd", "binary_compressed", fields, rows))
+        self.checkPoints(obj, pts)
+        self.assertEqual(obj.Intensity, [r[-1] for r in rows])
+
+    def testTruncated(self):
+        # ASCII files with fewer records than announced keep the records read
+        pts, nor, rgba = self.cloud(6)
+        props = [("float", "x", "f"), ("float", "y", "f"), ("float", "z", "f"),
+                 ("float", "nx", "f"), ("float", "ny", "f"), ("float", "nz", "f")]
+        rows = [p + n for p, n in zip(pts, nor)]
+        obj = self.read(self.writePly("truncated.ply", "ascii", props, rows, count=10))
+        self.checkPoints(obj, pts)
+        self.checkNormals(obj, nor)
+
+        fields = [("x", 4, "F", "f"), ("y", 4, "F", "f"), ("z", 4, "F", "f"), ("intensity", 4, "F", "f")]
+        obj = self.read(self.writePcd("truncated.pcd", "ascii", fields,
+                                      [p + (1.0,) for p in pts], count=10))
+        self.checkPoints(obj, pts)
+        self.assertEqual(obj.Intensity, [1.0] * 6)
+
+        # binary files are rejected
+        count = len(self.Doc.Objects)
+        for fmt in ("binary_little_endian", "binary_big_endian"):
+            path = self.writePly("truncated_" + fmt + ".ply", fmt, props, rows, count=10)
+            self.assertRaises(RuntimeError, Points.insert, path, self.Doc.Name)
+        path = self.writePcd("truncated_binary.pcd", "binary", fields, [p + (1.0,) for p in pts], count=10)
+        self.assertRaises(RuntimeError, Points.insert, path, self.Doc.Name)
+        self.assertEqual(len(self.Doc.Objects), count)
+
+    def testVoxelFilter(self):
+        # the points of a cell are merged into their centroid, in the order the cells
+        # are hit first, and NaN points of an organized cloud are dropped
+        size = 2.0
+        pts, nor, rgba = self.cloud(70000)
+        nan = float("nan")
+        pts = [(nan, nan, nan) if i % 17 == 0 else p for i, p in enumerate(pts)]
+        packed = [(a << 24) | (r << 16) | (g << 8) | b for r, g, b, a in rgba]
+
+        cells = {}
+        order = []
+        for p, n, c in zip(pts, nor, rgba):
+            if math.isnan(p[0]):
+                continue
+            key = tuple(int(math.floor(v / size)) for v in p)
+            if key not in cells:
+                cells[key] = [[0.0] * 3, [0.0] * 3, [0.0] * 4, 0]
+                order.append(key)
+            cell = cells[key]
+            for i in range(3):
+                cell[0][i] += p[i]
+                cell[1][i] += n[i]
+            for i in range(4):
+                cell[2][i] += c[i] / 255.0
+            cell[3] += 1
+        expPts = []
+        expNor = []
+        expCol = []
+        for key in order:
+            s, n, c, k = cells[key]
+            expPts.append([v / k for v in s])
+            length = math.sqrt(sum(v * v for v in n))
+            expNor.append([v / length for v in n])
+            expCol.append([v / k for v in c])
+
+        fields = [("x", 4, "F", "f"), ("y", 4, "F", "f"), ("z", 4, "F", "f"),
+                  ("normal_x", 4, "F", "f"), ("normal_y", 4, "F", "f"), ("normal_z", 4, "F", "f"),
+                  ("rgba", 4, "U", "I")]
+        rows = [p + n + (c,) for p, n, c in zip(pts, nor, packed)]
+        self.param.SetFloat("VoxelSize", size)
+        for fmt in ("binary", "binary_compressed"):
+            obj = self.read(self.writePcd("voxel_" + fmt + ".pcd", fmt, fields, rows, height=700))
+            # the downsampled cloud is not organized any more
+            self.assertEqual(obj.TypeId, "Points::FeatureCustom")
+            self.checkPoints(obj, expPts)
+            self.checkNormals(obj, expNor)
+            self.checkColors(obj, expCol)
+
+    def tearDown(self):
+        if self.voxelSize == 0.0:
+            self.param.RemFloat("VoxelSize")
+        else:
+            self.param.SetFloat("VoxelSize", self.voxelSize)
+        for path in self.files:
+            if os.path.exists(path):
+                os.remove(path)
+        FreeCAD.closeDocument(self.Doc.Name)
@@ -41,6 +41,7 @@
 #include <Base/TimeInfo.h>
 #include <Base/Console.h>
 #include <Base/VectorPy.h>
+#include <App/Application.h>
 
 #include <Mod/Part/App/Geometry.h>
 #include <Mod/Part/App/GeometryCurvePy.h>
@@ -73,6 +74,11 @@ Sketch::Sketch()
   , defaultSolverRedundant(GCS::DogLeg)
   , debugMode(GCS::Minimal)
 {
+    // The size above which subsystems are solved on a sparse jacobian is also
+    // used outside of the advanced solver dialog, e.g. when recomputing
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Sketcher/SolverAdvanced");
+    GCSsys.sparseThreshold = hGrp->GetInt("SparseThreshold", GCSsys.sparseThreshold);
 }
 
 Sketch::~Sketch()
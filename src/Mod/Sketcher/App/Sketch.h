@@ -433,6 +433,7 @@ public:
     GCS::Algorithm defaultSolver;
     GCS::Algorithm defaultSolverRedundant;
     inline void setDogLegGaussStep(GCS::DogLegGaussStep mode){GCSsys.dogLegGaussStep=mode;}
+    inline void setSparseThreshold(int params){GCSsys.sparseThreshold=params;}
     inline void setDebugMode(GCS::DebugMode mode) {debugMode=mode;GCSsys.debugMode=mode;}
     inline GCS::DebugMode getDebugMode(void) {return debugMode;}
     inline void setMaxIter(int maxiter){GCSsys.maxIter=maxiter;}
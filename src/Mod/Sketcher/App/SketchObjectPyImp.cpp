@@ -1722,6 +1722,28 @@ Py::Long SketchObjectPy::getAxisCount(void) const
     return Py::Long(this->getSketchObjectPtr()->getAxisCount());
 }
 
+Py::Tuple SketchObjectPy::getConflicts(void) const
+{
+    const std::vector<int>& c = this->getSketchObjectPtr()->getLastConflicting();
+    Py::Tuple t(c.size());
+    for (std::size_t i=0; i<c.size(); i++) {
+        t.setItem(i, Py::Long(c[i]));
+    }
+
+    return t;
+}
+
+Py::Tuple SketchObjectPy::getRedundancies(void) const
+{
+    const std::vector<int>& c = this->getSketchObjectPtr()->getLastRedundant();
+    Py::Tuple t(c.size());
+    for (std::size_t i=0; i<c.size(); i++) {
+        t.setItem(i, Py::Long(c[i]));
+    }
+
+    return t;
+}
+
 PyObject *SketchObjectPy::getCustomAttributes(const char* /*attr*/) const
 {
     return 0;
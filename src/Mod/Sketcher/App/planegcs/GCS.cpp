@@ -93,6 +93,7 @@
 //#undef EIGEN_SPARSEQR_COMPATIBLE
 
 #include <Eigen/QR>
+#include <Eigen/SparseCholesky>
 
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
 #include <Eigen/Sparse>
@@ -436,6 +437,7 @@ System::System()
   , convergenceRedundant(1e-10)
   , qrAlgorithm(EigenSparseQR)
   , dogLegGaussStep(FullPivLU)
+  , sparseThreshold(200)
   , qrpivotThreshold(1E-13)
   , debugMode(Minimal)
   , LM_eps(1E-10)
@@ -1694,7 +1696,148 @@ int System::solve_BFGS(SubSystem *subsys, bool /*isFine*/, bool isRedundantsolvi
     return Failed;
 }
 
+// Linear algebra of the LM and DL iterations for a given type of jacobian
+template <typename Jacobian>
+class LinearSteps;
+
+// Dense jacobian: pivoting LU decompositions, robust on rank deficient systems
+template <>
+class LinearSteps<Eigen::MatrixXd>
+{
+public:
+    explicit LinearSteps(DogLegGaussStep gaussStep) : gaussStep(gaussStep) {}
+
+    static const char *name() { return "dense"; }
+
+    // A = J^T J
+    void setNormal(const Eigen::MatrixXd &J)
+    {
+        A = J.transpose()*J;
+        diag_A = A.diagonal();
+    }
+
+    const Eigen::VectorXd &normalDiagonal() const { return diag_A; }
+
+    // solves (A+mu*I)*h = g, returns the relative error of the solution
+    double solveDamped(double mu, const Eigen::VectorXd &g, Eigen::VectorXd &h)
+    {
+        for (int i=0; i < A.rows(); ++i)
+            A(i,i) += mu;
+
+        h = A.fullPivLu().solve(g);
+        double rel_error = (A*h - g).norm() / g.norm();
+
+        for (int i=0; i < A.rows(); ++i) // restore diagonal J^T J entries
+            A(i,i) = diag_A(i);
+        return rel_error;
+    }
+
+    // solves J*h = -f
+    void solveGauss(const Eigen::MatrixXd &Jx, const Eigen::VectorXd &fx, Eigen::VectorXd &h_gn)
+    {
+        // http://forum.freecadweb.org/viewtopic.php?f=10&t=12769&start=50#p106220
+        // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
+        switch (gaussStep){
+            case FullPivLU:
+                h_gn = Jx.fullPivLu().solve(-fx);
+                break;
+            case LeastNormFullPivLU:
+                h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
+                break;
+            case LeastNormLdlt:
+                h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
+                break;
+        }
+    }
+
+private:
+    DogLegGaussStep gaussStep;
+    Eigen::MatrixXd A;
+    Eigen::VectorXd diag_A;
+};
+
+// Sparse jacobian: sparse Cholesky factorization of the normal equations. The
+// pattern of the jacobian is fixed for a subsystem, so the symbolic analysis of
+// the factorization is only done once per solve.
+template <>
+class LinearSteps<SparseJacobian>
+{
+public:
+    typedef Eigen::SparseMatrix<double> SparseMatrix;
+
+    explicit LinearSteps(DogLegGaussStep) : analyzed(false) {}
+
+    static const char *name() { return "sparse"; }
+
+    void setNormal(const SparseJacobian &J)
+    {
+        A = J.transpose()*J;
+        diag_A = A.diagonal();
+    }
+
+    const Eigen::VectorXd &normalDiagonal() const { return diag_A; }
+
+    double solveDamped(double mu, const Eigen::VectorXd &g, Eigen::VectorXd &h)
+    {
+        if (!factorize(A, mu))
+            return std::numeric_limits<double>::infinity();
+        h = ldlt.solve(g);
+        return (A*h + mu*h - g).norm() / g.norm();
+    }
+
+    // least norm step h = J^T*(J*J^T)^-1*(-f). J*J^T is singular on redundant
+    // constraints, the small regularization keeps the factorization defined and
+    // its effect on the range of J^T vanishes with it.
+    void solveGauss(const SparseJacobian &Jx, const Eigen::VectorXd &fx, Eigen::VectorXd &h_gn)
+    {
+        A = Jx*Jx.transpose();
+        double scale = A.rows() > 0 ? Eigen::VectorXd(A.diagonal()).maxCoeff() : 0.;
+        if (!factorize(A, 1e-12*std::max(scale, 1.))) {
+            h_gn.setZero(Jx.cols());
+            return;
+        }
+        h_gn = Jx.transpose()*ldlt.solve(-fx);
+    }
+
+private:
+    bool factorize(const SparseMatrix &M, double shift)
+    {
+        if (I.rows() != M.rows()) {
+            I.resize(M.rows(), M.cols());
+            I.setIdentity();
+        }
+        M_shifted = M + shift*I;
+        if (!analyzed) {
+            ldlt.analyzePattern(M_shifted);
+            analyzed = true;
+        }
+        ldlt.factorize(M_shifted);
+        return ldlt.info() == Eigen::Success;
+    }
+
+    SparseMatrix A, I, M_shifted;
+    Eigen::VectorXd diag_A;
+    Eigen::SimplicialLDLT<SparseMatrix> ldlt;
+    bool analyzed;
+};
+
+bool System::isSparseSubsystem(SubSystem *subsys) const
+{
+    return sparseThreshold > 0 && subsys->pSize() >= sparseThreshold;
+}
+
 int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
+{
+    if (isSparseSubsystem(subsys)) {
+        SparseJacobian J;
+        return solve_LM(subsys, J, isRedundantsolving);
+    }
+    Eigen::MatrixXd J;
+    return solve_LM(subsys, J, isRedundantsolving);
+}
+
+template <typename Jacobian>
+int System::solve_LM(SubSystem* subsys, Jacobian &J, bool isRedundantsolving)
 {
 #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
     extractSubsystem(subsys, isRedundantsolving);
@@ -1707,8 +1850,7 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         return Success;
 
     Eigen::VectorXd e(csize), e_new(csize); // vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);        // Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
+    LinearSteps<Jacobian> steps(dogLegGaussStep);
     Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
 
     subsys->redirectParams();
@@ -1734,6 +1876,7 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
                 << ", tau: "            << tau
                 << ", convergence: "    << (isRedundantsolving?convergenceRedundant:convergence)
                 << ", xsize: "          << xsize
+                << ", jacobian: "       << LinearSteps<Jacobian>::name()
                 << ", maxIter: "        << maxIterNumber  << "\n";
 
         const std::string tmp = stream.str();
@@ -1756,14 +1899,14 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         }
 
         // J^T J, J^T e
-        subsys->calcJacobi(J);;
+        subsys->calcJacobi(J);
 
-        A = J.transpose()*J;
+        steps.setNormal(J);
         g = J.transpose()*e;
 
         // Compute ||J^T e||_inf
         double g_inf = g.lpNorm<Eigen::Infinity>();
-        diag_A = A.diagonal(); // save diagonal entries so that augmentation can be later canceled
+        diag_A = steps.normalDiagonal();
 
         // check for convergence
         if (g_inf <= eps1) {
@@ -1779,13 +1922,8 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         // determine increment using adaptive damping
         int k=0;
         while (k < 50) {
-            // augment normal equations A = A+uI
-            for (int i=0; i < xsize; ++i)
-                A(i,i) += mu;
-
-            //solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
-            double rel_error = (A*h - g).norm() / g.norm();
+            //solve augmented functions (A+uI)*h=-g
+            double rel_error = steps.solveDamped(mu, g, h);
 
             // check if solving works
             if (rel_error < 1e-5) {
@@ -1832,8 +1970,6 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
             mu*=nu;
             nu*=2.0;
-            for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
-                A(i,i) = diag_A(i);
 
             k++;
         }
@@ -1865,6 +2001,17 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
 
 int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
+{
+    if (isSparseSubsystem(subsys)) {
+        SparseJacobian Jx, Jx_new;
+        return solve_DL(subsys, Jx, Jx_new, isRedundantsolving);
+    }
+    Eigen::MatrixXd Jx, Jx_new;
+    return solve_DL(subsys, Jx, Jx_new, isRedundantsolving);
+}
+
+template <typename Jacobian>
+int System::solve_DL(SubSystem* subsys, Jacobian &Jx, Jacobian &Jx_new, bool isRedundantsolving)
 {
 #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
     extractSubsystem(subsys, isRedundantsolving);
@@ -1891,6 +2038,7 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
                 << ", tolf: "           << tolf
                 << ", convergence: "    << (isRedundantsolving?convergenceRedundant:convergence)
                 << ", dogLegGaussStep: " << (dogLegGaussStep==FullPivLU?"FullPivLU":(dogLegGaussStep==LeastNormFullPivLU?"LeastNormFullPivLU":"LeastNormLdlt"))
+                << ", jacobian: "       << LinearSteps<Jacobian>::name()
                 << ", xsize: "          << xsize
                 << ", csize: "          << csize
                 << ", maxIter: "        << maxIterNumber  << "\n";
@@ -1901,8 +2049,8 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
 
     Eigen::VectorXd x(xsize), x_new(xsize);
     Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
     Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
+    LinearSteps<Jacobian> steps(dogLegGaussStep);
 
     subsys->redirectParams();
 
@@ -1943,19 +2091,7 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
             h_sd  = alpha*g;
 
             // get the gauss-newton step
-            // http://forum.freecadweb.org/viewtopic.php?f=10&t=12769&start=50#p106220
-            // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
-            switch (dogLegGaussStep){
-                case FullPivLU:
-                    h_gn = Jx.fullPivLu().solve(-fx);
-                    break;
-                case LeastNormFullPivLU:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
-                    break;
-                case LeastNormLdlt:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
-                    break;
-            }
+            steps.solveGauss(Jx, fx, h_gn);
 
             double rel_error = (Jx*h_gn + fx).norm() / fx.norm();
             if (rel_error > 1e15)
@@ -2014,7 +2150,7 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
 
         if (dF > 0 && dL > 0) {
             x  = x_new;
-            Jx = Jx_new;
+            Jx.swap(Jx_new);
             fx = fx_new;
             err = err_new;
 
@@ -3785,132 +3921,60 @@ void System::undoSolution()
     resetToReference();
 }
 
-void System::makeReducedJacobian(Eigen::MatrixXd &J,
+void System::makeReducedJacobian(Eigen::SparseMatrix<double> &J,
                                  std::map<int,int> &jacobianconstraintmap,
-                                 GCS::VEC_pD &pdiagnoselist,
-                                 std::map< int , int> &tagmultiplicity)
+                                 const std::vector<Constraint *> &constrs,
+                                 const GCS::VEC_pD &pdiagnoselist)
 {
-    // construct specific parameter list for diagonose ignoring driven constraint parameters
-    for (int j=0; j < int(plist.size()); j++) {
-        auto result1 = std::find(std::begin(pdrivenlist), std::end(pdrivenlist), plist[j]);
-
-        if (result1 == std::end(pdrivenlist)) {
-            pdiagnoselist.push_back(plist[j]);
-        }
-    }
-
-
-    J = Eigen::MatrixXd::Zero(clist.size(), pdiagnoselist.size());
+    MAP_pD_I pcols;
+    for (int j=0; j < int(pdiagnoselist.size()); j++)
+        pcols[pdiagnoselist[j]] = j;
 
+    // The reduced Jacobian only contains the driving constraints. A constraint only
+    // depends on its own parameters, so only those gradients have to be evaluated.
+    std::vector< Eigen::Triplet<double> > entries;
     int jacobianconstraintcount=0;
-    int allcount=0;
-    for (std::vector<Constraint *>::iterator constr=clist.begin(); constr != clist.end(); ++constr) {
-        (*constr)->revertParams();
-        ++allcount;
-        if ((*constr)->getTag() >= 0 && (*constr)->isDriving()) {
-            jacobianconstraintcount++;
-            for (int j=0; j < int(pdiagnoselist.size()); j++) {
-                J(jacobianconstraintcount-1,j) = (*constr)->grad(pdiagnoselist[j]);
+    for (int i=0; i < int(constrs.size()); i++) {
+        Constraint *constr = constrs[i];
+        constr->revertParams();
+        if (constr->getTag() >= 0 && constr->isDriving()) {
+            SET_I cols;
+            VEC_pD &cparams = c2p[constr];
+            for (VEC_pD::const_iterator param=cparams.begin(); param != cparams.end(); ++param) {
+                MAP_pD_I::const_iterator it = pcols.find(*param);
+                if (it != pcols.end())
+                    cols.insert(it->second);
             }
+            for (SET_I::const_iterator col=cols.begin(); col != cols.end(); ++col)
+                entries.push_back(Eigen::Triplet<double>(jacobianconstraintcount, *col,
+                                                         constr->grad(pdiagnoselist[*col])));
 
-            // parallel processing: create tag multiplicity map
-            if(tagmultiplicity.find((*constr)->getTag()) == tagmultiplicity.end())
-                tagmultiplicity[(*constr)->getTag()] = 0;
-            else
-                tagmultiplicity[(*constr)->getTag()]++;
-
-            jacobianconstraintmap[jacobianconstraintcount-1] = allcount-1;
+            jacobianconstraintmap[jacobianconstraintcount] = i;
+            jacobianconstraintcount++;
         }
     }
+
+    J.resize(jacobianconstraintcount, pdiagnoselist.size());
+    J.setFromTriplets(entries.begin(), entries.end());
+    J.prune(0.);
+    J.makeCompressed();
 }
 
-int System::diagnose(Algorithm alg)
+void System::diagnoseComponent(const Eigen::SparseMatrix<double> &SJ,
+                               const std::map<int,int> &jacobianconstraintmap,
+                               const std::vector<Constraint *> &constrs,
+                               GCS::VEC_pD &pdiagnoselist,
+                               const std::map< int , int> &tagmultiplicity,
+                               Algorithm alg,
+                               DiagnosisResult &result)
 {
-    // Analyses the constrainess grad of the system and provides feedback
-    // The vector "conflictingTags" will hold a group of conflicting constraints
-
-    // Hint 1: Only constraints with tag >= 0 are taken into account
-    // Hint 2: Constraints tagged with 0 are treated as high priority
-    //         constraints and they are excluded from the returned
-    //         list of conflicting constraints. Therefore, this function
-    //         will provide no feedback about possible conflicts between
-    //         two high priority constraints. For this reason, tagging
-    //         constraints with 0 should be used carefully.
-    hasDiagnosis = false;
-    if (!hasUnknowns) {
-        dofs = -1;
-        return dofs;
-    }
-
-#ifdef _DEBUG_TO_FILE
-SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
-#endif
-
-    // Input parameters' lists:
-    // plist            =>  list of all the parameters of the system, e.g. each coordinate of a point
-    // pdrivenlist      =>  list of the parameters that are driven by other parameters (e.g. value of driven constraints)
-
-    // When adding an external geometry or a constraint on an external geometry the array 'plist' is empty.
-    // So, we must abort here because otherwise we would create an invalid matrix and make the application
-    // eventually crash. This fixes issues #0002372/#0002373.
-    if (plist.empty() || (plist.size() - pdrivenlist.size()) == 0) {
-        hasDiagnosis = true;
-        dofs = 0;
-        return dofs;
-    }
-
-    redundant.clear();
-    conflictingTags.clear();
-    redundantTags.clear();
-
-    // This QR diagnosis uses a reduced Jacobian matrix to calculate the rank of the system and identify
-    // conflicting and redundant constraints.
-    //
-    // reduced Jacobian matrix
-    // The Jacobian has been reduced to:
-    // 1. only contain driving constraints, but keep a full size (zero padded).
-    // 2. remove the parameters of the values of driven constraints.
-    Eigen::MatrixXd J;
-
-    // maps the index of the rows of the reduced jacobian matrix (solver constraints) to
-    // the index those constraints would have in a full size Jacobian matrix
-    std::map<int,int> jacobianconstraintmap;
-
-    // list of parameters to be diagnosed in this routine (removes value parameters from driven constraints)
-    GCS::VEC_pD pdiagnoselist;
-
-    // tag multiplicity gives the number of solver constraints associated with the same tag
-    // A tag generally corresponds to the Sketcher constraint index - There are special tag values, like 0 and -1.
-    std::map< int , int> tagmultiplicity;
-
-
-    makeReducedJacobian(J, jacobianconstraintmap, pdiagnoselist, tagmultiplicity);
-
     // QR decomposition method selection: SparseQR vs DenseQR
-
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
-    Eigen::SparseMatrix<double> SJ;
-
-    if(qrAlgorithm==EigenSparseQR){
-        // this creation is not optimized (done using triplets)
-        // however the time this takes is negligible compared to the
-        // time the QR decomposition itself takes
-        SJ = J.sparseView();
-        SJ.makeCompressed();
-    }
-
     Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SqrJT;
-#else
-    if(qrAlgorithm==EigenSparseQR){
-        Base::Console().Warning("SparseQR not supported by you current version of Eigen. It requires Eigen 3.2.2 or higher. Falling back to Dense QR\n");
-        qrAlgorithm=EigenDenseQR;
-    }
 #endif
 
-
-
 #ifdef _GCS_DEBUG
-    SolverReportingManager::Manager().LogMatrix("J",J);
+    SolverReportingManager::Manager().LogMatrix("J",Eigen::MatrixXd(SJ));
 #endif
 
     Eigen::MatrixXd R;
@@ -3920,19 +3984,25 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     Eigen::MatrixXd R2; // Intended for a trapezoidal matrix, where R is the top triangular matrix of the R2 trapezoidal matrix
 #endif
 
-
-    int paramsNum = 0;
-    int constrNum = 0;
+    int paramsNum = SJ.cols();
+    int constrNum = SJ.rows();
     int rank = 0;
     Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qrJT;
 
-    if(qrAlgorithm==EigenDenseQR){
-        if (J.rows() > 0) {
-            qrJT.compute(J.topRows(jacobianconstraintmap.size()).transpose());
+    // Coupling of the dependent constraints (cols rank..constrNum-1 of R) with the pivot
+    // constraints, i.e. R12 after eliminating the non zeros above the diagonal of R11
+    Eigen::SparseMatrix<double> coupling;
+
+    // the first rank columns of the (permuted) transposed jacobian are the pivot constraints
+    VEC_I colsPermutation(constrNum);
+    for (int j=0; j < constrNum; j++)
+        colsPermutation[j] = j;
+
+    if (constrNum > 0 && paramsNum > 0) {
+        if(qrAlgorithm==EigenDenseQR){
+            qrJT.compute(Eigen::MatrixXd(SJ).transpose());
             //Eigen::MatrixXd Q = qrJT.matrixQ ();
 
-            paramsNum = qrJT.rows();
-            constrNum = qrJT.cols();
             qrJT.setThreshold(qrpivotThreshold);
             rank = qrJT.rank();
 
@@ -3946,367 +4016,508 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
             R2 = qrJT.matrixQR();
             Q = qrJT.matrixQ();
 #endif
-        }
-    }
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-    else if(qrAlgorithm==EigenSparseQR){
-        if (SJ.rows() > 0) {
-            auto SJT = SJ.topRows(jacobianconstraintmap.size()).transpose();
-            if (SJT.rows() > 0 && SJT.cols() > 0) {
-                SqrJT.compute(SJT);
-                // Do not ask for Q Matrix!!
-                // At Eigen 3.2 still has a bug that this only works for square matrices
-                // if enabled it will crash
-                #ifdef SPARSE_Q_MATRIX
-                Q = SqrJT.matrixQ();
-                //Q = QS;
-                #endif
-
-                paramsNum = SqrJT.rows();
-                constrNum = SqrJT.cols();
-                SqrJT.setPivotThreshold(qrpivotThreshold);
-                rank = SqrJT.rank();
-
-                if (constrNum >= paramsNum)
-                    R = SqrJT.matrixR().triangularView<Eigen::Upper>();
-                else
-                    R = SqrJT.matrixR().topRows(constrNum)
-                    .triangularView<Eigen::Upper>();
 
-                #ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-                R2 = SqrJT.matrixR();
-                #endif
+            if (constrNum > rank) {
+                for (int i=1; i < rank; i++) {
+                    // eliminate non zeros above pivot
+                    assert(R(i,i) != 0);
+                    for (int row=0; row < i; row++) {
+                        if (R(row,i) != 0) {
+                            double coef=R(row,i)/R(i,i);
+                            R.block(row,i+1,1,constrNum-i-1) -= coef * R.block(i,i+1,1,constrNum-i-1);
+                            R(row,i) = 0;
+                        }
+                    }
+                }
+                coupling = R.block(0,rank,rank,constrNum-rank).sparseView();
             }
-            else {
-                paramsNum = SJT.rows();
-                constrNum = SJT.cols();
+            for (int j=0; j < constrNum; j++)
+                colsPermutation[j]=qrJT.colsPermutation().indices()[j];
+        }
+#ifdef EIGEN_SPARSEQR_COMPATIBLE
+        else if(qrAlgorithm==EigenSparseQR){
+            Eigen::SparseMatrix<double> SJT = SJ.transpose();
+            SqrJT.compute(SJT);
+            // Do not ask for Q Matrix!!
+            // At Eigen 3.2 still has a bug that this only works for square matrices
+            // if enabled it will crash
+            #ifdef SPARSE_Q_MATRIX
+            Q = SqrJT.matrixQ();
+            //Q = QS;
+            #endif
+
+            SqrJT.setPivotThreshold(qrpivotThreshold);
+            rank = SqrJT.rank();
+
+            #ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
+            R = SqrJT.matrixR().topRows(std::min(constrNum, paramsNum)).triangularView<Eigen::Upper>();
+            R2 = SqrJT.matrixR();
+            #endif
+
+            if (constrNum > rank) {
+                // D.R11^-1.R12 is what the elimination of the dense case leaves in R12,
+                // the triangular solve keeps it sparse instead of densifying R
+                const Eigen::SparseMatrix<double> &SR = SqrJT.matrixR();
+                Eigen::SparseMatrix<double> R11 = SR.topLeftCorner(rank, rank);
+                Eigen::VectorXd D = R11.diagonal();
+                coupling = SR.block(0, rank, rank, constrNum-rank);
+                R11.triangularView<Eigen::Upper>().solveInPlace(coupling);
+                coupling = D.asDiagonal() * coupling;
             }
+            for (int j=0; j < constrNum; j++)
+                colsPermutation[j]=SqrJT.colsPermutation().indices()[j];
         }
-    }
 #endif
+    }
+    if (coupling.cols() != constrNum-rank) // constraints without parameters are not coupled
+        coupling.resize(rank, constrNum-rank);
 
     if(debugMode==IterationLevel) {
         SolverReportingManager::Manager().LogQRSystemInformation(*this, paramsNum, constrNum, rank);
     }
 
-    if (J.rows() > 0) {
 #ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-        SolverReportingManager::Manager().LogMatrix("R", R);
+    SolverReportingManager::Manager().LogMatrix("R", R);
 
-        SolverReportingManager::Manager().LogMatrix("R2", R2);
+    SolverReportingManager::Manager().LogMatrix("R2", R2);
 
-        if(qrAlgorithm == EigenDenseQR){ // There is no rowsTranspositions in SparseQR. obtaining Q is buggy in Eigen for SparseQR
-            SolverReportingManager::Manager().LogMatrix("Q", Q);
-            SolverReportingManager::Manager().LogMatrix("RowTransp", qrJT.rowsTranspositions());
-        }
+    if(qrAlgorithm == EigenDenseQR){ // There is no rowsTranspositions in SparseQR. obtaining Q is buggy in Eigen for SparseQR
+        SolverReportingManager::Manager().LogMatrix("Q", Q);
+        SolverReportingManager::Manager().LogMatrix("RowTransp", qrJT.rowsTranspositions());
+    }
 #ifdef SPARSE_Q_MATRIX
-        else if(qrAlgorithm == EigenSparseQR) {
-            SolverReportingManager::Manager().LogMatrix("Q", Q);
-        }
+    else if(qrAlgorithm == EigenSparseQR) {
+        SolverReportingManager::Manager().LogMatrix("Q", Q);
+    }
 #endif
 #endif
 
-        // DETECTING CONSTRAINT SOLVER PARAMETERS
-        //
-        // NOTE: This is only true for dense QR with full pivoting, because solve parameters get reordered.
-        // I am unable to adapt it to Sparse QR. (abdullah). See:
-        //
-        // https://stackoverflow.com/questions/49009771/getting-rows-transpositions-with-sparse-qr
-        // https://forum.kde.org/viewtopic.php?f=74&t=151239
-        //
-        // R (original version, not R here which is trimmed to not have empty rows)
-        // has paramsNum rows, the first "rank" rows correspond to parameters that are constraint
+    // DETECTING CONSTRAINT SOLVER PARAMETERS
+    //
+    // NOTE: This is only true for dense QR with full pivoting, because solve parameters get reordered.
+    // I am unable to adapt it to Sparse QR. (abdullah). See:
+    //
+    // https://stackoverflow.com/questions/49009771/getting-rows-transpositions-with-sparse-qr
+    // https://forum.kde.org/viewtopic.php?f=74&t=151239
+    //
+    // R (original version, not R here which is trimmed to not have empty rows)
+    // has paramsNum rows, the first "rank" rows correspond to parameters that are constraint
 
-        // Calculate the Permutation matrix from the Transposition matrix
-        Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic> rowPermutations;
+    // Calculate the Permutation matrix from the Transposition matrix
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic> rowPermutations;
 
-        rowPermutations.setIdentity(paramsNum);
+    rowPermutations.setIdentity(paramsNum);
 
-        if(qrAlgorithm==EigenDenseQR){ // P.J.P' = Q.R see https://eigen.tuxfamily.org/dox/classEigen_1_1FullPivHouseholderQR.html
-            const MatrixIndexType rowTranspositions = qrJT.rowsTranspositions();
+    if(qrAlgorithm==EigenDenseQR && constrNum > 0 && paramsNum > 0){ // P.J.P' = Q.R see https://eigen.tuxfamily.org/dox/classEigen_1_1FullPivHouseholderQR.html
+        const MatrixIndexType rowTranspositions = qrJT.rowsTranspositions();
 
-            for(int k = 0; k < rank; ++k)
-                rowPermutations.applyTranspositionOnTheRight(k, rowTranspositions.coeff(k));
-        }
+        for(int k = 0; k < rank; ++k)
+            rowPermutations.applyTranspositionOnTheRight(k, rowTranspositions.coeff(k));
+    }
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
-        else if(qrAlgorithm==EigenSparseQR){
-            // J.P = Q.R, see https://eigen.tuxfamily.org/dox/classEigen_1_1SparseQR.html
-            // There is no rowsTransposition in this QR decomposition.
-            // TODO: This detection method won't work for SparseQR
-        }
-
-#endif
-
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-        std::stringstream stream;
+    else if(qrAlgorithm==EigenSparseQR){
+        // J.P = Q.R, see https://eigen.tuxfamily.org/dox/classEigen_1_1SparseQR.html
+        // There is no rowsTransposition in this QR decomposition.
+        // TODO: This detection method won't work for SparseQR
+    }
 #endif
 
-// params (in the order of J) shown as independent from QR
-        std::set<int> indepParamCols;
-        std::set<int> depParamCols;
-
-        for (int j=0; j < rank; j++) {
+    // params (in the order of J) shown as independent from QR
+    std::set<int> indepParamCols;
+    for (int j=0; j < rank; j++) {
+        // NOTE: Q*R = transpose(J), so the row of R corresponds to the col of J (the rows of transpose(J)).
+        // The cols of J are the parameters, the rows are the constraints.
+        indepParamCols.insert(rowPermutations.indices()[j]);
+    }
 
-             int origRow = rowPermutations.indices()[j];
+    // If not independent, must be dependent
+    result.dependent.clear();
+    for(int j=0; j < paramsNum; j++) {
+        if(indepParamCols.count(j) == 0)
+            result.dependent.push_back(j);
+    }
 
-             indepParamCols.insert(origRow);
+    result.conflictGroups.clear();
+    result.redundant.clear();
 
-             // NOTE: Q*R = transpose(J), so the row of R corresponds to the col of J (the rows of transpose(J)).
-             // The cols of J are the parameters, the rows are the constraints.
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-             stream << "R row " << j << " = J col " << origRow << std::endl;
-#endif
+    // Detecting conflicting or redundant constraints
+    if (constrNum > rank) { // conflicting or redundant constraints
+        std::vector< std::vector<Constraint *> > conflictGroups(constrNum-rank);
+        for (int j=rank; j < constrNum; j++) {
+            for (Eigen::SparseMatrix<double>::InnerIterator it(coupling, j-rank); it; ++it) {
+                if (fabs(it.value()) > 1e-10)
+                    conflictGroups[j-rank].push_back(constrs[jacobianconstraintmap.at(colsPermutation[it.row()])]);
+            }
+            conflictGroups[j-rank].push_back(constrs[jacobianconstraintmap.at(colsPermutation[j])]);
         }
 
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-        std::string tmp = stream.str();
-
-        SolverReportingManager::Manager().LogString(tmp);
-#endif
-
-        // If not independent, must be dependent
-        for(int j=0; j < paramsNum; j++) {
-            auto result = indepParamCols.find(j);
-            if(result == indepParamCols.end()) {
-                depParamCols.insert(j);
-            }
+        // Augment the information regarding the group of constraints that are conflicting or redundant.
+        if(debugMode==IterationLevel) {
+            SolverReportingManager::Manager().LogGroupOfConstraints("Analysing groups of constraints of special interest", conflictGroups);
         }
 
-        // Last (NumParams-rank) rows of Q construct the dependent part of J
-        // in conjunction with the R matrix
-        // Last (NumParams-rank) cols of Q never contribute as R is zero after the rank
-        /*std::set<int> associatedParamCols;
-        for(int i = rank; i < paramsNum; i++) {
-            for(int j = 0; j < rank; j++) {
-                if(fabs(Q(i,j))>1e-10) {
-                    for(int k = j; k < constrNum; k++) {
-                        if(fabs(R(j,k))>1e-10) {
-                            associatedParamCols.insert(k);
-                        }
+        // try to remove the conflicting constraints and solve the
+        // system in order to check if the removed constraints were
+        // just redundant but not really conflicting
+        std::set<Constraint *> skipped;
+        SET_I satisfiedGroups;
+        while (1) {
+            std::map< Constraint *, SET_I > conflictingMap;
+            for (std::size_t i=0; i < conflictGroups.size(); i++) {
+                if (satisfiedGroups.count(i) == 0) {
+                    for (std::size_t j=0; j < conflictGroups[i].size(); j++) {
+                        Constraint *constr = conflictGroups[i][j];
+                        if (constr->getTag() != 0) // exclude constraints tagged with zero
+                            conflictingMap[constr].insert(i);
                     }
                 }
             }
-        }
-
-        for( auto param : associatedParamCols) {
-            auto pos = indepParamCols.find(rowPermutations.indices()[param]);
+            if (conflictingMap.empty())
+                break;
 
-            if(pos!=indepParamCols.end()) {
-                indepParamCols.erase(pos);
+            int maxPopularity = 0;
+            Constraint *mostPopular = NULL;
+            for (std::map< Constraint *, SET_I >::const_iterator it=conflictingMap.begin();
+                 it != conflictingMap.end(); ++it) {
+                if (static_cast<int>(it->second.size()) > maxPopularity ||
+                    (static_cast<int>(it->second.size()) == maxPopularity && mostPopular &&
+                    tagmultiplicity.at(it->first->getTag()) < tagmultiplicity.at(mostPopular->getTag())) ||
+
+                    (static_cast<int>(it->second.size()) == maxPopularity && mostPopular &&
+                    tagmultiplicity.at(it->first->getTag()) == tagmultiplicity.at(mostPopular->getTag()) &&
+                     it->first->getTag() > mostPopular->getTag())
+
+                ) {
+                    mostPopular = it->first;
+                    maxPopularity = it->second.size();
+                }
             }
-        }*/
-#ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
-        stream.flush();
-
-        stream << "Indep params: [";
-        for(auto indep :indepParamCols)
-            stream << indep;
-        stream << "]" << std::endl;
-
-        stream << "Dep params: [";
-        for(auto dep :depParamCols)
-            stream << dep;
-        stream << "]" << std::endl;
+            if (maxPopularity > 0) {
+                skipped.insert(mostPopular);
+                for (SET_I::const_iterator it=conflictingMap[mostPopular].begin();
+                     it != conflictingMap[mostPopular].end(); ++it)
+                    satisfiedGroups.insert(*it);
+            }
+        }
 
-        tmp = stream.str();
-        SolverReportingManager::Manager().LogString(tmp);
-#endif
-        for( auto param : depParamCols) {
-            pdependentparameters.push_back(pdiagnoselist[param]);
+        std::vector<Constraint *> clistTmp;
+        clistTmp.reserve(constrs.size());
+        for (std::vector<Constraint *>::const_iterator constr=constrs.begin();
+            constr != constrs.end(); ++constr) {
+            if (skipped.count(*constr) == 0)
+                clistTmp.push_back(*constr);
         }
 
-        // Detecting conflicting or redundant constraints
-        if (constrNum > rank) { // conflicting or redundant constraints
-            for (int i=1; i < rank; i++) {
-                // eliminate non zeros above pivot
-                assert(R(i,i) != 0);
-                for (int row=0; row < i; row++) {
-                    if (R(row,i) != 0) {
-                        double coef=R(row,i)/R(i,i);
-                        R.block(row,i+1,1,constrNum-i-1) -= coef * R.block(i,i+1,1,constrNum-i-1);
-                        R(row,i) = 0;
-                    }
-                }
+        SubSystem *subSysTmp = new SubSystem(clistTmp, pdiagnoselist);
+        int res = solve(subSysTmp,true,alg,true);
+
+        if(debugMode==Minimal || debugMode==IterationLevel) {
+            std::string solvername;
+            switch (alg) {
+                case 0:
+                    solvername = "BFGS";
+                    break;
+                case 1: // solving with the LevenbergMarquardt solver
+                    solvername = "LevenbergMarquardt";
+                    break;
+                case 2: // solving with the BFGS solver
+                    solvername = "DogLeg";
+                    break;
             }
-            std::vector< std::vector<Constraint *> > conflictGroups(constrNum-rank);
-            for (int j=rank; j < constrNum; j++) {
-                for (int row=0; row < rank; row++) {
-                    if (fabs(R(row,j)) > 1e-10) {
-                        int origCol = 0;
-
-                        if(qrAlgorithm==EigenDenseQR)
-                            origCol=qrJT.colsPermutation().indices()[row];
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-                        else if(qrAlgorithm==EigenSparseQR)
-                            origCol=SqrJT.colsPermutation().indices()[row];
-#endif
-                        //conflictGroups[j-rank].push_back(clist[origCol]);
-                        conflictGroups[j-rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
-                    }
-                }
-                int origCol = 0;
 
-                if(qrAlgorithm==EigenDenseQR)
-                    origCol=qrJT.colsPermutation().indices()[j];
+            Base::Console().Log("Sketcher::RedundantSolving-%s-\n",solvername.c_str());
+        }
 
-#ifdef EIGEN_SPARSEQR_COMPATIBLE
-                else if(qrAlgorithm==EigenSparseQR)
-                    origCol=SqrJT.colsPermutation().indices()[j];
-#endif
-                //conflictGroups[j-rank].push_back(clist[origCol]);
-                conflictGroups[j-rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
+        std::set<Constraint *> redundantSet;
+        if (res == Success) {
+            subSysTmp->applySolution();
+            for (std::set<Constraint *>::const_iterator constr=skipped.begin();
+                 constr != skipped.end(); ++constr) {
+                double err = (*constr)->error();
+                if (err * err < convergenceRedundant)
+                    redundantSet.insert(*constr);
             }
+            resetToReference();
 
-            // Augment the information regarding the group of constraints that are conflicting or redundant.
-            if(debugMode==IterationLevel) {
-                SolverReportingManager::Manager().LogGroupOfConstraints("Analysing groups of constraints of special interest", conflictGroups);
+            if(debugMode==Minimal || debugMode==IterationLevel) {
+                Base::Console().Log("Sketcher Redundant solving: %d redundants\n",redundantSet.size());
             }
 
-            // try to remove the conflicting constraints and solve the
-            // system in order to check if the removed constraints were
-            // just redundant but not really conflicting
-            std::set<Constraint *> skipped;
-            SET_I satisfiedGroups;
-            while (1) {
-                std::map< Constraint *, SET_I > conflictingMap;
-                for (std::size_t i=0; i < conflictGroups.size(); i++) {
-                    if (satisfiedGroups.count(i) == 0) {
-                        for (std::size_t j=0; j < conflictGroups[i].size(); j++) {
-                            Constraint *constr = conflictGroups[i][j];
-                            if (constr->getTag() != 0) // exclude constraints tagged with zero
-                                conflictingMap[constr].insert(i);
-                        }
-                    }
-                }
-                if (conflictingMap.empty())
-                    break;
-
-                int maxPopularity = 0;
-                Constraint *mostPopular = NULL;
-                for (std::map< Constraint *, SET_I >::const_iterator it=conflictingMap.begin();
-                     it != conflictingMap.end(); ++it) {
-                    if (static_cast<int>(it->second.size()) > maxPopularity ||
-                        (static_cast<int>(it->second.size()) == maxPopularity && mostPopular &&
-                        tagmultiplicity.at(it->first->getTag()) < tagmultiplicity.at(mostPopular->getTag())) ||
-
-                        (static_cast<int>(it->second.size()) == maxPopularity && mostPopular &&
-                        tagmultiplicity.at(it->first->getTag()) == tagmultiplicity.at(mostPopular->getTag()) &&
-                         it->first->getTag() > mostPopular->getTag())
-
-                    ) {
-                        mostPopular = it->first;
-                        maxPopularity = it->second.size();
+            std::vector< std::vector<Constraint *> > conflictGroupsOrig=conflictGroups;
+            conflictGroups.clear();
+            for (int i=conflictGroupsOrig.size()-1; i >= 0; i--) {
+                bool isRedundant = false;
+                for (std::size_t j=0; j < conflictGroupsOrig[i].size(); j++) {
+                    if (redundantSet.count(conflictGroupsOrig[i][j]) > 0) {
+                        isRedundant = true;
+                        break;
                     }
                 }
-                if (maxPopularity > 0) {
-                    skipped.insert(mostPopular);
-                    for (SET_I::const_iterator it=conflictingMap[mostPopular].begin();
-                         it != conflictingMap[mostPopular].end(); ++it)
-                        satisfiedGroups.insert(*it);
-                }
+                if (!isRedundant)
+                    conflictGroups.push_back(conflictGroupsOrig[i]);
+                else
+                    constrNum--;
             }
+        }
+        delete subSysTmp;
+
+        // results are kept as positions in constrs, so that they outlive the constraints
+        std::map<Constraint *, int> constrIndex;
+        for (int i=0; i < int(constrs.size()); i++)
+            constrIndex[constrs[i]] = i;
+        for (std::size_t i=0; i < conflictGroups.size(); i++) {
+            VEC_I group;
+            for (std::size_t j=0; j < conflictGroups[i].size(); j++)
+                group.push_back(constrIndex[conflictGroups[i][j]]);
+            result.conflictGroups.push_back(group);
+        }
+        for (std::set<Constraint *>::const_iterator constr=redundantSet.begin();
+             constr != redundantSet.end(); ++constr)
+            result.redundant.push_back(constrIndex[*constr]);
+    }
 
-            std::vector<Constraint *> clistTmp;
-            clistTmp.reserve(clist.size());
-            for (std::vector<Constraint *>::iterator constr=clist.begin();
-                constr != clist.end(); ++constr) {
-                if (skipped.count(*constr) == 0)
-                    clistTmp.push_back(*constr);
-            }
+    result.paramsNum = paramsNum;
+    result.constrNum = constrNum;
+    result.rank = rank;
+}
 
-            SubSystem *subSysTmp = new SubSystem(clistTmp, pdiagnoselist);
-            int res = solve(subSysTmp,true,alg,true);
+int System::diagnose(Algorithm alg)
+{
+    // Analyses the constrainess grad of the system and provides feedback
+    // The vector "conflictingTags" will hold a group of conflicting constraints
 
-            if(debugMode==Minimal || debugMode==IterationLevel) {
-                std::string solvername;
-                switch (alg) {
-                    case 0:
-                        solvername = "BFGS";
-                        break;
-                    case 1: // solving with the LevenbergMarquardt solver
-                        solvername = "LevenbergMarquardt";
-                        break;
-                    case 2: // solving with the BFGS solver
-                        solvername = "DogLeg";
-                        break;
-                }
+    // Hint 1: Only constraints with tag >= 0 are taken into account
+    // Hint 2: Constraints tagged with 0 are treated as high priority
+    //         constraints and they are excluded from the returned
+    //         list of conflicting constraints. Therefore, this function
+    //         will provide no feedback about possible conflicts between
+    //         two high priority constraints. For this reason, tagging
+    //         constraints with 0 should be used carefully.
+    hasDiagnosis = false;
+    if (!hasUnknowns) {
+        dofs = -1;
+        return dofs;
+    }
 
-                Base::Console().Log("Sketcher::RedundantSolving-%s-\n",solvername.c_str());
-            }
+#ifdef _DEBUG_TO_FILE
+SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
+#endif
 
-            if (res == Success) {
-                subSysTmp->applySolution();
-                for (std::set<Constraint *>::const_iterator constr=skipped.begin();
-                     constr != skipped.end(); ++constr) {
-                    double err = (*constr)->error();
-                    if (err * err < convergenceRedundant)
-                        redundant.insert(*constr);
-                }
-                resetToReference();
+    // Input parameters' lists:
+    // plist            =>  list of all the parameters of the system, e.g. each coordinate of a point
+    // pdrivenlist      =>  list of the parameters that are driven by other parameters (e.g. value of driven constraints)
 
-                if(debugMode==Minimal || debugMode==IterationLevel) {
-                    Base::Console().Log("Sketcher Redundant solving: %d redundants\n",redundant.size());
-                }
+    // When adding an external geometry or a constraint on an external geometry the array 'plist' is empty.
+    // So, we must abort here because otherwise we would create an invalid matrix and make the application
+    // eventually crash. This fixes issues #0002372/#0002373.
+    if (plist.empty() || (plist.size() - pdrivenlist.size()) == 0) {
+        hasDiagnosis = true;
+        dofs = 0;
+        return dofs;
+    }
 
-                std::vector< std::vector<Constraint *> > conflictGroupsOrig=conflictGroups;
-                conflictGroups.clear();
-                for (int i=conflictGroupsOrig.size()-1; i >= 0; i--) {
-                    bool isRedundant = false;
-                    for (std::size_t j=0; j < conflictGroupsOrig[i].size(); j++) {
-                        if (redundant.count(conflictGroupsOrig[i][j]) > 0) {
-                            isRedundant = true;
-                            break;
-                        }
-                    }
-                    if (!isRedundant)
-                        conflictGroups.push_back(conflictGroupsOrig[i]);
-                    else
-                        constrNum--;
-                }
-            }
-            delete subSysTmp;
+    redundant.clear();
+    conflictingTags.clear();
+    redundantTags.clear();
 
-            // simplified output of conflicting tags
-            SET_I conflictingTagsSet;
-            for (std::size_t i=0; i < conflictGroups.size(); i++) {
-                for (std::size_t j=0; j < conflictGroups[i].size(); j++) {
-                    conflictingTagsSet.insert(conflictGroups[i][j]->getTag());
-                }
-            }
-            conflictingTagsSet.erase(0); // exclude constraints tagged with zero
-            conflictingTags.resize(conflictingTagsSet.size());
-            std::copy(conflictingTagsSet.begin(), conflictingTagsSet.end(),
-                      conflictingTags.begin());
-
-            // output of redundant tags
-            SET_I redundantTagsSet;
-            for (std::set<Constraint *>::iterator constr=redundant.begin();
-                 constr != redundant.end(); ++constr)
-                redundantTagsSet.insert((*constr)->getTag());
-            // remove tags represented at least in one non-redundant constraint
-            for (std::vector<Constraint *>::iterator constr=clist.begin();
-                constr != clist.end(); ++constr) {
-                if (redundant.count(*constr) == 0)
-                    redundantTagsSet.erase((*constr)->getTag());
-            }
-            redundantTags.resize(redundantTagsSet.size());
-            std::copy(redundantTagsSet.begin(), redundantTagsSet.end(),
-                      redundantTags.begin());
-
-            if (paramsNum == rank && constrNum > rank) { // over-constrained
-                hasDiagnosis = true;
-                dofs = paramsNum - constrNum;
-                return dofs;
-            }
+#ifndef EIGEN_SPARSEQR_COMPATIBLE
+    if(qrAlgorithm==EigenSparseQR){
+        Base::Console().Warning("SparseQR not supported by you current version of Eigen. It requires Eigen 3.2.2 or higher. Falling back to Dense QR\n");
+        qrAlgorithm=EigenDenseQR;
+    }
+#endif
+
+    // list of parameters to be diagnosed in this routine (removes value parameters from driven constraints)
+    GCS::VEC_pD pdiagnoselist;
+    {
+        SET_pD drivenparams(pdrivenlist.begin(), pdrivenlist.end());
+        for (int j=0; j < int(plist.size()); j++) {
+            if (drivenparams.count(plist[j]) == 0)
+                pdiagnoselist.push_back(plist[j]);
         }
+    }
+    MAP_pD_I pdiagnoseIndex;
+    for (int j=0; j < int(pdiagnoselist.size()); j++)
+        pdiagnoseIndex[pdiagnoselist[j]] = j;
+
+    std::vector<Constraint *> clistD; // constraints with an impact on the diagnosis
+    for (std::vector<Constraint *>::const_iterator constr=clist.begin(); constr != clist.end(); ++constr) {
+        if ((*constr)->getTag() >= 0)
+            clistD.push_back(*constr);
+    }
 
+    if (clistD.empty()) {
         hasDiagnosis = true;
-        dofs = paramsNum - rank;
+        dofs = pdiagnoselist.size();
         return dofs;
     }
 
+    // tag multiplicity gives the number of solver constraints associated with the same tag
+    // A tag generally corresponds to the Sketcher constraint index - There are special tag values, like 0 and -1.
+    std::map< int , int> tagmultiplicity;
+    for (std::vector<Constraint *>::const_iterator constr=clistD.begin(); constr != clistD.end(); ++constr) {
+        if ((*constr)->isDriving()) {
+            if(tagmultiplicity.find((*constr)->getTag()) == tagmultiplicity.end())
+                tagmultiplicity[(*constr)->getTag()] = 0;
+            else
+                tagmultiplicity[(*constr)->getTag()]++;
+        }
+    }
+
+    // The reduced Jacobian is block diagonal over the decoupled components of the system,
+    // so ranks, conflicts and redundancies are determined per component. The result of a
+    // component is kept and reused as long as it does not change, so that editing one part
+    // of a sketch only factorizes the affected component again.
+    Graph g;
+    for (int i=0; i < int(pdiagnoselist.size() + clistD.size()); i++)
+        boost::add_vertex(g);
+
+    int cvtid = int(pdiagnoselist.size());
+    for (std::vector<Constraint *>::const_iterator constr=clistD.begin();
+         constr != clistD.end(); ++constr, cvtid++) {
+        VEC_pD &cparams = c2p[*constr];
+        for (VEC_pD::const_iterator param=cparams.begin();
+             param != cparams.end(); ++param) {
+            MAP_pD_I::const_iterator it = pdiagnoseIndex.find(*param);
+            if (it != pdiagnoseIndex.end())
+                boost::add_edge(cvtid, it->second, g);
+        }
+    }
+
+    VEC_I components(boost::num_vertices(g));
+    int componentsSize = boost::connected_components(g, &components[0]);
+
+    std::vector< std::vector<Constraint *> > componentConstrs(componentsSize);
+    std::vector< VEC_I > componentParams(componentsSize);
+    for (int j=0; j < int(pdiagnoselist.size()); j++)
+        componentParams[components[j]].push_back(j);
+    for (int i=0; i < int(clistD.size()); i++)
+        componentConstrs[components[pdiagnoselist.size()+i]].push_back(clistD[i]);
+
+    std::vector< std::pair<DiagnosisKey, DiagnosisResult> > cache;
+    cache.swap(diagnosisCache);
+
+    int paramsNum = 0;
+    int constrNum = 0;
+    int rank = 0;
+    std::set<int> depParamCols;
+    std::vector< std::vector<Constraint *> > conflictGroups;
+    for (int cid=0; cid < componentsSize; cid++) {
+        const std::vector<Constraint *> &constrs = componentConstrs[cid];
+        const VEC_I &params = componentParams[cid];
+        if (constrs.empty()) { // unconstrained parameter
+            paramsNum += params.size();
+            depParamCols.insert(params.begin(), params.end());
+            continue;
+        }
+
+        VEC_pD cparams;
+        for (VEC_I::const_iterator param=params.begin(); param != params.end(); ++param)
+            cparams.push_back(pdiagnoselist[*param]);
+
+        Eigen::SparseMatrix<double> J;
+        std::map<int,int> jacobianconstraintmap;
+        makeReducedJacobian(J, jacobianconstraintmap, constrs, cparams);
+
+        // everything the result depends on: constraint functions and errors, parameter
+        // values, the jacobian and the settings used for the analysis. Tags only matter by
+        // their order, so renumbering after deleting a constraint does not invalidate.
+        std::map<int,int> tagorder;
+        for (std::vector<Constraint *>::const_iterator constr=constrs.begin(); constr != constrs.end(); ++constr)
+            tagorder[(*constr)->getTag()] = 0;
+        int order = 0;
+        for (std::map<int,int>::iterator it=tagorder.begin(); it != tagorder.end(); ++it)
+            it->second = (it->first == 0) ? -1 : order++;
+
+        DiagnosisKey key;
+        key.structure.push_back(alg);
+        key.structure.push_back(qrAlgorithm);
+        key.structure.push_back(maxIterRedundant);
+        key.structure.push_back(sketchSizeMultiplierRedundant);
+        key.values.push_back(qrpivotThreshold);
+        key.values.push_back(convergenceRedundant);
+        key.values.push_back(LM_epsRedundant);
+        key.values.push_back(LM_eps1Redundant);
+        key.values.push_back(LM_tauRedundant);
+        key.values.push_back(DL_tolgRedundant);
+        key.values.push_back(DL_tolxRedundant);
+        key.values.push_back(DL_tolfRedundant);
+        for (std::vector<Constraint *>::const_iterator constr=constrs.begin(); constr != constrs.end(); ++constr) {
+            int tag = (*constr)->getTag();
+            key.structure.push_back((*constr)->getTypeId());
+            key.structure.push_back(tagorder[tag]);
+            key.structure.push_back((*constr)->isDriving());
+            key.structure.push_back(tagmultiplicity.count(tag) ? tagmultiplicity.at(tag) : -1);
+            key.values.push_back((*constr)->error());
+        }
+        key.structure.push_back(J.cols());
+        key.structure.insert(key.structure.end(), J.outerIndexPtr(), J.outerIndexPtr()+J.outerSize()+1);
+        key.structure.insert(key.structure.end(), J.innerIndexPtr(), J.innerIndexPtr()+J.nonZeros());
+        key.values.insert(key.values.end(), J.valuePtr(), J.valuePtr()+J.nonZeros());
+        for (VEC_pD::const_iterator param=cparams.begin(); param != cparams.end(); ++param)
+            key.values.push_back(**param);
+
+        std::vector< std::pair<DiagnosisKey, DiagnosisResult> >::iterator cached = cache.begin();
+        while (cached != cache.end() && !(cached->first == key))
+            ++cached;
+
+        DiagnosisResult res;
+        if (cached != cache.end())
+            res = cached->second;
+        else
+            diagnoseComponent(J, jacobianconstraintmap, constrs, cparams, tagmultiplicity, alg, res);
+        diagnosisCache.push_back(std::make_pair(key, res));
+
+        paramsNum += res.paramsNum;
+        constrNum += res.constrNum;
+        rank += res.rank;
+        for (VEC_I::const_iterator param=res.dependent.begin(); param != res.dependent.end(); ++param)
+            depParamCols.insert(params[*param]);
+        for (VEC_I::const_iterator constr=res.redundant.begin(); constr != res.redundant.end(); ++constr)
+            redundant.insert(constrs[*constr]);
+        for (std::size_t i=0; i < res.conflictGroups.size(); i++) {
+            std::vector<Constraint *> group;
+            for (VEC_I::const_iterator constr=res.conflictGroups[i].begin(); constr != res.conflictGroups[i].end(); ++constr)
+                group.push_back(constrs[*constr]);
+            conflictGroups.push_back(group);
+        }
+    }
+
+    for (std::set<int>::const_iterator param=depParamCols.begin(); param != depParamCols.end(); ++param)
+        pdependentparameters.push_back(pdiagnoselist[*param]);
+
+    // simplified output of conflicting tags
+    SET_I conflictingTagsSet;
+    for (std::size_t i=0; i < conflictGroups.size(); i++) {
+        for (std::size_t j=0; j < conflictGroups[i].size(); j++) {
+            conflictingTagsSet.insert(conflictGroups[i][j]->getTag());
+        }
+    }
+    conflictingTagsSet.erase(0); // exclude constraints tagged with zero
+    conflictingTags.resize(conflictingTagsSet.size());
+    std::copy(conflictingTagsSet.begin(), conflictingTagsSet.end(),
+              conflictingTags.begin());
+
+    // output of redundant tags
+    SET_I redundantTagsSet;
+    for (std::set<Constraint *>::iterator constr=redundant.begin();
+         constr != redundant.end(); ++constr)
+        redundantTagsSet.insert((*constr)->getTag());
+    // remove tags represented at least in one non-redundant constraint
+    for (std::vector<Constraint *>::iterator constr=clist.begin();
+        constr != clist.end(); ++constr) {
+        if (redundant.count(*constr) == 0)
+            redundantTagsSet.erase((*constr)->getTag());
+    }
+    redundantTags.resize(redundantTagsSet.size());
+    std::copy(redundantTagsSet.begin(), redundantTagsSet.end(),
+              redundantTags.begin());
+
     hasDiagnosis = true;
-    dofs = pdiagnoselist.size();
+    if (paramsNum == rank && constrNum > rank) // over-constrained
+        dofs = paramsNum - constrNum;
+    else
+        dofs = paramsNum - rank;
     return dofs;
 }
 
@@ -106,8 +106,36 @@ namespace GCS
         int solve_BFGS(SubSystem *subsys, bool isFine=true, bool isRedundantsolving=false);
         int solve_LM(SubSystem *subsys, bool isRedundantsolving=false);
         int solve_DL(SubSystem *subsys, bool isRedundantsolving=false);
-
-        void makeReducedJacobian(Eigen::MatrixXd &J, std::map<int,int> &jacobianconstraintmap, GCS::VEC_pD &pdiagnoselist, std::map< int , int> &tagmultiplicity);
+        // Jacobian is either Eigen::MatrixXd or SparseJacobian, see isSparseSubsystem
+        template <typename Jacobian>
+        int solve_LM(SubSystem *subsys, Jacobian &J, bool isRedundantsolving);
+        template <typename Jacobian>
+        int solve_DL(SubSystem *subsys, Jacobian &Jx, Jacobian &Jx_new, bool isRedundantsolving);
+        bool isSparseSubsystem(SubSystem *subsys) const;
+
+        // diagnosis of one decoupled component, constraints and parameters refer to the
+        // component lists it was computed for
+        struct DiagnosisResult {
+            int paramsNum, constrNum, rank;
+            VEC_I dependent;
+            std::vector< VEC_I > conflictGroups;
+            VEC_I redundant;
+        };
+        // everything a DiagnosisResult depends on
+        struct DiagnosisKey {
+            VEC_I structure;
+            VEC_D values;
+            bool operator==(const DiagnosisKey &other) const
+              { return structure == other.structure && values == other.values; }
+        };
+        // results of the components of the last diagnose, kept across clear()
+        std::vector< std::pair<DiagnosisKey, DiagnosisResult> > diagnosisCache;
+
+        void makeReducedJacobian(Eigen::SparseMatrix<double> &J, std::map<int,int> &jacobianconstraintmap,
+                                 const std::vector<Constraint *> &constrs, const GCS::VEC_pD &pdiagnoselist);
+        void diagnoseComponent(const Eigen::SparseMatrix<double> &J, const std::map<int,int> &jacobianconstraintmap,
+                               const std::vector<Constraint *> &constrs, GCS::VEC_pD &pdiagnoselist,
+                               const std::map< int , int> &tagmultiplicity, Algorithm alg, DiagnosisResult &result);
 
         #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
         void extractSubsystem(SubSystem *subsys, bool isRedundantsolving);
@@ -121,6 +149,9 @@ namespace GCS
         double convergenceRedundant;
         QRAlgorithm qrAlgorithm;
         DogLegGaussStep dogLegGaussStep;
+        // LM and DL use a sparse jacobian and sparse Cholesky steps on subsystems with at least
+        // this many parameters (dogLegGaussStep is then ignored), 0 always uses the dense path
+        int sparseThreshold;
         double qrpivotThreshold;
         DebugMode debugMode;
         double LM_eps;
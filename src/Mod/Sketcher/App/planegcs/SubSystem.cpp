@@ -126,6 +126,26 @@ void SubSystem::initialize(VEC_pD &params, MAP_pD_pD &reductionmap)
         }
 //        (*constr)->redirectParams(pmap); // redirect parameters to pvec
     }
+
+    // c2p lists the parameters of each constraint in pvals order, that is in column order
+    Eigen::VectorXi rowSizes(csize);
+    for (int i=0; i < csize; i++) {
+        std::map<Constraint *,VEC_pD >::const_iterator it = c2p.find(clist[i]);
+        rowSizes[i] = (it != c2p.end()) ? static_cast<int>(it->second.size()) : 0;
+    }
+    jacobiPattern.resize(csize, psize);
+    jacobiPattern.reserve(rowSizes);
+    for (int i=0; i < csize; i++) {
+        std::map<Constraint *,VEC_pD >::const_iterator it = c2p.find(clist[i]);
+        if (it != c2p.end())
+            for (VEC_pD::const_iterator p=it->second.begin(); p != it->second.end(); ++p)
+                jacobiPattern.insert(i, static_cast<int>(*p - &pvals[0])) = 0.;
+    }
+    jacobiPattern.makeCompressed();
+
+    jacobiParams.resize(jacobiPattern.nonZeros());
+    for (int k=0; k < int(jacobiParams.size()); k++)
+        jacobiParams[k] = &pvals[jacobiPattern.innerIndexPtr()[k]];
 }
 
 void SubSystem::redirectParams()
@@ -272,7 +292,24 @@ void SubSystem::calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi)
 
 void SubSystem::calcJacobi(Eigen::MatrixXd &jacobi)
 {
-    calcJacobi(plist, jacobi);
+    // only the entries of the non-zero pattern need evaluating
+    jacobi.setZero(csize, psize);
+    for (int i=0; i < csize; i++)
+        for (SparseJacobian::InnerIterator it(jacobiPattern, i); it; ++it)
+            jacobi(i, it.col()) = clist[i]->grad(&pvals[it.col()]);
+}
+
+void SubSystem::calcJacobi(SparseJacobian &jacobi)
+{
+    if (jacobi.rows() != csize || jacobi.cols() != psize || !jacobi.isCompressed() ||
+        jacobi.nonZeros() != jacobiPattern.nonZeros())
+        jacobi = jacobiPattern;
+
+    const int *outer = jacobi.outerIndexPtr();
+    double *values = jacobi.valuePtr();
+    for (int i=0; i < csize; i++)
+        for (int k=outer[i]; k < outer[i+1]; k++)
+            values[k] = clist[i]->grad(jacobiParams[k]);
 }
 
 void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
@@ -27,11 +27,15 @@
 #undef max
 
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 #include "Constraints.h"
 
 namespace GCS
 {
 
+    // one row per constraint, so that each row can be refilled from a single constraint
+    typedef Eigen::SparseMatrix<double, Eigen::RowMajor> SparseJacobian;
+
     class SubSystem
     {
     private:
@@ -43,6 +47,8 @@ namespace GCS
 //        JacobianMatrix jacobi;  // jacobi matrix of the residuals
         std::map<Constraint *,VEC_pD > c2p; // constraint to parameter adjacency list
         std::map<double *,std::vector<Constraint *> > p2c; // parameter to constraint adjacency list
+        SparseJacobian jacobiPattern; // non-zero pattern of the jacobian (built from c2p)
+        VEC_pD jacobiParams;          // parameter in pvals of every stored entry of jacobiPattern
         void initialize(VEC_pD &params, MAP_pD_pD &reductionmap); // called by the constructors
     public:
         SubSystem(std::vector<Constraint *> &clist_, VEC_pD &params);
@@ -71,6 +77,9 @@ namespace GCS
         void calcResidual(Eigen::VectorXd &r, double &err);
         void calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi);
         void calcJacobi(Eigen::MatrixXd &jacobi);
+        // jacobi must be empty or the result of a previous call on this subsystem,
+        // in which case only the values are refreshed and the structure is reused
+        void calcJacobi(SparseJacobian &jacobi);
         void calcGrad(VEC_pD &params, Eigen::VectorXd &grad);
         void calcGrad(Eigen::VectorXd &grad);
 
@@ -57,6 +57,7 @@
 #define DEFAULT_SOLVER_DEBUG 1      // None=0, Minimal=1, IterationLevel=2
 #define MAX_ITER_MULTIPLIER false
 #define DEFAULT_DOGLEG_GAUSS_STEP 0   // FullPivLU = 0, LeastNormFullPivLU = 1, LeastNormLdlt = 2
+#define SPARSE_THRESHOLD 200        // minimum number of parameters of a subsystem solved on a sparse Jacobian
 
 using namespace SketcherGui;
 using namespace Gui::TaskView;
@@ -75,6 +76,7 @@ TaskSketcherSolverAdvanced::TaskSketcherSolverAdvanced(ViewProviderSketch *sketc
 
     ui->comboBoxDefaultSolver->onRestore();
     ui->comboBoxDogLegGaussStep->onRestore();
+    ui->spinBoxSparseThreshold->onRestore();
     ui->spinBoxMaxIter->onRestore();
     ui->checkBoxSketchSizeMultiplier->onRestore();
     ui->lineEditConvergence->onRestore();
@@ -408,6 +410,12 @@ void TaskSketcherSolverAdvanced::on_comboBoxDogLegGaussStep_currentIndexChanged(
     updateDefaultMethodParameters();
 }
 
+void TaskSketcherSolverAdvanced::on_spinBoxSparseThreshold_valueChanged(int i)
+{
+    ui->spinBoxSparseThreshold->onSave();
+    sketchView->getSketchObject()->getSolvedSketch().setSparseThreshold(i);
+}
+
 void TaskSketcherSolverAdvanced::on_spinBoxMaxIter_valueChanged(int i)
 {
     ui->spinBoxMaxIter->onSave();
@@ -531,6 +539,7 @@ void TaskSketcherSolverAdvanced::on_pushButtonDefaults_clicked(bool checked/* =
     // Set other settings
     hGrp->SetInt("DefaultSolver",DEFAULT_SOLVER);
     hGrp->SetInt("DogLegGaussStep",DEFAULT_DOGLEG_GAUSS_STEP);
+    hGrp->SetInt("SparseThreshold",SPARSE_THRESHOLD);
 
     hGrp->SetInt("RedundantDefaultSolver",DEFAULT_RSOLVER);
     hGrp->SetInt("MaxIter",MAX_ITER);
@@ -545,6 +554,7 @@ void TaskSketcherSolverAdvanced::on_pushButtonDefaults_clicked(bool checked/* =
 
     ui->comboBoxDefaultSolver->onRestore();
     ui->comboBoxDogLegGaussStep->onRestore();
+    ui->spinBoxSparseThreshold->onRestore();
     ui->spinBoxMaxIter->onRestore();
     ui->checkBoxSketchSizeMultiplier->onRestore();
     ui->lineEditConvergence->onRestore();
@@ -573,6 +583,7 @@ void TaskSketcherSolverAdvanced::updateSketchObject(void)
     sketchView->getSketchObject()->getSolvedSketch().setMaxIter(ui->spinBoxMaxIter->value());
     sketchView->getSketchObject()->getSolvedSketch().defaultSolver=(GCS::Algorithm) ui->comboBoxDefaultSolver->currentIndex();
     sketchView->getSketchObject()->getSolvedSketch().setDogLegGaussStep((GCS::DogLegGaussStep) ui->comboBoxDogLegGaussStep->currentIndex());
+    sketchView->getSketchObject()->getSolvedSketch().setSparseThreshold(ui->spinBoxSparseThreshold->value());
 
     updateDefaultMethodParameters();
     updateRedundantMethodParameters();
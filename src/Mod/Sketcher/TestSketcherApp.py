@@ -210,6 +210,95 @@ class SketcherSolverTestCases(unittest.TestCase):
 		self.failUnless(len(values) == 0)
 		FreeCAD.closeDocument("Issue3245")
 	
+	def testSparseSolver(self):
+		# a staircase of horizontal and vertical lines forms a single subsystem
+		# with more parameters than the sparse threshold
+		param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Sketcher/SolverAdvanced")
+		threshold = param.GetInt("SparseThreshold", -1)
+		lengths = [1.0 + (i % 7) * 0.5 for i in range(300)]
+		points = [App.Vector(0,0,0)]
+		for i, length in enumerate(lengths):
+			step = App.Vector(length,0,0) if i % 2 == 0 else App.Vector(0,length,0)
+			points.append(points[-1] + step)
+
+		def createStaircase(name, sparseThreshold):
+			param.SetInt("SparseThreshold", sparseThreshold)
+			sketch = self.Doc.addObject('Sketcher::SketchObject', name)
+			geoList = []
+			conList = []
+			for i, length in enumerate(lengths):
+				# start away from the solution
+				offset = App.Vector(0.1 * (i % 3), -0.1 * (i % 2), 0)
+				geoList.append(Part.LineSegment(points[i] * 0.8 + offset, points[i+1] * 0.8))
+				conList.append(Sketcher.Constraint('Horizontal' if i % 2 == 0 else 'Vertical', i))
+				conList.append(Sketcher.Constraint('Distance', i, length))
+				if i > 0:
+					conList.append(Sketcher.Constraint('Coincident', i-1, 2, i, 1))
+			conList.append(Sketcher.Constraint('DistanceX', 0, 1, 0.0))
+			conList.append(Sketcher.Constraint('DistanceY', 0, 1, 0.0))
+			sketch.addGeometry(geoList, False)
+			sketch.addConstraint(conList)
+			return sketch
+
+		try:
+			dense = createStaircase('Dense', 0)
+			sparse = createStaircase('Sparse', 100)
+		finally:
+			if threshold < 0:
+				param.RemInt("SparseThreshold")
+			else:
+				param.SetInt("SparseThreshold", threshold)
+
+		self.assertEqual(dense.solve(), 0)
+		self.assertEqual(sparse.solve(), 0)
+		for i in range(len(lengths)):
+			for pnt in (dense.getPoint(i, 1), sparse.getPoint(i, 1)):
+				self.assertAlmostEqual((pnt - points[i]).Length, 0.0, 6)
+			self.assertAlmostEqual((dense.getPoint(i, 2) - sparse.getPoint(i, 2)).Length, 0.0, 6)
+
+	def testDiagnosisCache(self):
+		# four independent rectangles, constraints 1-12, 13-24, 26-37 and 39-50
+		sketch = self.Doc.addObject('Sketcher::SketchObject', 'Components')
+		CreateRectangleSketch(sketch, [0, 0], [10, 20])
+		CreateRectangleSketch(sketch, [30, 0], [10, 20])
+		sketch.addConstraint(Sketcher.Constraint('Horizontal', 4))      # 25, redundant
+		CreateRectangleSketch(sketch, [60, 0], [10, 20])
+		sketch.addConstraint(Sketcher.Constraint('Distance', 8, 15.0))  # 38, conflicting
+		CreateRectangleSketch(sketch, [90, 0], [10, 20])
+
+		def diagnoseAgain():
+			# a new sketch object diagnoses without any cached result
+			fresh = self.Doc.addObject('Sketcher::SketchObject', 'Fresh')
+			fresh.addGeometry(sketch.Geometry)
+			fresh.addConstraint(sketch.Constraints)
+			fresh.solve()
+			result = (sorted(fresh.Conflicts), sorted(fresh.Redundancies))
+			self.Doc.removeObject(fresh.Name)
+			return result
+
+		def checkDiagnosis():
+			sketch.solve()
+			self.assertEqual((sorted(sketch.Conflicts), sorted(sketch.Redundancies)), diagnoseAgain())
+
+		checkDiagnosis()
+		self.assertIn(38, sketch.Conflicts)
+		self.assertTrue(set(sketch.Redundancies) & set([17, 25]))
+
+		# redundant constraint in the last rectangle only
+		sketch.addConstraint(Sketcher.Constraint('Vertical', 13))       # 51
+		checkDiagnosis()
+		self.assertTrue(set(sketch.Redundancies) & set([45, 51]))
+
+		# the constraints of the later rectangles are renumbered
+		sketch.delConstraint(24)
+		checkDiagnosis()
+		self.assertIn(37, sketch.Conflicts)
+
+		# the conflicting dimension becomes a reference
+		sketch.setDriving(36, False)
+		checkDiagnosis()
+		self.assertEqual(len(sketch.Conflicts), 0)
+
 	def tearDown(self):
 		#closing doc
 		FreeCAD.closeDocument("SketchSolverTest")
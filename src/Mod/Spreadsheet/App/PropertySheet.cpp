@@ -72,6 +72,8 @@ void PropertySheet::clear()
     cellToPropertyNameMap.clear();
     documentObjectToCellMap.clear();
     cellToDocumentObjectMap.clear();
+    cellToDependantCellMap.clear();
+    cellToPrecedentCellMap.clear();
     aliasProp.clear();
     revAliasProp.clear();
 
@@ -199,6 +201,8 @@ PropertySheet::PropertySheet(const PropertySheet &other)
     , cellToPropertyNameMap(other.cellToPropertyNameMap)
     , documentObjectToCellMap(other.documentObjectToCellMap)
     , cellToDocumentObjectMap(other.cellToDocumentObjectMap)
+    , cellToDependantCellMap(other.cellToDependantCellMap)
+    , cellToPrecedentCellMap(other.cellToPrecedentCellMap)
     , aliasProp(other.aliasProp)
     , revAliasProp(other.revAliasProp)
     , updateCount(other.updateCount)
@@ -987,6 +991,14 @@ void PropertySheet::addDependencies(CellAddress key)
             propertyNameToCellMap[propName].insert(key);
             cellToPropertyNameMap[key].insert(propName);
 
+            if (docObj==owner && props.first.size()) {
+                CellAddress addr = stringToAddress(props.first.c_str(), true);
+                if (addr.isValid() && addr.toString(true) == props.first) {
+                    cellToDependantCellMap[addr].insert(key);
+                    cellToPrecedentCellMap[key].insert(addr);
+                }
+            }
+
             // Also an alias?
             if (docObj==owner && props.first.size()) {
                 std::map<std::string, CellAddress>::const_iterator j = revAliasProp.find(props.first);
@@ -998,6 +1010,8 @@ void PropertySheet::addDependencies(CellAddress key)
                     // Insert into maps
                     propertyNameToCellMap[propName].insert(key);
                     cellToPropertyNameMap[key].insert(propName);
+                    cellToDependantCellMap[j->second].insert(key);
+                    cellToPrecedentCellMap[key].insert(j->second);
                 }
             }
         }
@@ -1033,6 +1047,25 @@ void PropertySheet::removeDependencies(CellAddress key)
         cellToPropertyNameMap.erase(i1);
     }
 
+    /* Remove from cell <-> cell maps */
+
+    std::map<CellAddress, std::set< CellAddress > >::iterator i3 = cellToPrecedentCellMap.find(key);
+
+    if (i3 != cellToPrecedentCellMap.end()) {
+        for (std::set< CellAddress >::const_iterator j = i3->second.begin(); j != i3->second.end(); ++j) {
+            std::map<CellAddress, std::set< CellAddress > >::iterator k = cellToDependantCellMap.find(*j);
+
+            if (k != cellToDependantCellMap.end()) {
+                k->second.erase(key);
+
+                if (k->second.size() == 0)
+                    cellToDependantCellMap.erase(k);
+            }
+        }
+
+        cellToPrecedentCellMap.erase(i3);
+    }
+
     /* Remove from DocumentObject <-> Key maps */
 
     std::map<CellAddress, std::set< std::string > >::iterator i2 = cellToDocumentObjectMap.find(key);
@@ -1223,6 +1256,17 @@ const std::set<std::string> &PropertySheet::getDeps(CellAddress pos) const
         return empty;
 }
 
+const std::set<CellAddress> &PropertySheet::getDependants(CellAddress pos) const
+{
+    static std::set<CellAddress> empty;
+    std::map<CellAddress, std::set< CellAddress > >::const_iterator i = cellToDependantCellMap.find(pos);
+
+    if (i != cellToDependantCellMap.end())
+        return i->second;
+    else
+        return empty;
+}
+
 void PropertySheet::recomputeDependencies(CellAddress key)
 {
     AtomicPropertyChange signaller(*this);
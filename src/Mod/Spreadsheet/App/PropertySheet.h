@@ -154,6 +154,8 @@ public:
 
     const std::set<std::string> &getDeps(App::CellAddress pos) const;
 
+    const std::set< App::CellAddress > &getDependants(App::CellAddress pos) const;
+
     void recomputeDependencies(App::CellAddress key);
 
     PyObject *getPyObject(void) override;
@@ -242,6 +244,15 @@ private:
     /*! DocumentObject this cell depends on */
     std::map<App::CellAddress, std::set< std::string > > cellToDocumentObjectMap;
 
+    /*! Cell dependencies inside this sheet, i.e when the cell given in key changes,
+      the set of addresses needs to be recomputed. Same information as the entries
+      of propertyNameToCellMap naming cells of the owner, but without string lookups.
+      */
+    std::map<App::CellAddress, std::set< App::CellAddress > > cellToDependantCellMap;
+
+    /*! Cells of this sheet the cell depends on */
+    std::map<App::CellAddress, std::set< App::CellAddress > > cellToPrecedentCellMap;
+
     /*! Mapping of cell position to alias property */
     std::map<App::CellAddress, std::string> aliasProp;
 
@@ -31,11 +31,15 @@
 #include <boost/range/algorithm/copy.hpp>
 #include <boost/assign.hpp>
 #include <boost/graph/topological_sort.hpp>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
 #include <App/Application.h>
 #include <App/Document.h>
 #include <App/DynamicProperty.h>
 #include <App/FeaturePythonPyImp.h>
 #include <App/ExpressionParser.h>
+#include <App/ExpressionProgram.h>
 #include <Base/Exception.h>
 #include <Base/FileInfo.h>
 #include <Base/Placement.h>
@@ -77,6 +81,43 @@ typedef boost::graph_traits<DependencyList> Traits;
 typedef Traits::vertex_descriptor Vertex;
 typedef Traits::edge_descriptor Edge;
 
+namespace {
+
+// Minimum number of compiled cells of a level to evaluate them concurrently
+const std::size_t MinConcurrentCells = 16;
+
+// Evaluates the compiled expressions of a slice of cells of one level. The
+// compiled program neither needs Python nor changes the document, and the
+// cells of a level only read cells of lower levels.
+class CellEvaluation : public QRunnable
+{
+public:
+    CellEvaluation(const std::vector<const Expression*> &exprs,
+                   std::vector<std::unique_ptr<Expression> > &results,
+                   std::size_t begin, std::size_t end)
+        : exprs(exprs), results(results), begin(begin), end(end)
+    {
+        setAutoDelete(false);
+    }
+
+    void run()
+    {
+        for (std::size_t i=begin; i<end; ++i) {
+            ExpressionProgram::Value value;
+            if (exprs[i] && ExpressionProgram::eval(exprs[i], value))
+                results[i].reset(ExpressionProgram::toExpression(exprs[i]->getOwner(), value));
+        }
+    }
+
+private:
+    const std::vector<const Expression*> &exprs;
+    std::vector<std::unique_ptr<Expression> > &results;
+    std::size_t begin;
+    std::size_t end;
+};
+
+}
+
 /**
   * Construct a new Sheet object.
   */
@@ -666,7 +707,7 @@ struct CurrentAddressLock {
   *
   */
 
-void Sheet::updateProperty(CellAddress key)
+void Sheet::updateProperty(CellAddress key, const Expression *result)
 {
     Cell * cell = getCell(key);
 
@@ -674,25 +715,29 @@ void Sheet::updateProperty(CellAddress key)
         std::unique_ptr<Expression> output;
         const Expression * input = cell->getExpression();
 
-        if (input) {
-            CurrentAddressLock lock(currentRow,currentCol,key);
-            output.reset(input->eval());
-        }
-        else {
-            std::string s;
+        // the result may have been evaluated by the caller already
+        if (!result) {
+            if (input) {
+                CurrentAddressLock lock(currentRow,currentCol,key);
+                output.reset(input->eval());
+            }
+            else {
+                std::string s;
 
-            if (cell->getStringContent(s))
-                output.reset(new StringExpression(this, s));
-            else
-                output.reset(new StringExpression(this, ""));
+                if (cell->getStringContent(s))
+                    output.reset(new StringExpression(this, s));
+                else
+                    output.reset(new StringExpression(this, ""));
+            }
+            result = output.get();
         }
 
         /* Eval returns either NumberExpression or StringExpression, or
          * PyObjectExpression objects */
-        auto number = freecad_dynamic_cast<NumberExpression>(output.get());
+        auto number = freecad_dynamic_cast<NumberExpression>(result);
         if(number) {
             long l;
-            auto constant = freecad_dynamic_cast<ConstantExpression>(output.get());
+            auto constant = freecad_dynamic_cast<ConstantExpression>(result);
             if(constant && !constant->isNumber()) {
                 Base::PyGILStateLocker lock;
                 setObjectProperty(key, constant->getPyValue());
@@ -703,12 +748,12 @@ void Sheet::updateProperty(CellAddress key)
             else
                 setFloatProperty(key, number->getValue());
         }else{
-            auto str_expr = freecad_dynamic_cast<StringExpression>(output.get());
+            auto str_expr = freecad_dynamic_cast<StringExpression>(result);
             if(str_expr) 
                 setStringProperty(key, str_expr->getText().c_str());
             else {
                 Base::PyGILStateLocker lock;
-                auto py_expr = freecad_dynamic_cast<PyObjectExpression>(output.get());
+                auto py_expr = freecad_dynamic_cast<PyObjectExpression>(result);
                 if(py_expr) 
                     setObjectProperty(key, py_expr->getPyValue());
                 else
@@ -756,9 +801,10 @@ void Sheet::touchCells(Range range) {
 /**
  * @brief Recompute cell at address \a p.
  * @param p Address of cell.
+ * @param result The already evaluated expression of the cell, or 0.
  */
 
-void Sheet::recomputeCell(CellAddress p)
+void Sheet::recomputeCell(CellAddress p, const Expression *result)
 {
     Cell * cell = cells.getValue(p);
 
@@ -769,7 +815,7 @@ void Sheet::recomputeCell(CellAddress p)
             cell->setContent(content.c_str());
         }
 
-        updateProperty(p);
+        updateProperty(p, result);
 
         if(!cell || !cell->hasException()) {
             cells.clearDirty(p);
@@ -818,54 +864,88 @@ DocumentObjectExecReturn *Sheet::execute(void)
          dirtyCells.insert(*i);
     }
 
-    DependencyList graph;
-    std::map<CellAddress, Vertex> VertexList;
-    std::map<Vertex, CellAddress> VertexIndexList;
+    // Process cells that depend on the dirty cells, using the cell dependency
+    // graph that PropertySheet keeps up to date as expressions change
     std::deque<CellAddress> workQueue(dirtyCells.begin(),dirtyCells.end());
     while(workQueue.size()) {
         CellAddress currPos = workQueue.front();
         workQueue.pop_front();
 
-        // Insert into map of CellPos -> Index, if it doesn't exist already
-        auto res = VertexList.emplace(currPos,Vertex());
-        if(res.second) {
-            res.first->second = add_vertex(graph);
-            VertexIndexList[res.first->second] = currPos;
+        for(auto &dep : providesTo(currPos)) {
+            if(dirtyCells.insert(dep).second)
+                workQueue.push_back(dep);
         }
+    }
 
-        // Process cells that depend on the current cell
-        for(auto &dep : providesTo(currPos)) {
-            auto resDep = VertexList.emplace(dep,Vertex());
-            if(resDep.second) {
-                resDep.first->second = add_vertex(graph);
-                VertexIndexList[resDep.first->second] = dep;
-                if(dirtyCells.insert(dep).second)
-                    workQueue.push_back(dep);
+    // Sort the cells into levels: a cell comes one level after the last cell it
+    // depends on, so the cells of one level do not depend on each other.
+    std::map<CellAddress, int> pendingInputs;
+    for(auto &pos : dirtyCells) {
+        for(auto &dep : providesTo(pos))
+            ++pendingInputs[dep];
+    }
+    std::vector<std::vector<CellAddress> > levels(1);
+    for(auto &pos : dirtyCells) {
+        if(!pendingInputs.count(pos))
+            levels[0].push_back(pos);
+    }
+    std::size_t sorted = 0;
+    while(levels.back().size()) {
+        std::vector<CellAddress> next;
+        for(auto &pos : levels.back()) {
+            for(auto &dep : providesTo(pos)) {
+                if(--pendingInputs[dep] == 0)
+                    next.push_back(dep);
             }
-            // Add edge to graph to signal dependency
-            add_edge(res.first->second, resDep.first->second, graph);
         }
+        sorted += levels.back().size();
+        levels.push_back(std::move(next));
     }
-    // Compute cells
-    std::list<Vertex> make_order;
-    // Sort graph topologically to find evaluation order
-    try {
-        boost::topological_sort(graph, std::front_inserter(make_order));
+
+    if(sorted == dirtyCells.size()) {
         // Recompute cells
         FC_LOG("recomputing " << getFullName());
-        for(auto &pos : make_order) {
-            const auto &addr = VertexIndexList[pos];
-            FC_LOG(addr.toString());
-            recomputeCell(addr);
+        int threads = QThread::idealThreadCount();
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for(auto &level : levels) {
+            // Evaluate the cells with a compiled expression at once, the
+            // properties and signals are updated here in the calling thread
+            std::vector<const Expression*> exprs(level.size());
+            std::vector<std::unique_ptr<Expression> > results(level.size());
+            std::size_t count = 0;
+            for(std::size_t i=0; i<level.size(); ++i) {
+                Cell * cell = cells.getValue(level[i]);
+                if(cell && !cell->hasException() && cell->getExpression()) {
+                    exprs[i] = cell->getExpression();
+                    ++count;
+                }
+            }
+            if(threads > 1 && count >= MinConcurrentCells) {
+                std::size_t slice = (level.size() + threads - 1) / threads;
+                std::vector<std::unique_ptr<CellEvaluation> > tasks;
+                for(std::size_t begin=0; begin<level.size(); begin+=slice) {
+                    tasks.emplace_back(new CellEvaluation(exprs, results,
+                                begin, std::min(begin+slice, level.size())));
+                    pool.start(tasks.back().get());
+                }
+                pool.waitForDone();
+            }
+
+            for(std::size_t i=0; i<level.size(); ++i) {
+                FC_LOG(level[i].toString());
+                recomputeCell(level[i], results[i].get());
+            }
         }
-    } catch (std::exception &) {
-        for(auto &v : VertexList) {
-            Cell * cell = cells.getValue(v.first);
+    } else {
+        // Cells left with pending inputs are on or after a cycle
+        for(auto &pos : dirtyCells) {
+            Cell * cell = cells.getValue(pos);
             // Mark as erroneous
             if(cell)  {
-                cellErrors.insert(v.first);
+                cellErrors.insert(pos);
                 cell->setException("Pending computation due to cyclic dependency",true);
-                cellUpdated(v.first);
+                cellUpdated(pos);
             }
         }
 
@@ -1355,7 +1435,7 @@ std::set<std::string> Sheet::dependsOn(CellAddress address) const
 void Sheet::providesTo(CellAddress address, std::set<std::string> & result) const
 {
     std::string fullName = getFullName() + ".";
-    std::set<CellAddress> tmpResult = cells.getDeps(fullName + address.toString());
+    const std::set<CellAddress> &tmpResult = cells.getDependants(address);
 
     for (std::set<CellAddress>::const_iterator i = tmpResult.begin(); i != tmpResult.end(); ++i)
         result.insert(fullName + i->toString());
@@ -1367,9 +1447,9 @@ void Sheet::providesTo(CellAddress address, std::set<std::string> & result) cons
  * @param result Set of links.
  */
 
-std::set<CellAddress>  Sheet::providesTo(CellAddress address) const
+const std::set<CellAddress> &Sheet::providesTo(CellAddress address) const
 {
-    return cells.getDeps(getFullName()+"."+address.toString());
+    return cells.getDependants(address);
 }
 
 void Sheet::onDocumentRestored()
@@ -193,11 +193,11 @@ protected:
 
     void updateColumnsOrRows(bool horizontal, int section, int count) ;
 
-    std::set<App::CellAddress> providesTo(App::CellAddress address) const;
+    const std::set<App::CellAddress> &providesTo(App::CellAddress address) const;
 
     void onDocumentRestored();
 
-    void recomputeCell(App::CellAddress p);
+    void recomputeCell(App::CellAddress p, const App::Expression *result = 0);
 
     App::Property *getProperty(App::CellAddress key) const;
 
@@ -205,7 +205,7 @@ protected:
 
     void updateAlias(App::CellAddress key);
 
-    void updateProperty(App::CellAddress key);
+    void updateProperty(App::CellAddress key, const App::Expression *result = 0);
 
     App::Property *setStringProperty(App::CellAddress key, const std::string & value) ;
 
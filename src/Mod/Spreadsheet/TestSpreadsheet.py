@@ -1017,6 +1017,205 @@ class SpreadsheetCases(unittest.TestCase):
         self.doc.recompute()
         self.assertEqual(sheet.get('C1'), Units.Quantity('3 mm'))
 
+    def testReferenceUpdate(self):
+        """ Results follow changes of type, alias and label of the referenced cells """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '2')
+        sheet.setAlias('A1', 'base')
+        sheet.set('B1', '=base * 3')
+        sheet.set('B2', '=A1 / 4')
+        sheet.set('B3', '=A1 > 1 ? 1 : 0')
+        sheet.set('B4', '=hypot(3 * A1; 4 * A1)')
+        sheet.set('B5', '=A1 / 0')
+        box = self.doc.addObject('Part::Box', 'Box')
+        box.setExpression('Length', '<<Spreadsheet>>.base * 2mm')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 6)
+        self.assertEqual(sheet.B2, 0.5)
+        self.assertEqual(sheet.B3, 1)
+        self.assertEqual(sheet.B4, 10)
+        self.assertTrue(sheet.B5.startswith(u'ERR:'))
+        self.assertAlmostEqual(box.Length.Value, 4)
+
+        # The referenced cell changes its type
+        sheet.set('A1', '2.5')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 7.5)
+        self.assertEqual(sheet.B2, 0.625)
+        self.assertEqual(sheet.B3, 1)
+        self.assertAlmostEqual(box.Length.Value, 5)
+
+        # The referenced alias and label are renamed
+        sheet.set('A1', '5')
+        sheet.setAlias('A1', 'length')
+        sheet.Label = 'Params'
+        self.doc.recompute()
+        self.assertEqual(sheet.getContents('B1'), '=length * 3')
+        self.assertEqual(sheet.B1, 15)
+        self.assertEqual(sheet.B2, 1.25)
+        self.assertEqual(sheet.B4, 25)
+        self.assertAlmostEqual(box.Length.Value, 10)
+
+    def testDependencyEditExpression(self):
+        """ Dependants follow edited expressions, dropped references are forgotten """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '1')
+        sheet.set('B1', '=A1 + 1')
+        sheet.set('C1', '=A1 * 2')
+        sheet.set('D1', '=B1 + C1')
+        sheet.set('E1', '=D1 + A1')
+        self.doc.recompute()
+        self.assertEqual(sheet.D1, 4)
+        self.assertEqual(sheet.E1, 5)
+
+        sheet.set('A1', '2')
+        self.doc.recompute()
+        self.assertEqual(sheet.D1, 7)
+        self.assertEqual(sheet.E1, 9)
+
+        # B1 no longer depends on A1, so A1 may depend on B1
+        sheet.set('B1', '=5')
+        sheet.set('A1', '=B1 * 2')
+        self.doc.recompute()
+        self.assertFalse('Invalid' in sheet.State)
+        self.assertEqual(sheet.A1, 10)
+        self.assertEqual(sheet.C1, 20)
+        self.assertEqual(sheet.D1, 25)
+        self.assertEqual(sheet.E1, 35)
+
+        sheet.set('B1', '=6')
+        self.doc.recompute()
+        self.assertEqual(sheet.A1, 12)
+        self.assertEqual(sheet.E1, 42)
+
+    def testDependencyDeleteCell(self):
+        """ Deleting a cell drops the references of its expression """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '1')
+        sheet.set('B1', '=A1 * 2')
+        sheet.set('C1', '=A1 + 1')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 2)
+
+        sheet.clear('B1')
+        self.doc.recompute()
+        self.assertEqual(sheet.getContents('B1'), '')
+        self.assertEqual(sheet.C1, 2)
+
+        sheet.set('B1', '7')
+        sheet.set('A1', '=B1 + 1')
+        self.doc.recompute()
+        self.assertFalse('Invalid' in sheet.State)
+        self.assertEqual(sheet.A1, 8)
+        self.assertEqual(sheet.C1, 9)
+
+    def testDependencyRenameAlias(self):
+        """ Dependants of an alias follow the renamed alias """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '2')
+        sheet.setAlias('A1', 'base')
+        sheet.set('B1', '=base * 2')
+        sheet.set('C1', '=B1 + 1')
+        self.doc.recompute()
+        self.assertEqual(sheet.C1, 5)
+
+        sheet.setAlias('A1', 'length')
+        self.doc.recompute()
+        self.assertEqual(sheet.getContents('B1'), '=length * 2')
+        self.assertEqual(sheet.C1, 5)
+
+        sheet.set('A1', '4')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 8)
+        self.assertEqual(sheet.C1, 9)
+
+    def testDependencyMoveCells(self):
+        """ Dependants follow cells moved by inserting and removing rows and columns """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '1')
+        sheet.set('A2', '=A1 * 2')
+        sheet.set('A3', '=A2 + 1')
+        sheet.set('B1', '=A3 * 10')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 30)
+
+        sheet.insertRows('2', 1)
+        sheet.set('A1', '5')
+        self.doc.recompute()
+        self.assertEqual(sheet.getContents('A4'), '=A3 + 1')
+        self.assertEqual(sheet.getContents('B1'), '=A4 * 10')
+        self.assertEqual(sheet.A3, 10)
+        self.assertEqual(sheet.A4, 11)
+        self.assertEqual(sheet.B1, 110)
+
+        sheet.removeRows('2', 1)
+        sheet.set('A1', '7')
+        self.doc.recompute()
+        self.assertEqual(sheet.getContents('A3'), '=A2 + 1')
+        self.assertEqual(sheet.A2, 14)
+        self.assertEqual(sheet.A3, 15)
+        self.assertEqual(sheet.B1, 150)
+
+        sheet.insertColumns('B', 1)
+        sheet.set('A1', '2')
+        self.doc.recompute()
+        self.assertEqual(sheet.getContents('C1'), '=A3 * 10')
+        self.assertEqual(sheet.C1, 50)
+
+        sheet.removeColumns('B', 1)
+        sheet.set('A1', '3')
+        self.doc.recompute()
+        self.assertEqual(sheet.getContents('B1'), '=A3 * 10')
+        self.assertEqual(sheet.B1, 70)
+
+    def testDependencyCycle(self):
+        """ A cycle is reported and recomputed once it is broken """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '=B1 + 1')
+        sheet.set('B1', '=C1 + 1')
+        sheet.set('C1', '=A1 + 1')
+        sheet.set('D1', '=A1 * 2')
+        sheet.set('E1', '5')
+        self.doc.recompute()
+        self.assertTrue('Invalid' in sheet.State)
+
+        sheet.set('C1', '1')
+        self.doc.recompute()
+        self.assertFalse('Invalid' in sheet.State)
+        self.assertEqual(sheet.B1, 2)
+        self.assertEqual(sheet.A1, 3)
+        self.assertEqual(sheet.D1, 6)
+        self.assertEqual(sheet.E1, 5)
+
+    def testDependencyLevels(self):
+        """ Wide levels are evaluated at once and give the same values """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '3')
+        rows = range(2, 66)
+        for row in rows:
+            sheet.set('B%d' % row, '=A1 * %d + 0.5' % row)
+            sheet.set('C%d' % row, '=B%d * 1mm' % row)
+            sheet.set('D%d' % row, '=A1 * %d' % row)
+            # not compiled, evaluated in Python
+            sheet.set('E%d' % row, '=<<row %d>>' % row)
+        sheet.set('F1', '=B2 + B65 + D65')
+        self.doc.recompute()
+        self.assertFalse('Invalid' in sheet.State)
+        for row in rows:
+            self.assertEqual(sheet.get('B%d' % row), 3 * row + 0.5)
+            self.assertAlmostEqual(sheet.get('C%d' % row).Value, 3 * row + 0.5)
+            self.assertEqual(sheet.get('D%d' % row), 3 * row)
+            self.assertTrue(isinstance(sheet.get('D%d' % row), int))
+            self.assertEqual(sheet.get('E%d' % row), 'row %d' % row)
+        self.assertEqual(sheet.F1, 6.5 + 195.5 + 195)
+
+        sheet.set('A1', '2')
+        self.doc.recompute()
+        for row in rows:
+            self.assertEqual(sheet.get('B%d' % row), 2 * row + 0.5)
+            self.assertAlmostEqual(sheet.get('C%d' % row).Value, 2 * row + 0.5)
+        self.assertEqual(sheet.F1, 4.5 + 130.5 + 130)
+
 
     def tearDown(self):
         #closing doc
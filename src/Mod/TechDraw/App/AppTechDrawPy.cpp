@@ -95,6 +95,9 @@ public:
         add_varargs_method("findOuterWire",&Module::findOuterWire,
             "wire = findOuterWire(edgeList) -- Planar graph traversal finds OuterWire in edge pile."
         );
+        add_varargs_method("findSplitPoints",&Module::findSplitPoints,
+            "[(edge,point,parameter)] = findSplitPoints(edgePile) -- Find the edge ends lying inside other edges of edge pile."
+        );
         add_varargs_method("findShapeOutline",&Module::findShapeOutline,
             "wire = findShapeOutline(shape,scale,direction) -- Project shape in direction and find outer wire of result."
         );
@@ -272,6 +275,50 @@ private:
         return Py::asObject(outerWire);
     }
 
+    Py::Object findSplitPoints(const Py::Tuple& args)
+    {
+        PyObject *pcObj;
+        if (!PyArg_ParseTuple(args.ptr(), "O!", &(PyList_Type), &pcObj)) {
+            throw Py::TypeError("expected (listofedges)");
+        }
+
+        std::vector<TopoDS_Edge> edgeList;
+        try {
+            Py::Sequence list(pcObj);
+            for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+                if (PyObject_TypeCheck((*it).ptr(), &(Part::TopoShapeEdgePy::Type))) {
+                    const TopoDS_Shape& sh = static_cast<TopoShapePy*>((*it).ptr())->
+                        getTopoShapePtr()->getShape();
+                    const TopoDS_Edge e = TopoDS::Edge(sh);
+                    edgeList.push_back(e);
+                }
+            }
+        }
+        catch (Standard_Failure& e) {
+
+            throw Py::Exception(Part::PartExceptionOCCError, e.GetMessageString());
+        }
+
+        Py::List result;
+        try {
+            std::vector<splitPoint> splits = DrawProjectSplit::findSplitPoints(edgeList);
+            for (auto& s: splits) {
+                Py::Tuple item(3);
+                item.setItem(0, Py::Long(s.i));
+                item.setItem(1, Py::Vector(s.v));
+                item.setItem(2, Py::Float(s.param));
+                result.append(item);
+            }
+        }
+        catch (Standard_Failure& e) {
+            throw Py::Exception(Part::PartExceptionOCCError, e.GetMessageString());
+        }
+        catch (Base::Exception &e) {
+            throw Py::Exception(Base::BaseExceptionFreeCADError, e.what());
+        }
+        return result;
+    }
+
     Py::Object findShapeOutline(const Py::Tuple& args)
     {
         PyObject *pcObjShape;
@@ -62,8 +62,12 @@
 
 #endif
 
+#include <Standard_Version.hxx>
+#include <QtConcurrentMap>
+
 #include <limits>
 #include <algorithm>
+#include <iterator>
 #include <cmath>
 #include <GeomLib_Tool.hxx>
 
@@ -81,6 +85,7 @@
 #include "DrawProjectSplit.h"
 #include "DrawHatch.h"
 #include "EdgeWalker.h"
+#include "GridIndex.h"
 
 
 //#include <Mod/TechDraw/App/DrawProjectSplitPy.h>  // generated from DrawProjectSplitPy.xml
@@ -88,6 +93,39 @@
 using namespace TechDraw;
 using namespace std;
 
+namespace {
+
+//! isOnEdge for a vertex inside the bounding box of e, without Console output so it
+//! can run in a worker thread. failed is set if the distance can't be computed.
+bool isInsideEdge(const TopoDS_Edge& e, const TopoDS_Vertex& v, double& param, bool& failed)
+{
+    param = -2;
+    BRepExtrema_DistShapeShape extss(v, e);
+    if (!extss.IsDone() || extss.NbSolution() == 0) {
+        failed = true;
+        return false;
+    }
+    if (extss.Value() >= Precision::Confusion()) {
+        return false;
+    }
+    const gp_Pnt pt = BRep_Tool::Pnt(v);
+    BRepAdaptor_Curve adapt(e);
+    const Handle(Geom_Curve) c = adapt.Curve().Curve();
+    double maxDist = 0.000001;     //magic number.  less than this gives false positives.
+    (void) GeomLib_Tool::Parameter(c,pt,maxDist,param);  //already know point it on curve
+
+    TopoDS_Vertex v1 = TopExp::FirstVertex(e);
+    TopoDS_Vertex v2 = TopExp::LastVertex(e);
+    return !DrawUtil::isSamePoint(v,v1) && !DrawUtil::isSamePoint(v,v2);
+}
+
+struct SplitSearch {
+    int first;
+    int last;
+};
+
+} // namespace
+
 
 //===========================================================================
 // DrawProjectSplit
@@ -170,63 +208,7 @@ std::vector<TopoDS_Edge> DrawProjectSplit::getEdges(TechDraw::GeometryObject* ge
 
     //HLR algo does not provide all edge intersections for edge endpoints.
     //need to split long edges touched by Vertex of another edge
-    std::vector<splitPoint> splits;
-    std::vector<TopoDS_Edge>::iterator itOuter = origEdges.begin();
-    int iOuter = 0;
-    for (; itOuter != origEdges.end(); ++itOuter, iOuter++) {
-        TopoDS_Vertex v1 = TopExp::FirstVertex((*itOuter));
-        TopoDS_Vertex v2 = TopExp::LastVertex((*itOuter));
-        Bnd_Box sOuter;
-        BRepBndLib::Add(*itOuter, sOuter);
-        sOuter.SetGap(0.1);
-        if (sOuter.IsVoid()) {
-            Base::Console().Message("DPS::Extract Faces - outer Bnd_Box is void\n");
-            continue;
-        }
-        if (DrawUtil::isZeroEdge(*itOuter)) {
-            Base::Console().Message("DPS::extractFaces - outerEdge: %d is ZeroEdge\n",iOuter);   //this is not finding ZeroEdges
-            continue;  //skip zero length edges. shouldn't happen ;)
-        }
-        int iInner = 0;
-        std::vector<TopoDS_Edge>::iterator itInner = faceEdges.begin();
-        for (; itInner != faceEdges.end(); ++itInner,iInner++) {
-            if (iInner == iOuter) {
-                continue;
-            }
-            if (DrawUtil::isZeroEdge((*itInner))) {
-                continue;  //skip zero length edges. shouldn't happen ;)
-            }
-
-            Bnd_Box sInner;
-            BRepBndLib::Add(*itInner, sInner);
-            sInner.SetGap(0.1);
-            if (sInner.IsVoid()) {
-                Base::Console().Log("INFO - DPS::Extract Faces - inner Bnd_Box is void\n");
-                continue;
-            }
-            if (sOuter.IsOut(sInner)) {      //bboxes of edges don't intersect, don't bother
-                continue;
-            }
-
-            double param = -1;
-            if (isOnEdge((*itInner),v1,param,false)) {
-                gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
-                splitPoint s1;
-                s1.i = iInner;
-                s1.v = Base::Vector3d(pnt1.X(),pnt1.Y(),pnt1.Z());
-                s1.param = param;
-                splits.push_back(s1);
-            }
-            if (isOnEdge((*itInner),v2,param,false)) {
-                gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
-                splitPoint s2;
-                s2.i = iInner;
-                s2.v = Base::Vector3d(pnt2.X(),pnt2.Y(),pnt2.Z());
-                s2.param = param;
-                splits.push_back(s2);
-            }
-        } //inner loop
-    }   //outer loop
+    std::vector<splitPoint> splits = findSplitPoints(origEdges);
 
     std::vector<splitPoint> sorted = sortSplits(splits,true);
     auto last = std::unique(sorted.begin(), sorted.end(), DrawProjectSplit::splitEqual);  //duplicates to back
@@ -289,6 +271,118 @@ bool DrawProjectSplit::isOnEdge(TopoDS_Edge e, TopoDS_Vertex v, double& param, b
 }
 
 
+//! HLR algo does not provide all edge intersections for edge endpoints. Find where
+//! a Vertex of one edge touches another edge away from its ends.  Only the edges
+//! whose boxes contain the Vertex are checked, they are looked up in a grid over
+//! the view.  The edges are searched concurrently.
+std::vector<splitPoint> DrawProjectSplit::findSplitPoints(const std::vector<TopoDS_Edge>& edges)
+{
+    std::vector<splitPoint> result;
+    int count = edges.size();
+    std::vector<Bnd_Box> boxes(count);
+    std::vector<Base::BoundBox2d> boxes2d(count);
+    std::vector<char> usable(count, 0);
+    Base::BoundBox2d extent;
+    extent.SetVoid();
+    for (int i = 0; i < count; i++) {
+        BRepBndLib::Add(edges[i], boxes[i]);
+        boxes[i].SetGap(0.1);
+        if (boxes[i].IsVoid()) {
+            Base::Console().Log("DPS::findSplitPoints - Bnd_Box is void for edge: %d\n", i);
+            continue;
+        }
+        if (DrawUtil::isZeroEdge(edges[i])) {
+            continue;  //skip zero length edges. shouldn't happen ;)
+        }
+        usable[i] = 1;
+        Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+        boxes[i].Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        boxes2d[i] = Base::BoundBox2d(xMin, yMin, xMax, yMax);
+        extent.Add(Base::Vector2d(xMin, yMin));
+        extent.Add(Base::Vector2d(xMax, yMax));
+    }
+    if (!extent.IsValid()) {
+        return result;
+    }
+
+    GridIndex grid(extent, count);
+    for (int i = 0; i < count; i++) {
+        if (usable[i]) {
+            grid.add(i, boxes2d[i]);
+        }
+    }
+
+    std::vector<std::vector<splitPoint> > found(count);
+    std::vector<int> failures(count, 0);
+    auto searchEdges = [&](SplitSearch& search) {
+        std::vector<int> cell1, cell2, inner;
+        for (int iOuter = search.first; iOuter < search.last; iOuter++) {
+            if (!usable[iOuter]) {
+                continue;
+            }
+            TopoDS_Vertex v1 = TopExp::FirstVertex(edges[iOuter]);
+            TopoDS_Vertex v2 = TopExp::LastVertex(edges[iOuter]);
+            gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
+            gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
+            grid.candidates(pnt1.X(), pnt1.Y(), cell1);
+            grid.candidates(pnt2.X(), pnt2.Y(), cell2);
+            inner.clear();
+            std::set_union(cell1.begin(), cell1.end(), cell2.begin(), cell2.end(),
+                           std::back_inserter(inner));
+            for (int iInner: inner) {
+                if (iInner == iOuter) {
+                    continue;
+                }
+                bool failed = false;
+                double param = -1;
+                if (!boxes[iInner].IsOut(pnt1) &&
+                    isInsideEdge(edges[iInner], v1, param, failed)) {
+                    splitPoint s1;
+                    s1.i = iInner;
+                    s1.v = Base::Vector3d(pnt1.X(),pnt1.Y(),pnt1.Z());
+                    s1.param = param;
+                    found[iOuter].push_back(s1);
+                }
+                if (!boxes[iInner].IsOut(pnt2) &&
+                    isInsideEdge(edges[iInner], v2, param, failed)) {
+                    splitPoint s2;
+                    s2.i = iInner;
+                    s2.v = Base::Vector3d(pnt2.X(),pnt2.Y(),pnt2.Z());
+                    s2.param = param;
+                    found[iOuter].push_back(s2);
+                }
+                if (failed) {
+                    failures[iOuter]++;
+                }
+            }
+        }
+    };
+
+    const int chunk = 64;
+    std::vector<SplitSearch> searches;
+    for (int i = 0; i < count; i += chunk) {
+        searches.push_back(SplitSearch{i, std::min(i + chunk, count)});
+    }
+#if OCC_VERSION_HEX >= 0x070000
+    QtConcurrent::blockingMap(searches, searchEdges);
+#else
+    //curves cache their evaluation data before OCC 7, they can't be shared between threads
+    for (auto& s: searches) {
+        searchEdges(s);
+    }
+#endif
+
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        result.insert(result.end(), found[i].begin(), found[i].end());
+        failed += failures[i];
+    }
+    if (failed > 0) {
+        Base::Console().Error("DPS::findSplitPoints - distance to edge failed %d times\n", failed);
+    }
+    return result;
+}
+
 std::vector<TopoDS_Edge> DrawProjectSplit::splitEdges(std::vector<TopoDS_Edge> edges, std::vector<splitPoint> splits)
 {
     std::vector<TopoDS_Edge> result;
@@ -102,6 +102,7 @@
 #include "DrawViewBalloon.h"
 #include "DrawViewDetail.h"
 #include "DrawViewDimension.h"
+#include "DrawViewMulti.h"
 #include "LandmarkDimension.h"
 #include "DrawViewPart.h"
 #include "DrawViewSection.h"
@@ -109,6 +110,7 @@
 #include "Geometry.h"
 #include "GeometryObject.h"
 #include "LineGroup.h"
+#include "ProjectionCache.h"
 #include "ShapeExtractor.h"
 
 #include <Mod/TechDraw/App/DrawViewPartPy.h>  // generated from DrawViewPartPy.xml
@@ -116,6 +118,32 @@
 using namespace TechDraw;
 using namespace std;
 
+namespace {
+
+//! sections, details and multiviews project their own shapes in their execute()
+bool usesProjectionCache(const DrawViewPart* dvp)
+{
+    return !dvp->isDerivedFrom(DrawViewSection::getClassTypeId()) &&
+           !dvp->isDerivedFrom(DrawViewDetail::getClassTypeId()) &&
+           !dvp->isDerivedFrom(DrawViewMulti::getClassTypeId());
+}
+
+ProjectionCache::Key getProjectionKey(const DrawViewPart* dvp, const gp_Ax2& viewAxis)
+{
+    ProjectionCache::Key key;
+    key.sources = ShapeExtractor::getShapeList(dvp->getAllSources());
+    key.viewAxis = viewAxis;
+    key.scale = dvp->getScale();
+    key.rotation = dvp->Rotation.getValue();
+    key.usePolygonHLR = dvp->CoarseView.getValue();
+    key.isoCount = dvp->IsoCount.getValue();
+    key.isPersp = dvp->Perspective.getValue();
+    key.focus = dvp->Focus.getValue();
+    return key;
+}
+
+} // namespace
+
 
 //===========================================================================
 // DrawViewPart
@@ -289,6 +317,9 @@ App::DocumentObjectExecReturn *DrawViewPart::execute(void)
     }
 
     m_saveShape = shape;
+    if (usesProjectionCache(this)) {
+        scheduleProjections();
+    }
     partExec(shape);
     addShapes2d();
 
@@ -420,16 +451,90 @@ GeometryObject* DrawViewPart::makeGeometryForShape(TopoDS_Shape shape)
     m_saveCentroid = centroid;
     m_saveShape = centeredShape;
 
+    //reuse the projection if nothing it depends on has changed, or wait for
+    //the one queued by scheduleProjections
+    ProjectionCache::Key key = getProjectionKey(this, viewAxis);
+    ProjectionCache::Future projection = ProjectionCache::find(key);
+    if (!projection.valid()) {
+        TopoDS_Shape scaledShape = scaleAndRotate(centeredShape, viewAxis);
+//        BRepTools::Write(scaledShape, "DVPScaled.brep");            //debug
+        projection = ProjectionCache::compute(key, scaledShape, getNameInDocument());
+    }
+    GeometryObject* go =  buildGeometryFromProjection(*projection.get());
+    return go;
+}
+
+TopoDS_Shape DrawViewPart::scaleAndRotate(TopoDS_Shape centeredShape, gp_Ax2 viewAxis) const
+{
     TopoDS_Shape scaledShape = TechDraw::scaleShape(centeredShape,
                                                     getScale());
     if (!DrawUtil::fpCompare(Rotation.getValue(),0.0)) {
         scaledShape = TechDraw::rotateShape(scaledShape,
                                             viewAxis,
                                             Rotation.getValue());
-     }
-//    BRepTools::Write(scaledShape, "DVPScaled.brep");            //debug
-    GeometryObject* go =  buildGeometryObject(scaledShape,viewAxis);
-    return go;
+    }
+    return scaledShape;
+}
+
+//! Queue the HLR of the other views on the page that are waiting for a recompute,
+//! so they are projected while this view is.  Views whose sources still have to be
+//! recomputed are left alone, their projection would be outdated.
+void DrawViewPart::scheduleProjections(void)
+{
+    DrawPage* page = findParentPage();
+    if (page == nullptr) {
+        return;
+    }
+
+    for (auto& v: page->getAllViews()) {
+        DrawViewPart* dvp = dynamic_cast<DrawViewPart*>(v);
+        if (dvp == nullptr ||
+            dvp == this ||
+            !usesProjectionCache(dvp) ||
+            !dvp->keepUpdated()) {
+            continue;
+        }
+        if (!dvp->isTouched() && !dvp->mustRecompute()) {
+            continue;
+        }
+        bool sourcesReady = true;
+        for (auto& s: dvp->getAllSources()) {
+            if (s->isTouched() || s->mustRecompute()) {
+                sourcesReady = false;
+                break;
+            }
+        }
+        if (sourcesReady) {
+            dvp->queueProjection();
+        }
+    }
+}
+
+//! start the HLR of this view in a worker thread, unless it is known already
+void DrawViewPart::queueProjection(void)
+{
+    Base::Vector3d stdOrg(0.0,0.0,0.0);
+    gp_Ax2 viewAxis = getProjectionCS(stdOrg);
+    ProjectionCache::Key key = getProjectionKey(this, viewAxis);
+    if (key.sources.empty() ||
+        ProjectionCache::find(key).valid()) {
+        return;
+    }
+
+    //the job gets its own copy of the sources
+    TopoDS_Shape shape = ShapeExtractor::getShapes(getAllSources());
+    if (shape.IsNull()) {
+        return;
+    }
+    gp_Pnt inputCenter = TechDraw::findCentroid(shape,
+                                                viewAxis);
+    Base::Vector3d centroid(inputCenter.X(),
+                            inputCenter.Y(),
+                            inputCenter.Z());
+    TopoDS_Shape centeredShape = TechDraw::moveShape(shape,
+                                                     centroid * -1.0);
+    TopoDS_Shape scaledShape = scaleAndRotate(centeredShape, viewAxis);
+    ProjectionCache::computeAsync(key, scaledShape, getNameInDocument());
 }
 
 //note: slightly different than routine with same name in DrawProjectSplit
@@ -450,6 +555,26 @@ TechDraw::GeometryObject* DrawViewPart::buildGeometryObject(TopoDS_Shape shape,
             viewAxis);
     }
 
+    extractHLRGeometry(go);
+    return go;
+}
+
+//! as buildGeometryObject, for a projection computed by ProjectionCache
+TechDraw::GeometryObject* DrawViewPart::buildGeometryFromProjection(const TechDraw::HLRResult& projection)
+{
+    TechDraw::GeometryObject* go = new TechDraw::GeometryObject(getNameInDocument(), this);
+    go->setIsoCount(IsoCount.getValue());
+    go->isPerspective(Perspective.getValue());
+    go->setFocus(Focus.getValue());
+    go->usePolygonHLR(CoarseView.getValue());
+    go->setHLRResult(projection);
+
+    extractHLRGeometry(go);
+    return go;
+}
+
+void DrawViewPart::extractHLRGeometry(TechDraw::GeometryObject* go)
+{
     go->extractGeometry(TechDraw::ecHARD,                   //always show the hard&outline visible lines
                         true);
     go->extractGeometry(TechDraw::ecOUTLINE,
@@ -490,7 +615,6 @@ TechDraw::GeometryObject* DrawViewPart::buildGeometryObject(TopoDS_Shape shape,
         Base::Console().Log("DVP::buildGO - NO extracted edges!\n");
     }
     bbox = go->calcBoundingBox();
-    return go;
 }
 
 //! make faces from the existing edge geometry
@@ -520,63 +644,7 @@ void DrawViewPart::extractFaces()
 
     //HLR algo does not provide all edge intersections for edge endpoints.
     //need to split long edges touched by Vertex of another edge
-    std::vector<splitPoint> splits;
-    std::vector<TopoDS_Edge>::iterator itOuter = nonZero.begin();
-    int iOuter = 0;
-    for (; itOuter != nonZero.end(); ++itOuter, iOuter++) {    //*** itOuter != nonZero.end() - 1
-        TopoDS_Vertex v1 = TopExp::FirstVertex((*itOuter));
-        TopoDS_Vertex v2 = TopExp::LastVertex((*itOuter));
-        Bnd_Box sOuter;
-        BRepBndLib::Add(*itOuter, sOuter);
-        sOuter.SetGap(0.1);
-        if (sOuter.IsVoid()) {
-            Base::Console().Log("DVP::Extract Faces - outer Bnd_Box is void for %s\n",getNameInDocument());
-            continue;
-        }
-        if (DrawUtil::isZeroEdge(*itOuter)) {
-            Base::Console().Log("DVP::extractFaces - outerEdge: %d is ZeroEdge\n",iOuter);   //this is not finding ZeroEdges
-            continue;  //skip zero length edges. shouldn't happen ;)
-        }
-        int iInner = 0;
-        std::vector<TopoDS_Edge>::iterator itInner = nonZero.begin();   //***sb itOuter + 1;
-        for (; itInner != nonZero.end(); ++itInner,iInner++) {
-            if (iInner == iOuter) {
-                continue;
-            }
-            if (DrawUtil::isZeroEdge((*itInner))) {
-                continue;  //skip zero length edges. shouldn't happen ;)
-            }
-
-            Bnd_Box sInner;
-            BRepBndLib::Add(*itInner, sInner);
-            sInner.SetGap(0.1);
-            if (sInner.IsVoid()) {
-                Base::Console().Log("INFO - DVP::Extract Faces - inner Bnd_Box is void for %s\n",getNameInDocument());
-                continue;
-            }
-            if (sOuter.IsOut(sInner)) {      //bboxes of edges don't intersect, don't bother
-                continue;
-            }
-
-            double param = -1;
-            if (DrawProjectSplit::isOnEdge((*itInner),v1,param,false)) {
-                gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
-                splitPoint s1;
-                s1.i = iInner;
-                s1.v = Base::Vector3d(pnt1.X(),pnt1.Y(),pnt1.Z());
-                s1.param = param;
-                splits.push_back(s1);
-            }
-            if (DrawProjectSplit::isOnEdge((*itInner),v2,param,false)) {
-                gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
-                splitPoint s2;
-                s2.i = iInner;
-                s2.v = Base::Vector3d(pnt2.X(),pnt2.Y(),pnt2.Z());
-                s2.param = param;
-                splits.push_back(s2);
-            }
-        } //inner loop
-    }   //outer loop
+    std::vector<splitPoint> splits = DrawProjectSplit::findSplitPoints(nonZero);
 
     std::vector<splitPoint> sorted = DrawProjectSplit::sortSplits(splits,true);
     auto last = std::unique(sorted.begin(), sorted.end(), DrawProjectSplit::splitEqual);  //duplicates to back
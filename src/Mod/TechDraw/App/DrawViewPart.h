@@ -60,6 +60,7 @@ class Part;
 namespace TechDraw
 {
 class GeometryObject;
+class HLRResult;
 class Vertex;
 class BaseGeom;
 class Face;
@@ -171,6 +172,8 @@ public:
     virtual TopoDS_Shape getSourceShapeFused(void) const; 
     virtual std::vector<TopoDS_Shape> getSourceShape2d(void) const;
 
+    void queueProjection(void);
+
 
     bool isIso(void) const;
 
@@ -216,8 +219,12 @@ protected:
     virtual void unsetupObject() override;
 
     virtual TechDraw::GeometryObject*  buildGeometryObject(TopoDS_Shape shape, gp_Ax2 viewAxis); //const??
+    TechDraw::GeometryObject*  buildGeometryFromProjection(const TechDraw::HLRResult& projection);
+    void extractHLRGeometry(TechDraw::GeometryObject* go);
     virtual TechDraw::GeometryObject*  makeGeometryForShape(TopoDS_Shape shape);   //const??
+    TopoDS_Shape scaleAndRotate(TopoDS_Shape centeredShape, gp_Ax2 viewAxis) const;
     void partExec(TopoDS_Shape shape);
+    void scheduleProjections(void);
     virtual void addShapes2d(void);
 
     void extractFaces();
@@ -45,12 +45,14 @@
 #endif
 #include <sstream>
 #include <cmath>
+#include <algorithm>
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
 
 #include "DrawUtil.h"
 #include "EdgeWalker.h"
+#include "GridIndex.h"
 
 using namespace TechDraw;
 using namespace boost;
@@ -102,6 +104,50 @@ void edgeVisitor::setGraph(TechDraw::graph& g)
 //separated by more than 2*Precision::Confusion (expected tolerance for 2 TopoDS_Vertex)
 #define EWTOLERANCE 0.00001    //arbitrary number that seems to give good results for drawing
 
+namespace {
+
+//! points closer than EWTOLERANCE always meet in a grid of these boxes
+Base::BoundBox2d toleranceBox(const gp_Pnt& p)
+{
+    return Base::BoundBox2d(p.X() - EWTOLERANCE, p.Y() - EWTOLERANCE,
+                            p.X() + EWTOLERANCE, p.Y() + EWTOLERANCE);
+}
+
+GridIndex makeVertexGrid(const std::vector<TopoDS_Vertex>& verts)
+{
+    Base::BoundBox2d extent;
+    extent.SetVoid();
+    for (auto& v: verts) {
+        gp_Pnt p = BRep_Tool::Pnt(v);
+        extent.Add(Base::Vector2d(p.X(), p.Y()));
+    }
+    GridIndex grid(extent, verts.size());
+    int idx = 0;
+    for (auto& v: verts) {
+        grid.add(idx, toleranceBox(BRep_Tool::Pnt(v)));
+        idx++;
+    }
+    return grid;
+}
+
+//! findUniqueVert looking only at the vertices in the cell of vx
+int findVertexInGrid(const TopoDS_Vertex& vx,
+                     const std::vector<TopoDS_Vertex>& verts,
+                     const GridIndex& grid,
+                     std::vector<int>& cell)
+{
+    gp_Pnt p = BRep_Tool::Pnt(vx);
+    grid.candidates(p.X(), p.Y(), cell);
+    for (int idx: cell) {     //in ascending order
+        if (DrawUtil::isSamePoint(verts[idx],vx,EWTOLERANCE)) {
+            return idx;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
 
 EdgeWalker::EdgeWalker()
 {
@@ -307,21 +353,40 @@ std::vector<TopoDS_Vertex> EdgeWalker:: makeUniqueVList(std::vector<TopoDS_Edge>
 {
     //Base::Console().Message("TRACE - EW::makeUniqueVList()\n");
     std::vector<TopoDS_Vertex> uniqueVert;
+    Base::BoundBox2d extent;
+    extent.SetVoid();
+    for(auto& e:edges) {
+        gp_Pnt p1 = BRep_Tool::Pnt(TopExp::FirstVertex(e));
+        gp_Pnt p2 = BRep_Tool::Pnt(TopExp::LastVertex(e));
+        extent.Add(Base::Vector2d(p1.X(), p1.Y()));
+        extent.Add(Base::Vector2d(p2.X(), p2.Y()));
+    }
+    //the unique vertices found so far
+    GridIndex grid(extent, 2 * edges.size());
+    std::vector<int> cell;
+    auto isUnique = [&](const TopoDS_Vertex& vx, const gp_Pnt& p) {
+        grid.candidates(p.X(), p.Y(), cell);
+        for (int idx: cell) {
+            if (DrawUtil::isSamePoint(uniqueVert[idx],vx,EWTOLERANCE))
+                return false;
+        }
+        return true;
+    };
     for(auto& e:edges) {
         TopoDS_Vertex v1 = TopExp::FirstVertex(e);
         TopoDS_Vertex v2 = TopExp::LastVertex(e);
-        bool addv1 = true;
-        bool addv2 = true;
-        for (auto v:uniqueVert) {
-            if (DrawUtil::isSamePoint(v,v1,EWTOLERANCE))
-                addv1 = false;
-            if (DrawUtil::isSamePoint(v,v2,EWTOLERANCE))
-                addv2 = false;
-        }
-        if (addv1)
+        gp_Pnt p1 = BRep_Tool::Pnt(v1);
+        gp_Pnt p2 = BRep_Tool::Pnt(v2);
+        bool addv1 = isUnique(v1, p1);
+        bool addv2 = isUnique(v2, p2);
+        if (addv1) {
+            grid.add(uniqueVert.size(), toleranceBox(p1));
             uniqueVert.push_back(v1);
-        if (addv2)
+        }
+        if (addv2) {
+            grid.add(uniqueVert.size(), toleranceBox(p2));
             uniqueVert.push_back(v2);
+        }
     }
     return uniqueVert;
 }
@@ -333,11 +398,13 @@ std::vector<WalkerEdge> EdgeWalker::makeWalkerEdges(std::vector<TopoDS_Edge> edg
 //    Base::Console().Message("TRACE - EW::makeWalkerEdges()\n");
     m_saveInEdges = edges;
     std::vector<WalkerEdge> walkerEdges;
+    GridIndex grid = makeVertexGrid(verts);
+    std::vector<int> cell;
     for (auto e:edges) {
         TopoDS_Vertex ev1 = TopExp::FirstVertex(e);
         TopoDS_Vertex ev2 = TopExp::LastVertex(e);
-        int v1dx = findUniqueVert(ev1, verts);
-        int v2dx = findUniqueVert(ev2, verts);
+        int v1dx = findVertexInGrid(ev1, verts, grid, cell);
+        int v2dx = findVertexInGrid(ev2, verts, grid, cell);
         WalkerEdge we;
         we.v1 = v1dx;
         we.v2 = v2dx;
@@ -411,25 +478,37 @@ std::vector<embedItem> EdgeWalker::makeEmbedding(const std::vector<TopoDS_Edge>
 //                            edges.size(),uniqueVList.size());
     std::vector<embedItem> result;
 
-    int iv = 0;
-    for (auto& v: uniqueVList) {
-        int ie = 0;
-        std::vector<incidenceItem> iiList;
-        for (auto& e: edges) {
-            double angle = 0;
-            if (DrawUtil::isFirstVert(e,v,EWTOLERANCE)) {
-                angle = DrawUtil::angleWithX(e,v,EWTOLERANCE);
-                incidenceItem ii(ie, angle, m_saveWalkerEdges[ie].ed);
-                iiList.push_back(ii);
-            } else if (DrawUtil::isLastVert(e,v,EWTOLERANCE)) {
-                angle = DrawUtil::angleWithX(e,v,EWTOLERANCE);
-                incidenceItem ii(ie, angle, m_saveWalkerEdges[ie].ed);
-                iiList.push_back(ii);
-            } else {
-                //Base::Console().Message("TRACE - EW::makeEmbedding - neither first nor last\n");
+    //edges incident to each vertex, in edge order. only the vertices near the
+    //ends of an edge are looked at.
+    GridIndex grid = makeVertexGrid(uniqueVList);
+    std::vector<std::vector<incidenceItem> > incidence(uniqueVList.size());
+    std::vector<int> touched;
+    std::vector<int> cell;
+    int ie = 0;
+    for (auto& e: edges) {
+        touched.clear();
+        TopoDS_Vertex ends[2] = { TopExp::FirstVertex(e), TopExp::LastVertex(e) };
+        for (auto& end: ends) {
+            gp_Pnt p = BRep_Tool::Pnt(end);
+            grid.candidates(p.X(), p.Y(), cell);
+            for (int iv: cell) {
+                if (DrawUtil::isSamePoint(uniqueVList[iv],end,EWTOLERANCE)) {
+                    touched.push_back(iv);
+                }
             }
-            ie++;
-       }
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (int iv: touched) {
+            double angle = DrawUtil::angleWithX(e,uniqueVList[iv],EWTOLERANCE);
+            incidenceItem ii(ie, angle, m_saveWalkerEdges[ie].ed);
+            incidence[iv].push_back(ii);
+        }
+        ie++;
+    }
+
+    int iv = 0;
+    for (auto& iiList: incidence) {
        //sort incidenceList by angle
        iiList = embedItem::sortIncidenceList(iiList,  false);
        embedItem embed(iv, iiList);
@@ -68,6 +68,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdarg>
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
@@ -89,6 +90,26 @@ struct EdgePoints {
     TopoDS_Edge edge;
 };
 
+void HLRResult::addError(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    messages.emplace_back(Base::ConsoleSingleton::MsgType_Err, buffer);
+}
+
+void HLRResult::addLog(const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    messages.emplace_back(Base::ConsoleSingleton::MsgType_Log, buffer);
+}
+
 GeometryObject::GeometryObject(const string& parent, TechDraw::DrawView* parentObj) :
     m_parentName(parent),
     m_parent(parentObj),
@@ -175,8 +196,72 @@ void GeometryObject::projectShape(const TopoDS_Shape& input,
                                   const gp_Ax2 viewAxis)
 {
 //    Base::Console().Message("GO::projectShape() - %s\n", m_parentName.c_str());
-   // Clear previous Geometry
+    HLRResult result = computeHLR(input, viewAxis, false,
+                                  m_isoCount, m_isPersp, m_focus, m_parentName);
+    setHLRResult(result);
+}
+
+//!set up a hidden line remover and project a shape with it
+void GeometryObject::projectShapeWithPolygonAlgo(const TopoDS_Shape& input,
+                                                 const gp_Ax2 viewAxis)
+{
+    HLRResult result = computeHLR(input, viewAxis, true,
+                                  m_isoCount, m_isPersp, m_focus, m_parentName);
+    setHLRResult(result);
+}
+
+//! the hidden line removal proper. Base::Console is not thread safe, so messages
+//! are collected in the result and reported by setHLRResult.
+HLRResult GeometryObject::computeHLR(const TopoDS_Shape& input,
+                                     const gp_Ax2 viewAxis,
+                                     bool usePolygonHLR,
+                                     int isoCount,
+                                     bool isPersp,
+                                     double focus,
+                                     const std::string& parentName)
+{
+    HLRResult result;
+    if (usePolygonHLR) {
+        projectShapeWithPolygonAlgo(input, viewAxis, isPersp, focus, parentName, result);
+    } else {
+        projectShape(input, viewAxis, isoCount, isPersp, focus, parentName, result);
+    }
+    return result;
+}
+
+void GeometryObject::setHLRResult(const HLRResult& result)
+{
+    // Clear previous Geometry
     clear();
+
+    visHard    = result.visHard;
+    visOutline = result.visOutline;
+    visSmooth  = result.visSmooth;
+    visSeam    = result.visSeam;
+    visIso     = result.visIso;
+    hidHard    = result.hidHard;
+    hidOutline = result.hidOutline;
+    hidSmooth  = result.hidSmooth;
+    hidSeam    = result.hidSeam;
+    hidIso     = result.hidIso;
+
+    for (auto& m: result.messages) {
+        if (m.first == Base::ConsoleSingleton::MsgType_Err) {
+            Base::Console().Error("%s", m.second.c_str());
+        } else {
+            Base::Console().Log("%s", m.second.c_str());
+        }
+    }
+}
+
+void GeometryObject::projectShape(const TopoDS_Shape& input,
+                                  const gp_Ax2 viewAxis,
+                                  int isoCount,
+                                  bool isPersp,
+                                  double focus,
+                                  const std::string& parentName,
+                                  HLRResult& result)
+{
 //    DrawUtil::dumpCS("GO::projectShape - VA in", viewAxis);    //debug
 
     auto start = chrono::high_resolution_clock::now();
@@ -184,9 +269,9 @@ void GeometryObject::projectShape(const TopoDS_Shape& input,
     Handle(HLRBRep_Algo) brep_hlr = NULL;
     try {
         brep_hlr = new HLRBRep_Algo();
-        brep_hlr->Add(input, m_isoCount);
-        if (m_isPersp) {
-            double fLength = std::max(Precision::Confusion(),m_focus);
+        brep_hlr->Add(input, isoCount);
+        if (isPersp) {
+            double fLength = std::max(Precision::Confusion(),focus);
             HLRAlgo_Projector projector( viewAxis, fLength );
             brep_hlr->Projector(projector);
         } else {
@@ -198,79 +283,79 @@ void GeometryObject::projectShape(const TopoDS_Shape& input,
 
     }
     catch (const Standard_Failure& e) {
-        Base::Console().Error("GO::projectShape - OCC error - %s - while projecting shape\n",
-                              e.GetMessageString());
+        result.addError("GO::projectShape - OCC error - %s - while projecting shape\n",
+                        e.GetMessageString());
         }
     catch (...) {
-        Base::Console().Error("GeometryObject::projectShape - unknown error occurred while projecting shape\n");
+        result.addError("GeometryObject::projectShape - unknown error occurred while projecting shape\n");
 //        throw Base::RuntimeError("GeometryObject::projectShape - unknown error occurred while projecting shape");
     }
 
     auto end   = chrono::high_resolution_clock::now();
     auto diff  = end - start;
     double diffOut = chrono::duration <double, milli> (diff).count();
-    Base::Console().Log("TIMING - %s GO spent: %.3f millisecs in HLRBRep_Algo & co\n",m_parentName.c_str(),diffOut);
+    result.addLog("TIMING - %s GO spent: %.3f millisecs in HLRBRep_Algo & co\n",parentName.c_str(),diffOut);
 
     start = chrono::high_resolution_clock::now();
 
     try {
         HLRBRep_HLRToShape hlrToShape(brep_hlr);
 
-        visHard    = hlrToShape.VCompound();
-        BRepLib::BuildCurves3d(visHard);
-        visHard = invertGeometry(visHard);
-//        BRepTools::Write(visHard, "GOvisHardi.brep");            //debug
+        result.visHard    = hlrToShape.VCompound();
+        BRepLib::BuildCurves3d(result.visHard);
+        result.visHard = invertGeometry(result.visHard);
+//        BRepTools::Write(result.visHard, "GOvisHardi.brep");            //debug
 
-        visSmooth  = hlrToShape.Rg1LineVCompound();
-        BRepLib::BuildCurves3d(visSmooth);
-        visSmooth = invertGeometry(visSmooth);
+        result.visSmooth  = hlrToShape.Rg1LineVCompound();
+        BRepLib::BuildCurves3d(result.visSmooth);
+        result.visSmooth = invertGeometry(result.visSmooth);
 
-        visSeam    = hlrToShape.RgNLineVCompound();
-        BRepLib::BuildCurves3d(visSeam);
-        visSeam = invertGeometry(visSeam);
+        result.visSeam    = hlrToShape.RgNLineVCompound();
+        BRepLib::BuildCurves3d(result.visSeam);
+        result.visSeam = invertGeometry(result.visSeam);
 
-        visOutline    = hlrToShape.OutLineVCompound();
-        BRepLib::BuildCurves3d(visOutline);
-        visOutline = invertGeometry(visOutline);
+        result.visOutline    = hlrToShape.OutLineVCompound();
+        BRepLib::BuildCurves3d(result.visOutline);
+        result.visOutline = invertGeometry(result.visOutline);
 
-        visIso     = hlrToShape.IsoLineVCompound();
-        BRepLib::BuildCurves3d(visIso);
-        visIso = invertGeometry(visIso);
+        result.visIso     = hlrToShape.IsoLineVCompound();
+        BRepLib::BuildCurves3d(result.visIso);
+        result.visIso = invertGeometry(result.visIso);
 
-        hidHard    = hlrToShape.HCompound();
-        BRepLib::BuildCurves3d(hidHard);
-        hidHard = invertGeometry(hidHard);
-//        BRepTools::Write(hidHard, "GOhidHardi.brep");            //debug
+        result.hidHard    = hlrToShape.HCompound();
+        BRepLib::BuildCurves3d(result.hidHard);
+        result.hidHard = invertGeometry(result.hidHard);
+//        BRepTools::Write(result.hidHard, "GOhidHardi.brep");            //debug
 
-        hidSmooth  = hlrToShape.Rg1LineHCompound();
-        BRepLib::BuildCurves3d(hidSmooth);
-        hidSmooth = invertGeometry(hidSmooth);
+        result.hidSmooth  = hlrToShape.Rg1LineHCompound();
+        BRepLib::BuildCurves3d(result.hidSmooth);
+        result.hidSmooth = invertGeometry(result.hidSmooth);
 
-        hidSeam    = hlrToShape.RgNLineHCompound();
-        BRepLib::BuildCurves3d(hidSeam);
-        hidSeam = invertGeometry(hidSeam);
+        result.hidSeam    = hlrToShape.RgNLineHCompound();
+        BRepLib::BuildCurves3d(result.hidSeam);
+        result.hidSeam = invertGeometry(result.hidSeam);
 
-        hidOutline = hlrToShape.OutLineHCompound();
-        BRepLib::BuildCurves3d(hidOutline);
-        hidOutline = invertGeometry(hidOutline);
+        result.hidOutline = hlrToShape.OutLineHCompound();
+        BRepLib::BuildCurves3d(result.hidOutline);
+        result.hidOutline = invertGeometry(result.hidOutline);
 
-        hidIso     = hlrToShape.IsoLineHCompound();
-        BRepLib::BuildCurves3d(hidIso);
-        hidIso = invertGeometry(hidIso);
+        result.hidIso     = hlrToShape.IsoLineHCompound();
+        BRepLib::BuildCurves3d(result.hidIso);
+        result.hidIso = invertGeometry(result.hidIso);
 
     }
     catch (const Standard_Failure& e) {
-        Base::Console().Error("GO::projectShape - OCC error - %s - while extracting edges\n",
-                              e.GetMessageString());
+        result.addError("GO::projectShape - OCC error - %s - while extracting edges\n",
+                        e.GetMessageString());
     }
     catch (...) {
-        Base::Console().Error("GO::projectShape - unknown error while extracting edges\n");
+        result.addError("GO::projectShape - unknown error while extracting edges\n");
 //        throw Base::RuntimeError("GeometryObject::projectShape - error occurred while extracting edges");
     }
     end   = chrono::high_resolution_clock::now();
     diff  = end - start;
     diffOut = chrono::duration <double, milli> (diff).count();
-    Base::Console().Log("TIMING - %s GO spent: %.3f millisecs in hlrToShape and BuildCurves\n",m_parentName.c_str(),diffOut);
+    result.addLog("TIMING - %s GO spent: %.3f millisecs in hlrToShape and BuildCurves\n",parentName.c_str(),diffOut);
 }
 
 //mirror a shape thru XZ plane for Qt's inverted Y coordinate
@@ -293,25 +378,32 @@ TopoDS_Shape GeometryObject::invertGeometry(const TopoDS_Shape s)
     return result;
 }
 
-//!set up a hidden line remover and project a shape with it
 void GeometryObject::projectShapeWithPolygonAlgo(const TopoDS_Shape& input,
-                                                 const gp_Ax2 viewAxis)
+                                                 const gp_Ax2 viewAxis,
+                                                 bool isPersp,
+                                                 double focus,
+                                                 const std::string& parentName,
+                                                 HLRResult& result)
 {
-    // Clear previous Geometry
-    clear();
-    
     //work around for Mantis issue #3332
     //if 3332 gets fixed in OCC, this will produce shifted views and will need
     //to be reverted.
     TopoDS_Shape inCopy;
-    if (!m_isPersp) {
-        gp_Pnt gCenter = findCentroid(input,
-                                      viewAxis);
-        Base::Vector3d motion(-gCenter.X(),-gCenter.Y(),-gCenter.Z());
-        inCopy = moveShape(input,motion);
-    } else {
-        BRepBuilderAPI_Copy BuilderCopy(input);
-        inCopy = BuilderCopy.Shape();
+    try {
+        if (!isPersp) {
+            gp_Pnt gCenter = findCentroid(input,
+                                          viewAxis);
+            gp_Trsf xlate;
+            xlate.SetTranslation(gp_Vec(-gCenter.X(),-gCenter.Y(),-gCenter.Z()));
+            BRepBuilderAPI_Transform mkTrf(input, xlate);
+            inCopy = mkTrf.Shape();
+        } else {
+            BRepBuilderAPI_Copy BuilderCopy(input);
+            inCopy = BuilderCopy.Shape();
+        }
+    }
+    catch (...) {
+        result.addLog("GeometryObject::projectShapeWithPolygonAlgo - move failed.\n");
     }
 
     auto start = chrono::high_resolution_clock::now();
@@ -329,8 +421,8 @@ void GeometryObject::projectShapeWithPolygonAlgo(const TopoDS_Shape& input,
         brep_hlrPoly = new HLRBRep_PolyAlgo();
         brep_hlrPoly->Load(inCopy);
 
-        if (m_isPersp) {
-            double fLength = std::max(Precision::Confusion(), m_focus);
+        if (isPersp) {
+            double fLength = std::max(Precision::Confusion(), focus);
             HLRAlgo_Projector projector(viewAxis, fLength);
             brep_hlrPoly->Projector(projector);
         }
@@ -341,11 +433,11 @@ void GeometryObject::projectShapeWithPolygonAlgo(const TopoDS_Shape& input,
         brep_hlrPoly->Update();
     }
     catch (const Standard_Failure& e) {
-        Base::Console().Error("GO::projectShapeWithPolygonAlgo - OCC error - %s - while projecting shape\n",
-                              e.GetMessageString());
+        result.addError("GO::projectShapeWithPolygonAlgo - OCC error - %s - while projecting shape\n",
+                        e.GetMessageString());
     }
     catch (...) {
-        Base::Console().Error("GO::projectShapeWithPolygonAlgo - unknown error while projecting shape\n");
+        result.addError("GO::projectShapeWithPolygonAlgo - unknown error while projecting shape\n");
 //        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo  - error occurred while projecting shape");
 //        Standard_Failure::Raise("GeometryObject::projectShapeWithPolygonAlgo  - error occurred while projecting shape");
     }
@@ -354,53 +446,53 @@ void GeometryObject::projectShapeWithPolygonAlgo(const TopoDS_Shape& input,
         HLRBRep_PolyHLRToShape polyhlrToShape;
         polyhlrToShape.Update(brep_hlrPoly);
 
-        visHard    = polyhlrToShape.VCompound();
-        BRepLib::BuildCurves3d(visHard);
-        visHard = invertGeometry(visHard);
-//        BRepTools::Write(visHard, "GOvisHardi.brep");            //debug
+        result.visHard    = polyhlrToShape.VCompound();
+        BRepLib::BuildCurves3d(result.visHard);
+        result.visHard = invertGeometry(result.visHard);
+//        BRepTools::Write(result.visHard, "GOvisHardi.brep");            //debug
 
-        visSmooth  = polyhlrToShape.Rg1LineVCompound();
-        BRepLib::BuildCurves3d(visSmooth);
-        visSmooth = invertGeometry(visSmooth);
+        result.visSmooth  = polyhlrToShape.Rg1LineVCompound();
+        BRepLib::BuildCurves3d(result.visSmooth);
+        result.visSmooth = invertGeometry(result.visSmooth);
 
-        visSeam    = polyhlrToShape.RgNLineVCompound();
-        BRepLib::BuildCurves3d(visSeam);
-        visSeam = invertGeometry(visSeam);
+        result.visSeam    = polyhlrToShape.RgNLineVCompound();
+        BRepLib::BuildCurves3d(result.visSeam);
+        result.visSeam = invertGeometry(result.visSeam);
 
-        visOutline    = polyhlrToShape.OutLineVCompound();
-        BRepLib::BuildCurves3d(visOutline);
-        visOutline = invertGeometry(visOutline);
+        result.visOutline    = polyhlrToShape.OutLineVCompound();
+        BRepLib::BuildCurves3d(result.visOutline);
+        result.visOutline = invertGeometry(result.visOutline);
 
-        hidHard    = polyhlrToShape.HCompound();
-        BRepLib::BuildCurves3d(hidHard);
-        hidHard = invertGeometry(hidHard);
-//        BRepTools::Write(hidHard, "GOhidHardi.brep");            //debug
+        result.hidHard    = polyhlrToShape.HCompound();
+        BRepLib::BuildCurves3d(result.hidHard);
+        result.hidHard = invertGeometry(result.hidHard);
+//        BRepTools::Write(result.hidHard, "GOhidHardi.brep");            //debug
 
-        hidSmooth  = polyhlrToShape.Rg1LineHCompound();
-        BRepLib::BuildCurves3d(hidSmooth);
-        hidSmooth = invertGeometry(hidSmooth);
+        result.hidSmooth  = polyhlrToShape.Rg1LineHCompound();
+        BRepLib::BuildCurves3d(result.hidSmooth);
+        result.hidSmooth = invertGeometry(result.hidSmooth);
 
-        hidSeam    = polyhlrToShape.RgNLineHCompound();
-        BRepLib::BuildCurves3d(hidSeam);
-        hidSeam = invertGeometry(hidSeam);
+        result.hidSeam    = polyhlrToShape.RgNLineHCompound();
+        BRepLib::BuildCurves3d(result.hidSeam);
+        result.hidSeam = invertGeometry(result.hidSeam);
 
-        hidOutline = polyhlrToShape.OutLineHCompound();
-        BRepLib::BuildCurves3d(hidOutline);
-        hidOutline = invertGeometry(hidOutline);
+        result.hidOutline = polyhlrToShape.OutLineHCompound();
+        BRepLib::BuildCurves3d(result.hidOutline);
+        result.hidOutline = invertGeometry(result.hidOutline);
     }
     catch (const Standard_Failure& e) {
-        Base::Console().Error("GO::projectShapeWithPolygonAlgo - OCC error - %s - while extracting edges\n",
-                              e.GetMessageString());
+        result.addError("GO::projectShapeWithPolygonAlgo - OCC error - %s - while extracting edges\n",
+                        e.GetMessageString());
     }
     catch (...) {
-        Base::Console().Error("GO::projectShapeWithPolygonAlgo - - error occurred while extracting edges\n");
+        result.addError("GO::projectShapeWithPolygonAlgo - - error occurred while extracting edges\n");
 //        throw Base::RuntimeError("GeometryObject::projectShapeWithPolygonAlgo  - error occurred while extracting edges");
 //        Standard_Failure::Raise("GeometryObject::projectShapeWithPolygonAlgo - error occurred while extracting edges");
     }
     auto end = chrono::high_resolution_clock::now();
     auto diff = end - start;
     double diffOut = chrono::duration <double, milli>(diff).count();
-    Base::Console().Log("TIMING - %s GO spent: %.3f millisecs in HLRBRep_PolyAlgo & co\n", m_parentName.c_str(), diffOut);
+    result.addLog("TIMING - %s GO spent: %.3f millisecs in HLRBRep_PolyAlgo & co\n", parentName.c_str(), diffOut);
 }
 
 TopoDS_Shape GeometryObject::projectFace(const TopoDS_Shape &face,
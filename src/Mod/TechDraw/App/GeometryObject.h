@@ -28,9 +28,11 @@
 #include <gp_Pnt.hxx>
 #include <gp_Ax2.hxx>
 
+#include <Base/Console.h>
 #include <Base/Vector3D.h>
 #include <Base/BoundBox.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Geometry.h"
@@ -92,6 +94,29 @@ gp_Ax2 TechDrawExport legacyViewAxis1(const Base::Vector3d origin,
                                      const Base::Vector3d& direction,
                                      const bool flip=true);
 
+//! Output of the hidden line removal. It does not refer to any view, so it can be
+//! computed in a worker thread and shared by views with the same projection.
+class TechDrawExport HLRResult
+{
+public:
+    void addError(const char* format, ...);
+    void addLog(const char* format, ...);
+
+    TopoDS_Shape visHard;
+    TopoDS_Shape visOutline;
+    TopoDS_Shape visSmooth;
+    TopoDS_Shape visSeam;
+    TopoDS_Shape visIso;
+    TopoDS_Shape hidHard;
+    TopoDS_Shape hidOutline;
+    TopoDS_Shape hidSmooth;
+    TopoDS_Shape hidSeam;
+    TopoDS_Shape hidIso;
+
+    //! Console output of the computation, reported by GeometryObject::setHLRResult
+    std::vector<std::pair<Base::ConsoleSingleton::FreeCAD_ConsoleMsgType, std::string> > messages;
+};
+
 class TechDrawExport GeometryObject
 {
 public:
@@ -116,6 +141,16 @@ public:
                       const gp_Ax2 viewAxis);
     void projectShapeWithPolygonAlgo(const TopoDS_Shape &input,
                                      const gp_Ax2 viewAxis);
+    //! runs the hidden line removal without touching any GeometryObject or
+    //! Base::Console, so it may be called from a worker thread
+    static HLRResult computeHLR(const TopoDS_Shape &input,
+                                const gp_Ax2 viewAxis,
+                                bool usePolygonHLR,
+                                int isoCount,
+                                bool isPersp,
+                                double focus,
+                                const std::string& parentName);
+    void setHLRResult(const HLRResult& result);
     TopoDS_Shape projectFace(const TopoDS_Shape &face,
                              const gp_Ax2 CS);
 
@@ -131,7 +166,7 @@ public:
     void setFocus(double f) { m_focus = f; }
     double getFocus(void) { return m_focus; }
     void pruneVertexGeom(Base::Vector3d center, double radius);
-    TopoDS_Shape invertGeometry(const TopoDS_Shape s);
+    static TopoDS_Shape invertGeometry(const TopoDS_Shape s);
 
     TopoDS_Shape getVisHard(void)    { return visHard; }
     TopoDS_Shape getVisOutline(void) { return visOutline; }
@@ -179,6 +214,20 @@ protected:
     TopoDS_Shape hidSeam;
     TopoDS_Shape hidIso;
 
+    static void projectShape(const TopoDS_Shape &input,
+                             const gp_Ax2 viewAxis,
+                             int isoCount,
+                             bool isPersp,
+                             double focus,
+                             const std::string& parentName,
+                             HLRResult& result);
+    static void projectShapeWithPolygonAlgo(const TopoDS_Shape &input,
+                                            const gp_Ax2 viewAxis,
+                                            bool isPersp,
+                                            double focus,
+                                            const std::string& parentName,
+                                            HLRResult& result);
+
     void addGeomFromCompound(TopoDS_Shape edgeCompound, edgeClass category, bool visible);
     TechDraw::DrawViewDetail* isParentDetail(void);
 
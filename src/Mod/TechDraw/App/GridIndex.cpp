@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD Developers                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <iterator>
+#endif
+
+#include "GridIndex.h"
+
+using namespace TechDraw;
+
+namespace {
+// keeps the grid small for views with few, widely spread items
+const int MaxGridSize = 1024;
+// items covering more cells are checked for every point instead
+const int MaxCellsPerItem = 64;
+}
+
+GridIndex::GridIndex(const Base::BoundBox2d& extent, std::size_t count) :
+    m_minX(extent.MinX),
+    m_minY(extent.MinY),
+    m_cellSize(1.0),
+    m_columns(1),
+    m_rows(1)
+{
+    double width = std::max(extent.MaxX - extent.MinX, 0.0);
+    double height = std::max(extent.MaxY - extent.MinY, 0.0);
+    double size = std::max(width, height);
+    if (count > 0 && size > 0.0) {
+        //about one item per cell
+        double area = std::max(width * height, size * size / MaxGridSize);
+        m_cellSize = std::max(std::sqrt(area / count), size / MaxGridSize);
+        m_columns = std::min(MaxGridSize, static_cast<int>(width / m_cellSize) + 1);
+        m_rows = std::min(MaxGridSize, static_cast<int>(height / m_cellSize) + 1);
+    }
+    m_cells.resize(static_cast<std::size_t>(m_columns) * m_rows);
+}
+
+int GridIndex::column(double x) const
+{
+    double c = std::floor((x - m_minX) / m_cellSize);
+    return static_cast<int>(std::min(std::max(c, 0.0), m_columns - 1.0));
+}
+
+int GridIndex::row(double y) const
+{
+    double r = std::floor((y - m_minY) / m_cellSize);
+    return static_cast<int>(std::min(std::max(r, 0.0), m_rows - 1.0));
+}
+
+void GridIndex::add(int index, const Base::BoundBox2d& box)
+{
+    int firstColumn = column(box.MinX);
+    int lastColumn = column(box.MaxX);
+    int firstRow = row(box.MinY);
+    int lastRow = row(box.MaxY);
+    if ((lastColumn - firstColumn + 1) * (lastRow - firstRow + 1) > MaxCellsPerItem) {
+        m_large.push_back(index);
+        return;
+    }
+    for (int r = firstRow; r <= lastRow; r++) {
+        for (int c = firstColumn; c <= lastColumn; c++) {
+            m_cells[r * m_columns + c].push_back(index);
+        }
+    }
+}
+
+void GridIndex::candidates(double x, double y, std::vector<int>& result) const
+{
+    const std::vector<int>& cell = m_cells[row(y) * m_columns + column(x)];
+    result.clear();
+    std::merge(cell.begin(), cell.end(), m_large.begin(), m_large.end(),
+               std::back_inserter(result));
+}
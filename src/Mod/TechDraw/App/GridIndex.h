@@ -0,0 +1,70 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD Developers                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef _TECHDRAW_GRIDINDEX_H
+#define _TECHDRAW_GRIDINDEX_H
+
+#include <cstddef>
+#include <vector>
+
+#include <Base/Tools2D.h>
+
+namespace TechDraw
+{
+
+/** Uniform grid over the XY plane of a view.
+ *
+ * Items are entered with their 2d bounding box, and the grid answers which
+ * items may contain a point. This replaces comparing every projected edge or
+ * vertex with every other one.
+ *
+ * Items covering many cells (e.g. a border line spanning the view) are not
+ * entered in the cells but kept in a list that is part of every answer, so
+ * the memory used stays proportional to the number of items.
+ */
+class TechDrawExport GridIndex
+{
+public:
+    //! extent covers the items to be added, count is about how many there will be
+    GridIndex(const Base::BoundBox2d& extent, std::size_t count);
+
+    //! items have to be added in ascending index order
+    void add(int index, const Base::BoundBox2d& box);
+    //! fills result with the items whose box may contain (x, y), in ascending order
+    void candidates(double x, double y, std::vector<int>& result) const;
+
+private:
+    int column(double x) const;
+    int row(double y) const;
+
+    double m_minX;
+    double m_minY;
+    double m_cellSize;
+    int m_columns;
+    int m_rows;
+    std::vector<std::vector<int> > m_cells;
+    std::vector<int> m_large;
+};
+
+} //namespace TechDraw
+
+#endif  // #ifndef _TECHDRAW_GRIDINDEX_H
@@ -0,0 +1,205 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD Developers                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <chrono>
+# include <iterator>
+# include <list>
+# include <mutex>
+# include <Precision.hxx>
+#endif
+
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "ProjectionCache.h"
+
+using namespace TechDraw;
+
+namespace {
+
+class ProjectionTask : public QRunnable
+{
+public:
+    ProjectionTask(const ProjectionCache::Key& key, const TopoDS_Shape& input,
+                   const std::string& parentName)
+        : input(input), viewAxis(key.viewAxis), usePolygonHLR(key.usePolygonHLR),
+          isoCount(key.isoCount), isPersp(key.isPersp), focus(key.focus),
+          parentName(parentName)
+    {
+        result = promise.get_future().share();
+    }
+
+    virtual void run() override
+    {
+        try {
+            promise.set_value(std::make_shared<const HLRResult>(
+                GeometryObject::computeHLR(input, viewAxis, usePolygonHLR,
+                                           isoCount, isPersp, focus, parentName)));
+        }
+        catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+    TopoDS_Shape input;
+    gp_Ax2 viewAxis;
+    bool usePolygonHLR;
+    int isoCount;
+    bool isPersp;
+    double focus;
+    std::string parentName;
+    std::promise<std::shared_ptr<const HLRResult> > promise;
+    ProjectionCache::Future result;
+};
+
+struct ProjectionEntry
+{
+    ProjectionCache::Key key;
+    ProjectionCache::Future result;
+};
+
+const std::size_t MaxProjectionEntries = 64;
+
+std::mutex ProjectionMutex;
+// most recently used first
+std::list<ProjectionEntry> ProjectionEntries;
+
+QThreadPool *projectionPool()
+{
+    static QThreadPool *pool;
+    if (!pool) {
+        pool = new QThreadPool;
+    }
+    return pool;
+}
+
+bool isReady(const ProjectionCache::Future& future)
+{
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void addEntry(const ProjectionCache::Key& key, const ProjectionCache::Future& result)
+{
+    ProjectionEntries.push_front(ProjectionEntry{key, result});
+    if (ProjectionEntries.size() <= MaxProjectionEntries) {
+        return;
+    }
+    // pending jobs are kept, their views are about to ask for them
+    for (auto it = std::prev(ProjectionEntries.end()); it != ProjectionEntries.begin(); --it) {
+        if (isReady(it->result)) {
+            ProjectionEntries.erase(it);
+            break;
+        }
+    }
+}
+
+} // namespace
+
+ProjectionCache::Key::Key() :
+    scale(1.0),
+    rotation(0.0),
+    usePolygonHLR(false),
+    isoCount(0),
+    isPersp(false),
+    focus(0.0)
+{
+}
+
+bool ProjectionCache::Key::operator==(const Key& other) const
+{
+    if (scale != other.scale ||
+        rotation != other.rotation ||
+        usePolygonHLR != other.usePolygonHLR ||
+        isoCount != other.isoCount ||
+        isPersp != other.isPersp ||
+        focus != other.focus ||
+        sources.size() != other.sources.size()) {
+        return false;
+    }
+    if (!viewAxis.Location().IsEqual(other.viewAxis.Location(), Precision::Confusion()) ||
+        !viewAxis.Direction().IsEqual(other.viewAxis.Direction(), Precision::Angular()) ||
+        !viewAxis.XDirection().IsEqual(other.viewAxis.XDirection(), Precision::Angular())) {
+        return false;
+    }
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        if (!sources[i].IsEqual(other.sources[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ProjectionCache::Future ProjectionCache::find(const Key& key)
+{
+    std::lock_guard<std::mutex> lock(ProjectionMutex);
+
+    for (auto it = ProjectionEntries.begin(); it != ProjectionEntries.end(); ++it) {
+        if (it->key == key) {
+            ProjectionEntries.splice(ProjectionEntries.begin(), ProjectionEntries, it);
+            return it->result;
+        }
+    }
+    return Future();
+}
+
+ProjectionCache::Future ProjectionCache::computeAsync(const Key& key, const TopoDS_Shape& input,
+                                                      const std::string& parentName)
+{
+    ProjectionTask* task = new ProjectionTask(key, input, parentName);
+    Future result = task->result;
+    {
+        std::lock_guard<std::mutex> lock(ProjectionMutex);
+        addEntry(key, result);
+    }
+    projectionPool()->start(task);
+    return result;
+}
+
+ProjectionCache::Future ProjectionCache::compute(const Key& key, const TopoDS_Shape& input,
+                                                 const std::string& parentName)
+{
+    std::promise<std::shared_ptr<const HLRResult> > promise;
+    promise.set_value(std::make_shared<const HLRResult>(
+        GeometryObject::computeHLR(input, key.viewAxis, key.usePolygonHLR,
+                                   key.isoCount, key.isPersp, key.focus, parentName)));
+    Future result = promise.get_future().share();
+
+    std::lock_guard<std::mutex> lock(ProjectionMutex);
+    addEntry(key, result);
+    return result;
+}
+
+void ProjectionCache::clear()
+{
+    std::lock_guard<std::mutex> lock(ProjectionMutex);
+
+    for (auto it = ProjectionEntries.begin(); it != ProjectionEntries.end();) {
+        if (isReady(it->result)) {
+            it = ProjectionEntries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD Developers                             *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef _TECHDRAW_PROJECTIONCACHE_H
+#define _TECHDRAW_PROJECTIONCACHE_H
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <TopoDS_Shape.hxx>
+#include <gp_Ax2.hxx>
+
+#include "GeometryObject.h"
+
+namespace TechDraw
+{
+
+/** Hidden line removal results of views.
+ *
+ * A result is kept for the source shapes it was computed from, so changing
+ * anything about a view that does not affect its projection (moving it,
+ * editing its label, ...) does not run HLR again. The HLR of views that are
+ * waiting for a recompute can be queued in worker threads, so the views of a
+ * page are projected concurrently. Each job gets its own copy of the source
+ * shapes, nothing is shared with the document or with other jobs.
+ */
+class TechDrawExport ProjectionCache
+{
+public:
+    //! the source shapes and everything else that determines the projection
+    struct TechDrawExport Key
+    {
+        Key();
+        bool operator==(const Key& other) const;
+
+        std::vector<TopoDS_Shape> sources;     //not copied, compared by identity
+        gp_Ax2 viewAxis;
+        double scale;
+        double rotation;
+        bool usePolygonHLR;
+        int isoCount;
+        bool isPersp;
+        double focus;
+    };
+
+    typedef std::shared_future<std::shared_ptr<const HLRResult> > Future;
+
+    //! the pending or finished projection for key, or an invalid future
+    static Future find(const Key& key);
+    /** queue the projection of input in a worker thread
+     * input has to be centered, scaled and rotated as for key and must not be
+     * used by anything else while the job runs.
+     */
+    static Future computeAsync(const Key& key, const TopoDS_Shape& input,
+                               const std::string& parentName);
+    //! project input in the calling thread and remember the result
+    static Future compute(const Key& key, const TopoDS_Shape& input,
+                          const std::string& parentName);
+    //! forget all finished projections
+    static void clear();
+};
+
+} //namespace TechDraw
+
+#endif  // #ifndef _TECHDRAW_PROJECTIONCACHE_H
@@ -23,6 +23,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <sstream>
 #endif
 
@@ -98,10 +99,34 @@ std::vector<TopoDS_Shape> ShapeExtractor::getShapes2d(const std::vector<App::Doc
     return shapes2d;
 }
 
+//! copies of the source shapes, in a compound
 TopoDS_Shape ShapeExtractor::getShapes(const std::vector<App::DocumentObject*> links)
 {
 //    Base::Console().Message("SE::getShapes() - links in: %d\n", links.size());
     TopoDS_Shape result;
+    std::vector<TopoDS_Shape> sourceShapes = getShapeList(links);
+
+    BRep_Builder builder;
+    TopoDS_Compound comp;
+    builder.MakeCompound(comp);
+    for (auto& s:sourceShapes) {
+        BRepBuilderAPI_Copy BuilderCopy(s);
+        TopoDS_Shape shape = BuilderCopy.Shape();
+        builder.Add(comp, shape);
+    }
+    //it appears that an empty compound is !IsNull(), so we need to check a different way 
+    //if we added anything to the compound.
+    if (sourceShapes.empty()) {
+        Base::Console().Error("SE::getSourceShapes - source shape is empty!\n");
+    } else {
+        result = comp;
+    }
+    return result;
+}
+
+//! the source shapes themselves, not copied. Used to tell if the sources have changed.
+std::vector<TopoDS_Shape> ShapeExtractor::getShapeList(const std::vector<App::DocumentObject*> links)
+{
     std::vector<TopoDS_Shape> sourceShapes;
 
     for (auto& l:links) {
@@ -132,27 +157,11 @@ TopoDS_Shape ShapeExtractor::getShapes(const std::vector<App::DocumentObject*> l
         }
     }
 
-    BRep_Builder builder;
-    TopoDS_Compound comp;
-    builder.MakeCompound(comp);
-    bool found = false;
-    for (auto& s:sourceShapes) {
-        if (s.IsNull()) {
-            continue;    //has no shape
-        }
-        found = true;
-        BRepBuilderAPI_Copy BuilderCopy(s);
-        TopoDS_Shape shape = BuilderCopy.Shape();
-        builder.Add(comp, shape);
-    }
-    //it appears that an empty compound is !IsNull(), so we need to check a different way 
-    //if we added anything to the compound.
-    if (!found) {
-        Base::Console().Error("SE::getSourceShapes - source shape is empty!\n");
-    } else {
-        result = comp;
-    }
-    return result;
+    //drop sources that have no shape
+    sourceShapes.erase(std::remove_if(sourceShapes.begin(), sourceShapes.end(),
+                                      [](const TopoDS_Shape& s) { return s.IsNull(); }),
+                       sourceShapes.end());
+    return sourceShapes;
 }
 
 std::vector<TopoDS_Shape> ShapeExtractor::getXShapes(const App::Link* xLink)
@@ -46,6 +46,7 @@ class TechDrawExport ShapeExtractor
 {
 public:
     static TopoDS_Shape getShapes(const std::vector<App::DocumentObject*> links); 
+    static std::vector<TopoDS_Shape> getShapeList(const std::vector<App::DocumentObject*> links);
     static std::vector<TopoDS_Shape> getShapes2d(const std::vector<App::DocumentObject*> links);
     static std::vector<TopoDS_Shape> getXShapes(const App::Link* xLink);
     static std::vector<TopoDS_Shape> getShapesFromObject(const App::DocumentObject* docObj);
@@ -40,6 +40,21 @@ def DVPartTest():
     rc = False
     if ("Up-to-date" in view.State):
         rc = True
+
+    # a second view of the same source is projected along with the first one,
+    # moving a view reuses its projection
+    view2 = FreeCAD.ActiveDocument.addObject('TechDraw::DrawViewPart','View2')
+    page.addView(view2)
+    view2.Source = [box]
+    view2.Direction = FreeCAD.Vector(1.0, 0.0, 0.0)
+    edgeCount = len(view.getVisibleEdges())
+    view.X = 20.0
+    view.touch()
+    FreeCAD.ActiveDocument.recompute()
+    if len(view.getVisibleEdges()) != edgeCount or len(view2.getVisibleEdges()) == 0:
+        rc = False
+    if not ("Up-to-date" in view2.State):
+        rc = False
     FreeCAD.closeDocument("TDPart")
     return rc
 
@@ -19,7 +19,7 @@
 #   USA                                                                   *
 #**************************************************************************
 
-import FreeCAD, os, sys, unittest, Part
+import FreeCAD, os, sys, unittest, Part, math
 import Measure
 import TechDraw
 import time
@@ -94,3 +94,39 @@ class TechDrawTestCases(unittest.TestCase):
             print("TD DrawViewBalloon test passed")
         else:
             print("TD DrawViewBalloon test failed")
+
+    def testSplitPoints(self):
+        V = App.Vector
+        line = lambda p1, p2: Part.LineSegment(p1, p2).toShape()
+        # a border spanning the view, with the feet of many short edges on it
+        edges = [line(V(0, 0, 0), V(400, 0, 0))]
+        edges += [line(V(2 * i + 1, 0, 0), V(2 * i + 1, 5, 0)) for i in range(200)]
+        # a diagonal whose box covers the whole view, and an edge ending on it
+        edges.append(line(V(0, -20, 0), V(400, 20, 0)))
+        edges.append(line(V(100, -10, 0), V(100, -15, 0)))
+        # an edge ending inside an arc
+        arc = Part.ArcOfCircle(Part.Circle(V(150, 30, 0), V(0, 0, 1), 5), 0, math.pi)
+        edges.append(arc.toShape())
+        edges.append(line(V(150, 35, 0), V(150, 45, 0)))
+
+        # what comparing every edge with every other one finds
+        expected = []
+        for i, outer in enumerate(edges):
+            ends = [outer.valueAt(outer.FirstParameter), outer.valueAt(outer.LastParameter)]
+            for j, inner in enumerate(edges):
+                if j == i:
+                    continue
+                innerEnds = [inner.valueAt(inner.FirstParameter), inner.valueAt(inner.LastParameter)]
+                for p in ends:
+                    if inner.distToShape(Part.Vertex(p))[0] >= 1e-7:
+                        continue
+                    if any(p.distanceToPoint(e) < 2e-7 for e in innerEnds):
+                        continue
+                    expected.append((j, p))
+        self.assertEqual(len(expected), 202)
+
+        splits = TechDraw.findSplitPoints(edges)
+        self.assertEqual([s[0] for s in splits], [e[0] for e in expected])
+        for (j, point, param), (_, p) in zip(splits, expected):
+            self.assertAlmostEqual(point.distanceToPoint(p), 0, 7)
+            self.assertAlmostEqual(edges[j].valueAt(param).distanceToPoint(p), 0, 6)
@@ -237,6 +237,26 @@ class DocumentBasicCases(unittest.TestCase):
       self.failUnless(False)
     del L2
 
+  def testFindObjects(self):
+    L1 = self.Doc.addObject("App::FeatureTest","Find_1")
+    L2 = self.Doc.addObject("App::FeaturePython","Find_2")
+    L3 = self.Doc.addObject("App::FeatureTest","Find_3")
+    L4 = self.Doc.addObject("App::DocumentObjectGroup","Find_4")
+    self.assertEqual(self.Doc.findObjects(), self.Doc.Objects)
+    self.assertEqual(self.Doc.findObjects("App::FeatureTest"), [L1, L3])
+    self.assertEqual(self.Doc.findObjects("App::GeoFeature"), [])
+    self.assertEqual(self.Doc.findObjects("App::DocumentObject", "Find_[23]"), [L2, L3])
+    self.assertEqual(self.Doc.findObjects("App::DocumentObjectGroup"), [L4])
+
+    self.Doc.UndoMode = 1
+    self.Doc.openTransaction("Find")
+    self.Doc.removeObject(L1.Name)
+    self.Doc.commitTransaction()
+    self.assertEqual(self.Doc.findObjects("App::FeatureTest"), [L3])
+    self.Doc.undo()
+    self.assertEqual(self.Doc.findObjects("App::FeatureTest"), [L3, L1])
+    self.assertEqual(self.Doc.findObjects(), self.Doc.Objects)
+
   def testExtensions(self):
     #we try to create a normal python object and add an extension to it
     obj = self.Doc.addObject("App::DocumentObject", "Extension_1")
@@ -492,6 +512,114 @@ class DocumentSaveRestoreCases(unittest.TestCase):
 
     FreeCAD.closeDocument("SaveRestoreExtensions")
 
+  def testParallelCompression(self):
+    import zipfile
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    parallel = param.GetBool("ParallelCompression", False)
+    perFile = param.GetBool("PerFileCompression", False)
+    try:
+      import Points
+    except ImportError:
+      Points = None
+    try:
+      SaveName = self.TempPath + os.sep + "ParallelCompression.FCStd"
+      self.Doc.Label_1.Link = self.Doc.Label_2
+      if Points:
+        pts = Points.Points([(i,2*i,3*i) for i in range(1000)])
+        self.Doc.addObject("Points::Feature", "Cloud").Points = pts
+      for parallelOn, perFileOn in [(False, False), (False, True), (True, False), (True, True)]:
+        param.SetBool("ParallelCompression", parallelOn)
+        param.SetBool("PerFileCompression", perFileOn)
+        self.Doc.saveAs(SaveName)
+        FreeCAD.closeDocument(self.Doc.Name)
+        self.Doc = FreeCAD.open(SaveName)
+        self.failUnless(self.Doc.Label_1.Link == self.Doc.Label_2)
+        if Points:
+          cloud = self.Doc.Cloud.Points
+          self.failUnless(cloud.CountPoints == 1000)
+          self.failUnless(cloud.Points[10] == FreeCAD.Vector(10,20,30))
+          # point kernels ask to be stored uncompressed, which is only done on
+          # request and in a raw entry, and then memory mapped on restore
+          with zipfile.ZipFile(SaveName) as archive:
+            entries = [info for info in archive.infolist() if info.filename.startswith("Cloud")]
+          self.failUnless(len(entries) == 1)
+          if parallelOn and perFileOn:
+            self.failUnless(entries[0].compress_type == zipfile.ZIP_STORED)
+          elif not parallelOn:
+            self.failUnless(entries[0].compress_type == zipfile.ZIP_DEFLATED)
+    finally:
+      param.SetBool("ParallelCompression", parallel)
+      param.SetBool("PerFileCompression", perFile)
+
+  def testLazyRestore(self):
+    try:
+      import Points
+    except ImportError:
+      return
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    lazy = param.GetBool("LazyRestore", False)
+    param.SetBool("LazyRestore", True)
+    try:
+      SaveName = self.TempPath + os.sep + "LazyRestore.FCStd"
+      pts = Points.Points([(i,2*i,3*i) for i in range(100)])
+      self.Doc.addObject("Points::Feature", "Cloud").Points = pts
+      self.Doc.addObject("Points::Feature", "Untouched").Points = pts
+      self.Doc.saveAs(SaveName)
+      FreeCAD.closeDocument(self.Doc.Name)
+      self.Doc = FreeCAD.open(SaveName)
+      self.failUnless(self.Doc.Cloud.Points.CountPoints == 100)
+      self.failUnless(self.Doc.Cloud.Points.Points[1] == FreeCAD.Vector(1,2,3))
+      # saving over the project file must keep the data not read yet
+      self.Doc.save()
+      FreeCAD.closeDocument(self.Doc.Name)
+      self.Doc = FreeCAD.open(SaveName)
+      self.failUnless(self.Doc.Untouched.Points.CountPoints == 100)
+    finally:
+      param.SetBool("LazyRestore", lazy)
+
+  def testLazyRestoreChangedArchive(self):
+    try:
+      import Points
+    except ImportError:
+      return
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    lazy = param.GetBool("LazyRestore", False)
+    param.SetBool("LazyRestore", True)
+    try:
+      SaveName = self.TempPath + os.sep + "LazyRestoreChanged.FCStd"
+      OtherName = self.TempPath + os.sep + "LazyRestoreOther.FCStd"
+      if os.path.exists(OtherName):
+        os.remove(OtherName)
+      pts = Points.Points([(i,2*i,3*i) for i in range(100)])
+      self.Doc.addObject("Points::Feature", "Cloud").Points = pts
+      self.Doc.saveAs(SaveName)
+      FreeCAD.closeDocument(self.Doc.Name)
+      self.Doc = FreeCAD.open(SaveName)
+      # replace the archive before the points are read
+      with open(SaveName, "wb") as f:
+        f.write(b"replaced")
+      # neither saving over the archive nor to another file may write the
+      # points that couldn't be read
+      with self.assertRaises(Exception):
+        self.Doc.save()
+      with self.assertRaises(Exception):
+        self.Doc.saveAs(OtherName)
+      with open(SaveName, "rb") as f:
+        self.failUnless(f.read() == b"replaced")
+      self.failIf(os.path.exists(OtherName))
+      # the failure sticks, the data stays empty and saving keeps failing
+      self.failUnless(self.Doc.Cloud.Points.CountPoints == 0)
+      with self.assertRaises(Exception):
+        self.Doc.save()
+      # replacing the data drops the file that couldn't be read
+      self.Doc.Cloud.Points = pts
+      self.Doc.saveAs(OtherName)
+      FreeCAD.closeDocument(self.Doc.Name)
+      self.Doc = FreeCAD.open(OtherName)
+      self.failUnless(self.Doc.Cloud.Points.CountPoints == 100)
+    finally:
+      param.SetBool("LazyRestore", lazy)
+
   def testPersistenceContentDump(self):
     #test smallest level... property
     self.Doc.Label_1.Vector = (1,2,3)
@@ -518,8 +646,8 @@ class DocumentSaveRestoreCases(unittest.TestCase):
     FreeCAD.closeDocument("DumpTest")
 
   def tearDown(self):
-    #closing doc
-    FreeCAD.closeDocument("SaveRestoreTests")
+    #closing doc, it is named after the file if it has been reopened
+    FreeCAD.closeDocument(self.Doc.Name)
 
 class DocumentRecomputeCases(unittest.TestCase):
   def setUp(self):
@@ -608,6 +736,121 @@ class DocumentRecomputeCases(unittest.TestCase):
     self.Doc.removeObject(L7.Name)
     self.Doc.removeObject(L8.Name)
 
+  def testDependencyListCache(self):
+    self.L1.Link = self.L2
+    self.Doc.recompute()
+    self.Doc.resetRecomputeStatistics()
+    for i in range(3):
+      self.L2.Integer = i
+      self.Doc.recompute()
+    stats = self.Doc.RecomputeStatistics
+    self.failUnless(stats["RecomputeCount"] == 3)
+    self.failUnless(stats["DependencyListHits"] == 3)
+    self.failUnless(stats["DependencyListMisses"] == 0)
+    # changing a link must rebuild the list
+    self.L2.Link = self.L3
+    self.Doc.recompute()
+    stats = self.Doc.RecomputeStatistics
+    self.failUnless(stats["DependencyListMisses"] == 1)
+    self.failUnless(self.L2.ExecCount == 5)
+
+  def testRecomputeProfile(self):
+    import json
+    self.L1.Link = self.L2
+    self.L2.Link = self.L3
+    self.Doc.recompute()
+    self.Doc.RecomputeProfiling = True
+    try:
+      self.L3.touch()
+      self.Doc.recompute()
+      profile = self.Doc.RecomputeProfile
+      self.failUnless([entry["Name"] for entry in profile] == [self.L3.Name, self.L2.Name, self.L1.Name])
+      self.failUnless(profile[0]["Trigger"] == "")
+      self.failUnless(profile[1]["Trigger"] == self.L3.Name)
+      self.failUnless(profile[2]["Trigger"] == self.L2.Name)
+      self.failUnless(not any(entry["Error"] for entry in profile))
+      trace = json.loads(self.Doc.exportRecomputeProfile())
+      self.failUnless(len(trace["traceEvents"]) == 3)
+      self.failUnless(trace["traceEvents"][0]["args"]["object"] == self.L3.Name)
+    finally:
+      self.Doc.RecomputeProfiling = False
+
+  def testParallelRecompute(self):
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    parallel = param.GetBool("ParallelRecompute", False)
+    threads = param.GetInt("RecomputeThreads", 0)
+    param.SetBool("ParallelRecompute", True)
+    param.SetInt("RecomputeThreads", 4)
+    try:
+      # a root depending on many independent leaves
+      leaves = [self.Doc.addObject("App::FeatureTest","Leaf") for i in range(16)]
+      root = self.Doc.addObject("App::FeatureTest","Root")
+      root.LinkList = leaves
+      order = []
+      class Observer:
+        def slotRecomputedObject(self, obj):
+          order.append(obj)
+      observer = Observer()
+      FreeCAD.addDocumentObserver(observer)
+      try:
+        self.Doc.recompute()
+      finally:
+        FreeCAD.removeDocumentObserver(observer)
+      self.failUnless(root.ExecCount == 1)
+      self.failUnless([obj.ExecCount for obj in leaves] == [1]*16)
+      # signals are emitted in topological order
+      self.failUnless(order[-1] == root)
+
+      # a failing leaf must stop the recompute of its dependents only
+      failed = self.Doc.addObject("App::FeatureTestException","Failed")
+      root.LinkList = leaves + [failed]
+      leaves[0].touch()
+      self.Doc.recompute()
+      self.failUnless('Invalid' in failed.State)
+      self.failUnless(leaves[0].ExecCount == 2)
+      self.failUnless(root.ExecCount == 1)
+    finally:
+      param.SetBool("ParallelRecompute", parallel)
+      param.SetInt("RecomputeThreads", threads)
+
+  def testParallelRecomputeUndo(self):
+    import threading
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    parallel = param.GetBool("ParallelRecompute", False)
+    threads = param.GetInt("RecomputeThreads", 0)
+    param.SetBool("ParallelRecompute", True)
+    param.SetInt("RecomputeThreads", 4)
+    try:
+      self.Doc.UndoMode = 1
+      leaves = [self.Doc.addObject("App::FeatureTest","Leaf") for i in range(16)]
+      self.Doc.recompute()
+      changes = []
+      class Observer:
+        def slotBeforeChangeObject(self, obj, prop):
+          if prop == "ExecCount":
+            changes.append((obj.ExecCount, threading.current_thread().ident))
+      observer = Observer()
+      self.Doc.openTransaction("Recompute")
+      for leaf in leaves:
+        leaf.touch()
+      FreeCAD.addDocumentObserver(observer)
+      try:
+        self.Doc.recompute()
+      finally:
+        FreeCAD.removeDocumentObserver(observer)
+      self.Doc.commitTransaction()
+      self.failUnless([leaf.ExecCount for leaf in leaves] == [2]*16)
+      # the workers' changes are announced in the main thread with the old value
+      self.failUnless(changes == [(1, threading.current_thread().ident)]*16)
+      # and recorded by the undo transaction
+      self.Doc.undo()
+      self.failUnless([leaf.ExecCount for leaf in leaves] == [1]*16)
+      self.Doc.redo()
+      self.failUnless([leaf.ExecCount for leaf in leaves] == [2]*16)
+    finally:
+      param.SetBool("ParallelRecompute", parallel)
+      param.SetInt("RecomputeThreads", threads)
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("RecomputeTests")
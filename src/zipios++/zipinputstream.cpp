@@ -58,6 +58,10 @@ ConstEntryPointer ZipInputStream::getNextEntry() {
   return izf->getNextEntry() ;
 }
 
+int ZipInputStream::getEntryDataOffset() const {
+  return izf->getEntryDataOffset() ;
+}
+
 ZipInputStream::~ZipInputStream() {
   // It's ok to call delete with a Null pointer.
   delete izf ;
@@ -49,6 +49,12 @@ public:
   */
   ConstEntryPointer getNextEntry() ;
 
+  /** Returns the position of the data of the current entry in the
+      istream the zip archive is read from, or -1 if no entry is open.
+      Together with the compressed size of the entry this allows to
+      access the data of STORED entries directly in the archive. */
+  int getEntryDataOffset() const ;
+
   /** Destructor. */
   virtual ~ZipInputStream() ;
 
@@ -79,6 +79,11 @@ ConstEntryPointer ZipInputStreambuf::getNextEntry() {
 }
 
 
+int ZipInputStreambuf::getEntryDataOffset() const {
+  return _open_entry ? _data_start : -1 ;
+}
+
+
 ZipInputStreambuf::~ZipInputStreambuf() {
 }
 
@@ -39,6 +39,10 @@ public:
   */
   ConstEntryPointer getNextEntry() ;
 
+  /** Returns the position of the data of the current entry in the
+      underlying streambuf, or -1 if no entry is open. */
+  int getEntryDataOffset() const ;
+
   /** Destructor. */
   virtual ~ZipInputStreambuf() ;
 protected:
@@ -49,6 +49,20 @@ public:
       entry. */
   void putNextEntry( const ZipCDirEntry &entry ) ;
 
+  /** Writes a complete entry whose data has already been compressed
+      with the given method (raw deflate without zlib header for
+      DEFLATED). The data is copied to the archive as is, bypassing
+      the internal deflate stream.
+      @param entry the entry to write.
+      @param method the method the data has been compressed with.
+      @param data the compressed data.
+      @param compressed_size the number of bytes in data.
+      @param size the uncompressed size of the data.
+      @param crc the crc32 checksum of the uncompressed data. */
+  void putRawEntry( const ZipCDirEntry &entry, StorageMethod method,
+                    const char *data, uint32 compressed_size,
+                    uint32 size, uint32 crc ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
@@ -69,6 +83,8 @@ protected:
   void setEntryClosedState() ;
   void updateEntryHeaderInfo() ;
 
+  static int currentDosTime() ;
+
   // Should/could be moved to zipheadio.h ?!
   static void writeCentralDirectory( const vector< ZipCDirEntry > &entries, 
 				     EndOfCentralDirectory eocd,